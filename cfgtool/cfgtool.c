@@ -23,6 +23,13 @@
 #include <stdarg.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#ifndef _WIN32
+#  include <poll.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#endif
 
 #include "ff_debug.h"
 #include "ff_stuff.h"
@@ -36,13 +43,22 @@
 #include "cfgtool_uc2cfg.h"
 #include "cfgtool_cfginfo.h"
 #include "cfgtool_parse.h"
+#include "cfgtool_index.h"
+#include "cfgtool_extract.h"
+#include "cfgtool_record.h"
+#include "cfgtool_replay.h"
 #include "cfgtool_reset.h"
 #include "cfgtool_status.h"
+#include "cfgtool_stats.h"
 #include "cfgtool_bin2hex.h"
+#include "cfgtool_bench.h"
+#include "cfgtool_sim.h"
 
 
 /* ****************************************************************************************************************** */
 
+#define CFGTOOL_MAX_PORTS 256
+
 // FIXME: there's room for improvement...
 
 typedef struct CMD_s
@@ -59,6 +75,15 @@ typedef struct CMD_s
     bool          may_u;
     bool          may_U;
     bool          may_R;
+    bool          may_P;    // May use multiple -p ports (run concurrently)
+    bool          may_j;    // May use -j (other than for multiple ports)
+    bool          may_t;    // May use -t
+    bool          may_m;    // May use -m
+    bool          may_f;    // May use -f, -S and -T
+    bool          may_s;    // May use -s
+    bool          may_E;    // May use -E
+    bool          i_or_p;   // Needs either -i (input file) or -p (receiver)
+    bool          stream_o; // Output of multiple ports is streamed line by line (rather than one block per port)
     const char   *info;
     const char *(*help)(void);
     int         (*run)(void);
@@ -77,8 +102,21 @@ typedef struct ARGS_s
     bool         outOverwrite;
 
     const char  *rxPort;
+    const char  *rxPorts[CFGTOOL_MAX_PORTS];
+    int          numRxPorts;
+    char        *rxPortsAlloc[CFGTOOL_MAX_PORTS]; // Ports from '@<file>' lists (strdup()ed)
+    int          numRxPortsAlloc;
+    const char  *numJobsStr;
+    int          numJobs;
     const char  *cfgLayer;
     const char  *resetType;
+    const char  *timeRange;
+    const char  *msgFilter;
+    const char  *recFormat;
+    const char  *rotateSize;
+    const char  *rotateTime;
+    const char  *replaySpeed;
+    const char  *epochFormat;
     bool         useUnknown;
     bool         extraInfo;
     bool         applyConfig;
@@ -99,24 +137,31 @@ static int cfg2hex(void) { return cfg2hexRun(gArgs.cfgLayer, gArgs.extraInfo, gA
 static int cfg2c(void)   { return cfg2cRun(  gArgs.cfgLayer, gArgs.extraInfo, gArgs.allowReplace); }
 static int uc2cfg(void)  { return uc2cfgRun(); }
 static int cfginfo(void) { return cfginfoRun(); }
-static int dump(void)    { return dumpRun( gArgs.rxPort, gArgs.extraInfo, gArgs.noProbe); }
-static int parse(void)   { return parseRun(  gArgs.extraInfo, gArgs.doEpoch ); }
+static int dump(void)    { return dumpRun( gArgs.rxPort, gArgs.extraInfo, gArgs.noProbe, gArgs.epochFormat); }
+static int parse(void)   { return parseRun(  gArgs.inName, gArgs.extraInfo, gArgs.doEpoch || (gArgs.epochFormat != NULL), gArgs.epochFormat, gArgs.numJobs, gArgs.timeRange, gArgs.msgFilter); }
+static int indexCmd(void) { return indexRun(  gArgs.inName); }
+static int extract(void) { return extractRun(gArgs.inName, gArgs.timeRange, gArgs.msgFilter); }
+static int record(void)  { return recordRun( gArgs.rxPort, gArgs.outName, gArgs.outOverwrite, gArgs.noProbe, gArgs.recFormat, gArgs.rotateSize, gArgs.rotateTime); }
+static int replay(void)  { return replayRun( gArgs.inName, gArgs.rxPort, gArgs.replaySpeed); }
 static int reset(void)   { return resetRun(  gArgs.rxPort, gArgs.resetType); }
+static int stats(void)   { return statsRun(  gArgs.inName, gArgs.rxPort, gArgs.extraInfo, gArgs.noProbe); }
 static int status(void)  { return statusRun( gArgs.rxPort, gArgs.extraInfo, gArgs.noProbe); }
 static int bin2hex(void) { return bin2hexRun(); }
 static int hex2bin(void) { return hex2binRun(); }
 static int cmd2rx(void)  { return cmd2rxRun( gArgs.rxPort, gArgs.noProbe, gArgs.extraInfo); }
+static int bench(void)   { return benchRun(  gArgs.msgFilter, gArgs.extraInfo); }
+static int sim(void)     { return simRun(    gArgs.rxPort, gArgs.msgFilter); }
 
 const CMD_t kCmds[] =
 {
     { .name = "cfg2rx",  .info = "Configure a receiver from a configuration file",             .help = cfg2rxHelp,  .run = cfg2rx,
-      .need_i = true,  .need_o = false, .need_p = true,  .need_l = true,  .may_r  = true,  .may_n = false, .may_e = false, .may_u = true,  .may_U = true,  .may_R = true,  },
+      .need_i = true,  .need_o = false, .need_p = true,  .need_l = true,  .may_r  = true,  .may_n = false, .may_e = false, .may_u = true,  .may_U = true,  .may_R = true,  .may_P = true,  },
 
     { .name = "rx2cfg",  .info = "Create configuration file from config in a receiver",        .help = rx2cfgHelp,  .run = rx2cfg,
-      .need_i = false, .need_o = true,  .need_p = true,  .need_l = true,  .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
+      .need_i = false, .need_o = true,  .need_p = true,  .need_l = true,  .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_P = true,  },
 
     { .name = "rx2list", .info = "Like rx2cfg but output a flat list of key-value pairs",      .help = rx2listHelp, .run = rx2list,
-      .need_i = false, .need_o = true,  .need_p = true,  .need_l = true,  .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = true,  },
+      .need_i = false, .need_o = true,  .need_p = true,  .need_l = true,  .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = true,  .may_P = true,  },
 
     { .name = "cfg2ubx", .info = "Convert config file to UBX-CFG-VALSET message(s)",           .help = cfg2ubxHelp, .run = cfg2ubx,
       .need_i = true,  .need_o = true,  .need_p = false, .need_l = true,  .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = true,  },
@@ -134,16 +179,31 @@ const CMD_t kCmds[] =
       .need_i = false, .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
 
     { .name = "dump",    .info = "Connects to receiver and prints received message frames",    .help = dumpHelp,    .run = dump,
-      .need_i = false, .need_o = true,  .need_p = true,  .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
+      .need_i = false, .need_o = true,  .need_p = true,  .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_E = true,  },
 
     { .name = "parse",   .info = "Parse file and output message frames",                       .help = parseHelp,   .run = parse,
-      .need_i = true,  .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = true,  .may_u = false, .may_U = false, .may_R = false, },
+      .need_i = true,  .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = true,  .may_u = false, .may_U = false, .may_R = false, .may_j = true,  .may_t = true,  .may_m = true,  .may_E = true,  },
+
+    { .name = "index",   .info = "Create index of file for parse/extract -t/-m",              .help = indexHelp,   .run = indexCmd,
+      .need_i = true,  .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
+
+    { .name = "extract", .info = "Copy selected messages from file (binary)",                  .help = extractHelp, .run = extract,
+      .need_i = true,  .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_t = true,  .may_m = true,  },
+
+    { .name = "record",  .info = "Connects to receiver and records received data",             .help = recordHelp,  .run = record,
+      .need_i = false, .need_o = true,  .need_p = true,  .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_f = true,  },
+
+    { .name = "replay",  .info = "Send messages from a file to a port with their original timing", .help = replayHelp, .run = replay,
+      .need_i = true,  .need_o = false, .need_p = true,  .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_s = true,  },
 
     { .name = "reset",   .info = "Reset receiver",                                             .help = resetHelp,   .run = reset,
-      .need_i = false, .need_o = false, .need_p = true,  .need_l = false, .need_r = true,  .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
+      .need_i = false, .need_o = false, .need_p = true,  .need_l = false, .need_r = true,  .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_P = true,  },
+
+    { .name = "stats",   .info = "Print message statistics (rate, bandwidth, intervals, ...)", .help = statsHelp,   .run = stats,
+      .need_i = false, .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, .i_or_p = true, },
 
     { .name = "status",  .info = "Connects to receiver and prints status",                     .help = statusHelp,  .run = status,
-      .need_i = false, .need_o = true,  .need_p = true,  .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
+      .need_i = false, .need_o = true,  .need_p = true,  .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_P = true,  .stream_o = true, },
 
     { .name = "bin2hex", .info = "Convert to hex dump",                                        .help = bin2hexHelp, .run = bin2hex,
       .need_i = true,  .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
@@ -154,6 +214,12 @@ const CMD_t kCmds[] =
     { .name = "cmd2rx", .info = "Send commands to a receiver",                                 .help = cmd2rxHelp,  .run = cmd2rx,
       .need_i = true,  .need_o = false, .need_p = true,  .need_l = false, .need_r = false, .may_n = true,  .may_e = false, .may_u = false, .may_U = false, .may_R = false, },
 
+    { .name = "bench",   .info = "Run parser, epoch, CRC and configuration library benchmarks", .help = benchHelp,  .run = bench,
+      .need_i = false, .need_o = true,  .need_p = false, .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_m = true,  },
+
+    { .name = "sim",     .info = "Simulate a receiver on a pseudo-terminal",                   .help = simHelp,     .run = sim,
+      .need_i = false, .need_o = false, .need_p = true,  .need_l = false, .need_r = false, .may_n = false, .may_e = false, .may_u = false, .may_U = false, .may_R = false, .may_P = true,  .may_m = true,  },
+
 };
 
 const char * const kTitleStr =
@@ -199,6 +265,9 @@ const char * const kHelpStr =
     "                       [ser://]<device>[:<baudrate>]\n"
     "                       tcp://<host>:<port>[:<baudrate>]\n"
     "                       telnet://<host>:<port>[:<baudrate>]\n"
+    "                   Some commands accept more than one port (see below).\n"
+    "    -j <num>       Number of concurrent jobs (multiple ports: default all,\n"
+    "                   parse: default 1)\n"
     "    -l <layer(s)>  Configuration layer(s) to use:\n"
     "                       RAM, BBR, Flash, Default\n"
     "    -r <reset>     Reset mode to use to reset the receiver:\n"
@@ -209,6 +278,14 @@ const char * const kHelpStr =
     "    -a             Activate configuration after storing\n"
     "    -n             Do not probe/autobaud receiver, use passive reading only.\n"
     "                   For example, for other receivers or read-only connection.\n"
+    "    -t <range>     Time range (see 'index' command)\n"
+    "    -m <filter>    Message filter (see 'index' command), protocol mix (see\n"
+    "                   'bench' command), or simulator spec (see 'sim' command)\n"
+    "    -f <format>    Output format (see 'record' command)\n"
+    "    -S <size>      Output file size (see 'record' command)\n"
+    "    -T <duration>  Output file duration (see 'record' command)\n"
+    "    -s <speed>     Replay speed (see 'replay' command)\n"
+"    -E <format>    Epoch output format (see 'parse' command)\n"
     "\n"
     // -----------------------------------------------------------------------------
     "    Available <commands>s:\n"
@@ -277,6 +354,16 @@ const char * const kPortHelp =
     "        A minimal ser2net command line that should work is:\n"
     "           ser2net -d -C \"12345:telnet:0:/dev/ttyUSB0: remctl\"\n"
     "        This should allow using '-p telnet://localhost:12345'.\n"
+    "\n"
+    "    Multiple ports: The commands cfg2rx, rx2cfg, rx2list, reset, status and\n"
+    "    sim accept more than one port. The '-p' argument can be given several\n"
+    "    times and '-p @<file>' reads a list of ports (one per line, # style\n"
+    "    comments) from a file. The ports are processed concurrently (up to\n"
+    "    '-j <num>' at a time), log messages are prefixed with the port, and the\n"
+    "    output of each port is written as a block preceded by a '# <port>'\n"
+    "    comment line. For the status command each output line is prefixed with\n"
+    "    the port instead. The exit status is that of the worst failing port.\n"
+    "    Multiple ports are processed one after the other on Windows.\n"
     "\n";
 
 const char * const kLayersHelp =
@@ -369,6 +456,480 @@ void printVersion(void)
     fputs(kGreeting, stdout);
 }
 
+// Free the ports read from '@<file>' lists
+static void _freePortList(void)
+{
+    for (int ix = 0; ix < gArgs.numRxPortsAlloc; ix++)
+    {
+        free(gArgs.rxPortsAlloc[ix]);
+        gArgs.rxPortsAlloc[ix] = NULL;
+    }
+    gArgs.numRxPortsAlloc = 0;
+}
+
+// Expand '@<file>' entries in the list of ports
+static bool _expandPortList(void)
+{
+    const char *ports[CFGTOOL_MAX_PORTS];
+    int numPorts = 0;
+    bool res = true;
+    for (int portIx = 0; res && (portIx < gArgs.numRxPorts); portIx++)
+    {
+        const char *port = gArgs.rxPorts[portIx];
+        if (port[0] != '@')
+        {
+            if (numPorts < NUMOF(ports))
+            {
+                ports[numPorts++] = port;
+            }
+            else
+            {
+                WARNING("Too many ports!");
+                res = false;
+            }
+            continue;
+        }
+
+        FILE *file = fopen(&port[1], "r");
+        if (file == NULL)
+        {
+            WARNING("Failed opening port list '%s': %s!", &port[1], strerror(errno));
+            res = false;
+            break;
+        }
+        char line[1000];
+        while (res && (fgets(line, sizeof(line), file) != NULL))
+        {
+            // Remove comments and whitespace
+            char *comment = strchr(line, '#');
+            if (comment != NULL)
+            {
+                *comment = '\0';
+            }
+            char *pLine = line;
+            while (isspace(*pLine) != 0)
+            {
+                pLine++;
+            }
+            char *pEnd = &pLine[strlen(pLine)];
+            while ( (pEnd > pLine) && (isspace(pEnd[-1]) != 0) )
+            {
+                pEnd--;
+            }
+            *pEnd = '\0';
+            if (pLine[0] == '\0')
+            {
+                continue;
+            }
+            if (numPorts < NUMOF(ports))
+            {
+                char *dup = strdup(pLine);
+                if (dup == NULL)
+                {
+                    WARNING("malloc fail!");
+                    res = false;
+                    break;
+                }
+                gArgs.rxPortsAlloc[gArgs.numRxPortsAlloc++] = dup;
+                ports[numPorts++] = dup;
+            }
+            else
+            {
+                WARNING("Too many ports in '%s'!", &port[1]);
+                res = false;
+            }
+        }
+        fclose(file);
+    }
+
+    if (res)
+    {
+        memcpy(gArgs.rxPorts, ports, numPorts * sizeof(ports[0]));
+        gArgs.numRxPorts = numPorts;
+    }
+    else
+    {
+        _freePortList();
+    }
+    return res;
+}
+
+#ifndef _WIN32
+// Read entire input into memory so that it can be handed to each worker
+static char *_slurpInput(size_t *size)
+{
+    const int fd = fileno(gArgs.inFile);
+    const int flags = fcntl(fd, F_GETFL, 0);
+    if ( (flags >= 0) && ((flags & O_NONBLOCK) != 0) )
+    {
+        fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+    }
+    char *data = NULL;
+    size_t dataSize = 0;
+    size_t allocSize = 0;
+    while (true)
+    {
+        if (dataSize >= allocSize)
+        {
+            allocSize += 64 * 1024;
+            char *newData = realloc(data, allocSize);
+            if (newData == NULL)
+            {
+                free(data);
+                return NULL;
+            }
+            data = newData;
+        }
+        const size_t num = fread(&data[dataSize], 1, allocSize - dataSize, gArgs.inFile);
+        if (num == 0)
+        {
+            break;
+        }
+        dataSize += num;
+    }
+    *size = dataSize;
+    return data;
+}
+
+static volatile bool gAbortMulti;
+
+static void _sigHandlerMulti(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) || (signal == SIGHUP) )
+    {
+        gAbortMulti = true;
+    }
+}
+
+typedef struct WORKER_s
+{
+    const char *port;
+    pid_t       pid;
+    int         fd;        // Read end of pipe connected to the worker's stdout, -1 when closed
+    int         exitCode;
+    bool        started;
+    char       *out;       // Output from worker not yet written
+    int         outSize;
+    bool        outFail;   // Output was dropped (out of memory)
+
+} WORKER_t;
+
+static bool _startWorker(WORKER_t *workers, const int workerIx, const char *inData, const size_t inSize)
+{
+    WORKER_t *worker = &workers[workerIx];
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        WARNING("%s: pipe() failed: %s", worker->port, strerror(errno));
+        return false;
+    }
+    fflush(NULL);
+    const pid_t pid = fork();
+    if (pid < 0)
+    {
+        WARNING("%s: fork() failed: %s", worker->port, strerror(errno));
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    // Worker: run the command with the port and output to stdout (the pipe)
+    if (pid == 0)
+    {
+        close(fds[0]);
+        for (int ix = 0; ix < workerIx; ix++)
+        {
+            if (workers[ix].fd >= 0)
+            {
+                close(workers[ix].fd);
+            }
+        }
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[1]);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGHUP, SIG_DFL);
+
+        char mark[200];
+        snprintf(mark, sizeof(mark), "%s[%s]", gArgs.cmd->name, worker->port);
+        DEBUG_CFG_t debugCfg;
+        debugGetCfg(&debugCfg);
+        debugCfg.mark = mark;
+        debugSetup(&debugCfg);
+
+        if (gArgs.cmd->need_i)
+        {
+            gArgs.inFile = fmemopen((void *)inData, inSize, "r");
+            if (gArgs.inFile == NULL)
+            {
+                WARNING("fmemopen() failed: %s", strerror(errno));
+                exit(EXIT_OTHERFAIL);
+            }
+            ioSetInput(gArgs.inName, gArgs.inFile);
+        }
+        if (gArgs.cmd->need_o)
+        {
+            // The parent writes the output (and says where to)
+            ioSetOutput(gArgs.outName, stdout, true);
+            ioSetOutputQuiet(true);
+        }
+        gArgs.rxPort = worker->port;
+        const int exitCode = gArgs.cmd->run();
+        exit( (!ioCloseOutput() && (exitCode == EXIT_SUCCESS)) ? EXIT_OTHERFAIL : exitCode );
+    }
+
+    // Parent
+    close(fds[1]);
+    worker->pid     = pid;
+    worker->fd      = fds[0];
+    worker->started = true;
+    DEBUG("%s: worker pid %d", worker->port, (int)pid);
+    return true;
+}
+
+// Output the (complete lines of) output collected from a worker
+static void _outputWorker(WORKER_t *worker, const bool final, bool *append)
+{
+    int size = 0;
+    if (gArgs.cmd->stream_o)
+    {
+        for (int ix = 0; ix < worker->outSize; ix++)
+        {
+            if (worker->out[ix] == '\n')
+            {
+                const int len = ix + 1 - size;
+                ioOutputStr("%s: ", worker->port);
+                ioAddOutputBin((const uint8_t *)&worker->out[size], len);
+                size += len;
+            }
+        }
+        if (final && (size < worker->outSize))
+        {
+            ioOutputStr("%s: ", worker->port);
+            ioAddOutputBin((const uint8_t *)&worker->out[size], worker->outSize - size);
+            ioOutputStr("\n");
+            size = worker->outSize;
+        }
+    }
+    else if (final && (worker->outSize > 0))
+    {
+        ioOutputStr("# %s\n", worker->port);
+        ioAddOutputBin((const uint8_t *)worker->out, worker->outSize);
+        size = worker->outSize;
+    }
+
+    if (size > 0)
+    {
+        ioWriteOutput(*append);
+        *append = true;
+        worker->outSize -= size;
+        memmove(worker->out, &worker->out[size], worker->outSize);
+    }
+}
+#endif
+
+// Severity of an exit code (the EXIT_* values are not ordered by severity), unknown codes are the most severe
+static int _exitSeverity(const int exitCode)
+{
+    switch (exitCode)
+    {
+        case EXIT_SUCCESS:   return 0;
+        case EXIT_RXNODATA:  return 1;
+        case EXIT_RXFAIL:    return 2;
+        case EXIT_BADARGS:   return 3;
+        case EXIT_OTHERFAIL: return 4;
+    }
+    return 5;
+}
+
+// The more severe of two exit codes, the first one if they're equally severe
+static int _worseExitCode(const int exitCode1, const int exitCode2)
+{
+    return _exitSeverity(exitCode2) > _exitSeverity(exitCode1) ? exitCode2 : exitCode1;
+}
+
+// Run command for multiple ports
+static int _runMulti(void)
+{
+    const int numWorkers = gArgs.numRxPorts;
+    const int numJobs = gArgs.numJobs > 0 ? gArgs.numJobs : numWorkers;
+    int exitCode = EXIT_SUCCESS;
+    PRINT("Running %s for %d ports (%d at a time)", gArgs.cmd->name, numWorkers, MIN(numJobs, numWorkers));
+
+#ifdef _WIN32
+    for (int ix = 0; ix < numWorkers; ix++)
+    {
+        gArgs.rxPort = gArgs.rxPorts[ix];
+        PRINT("%s: start", gArgs.rxPort);
+        const int res = gArgs.cmd->run();
+        PRINT("%s: %s (exit %d)", gArgs.rxPort, res == EXIT_SUCCESS ? "success" : "failure", res);
+        exitCode = _worseExitCode(exitCode, res);
+    }
+#else
+    // The input file is read only once, each worker gets a copy
+    char *inData = NULL;
+    size_t inSize = 0;
+    if (gArgs.cmd->need_i)
+    {
+        inData = _slurpInput(&inSize);
+        if (inData == NULL)
+        {
+            WARNING("Failed reading input '%s'!", gArgs.inName);
+            return EXIT_OTHERFAIL;
+        }
+    }
+
+    WORKER_t *workers = calloc(numWorkers, sizeof(WORKER_t));
+    if (workers == NULL)
+    {
+        free(inData);
+        return EXIT_OTHERFAIL;
+    }
+    for (int ix = 0; ix < numWorkers; ix++)
+    {
+        workers[ix].port     = gArgs.rxPorts[ix];
+        workers[ix].fd       = -1;
+        workers[ix].exitCode = EXIT_OTHERFAIL;
+    }
+
+    gAbortMulti = false;
+    signal(SIGINT,  _sigHandlerMulti);
+    signal(SIGTERM, _sigHandlerMulti);
+    signal(SIGHUP,  _sigHandlerMulti);
+
+    int nextIx = 0;
+    int numRunning = 0;
+    bool killed = false;
+    bool append = false;
+    while ( (nextIx < numWorkers) || (numRunning > 0) )
+    {
+        // Start more workers
+        while ( !gAbortMulti && (numRunning < numJobs) && (nextIx < numWorkers) )
+        {
+            if (_startWorker(workers, nextIx, inData, inSize))
+            {
+                numRunning++;
+            }
+            nextIx++;
+        }
+        if (gAbortMulti)
+        {
+            nextIx = numWorkers;
+            if (!killed)
+            {
+                for (int ix = 0; ix < numWorkers; ix++)
+                {
+                    if (workers[ix].fd >= 0)
+                    {
+                        kill(workers[ix].pid, SIGTERM);
+                    }
+                }
+                killed = true;
+            }
+        }
+        if (numRunning == 0)
+        {
+            continue;
+        }
+
+        // Wait for output from the workers
+        struct pollfd pfds[CFGTOOL_MAX_PORTS];
+        int pfdIxs[CFGTOOL_MAX_PORTS];
+        int numPfds = 0;
+        for (int ix = 0; ix < numWorkers; ix++)
+        {
+            if (workers[ix].fd >= 0)
+            {
+                pfds[numPfds].fd = workers[ix].fd;
+                pfds[numPfds].events = POLLIN;
+                pfds[numPfds].revents = 0;
+                pfdIxs[numPfds] = ix;
+                numPfds++;
+            }
+        }
+        if (poll(pfds, numPfds, 500) <= 0)
+        {
+            continue;
+        }
+
+        for (int pfdIx = 0; pfdIx < numPfds; pfdIx++)
+        {
+            if (pfds[pfdIx].revents == 0)
+            {
+                continue;
+            }
+            WORKER_t *worker = &workers[pfdIxs[pfdIx]];
+            char buf[16 * 1024];
+            const ssize_t num = read(worker->fd, buf, sizeof(buf));
+            if ( (num < 0) && (errno == EINTR) )
+            {
+                continue;
+            }
+
+            // Collect output
+            if (num > 0)
+            {
+                char *out = worker->outFail ? NULL : realloc(worker->out, worker->outSize + num);
+                if (out != NULL)
+                {
+                    worker->out = out;
+                    memcpy(&worker->out[worker->outSize], buf, num);
+                    worker->outSize += num;
+                    _outputWorker(worker, false, &append);
+                }
+                // Drop this and all further output from the worker, and fail it
+                else if (!worker->outFail)
+                {
+                    WARNING("%s: malloc fail, dropping output", worker->port);
+                    worker->outFail = true;
+                }
+            }
+            // Worker is done
+            else
+            {
+                close(worker->fd);
+                worker->fd = -1;
+                int status = 0;
+                while ( (waitpid(worker->pid, &status, 0) < 0) && (errno == EINTR) ) { }
+                worker->exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_OTHERFAIL;
+                if (worker->outFail)
+                {
+                    worker->exitCode = _worseExitCode(worker->exitCode, EXIT_OTHERFAIL);
+                }
+                _outputWorker(worker, true, &append);
+                free(worker->out);
+                worker->out = NULL;
+                numRunning--;
+                DEBUG("%s: worker pid %d done, exit %d", worker->port, (int)worker->pid, worker->exitCode);
+            }
+        }
+    }
+
+    // Summary
+    for (int ix = 0; ix < numWorkers; ix++)
+    {
+        const WORKER_t *worker = &workers[ix];
+        if (!worker->started)
+        {
+            WARNING("%s: not run", worker->port);
+        }
+        else if (worker->exitCode != EXIT_SUCCESS)
+        {
+            WARNING("%s: failure (exit %d)", worker->port, worker->exitCode);
+        }
+        else
+        {
+            PRINT("%s: success", worker->port);
+        }
+        exitCode = _worseExitCode(exitCode, worker->exitCode);
+    }
+
+    free(workers);
+    free(inData);
+#endif
+    return exitCode;
+}
+
 int main(int argc, char **argv)
 {
     const uint64_t t0 = TIME();
@@ -416,9 +977,28 @@ int main(int argc, char **argv)
         }
         _ARGS_STR("-i", gArgs.inName)
         _ARGS_STR("-o", gArgs.outName)
-        _ARGS_STR("-p", gArgs.rxPort)
+        else if (strcmp("-p", argv[argIx]) == 0)
+        {
+            if ( ((argIx + 1) < argc) && (gArgs.numRxPorts < NUMOF(gArgs.rxPorts)) )
+            {
+                gArgs.rxPorts[gArgs.numRxPorts++] = argv[argIx + 1];
+                argIx++;
+            }
+            else
+            {
+                argOk = false;
+            }
+        }
+        _ARGS_STR("-j", gArgs.numJobsStr)
         _ARGS_STR("-l", gArgs.cfgLayer)
         _ARGS_STR("-r", gArgs.resetType)
+        _ARGS_STR("-t", gArgs.timeRange)
+        _ARGS_STR("-m", gArgs.msgFilter)
+        _ARGS_STR("-f", gArgs.recFormat)
+        _ARGS_STR("-S", gArgs.rotateSize)
+        _ARGS_STR("-T", gArgs.rotateTime)
+        _ARGS_STR("-s", gArgs.replaySpeed)
+        _ARGS_STR("-E", gArgs.epochFormat)
         _ARGS_BOOL("-u", gArgs.useUnknown, true)
         _ARGS_BOOL("-x", gArgs.extraInfo, true)
         _ARGS_BOOL("-a", gArgs.applyConfig, true)
@@ -488,7 +1068,7 @@ int main(int argc, char **argv)
     }
 
     // Open input file
-    if (res && gArgs.cmd->need_i)
+    if (res && (gArgs.cmd->need_i || (gArgs.cmd->i_or_p && (gArgs.numRxPorts == 0))))
     {
         if ( (gArgs.inName == NULL) || ((gArgs.inName[0] == '-') && (gArgs.inName[1] == '\0')) )
         {
@@ -525,7 +1105,12 @@ int main(int argc, char **argv)
             }
         }
     }
-    else if ( (gArgs.cmd != NULL) && !gArgs.cmd->need_i && (gArgs.inName != NULL) )
+    else if ( (gArgs.cmd != NULL) && gArgs.cmd->i_or_p && (gArgs.inName != NULL) )
+    {
+        WARNING("Cannot use -i and -p together!");
+        res = false;
+    }
+    else if ( (gArgs.cmd != NULL) && !gArgs.cmd->need_i && !gArgs.cmd->i_or_p && (gArgs.inName != NULL) )
     {
         WARNING("Illegal argument '-i %s'!", gArgs.inName);
         res = false;
@@ -554,6 +1139,11 @@ int main(int argc, char **argv)
     ioSetOutput(gArgs.outName, gArgs.outFile, gArgs.outOverwrite);
 
     // Require -p arg?
+    if ( res && (gArgs.numRxPorts > 0) && !_expandPortList() )
+    {
+        res = false;
+    }
+    gArgs.rxPort = gArgs.numRxPorts > 0 ? gArgs.rxPorts[0] : NULL;
     if ( (gArgs.cmd != NULL) && gArgs.cmd->need_p )
     {
         if ( (gArgs.rxPort == NULL) || (gArgs.rxPort[0] == '\0') )
@@ -561,13 +1151,38 @@ int main(int argc, char **argv)
             WARNING("Need '-p <port>' argument!");
             res = false;
         }
+        else if ( (gArgs.numRxPorts > 1) && !gArgs.cmd->may_P )
+        {
+            WARNING("Illegal argument '-p %s', only one port allowed!", gArgs.rxPorts[1]);
+            res = false;
+        }
+    }
+    else if ( (gArgs.cmd != NULL) && gArgs.cmd->i_or_p && (gArgs.numRxPorts > 1) )
+    {
+        WARNING("Illegal argument '-p %s', only one port allowed!", gArgs.rxPorts[1]);
+        res = false;
     }
-    else if ( (gArgs.cmd != NULL) && !gArgs.cmd->need_p && (gArgs.rxPort != NULL) )
+    else if ( (gArgs.cmd != NULL) && !gArgs.cmd->need_p && !gArgs.cmd->i_or_p && (gArgs.rxPort != NULL) )
     {
         WARNING("Illegal argument '-p %s'!", gArgs.rxPort);
         res = false;
     }
 
+    // May use -j arg?
+    if ( (gArgs.cmd != NULL) && (gArgs.numJobsStr != NULL) )
+    {
+        if (!gArgs.cmd->may_P && !gArgs.cmd->may_j)
+        {
+            WARNING("Illegal argument '-j %s'!", gArgs.numJobsStr);
+            res = false;
+        }
+        else if ( (sscanf(gArgs.numJobsStr, "%d", &gArgs.numJobs) != 1) || (gArgs.numJobs < 1) )
+        {
+            WARNING("Illegal number of jobs '-j %s'!", gArgs.numJobsStr);
+            res = false;
+        }
+    }
+
     // Require -l arg?
     if ((gArgs.cmd != NULL) && gArgs.cmd->need_l)
     {
@@ -598,6 +1213,42 @@ int main(int argc, char **argv)
         res = false;
     }
 
+    // May use -t arg?
+    if ( (gArgs.cmd != NULL) && !gArgs.cmd->may_t && (gArgs.timeRange != NULL) )
+    {
+        WARNING("Illegal argument '-t %s'!", gArgs.timeRange);
+        res = false;
+    }
+
+    // May use -m arg?
+    if ( (gArgs.cmd != NULL) && !gArgs.cmd->may_m && (gArgs.msgFilter != NULL) )
+    {
+        WARNING("Illegal argument '-m %s'!", gArgs.msgFilter);
+        res = false;
+    }
+
+    // May use -f, -S and -T args?
+    if ( (gArgs.cmd != NULL) && !gArgs.cmd->may_f &&
+         ( (gArgs.recFormat != NULL) || (gArgs.rotateSize != NULL) || (gArgs.rotateTime != NULL) ) )
+    {
+        WARNING("Illegal argument '%s'!", gArgs.recFormat != NULL ? "-f" : (gArgs.rotateSize != NULL ? "-S" : "-T"));
+        res = false;
+    }
+
+    // May use -s arg?
+    if ( (gArgs.cmd != NULL) && !gArgs.cmd->may_s && (gArgs.replaySpeed != NULL) )
+    {
+        WARNING("Illegal argument '-s %s'!", gArgs.replaySpeed);
+        res = false;
+    }
+
+    // May use -E arg?
+    if ( (gArgs.cmd != NULL) && !gArgs.cmd->may_E && (gArgs.epochFormat != NULL) )
+    {
+        WARNING("Illegal argument '-E %s'!", gArgs.epochFormat);
+        res = false;
+    }
+
     // May use -n arg?
     if ( (gArgs.cmd != NULL) && (!gArgs.cmd->may_n && gArgs.noProbe) )
     {
@@ -633,10 +1284,15 @@ int main(int argc, char **argv)
     }
 
     // Execute
-    DEBUG("args: inName=%s outName=%s outOverwrite=%d rxPort=%s cfgLayer=%s useUnknown=%d extraInfo=%d applyConfig=%d noProbe=%d doEpoch=%d updateOnly=%d allowReplace=%d",
-        gArgs.inName, gArgs.outName, gArgs.outOverwrite, gArgs.rxPort, gArgs.cfgLayer, gArgs.useUnknown, gArgs.extraInfo, gArgs.applyConfig, gArgs.noProbe, gArgs.doEpoch, gArgs.updateOnly, gArgs.allowReplace);
+    DEBUG("args: inName=%s outName=%s outOverwrite=%d rxPort=%s numRxPorts=%d numJobs=%d cfgLayer=%s useUnknown=%d extraInfo=%d applyConfig=%d noProbe=%d doEpoch=%d updateOnly=%d allowReplace=%d timeRange=%s msgFilter=%s",
+        gArgs.inName, gArgs.outName, gArgs.outOverwrite, gArgs.rxPort, gArgs.numRxPorts, gArgs.numJobs, gArgs.cfgLayer, gArgs.useUnknown, gArgs.extraInfo, gArgs.applyConfig, gArgs.noProbe, gArgs.doEpoch, gArgs.updateOnly, gArgs.allowReplace, gArgs.timeRange, gArgs.msgFilter);
 
-    const int exitCode = gArgs.cmd->run();
+    int exitCode = gArgs.numRxPorts > 1 ? _runMulti() : gArgs.cmd->run();
+    if (!ioCloseOutput() && (exitCode == EXIT_SUCCESS))
+    {
+        exitCode = EXIT_OTHERFAIL;
+    }
+    _freePortList();
 
     DEBUG("Duration %.3f", (double)(TIME() - t0) * 1e-3);
     return exitCode;
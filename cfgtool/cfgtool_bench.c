@@ -0,0 +1,641 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <signal.h>
+
+#include "cfgtool_util.h"
+
+#include "ff_parser.h"
+#include "ff_epoch.h"
+#include "ff_crc.h"
+#include "ff_ubx.h"
+
+#include "cfgtool_fake.h"
+#include "cfgtool_bench.h"
+
+/* ****************************************************************************************************************** */
+
+#define BENCH_STREAM_SIZE  (16 * 1024 * 1024) // Size of the generated stream [bytes]
+#define BENCH_EPOCH_SIZE   (8 * 1024)         // Approximate size of one (1 Hz) epoch in the stream [bytes]
+#define BENCH_CHUNK_SIZE   4096               // Size of the chunks fed to the parser [bytes]
+#define BENCH_CRC_SIZE     256                // Size of the blocks to calculate CRCs on [bytes]
+#define BENCH_MIN_TIME     500                // Minimal run time for each benchmark [ms]
+#define BENCH_DEFAULT_MIX  "ubx:55,nmea:20,rtcm3:20,novatel:4,garbage:1"
+
+const char *benchHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'bench':\n"
+"\n"
+"    Usage: cfgtool bench [-o <outfile>] [-y] [-m <mix>] [-x]\n"
+"\n"
+"    Runs benchmarks of the message parser, the navigation epoch collector, the\n"
+"    CRC functions and the configuration library and reports the throughput.\n"
+"\n"
+"    The parser and epoch benchmarks use a generated stream of "STRINGIFY(BENCH_STREAM_SIZE)" bytes.\n"
+"    It consists of 1Hz navigation epochs (UBX-NAV-PVT, UBX-NAV-SAT,\n"
+"    UBX-NAV-SIG, UBX-NAV-EOE, NMEA GGA and RMC), other messages (UBX-ESF-MEAS,\n"
+"    UBX-ESF-STATUS, UBX-MON-HW, NMEA GSA and GSV, RTCM3 1005 and 1077, NOVATEL\n"
+"    BESTPOS) and garbage. The mix of the protocols is given as a list of\n"
+"    <protocol>:<weight> pairs, where <protocol> is one of 'ubx', 'nmea',\n"
+"    'rtcm3', 'novatel' or 'garbage' and <weight> is the relative share of\n"
+"    the data (bytes). The default is '"BENCH_DEFAULT_MIX"'.\n"
+"\n"
+"    Each benchmark is repeated for at least "STRINGIFY(BENCH_MIN_TIME)"ms. The output is one line\n"
+"    per benchmark:\n"
+"\n"
+"        bench <name> <bytes> <count> <time> <MB/s> <ns/op>\n"
+"\n"
+"    Where <bytes> and <count> are the total number of bytes and operations\n"
+"    (messages, CRC blocks of "STRINGIFY(BENCH_CRC_SIZE)" bytes, key-value pairs or lookups), and\n"
+"    <time> is the total time [ns]. The <MB/s> are 0.0 for benchmarks that\n"
+"    do not process data. Lines starting with '#' are comments. With -x the\n"
+"    composition of the generated stream is output as well.\n"
+"\n"
+"    The benchmarks are:\n"
+"\n"
+"        parser-nonames    parserProcess() without message names\n"
+"        parser            parserProcess()\n"
+"        parser-info       parserProcess() with message info\n"
+"        epoch             epochCollect()\n"
+"        crc-<name>        crc<Name>() (each CRC of ff_crc.h)\n"
+"        cfg-make          ubloxcfg_makeData()\n"
+"        cfg-parse         ubloxcfg_parseData()\n"
+"        cfg-stringify     ubloxcfg_stringifyKeyVal()\n"
+"        cfg-byname        ubloxcfg_getItemByName()\n"
+"        cfg-byid          ubloxcfg_getItemById()\n"
+"        cfg-msgrate       ubloxcfg_getMsgRateCfg()\n"
+"\n"
+"    The 'bench' build target runs this with the default settings.\n"
+"\n"
+"    Examples:\n"
+"\n"
+"        cfgtool bench\n"
+"        cfgtool bench -m ubx:1 -o bench-ubx.txt\n"
+"        cfgtool bench -m ubx:50,nmea:50,garbage:10 -x\n"
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        PRINT("Aborting...");
+        gAbort = true;
+    }
+}
+
+// Result sink, so that the compiler doesn't optimise away the functions under test
+static volatile uint32_t gSink;
+
+typedef enum BENCH_PROTO_e
+{
+    BENCH_PROTO_UBX = 0, BENCH_PROTO_NMEA, BENCH_PROTO_RTCM3, BENCH_PROTO_NOVATEL, BENCH_PROTO_GARBAGE,
+    _BENCH_PROTO_NUM
+} BENCH_PROTO_t;
+
+static const char * const kBenchProtoNames[_BENCH_PROTO_NUM] = { "ubx", "nmea", "rtcm3", "novatel", "garbage" };
+
+typedef struct BENCH_STREAM_s
+{
+    uint8_t  *data;
+    int       size;
+    uint32_t  seed;                      // Pseudo-random number generator state
+    double    weights[_BENCH_PROTO_NUM]; // Share of the protocols
+    double    target[_BENCH_PROTO_NUM];  // Target number of bytes for each protocol
+    uint64_t  bytes[_BENCH_PROTO_NUM];   // Generated number of bytes for each protocol
+    uint32_t  nMsgs[_BENCH_PROTO_NUM];   // Generated number of messages (chunks for garbage)
+    uint32_t  nEpochs;
+    uint32_t  iTow;
+    uint32_t  nFill[_BENCH_PROTO_NUM];   // Counter to cycle through different messages
+} BENCH_STREAM_t;
+
+typedef struct BENCH_s
+{
+    const char *name;
+    uint64_t    bytes;
+    uint64_t    count;
+    uint64_t    t0;
+    uint64_t    time;
+} BENCH_t;
+
+/* ****************************************************************************************************************** */
+
+static void _add(BENCH_STREAM_t *st, const BENCH_PROTO_t proto, const uint8_t *data, const int size)
+{
+    memcpy(&st->data[st->size], data, size);
+    st->size += size;
+    st->bytes[proto] += size;
+    st->nMsgs[proto]++;
+}
+
+// Navigation epoch messages
+static void _addEpochUbx(BENCH_STREAM_t *st)
+{
+    uint8_t msg[FAKE_MSG_MAX_SIZE];
+    _add(st, BENCH_PROTO_UBX, msg, fakeUbxNavPvt(msg, st->iTow, &st->seed));
+    _add(st, BENCH_PROTO_UBX, msg, fakeUbxNavSat(msg, st->iTow, &st->seed));
+    _add(st, BENCH_PROTO_UBX, msg, fakeUbxNavSig(msg, st->iTow, &st->seed));
+}
+
+static void _addEpochNmea(BENCH_STREAM_t *st)
+{
+    uint8_t msg[FAKE_MSG_MAX_SIZE];
+    _add(st, BENCH_PROTO_NMEA, msg, fakeNmeaGga(msg, st->iTow));
+    _add(st, BENCH_PROTO_NMEA, msg, fakeNmeaRmc(msg, st->iTow));
+}
+
+// Other messages
+static void _addFill(BENCH_STREAM_t *st, const BENCH_PROTO_t proto)
+{
+    const uint32_t n = st->nFill[proto]++;
+    uint8_t msg[FAKE_MSG_MAX_SIZE];
+    int size = 0;
+    switch (proto)
+    {
+        case BENCH_PROTO_UBX:
+            switch (n % 3)
+            {
+                case 0: size = fakeUbxEsfMeas(msg, st->iTow, &st->seed); break;
+                case 1: size = fakeUbxEsfStatus(msg, st->iTow);          break;
+                case 2: size = fakeUbxMonHw(msg, n, &st->seed);          break;
+            }
+            break;
+        case BENCH_PROTO_NMEA:
+            size = (n % 2) == 0 ? fakeNmeaGsa(msg) : fakeNmeaGsv(msg, n);
+            break;
+        case BENCH_PROTO_RTCM3:
+            size = (n % 10) == 0 ? fakeRtcm3(msg, 1005, 19, &st->seed) :
+                fakeRtcm3(msg, 1077, 100 + (fakeRand(&st->seed) % 400), &st->seed);
+            break;
+        case BENCH_PROTO_NOVATEL:
+            size = fakeNovatel(msg, 42 /* BESTPOS */, 72, &st->seed);
+            break;
+        case BENCH_PROTO_GARBAGE:
+            size = fakeGarbage(msg, &st->seed);
+            break;
+        case _BENCH_PROTO_NUM:
+            return;
+    }
+    _add(st, proto, msg, size);
+}
+
+static bool _benchParseMix(BENCH_STREAM_t *st, const char *mix)
+{
+    char str[200];
+    if (snprintf(str, sizeof(str), "%s", mix) >= (int)sizeof(str))
+    {
+        return false;
+    }
+    double sum = 0.0;
+    char *save = NULL;
+    for (char *tok = strtok_r(str, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save))
+    {
+        char *colon = strchr(tok, ':');
+        if (colon == NULL)
+        {
+            return false;
+        }
+        *colon = '\0';
+        int proto = 0;
+        while ( (proto < _BENCH_PROTO_NUM) && (strcasecmp(tok, kBenchProtoNames[proto]) != 0) )
+        {
+            proto++;
+        }
+        double weight = 0.0;
+        int n = 0;
+        if ( (proto >= _BENCH_PROTO_NUM) || (sscanf(&colon[1], "%lf%n", &weight, &n) != 1) ||
+            (colon[1 + n] != '\0') || (weight < 0.0) )
+        {
+            return false;
+        }
+        st->weights[proto] = weight;
+        sum += weight;
+    }
+    // Need some messages, not just garbage
+    if ((sum - st->weights[BENCH_PROTO_GARBAGE]) <= 0.0)
+    {
+        return false;
+    }
+    for (int proto = 0; proto < _BENCH_PROTO_NUM; proto++)
+    {
+        st->weights[proto] /= sum;
+    }
+    return true;
+}
+
+static bool _benchGenerate(BENCH_STREAM_t *st)
+{
+    // Enough space for the stream plus the last epoch
+    st->data = malloc(BENCH_STREAM_SIZE + (4 * BENCH_EPOCH_SIZE));
+    if (st->data == NULL)
+    {
+        WARNING("malloc fail");
+        return false;
+    }
+    st->seed = 0x12345678;
+    st->iTow = 302400000;
+
+    while (st->size < BENCH_STREAM_SIZE)
+    {
+        for (int proto = 0; proto < _BENCH_PROTO_NUM; proto++)
+        {
+            st->target[proto] += st->weights[proto] * (double)BENCH_EPOCH_SIZE;
+        }
+        if (st->weights[BENCH_PROTO_UBX] > 0.0)
+        {
+            _addEpochUbx(st);
+        }
+        if (st->weights[BENCH_PROTO_NMEA] > 0.0)
+        {
+            _addEpochNmea(st);
+        }
+
+        // Fill the epoch with messages of the protocol that is most behind its target
+        while (true)
+        {
+            int fillProto = -1;
+            double maxLag = 0.0;
+            for (int proto = 0; proto < _BENCH_PROTO_NUM; proto++)
+            {
+                const double lag = st->target[proto] - (double)st->bytes[proto];
+                if ( (st->weights[proto] > 0.0) && (lag > maxLag) )
+                {
+                    fillProto = proto;
+                    maxLag = lag;
+                }
+            }
+            if (fillProto < 0)
+            {
+                break;
+            }
+            _addFill(st, fillProto);
+        }
+
+        if (st->weights[BENCH_PROTO_UBX] > 0.0)
+        {
+            uint8_t msg[FAKE_MSG_MAX_SIZE];
+            _add(st, BENCH_PROTO_UBX, msg, fakeUbxNavEoe(msg, st->iTow));
+        }
+        st->nEpochs++;
+        st->iTow = (st->iTow + 1000) % (7 * 86400000);
+    }
+    return true;
+}
+
+/* ****************************************************************************************************************** */
+
+static void _benchStart(BENCH_t *b, const char *name)
+{
+    memset(b, 0, sizeof(*b));
+    b->name = name;
+    b->t0 = timeMonoNs();
+}
+
+static bool _benchDone(BENCH_t *b)
+{
+    b->time = timeMonoNs() - b->t0;
+    return gAbort || (b->time >= ((uint64_t)BENCH_MIN_TIME * 1000000));
+}
+
+static void _benchOutput(const BENCH_t *b)
+{
+    const double t = (double)b->time;
+    ioOutputStr("bench %-16s %12" PRIu64 " %10" PRIu64 " %12" PRIu64 " %10.2f %10.2f\n", b->name, b->bytes, b->count,
+        b->time, t > 0.0 ? (double)b->bytes / t * 1e3 : 0.0, b->count > 0 ? t / (double)b->count : 0.0);
+    DEBUG("%s done", b->name);
+}
+
+typedef enum BENCH_PARSER_e { BENCH_PARSER_NONAMES, BENCH_PARSER_NAMES, BENCH_PARSER_INFO } BENCH_PARSER_t;
+
+static void _benchParser(const BENCH_STREAM_t *st, const char *name, const BENCH_PARSER_t mode, PARSER_t *parser)
+{
+    BENCH_t b;
+    _benchStart(&b, name);
+    PARSER_MSG_t msg;
+    do
+    {
+        parserInit(parser);
+        parserSetNames(parser, mode != BENCH_PARSER_NONAMES);
+        for (int offs = 0; offs < st->size; offs += BENCH_CHUNK_SIZE)
+        {
+            parserAdd(parser, &st->data[offs], MIN(BENCH_CHUNK_SIZE, st->size - offs));
+            while (parserProcess(parser, &msg, mode == BENCH_PARSER_INFO))
+            {
+                b.count++;
+            }
+        }
+        while (parserFlush(parser, &msg))
+        {
+            b.count++;
+        }
+        b.bytes += st->size;
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+}
+
+static bool _benchEpoch(const BENCH_STREAM_t *st, PARSER_t *parser)
+{
+    // Prepare messages. The parser doesn't modify the data, so we can point the messages into the stream.
+    PARSER_MSG_t *msgs = malloc(sizeof(PARSER_MSG_t) * (st->size / 8));
+    EPOCH_t *coll = calloc(1, sizeof(EPOCH_t));
+    EPOCH_t *epoch = calloc(1, sizeof(EPOCH_t));
+    if ( (msgs == NULL) || (coll == NULL) || (epoch == NULL) || !epochInit(coll) || !epochInit(epoch) )
+    {
+        WARNING("malloc fail");
+        free(msgs);
+        epochFree(coll);
+        epochFree(epoch);
+        free(coll);
+        free(epoch);
+        return false;
+    }
+    int nMsgs = 0;
+    uint64_t bytes = 0;
+    parserInit(parser);
+    parserSetNames(parser, false);
+    PARSER_MSG_t msg;
+    int offs = 0;
+    int chunk = 0;
+    while (true)
+    {
+        bool haveMsg = parserProcess(parser, &msg, false);
+        if (!haveMsg && (chunk < st->size))
+        {
+            const int size = MIN(BENCH_CHUNK_SIZE, st->size - chunk);
+            parserAdd(parser, &st->data[chunk], size);
+            chunk += size;
+            continue;
+        }
+        if (!haveMsg && !parserFlush(parser, &msg))
+        {
+            break;
+        }
+        if (msg.type != PARSER_MSGTYPE_GARBAGE)
+        {
+            msgs[nMsgs] = msg;
+            msgs[nMsgs].data = &st->data[offs];
+            nMsgs++;
+            bytes += msg.size;
+        }
+        offs += msg.size;
+    }
+
+    BENCH_t b;
+    _benchStart(&b, "epoch");
+    uint32_t nEpochs = 0;
+    uint32_t nPasses = 0;
+    bool ok = true;
+    do
+    {
+        nPasses++;
+        epochFree(coll);
+        if (!epochInit(coll))
+        {
+            ok = false;
+            break;
+        }
+        for (int ix = 0; ix < nMsgs; ix++)
+        {
+            if (epochCollect(coll, &msgs[ix], epoch))
+            {
+                nEpochs++;
+            }
+        }
+        b.count += nMsgs;
+        b.bytes += bytes;
+    }
+    while (!_benchDone(&b));
+    if (ok)
+    {
+        gSink = nEpochs;
+        DEBUG("epoch: %" PRIu32 " epochs from %d messages per pass", nEpochs / nPasses, nMsgs);
+        _benchOutput(&b);
+    }
+
+    free(msgs);
+    epochFree(coll);
+    epochFree(epoch);
+    free(coll);
+    free(epoch);
+    return ok;
+}
+
+static void _benchCrc(const BENCH_STREAM_t *st, const char *name, uint32_t (*func)(const uint8_t *, const int))
+{
+    BENCH_t b;
+    _benchStart(&b, name);
+    uint32_t res = 0;
+    do
+    {
+        for (int offs = 0; (offs + BENCH_CRC_SIZE) <= st->size; offs += BENCH_CRC_SIZE)
+        {
+            res ^= func(&st->data[offs], BENCH_CRC_SIZE);
+            b.count++;
+        }
+        b.bytes += (st->size / BENCH_CRC_SIZE) * BENCH_CRC_SIZE;
+    }
+    while (!_benchDone(&b));
+    gSink = res;
+    _benchOutput(&b);
+}
+
+static void _benchCfg(void)
+{
+    int nItems = 0;
+    const UBLOXCFG_ITEM_t **items = ubloxcfg_getAllItems(&nItems);
+    int nRates = 0;
+    const UBLOXCFG_MSGRATE_t **rates = ubloxcfg_getAllMsgRateCfgs(&nRates);
+
+    const int nChunks = (nItems + UBX_CFG_VALSET_V1_MAX_KV - 1) / UBX_CFG_VALSET_V1_MAX_KV;
+    UBLOXCFG_KEYVAL_t *kv = calloc(nItems, sizeof(UBLOXCFG_KEYVAL_t));
+    uint8_t *data = calloc(nChunks, UBX_CFG_VALSET_V1_CFGDATA_MAX);
+    int *dataSizes = calloc(nChunks, sizeof(int));
+    if ( (kv == NULL) || (data == NULL) || (dataSizes == NULL) )
+    {
+        WARNING("malloc fail");
+        free(kv);
+        free(data);
+        free(dataSizes);
+        return;
+    }
+    for (int ix = 0; ix < nItems; ix++)
+    {
+        kv[ix].id = items[ix]->id;
+        kv[ix].val._raw = ix & (items[ix]->size == UBLOXCFG_SIZE_BIT ? 0x01 : 0x7f);
+    }
+
+    BENCH_t b;
+    bool ok = true;
+
+    _benchStart(&b, "cfg-make");
+    do
+    {
+        for (int chunk = 0; chunk < nChunks; chunk++)
+        {
+            const int offs = chunk * UBX_CFG_VALSET_V1_MAX_KV;
+            const int num = MIN(UBX_CFG_VALSET_V1_MAX_KV, nItems - offs);
+            ok = ubloxcfg_makeData(&data[chunk * UBX_CFG_VALSET_V1_CFGDATA_MAX], UBX_CFG_VALSET_V1_CFGDATA_MAX,
+                &kv[offs], num, &dataSizes[chunk]) && ok;
+            b.count += num;
+            b.bytes += dataSizes[chunk];
+        }
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+
+    _benchStart(&b, "cfg-parse");
+    do
+    {
+        for (int chunk = 0; chunk < nChunks; chunk++)
+        {
+            UBLOXCFG_KEYVAL_t parsed[UBX_CFG_VALSET_V1_MAX_KV];
+            int num = 0;
+            ok = ubloxcfg_parseData(&data[chunk * UBX_CFG_VALSET_V1_CFGDATA_MAX], dataSizes[chunk],
+                parsed, NUMOF(parsed), &num) && ok;
+            b.count += num;
+            b.bytes += dataSizes[chunk];
+        }
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+
+    _benchStart(&b, "cfg-stringify");
+    do
+    {
+        for (int ix = 0; ix < nItems; ix++)
+        {
+            char str[200];
+            ok = ubloxcfg_stringifyKeyVal(str, sizeof(str), &kv[ix]) && ok;
+            b.count++;
+        }
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+
+    _benchStart(&b, "cfg-byname");
+    do
+    {
+        for (int ix = 0; ix < nItems; ix++)
+        {
+            ok = (ubloxcfg_getItemByName(items[ix]->name) != NULL) && ok;
+            b.count++;
+        }
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+
+    _benchStart(&b, "cfg-byid");
+    do
+    {
+        for (int ix = 0; ix < nItems; ix++)
+        {
+            ok = (ubloxcfg_getItemById(items[ix]->id) != NULL) && ok;
+            b.count++;
+        }
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+
+    _benchStart(&b, "cfg-msgrate");
+    do
+    {
+        for (int ix = 0; ix < nRates; ix++)
+        {
+            ok = (ubloxcfg_getMsgRateCfg(rates[ix]->msgName) != NULL) && ok;
+            b.count++;
+        }
+    }
+    while (!_benchDone(&b));
+    _benchOutput(&b);
+
+    if (!ok)
+    {
+        WARNING("Configuration library functions failed!");
+    }
+
+    free(kv);
+    free(data);
+    free(dataSizes);
+}
+
+int benchRun(const char *mix, const bool extraInfo)
+{
+    BENCH_STREAM_t st;
+    memset(&st, 0, sizeof(st));
+    if (!_benchParseMix(&st, mix != NULL ? mix : BENCH_DEFAULT_MIX))
+    {
+        WARNING("Illegal mix '-m %s'!", mix);
+        return EXIT_BADARGS;
+    }
+
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    if ( (parser == NULL) || !_benchGenerate(&st) )
+    {
+        free(parser);
+        free(st.data);
+        return EXIT_OTHERFAIL;
+    }
+
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    ioOutputStr("# stream %d bytes, %" PRIu32 " epochs, mix %s\n", st.size, st.nEpochs,
+        mix != NULL ? mix : BENCH_DEFAULT_MIX);
+    if (extraInfo)
+    {
+        for (int proto = 0; proto < _BENCH_PROTO_NUM; proto++)
+        {
+            ioOutputStr("# stream %-8s %8" PRIu32 " messages %10" PRIu64 " bytes (%5.1f%%)\n", kBenchProtoNames[proto],
+                st.nMsgs[proto], st.bytes[proto], (double)st.bytes[proto] / (double)st.size * 1e2);
+        }
+    }
+    ioOutputStr("# name                   bytes      count         time       MB/s      ns/op\n");
+
+    PRINT("Running benchmarks...");
+    _benchParser(&st, "parser-nonames", BENCH_PARSER_NONAMES, parser);
+    _benchParser(&st, "parser",         BENCH_PARSER_NAMES,   parser);
+    _benchParser(&st, "parser-info",    BENCH_PARSER_INFO,    parser);
+    const bool ok = _benchEpoch(&st, parser);
+    _benchCrc(&st, "crc-rtcm3",     crcRtcm3);
+    _benchCrc(&st, "crc-spartn4",   crcSpartn4);
+    _benchCrc(&st, "crc-spartn8",   crcSpartn8);
+    _benchCrc(&st, "crc-spartn16",  crcSpartn16);
+    _benchCrc(&st, "crc-spartn24",  crcSpartn24);
+    _benchCrc(&st, "crc-spartn32",  crcSpartn32);
+    _benchCrc(&st, "crc-novatel32", crcNovatel32);
+    _benchCfg();
+
+    free(parser);
+    free(st.data);
+
+    return ioWriteOutput(false) && ok && !gAbort ? EXIT_SUCCESS : EXIT_OTHERFAIL;
+}
+
+/* ****************************************************************************************************************** */
+// eof
@@ -24,6 +24,7 @@
 #include "ff_rx.h"
 #include "ff_ubx.h"
 #include "ff_epoch.h"
+#include "ff_prof.h"
 
 #include "cfgtool_dump.h"
 
@@ -35,12 +36,18 @@ const char *dumpHelp(void)
 // -----------------------------------------------------------------------------
 "Command 'dump':\n"
 "\n"
-"    Usage: cfgtool dump -p <port> [-o <outfile>] [-y] [-x] [-n]\n"
+"    Usage: cfgtool dump -p <port> [-o <outfile>] [-y] [-x] [-n] [-E <format>]\n"
 "\n"
 "    Connects to the receiver and outputs information on the received messages\n"
 "    and optionally a hex dump of the messages until SIGINT (e.g. CTRL-C)"NOT_WIN(", SIGHUP")"\n"
 "    or SIGTERM is received.\n"
 "\n"
+"    With -E <format> only the detected epochs are output, in one of the formats\n"
+"    described for the 'parse' command.\n"
+"\n"
+"    If cfgtool was built with profiling (FF_PROF), a summary of the hot path\n"
+"    timings is printed at the end"NOT_WIN(" and on SIGUSR1")".\n"
+"\n"
 "    Returns success (0) if receiver was detected and at least one message was\n"
 "    received. Otherwise returns "STRINGIFY(EXIT_RXFAIL)" (rx not detected) or "STRINGIFY(EXIT_RXNODATA)" (no messages).\n"
 "\n"
@@ -58,6 +65,7 @@ const char *dumpHelp(void)
 /* ****************************************************************************************************************** */
 
 bool gAbort;
+static bool gProfDump;
 
 static void _sigHandler(int signal)
 {
@@ -66,10 +74,25 @@ static void _sigHandler(int signal)
         PRINT("Aborting...");
         gAbort = true;
     }
+#ifndef _WIN32
+    else if (signal == SIGUSR1)
+    {
+        gProfDump = true;
+    }
+#endif
 }
 
-int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe)
+int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe, const char *epochFormat)
 {
+    // With an epoch format only the epochs are output
+    EPOCHFMT_t epochFmt = EPOCHFMT_STR;
+    if ( (epochFormat != NULL) && !epochfmtFromName(epochFormat, &epochFmt) )
+    {
+        WARNING("Illegal format '-E %s'!", epochFormat);
+        return EXIT_BADARGS;
+    }
+    const bool doMsgs = (epochFormat == NULL);
+
     RX_OPTS_t opts = RX_OPTS_DEFAULT();
     if (noProbe)
     {
@@ -83,22 +106,40 @@ int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe)
         free(rx);
         return EXIT_RXFAIL;
     }
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    if (!epochInit(&coll) || !epochInit(&epoch) || !ioEpochOutputBegin(epochFmt))
+    {
+        epochFree(&coll);
+        epochFree(&epoch);
+        rxClose(rx);
+        free(rx);
+        return EXIT_OTHERFAIL;
+    }
 
     gAbort = false;
     signal(SIGINT, _sigHandler);
     signal(SIGTERM, _sigHandler);
     NOT_WIN( signal(SIGHUP, _sigHandler) );
+    gProfDump = false;
+    if (profEnabled())
+    {
+        NOT_WIN( signal(SIGUSR1, _sigHandler) );
+        profReset();
+    }
 
     const uint64_t tOffs = TIME() - timeOfDay(); // Offset between wall clock and parser time reference
     uint32_t nEpochs = 0;
-    EPOCH_t coll;
-    EPOCH_t epoch;
-    epochInit(&coll);
 
     PRINT("Dumping received data...");
     const PARSER_t *parser = rxGetParser(rx);
     while (!gAbort)
     {
+        if (gProfDump)
+        {
+            gProfDump = false;
+            profDump();
+        }
         PARSER_MSG_t *msg = rxGetNextMessage(rx);
         if (msg != NULL)
         {
@@ -106,17 +147,27 @@ int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe)
             if (epochCollect(&coll, msg, &epoch))
             {
                 nEpochs++;
-                ioOutputStr("epoch %4u, %s\n", epoch.seq, epoch.str);
+                if (epochFmt == EPOCHFMT_STR)
+                {
+                    ioOutputStr("epoch %4u, %s\n", epoch.seq, epochStr(&epoch));
+                }
+                else
+                {
+                    ioAddOutputEpoch(&epoch);
+                }
                 if (!ioWriteOutput(parser->nMsgs == 1 ? false : true))
                 {
                     break;
                 }
             }
-            ioOutputStr("message %4u, dt %4u, size %4d, %-8s %-20s %s\n",
-                msg->seq, latency, msg->size, parserMsgtypeName(msg->type), msg->name, msg->info != NULL ? msg->info : "n/a");
-            if (extraInfo)
+            if (doMsgs)
             {
-                ioAddOutputHexdump(msg->data, msg->size);
+                ioOutputStr("message %4u, dt %4u, size %4d, %-8s %-20s %s\n",
+                    msg->seq, latency, msg->size, parserMsgtypeName(msg->type), msg->name, msg->info != NULL ? msg->info : "n/a");
+                if (extraInfo)
+                {
+                    ioAddOutputHexdump(msg->data, msg->size);
+                }
             }
             if (!ioWriteOutput(parser->nMsgs == 1 ? false : true))
             {
@@ -130,18 +181,29 @@ int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe)
         }
     }
 
-    ioOutputStr("stats UBX      count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nUbx,     parser->nMsgs > 0 ? (double)parser->nUbx     / (double)parser->nMsgs * 1e2 : 0.0, parser->sUbx,     parser->sMsgs > 0 ? (double)parser->sUbx     / (double)parser->sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats NMEA     count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nNmea,    parser->nMsgs > 0 ? (double)parser->nNmea    / (double)parser->nMsgs * 1e2 : 0.0, parser->sNmea,    parser->sMsgs > 0 ? (double)parser->sNmea    / (double)parser->sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats RTCM3    count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nRtcm3,   parser->nMsgs > 0 ? (double)parser->nRtcm3   / (double)parser->nMsgs * 1e2 : 0.0, parser->sRtcm3,   parser->sMsgs > 0 ? (double)parser->sRtcm3   / (double)parser->sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats SPARTN   count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nSpartn,  parser->nMsgs > 0 ? (double)parser->nSpartn  / (double)parser->nMsgs * 1e2 : 0.0, parser->sSpartn,  parser->sMsgs > 0 ? (double)parser->sSpartn  / (double)parser->sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats NOVATEL  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nUbx,     parser->nMsgs > 0 ? (double)parser->nNovatel / (double)parser->nMsgs * 1e2 : 0.0, parser->sNovatel, parser->sMsgs > 0 ? (double)parser->sNovatel / (double)parser->sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats GARBAGE  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nGarbage, parser->nMsgs > 0 ? (double)parser->nGarbage / (double)parser->nMsgs * 1e2 : 0.0, parser->sGarbage, parser->sMsgs > 0 ? (double)parser->sGarbage / (double)parser->sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats Total    count %6u (100.0%%)  size %10u (100.0%%)\n", parser->nMsgs, parser->sMsgs);
-    ioOutputStr("stats EPOCH    count %6u (%5.1f%%)\n", nEpochs, parser->nMsgs > 0 ? (double)nEpochs / (double)parser->nMsgs * 1e2 : 0.0);
+    if (profEnabled())
+    {
+        profDump();
+    }
+
+    ioEpochOutputEnd();
+    if (doMsgs)
+    {
+        ioOutputStr("stats UBX      count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nUbx,     parser->nMsgs > 0 ? (double)parser->nUbx     / (double)parser->nMsgs * 1e2 : 0.0, parser->sUbx,     parser->sMsgs > 0 ? (double)parser->sUbx     / (double)parser->sMsgs * 1e2 : 0.0);
+        ioOutputStr("stats NMEA     count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nNmea,    parser->nMsgs > 0 ? (double)parser->nNmea    / (double)parser->nMsgs * 1e2 : 0.0, parser->sNmea,    parser->sMsgs > 0 ? (double)parser->sNmea    / (double)parser->sMsgs * 1e2 : 0.0);
+        ioOutputStr("stats RTCM3    count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nRtcm3,   parser->nMsgs > 0 ? (double)parser->nRtcm3   / (double)parser->nMsgs * 1e2 : 0.0, parser->sRtcm3,   parser->sMsgs > 0 ? (double)parser->sRtcm3   / (double)parser->sMsgs * 1e2 : 0.0);
+        ioOutputStr("stats SPARTN   count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nSpartn,  parser->nMsgs > 0 ? (double)parser->nSpartn  / (double)parser->nMsgs * 1e2 : 0.0, parser->sSpartn,  parser->sMsgs > 0 ? (double)parser->sSpartn  / (double)parser->sMsgs * 1e2 : 0.0);
+        ioOutputStr("stats NOVATEL  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nNovatel, parser->nMsgs > 0 ? (double)parser->nNovatel / (double)parser->nMsgs * 1e2 : 0.0, parser->sNovatel, parser->sMsgs > 0 ? (double)parser->sNovatel / (double)parser->sMsgs * 1e2 : 0.0);
+        ioOutputStr("stats GARBAGE  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nGarbage, parser->nMsgs > 0 ? (double)parser->nGarbage / (double)parser->nMsgs * 1e2 : 0.0, parser->sGarbage, parser->sMsgs > 0 ? (double)parser->sGarbage / (double)parser->sMsgs * 1e2 : 0.0);
+        ioOutputStr("stats Total    count %6u (100.0%%)  size %10u (100.0%%)\n", parser->nMsgs, parser->sMsgs);
+        ioOutputStr("stats EPOCH    count %6u (%5.1f%%)\n", nEpochs, parser->nMsgs > 0 ? (double)nEpochs / (double)parser->nMsgs * 1e2 : 0.0);
+    }
 
     bool res = ioWriteOutput(true);
     const uint32_t nMsgs = parser->nMsgs;
 
+    epochFree(&coll);
+    epochFree(&epoch);
     rxClose(rx);
     free(rx);
 
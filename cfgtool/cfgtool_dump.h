@@ -25,7 +25,7 @@
 
 const char *dumpHelp(void);
 
-int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe);
+int dumpRun(const char *portArg, const bool extraInfo, const bool noProbe, const char *epochFormat);
 
 /* ****************************************************************************************************************** */
 #endif // __CFGTOOL_DUMP_H__
@@ -0,0 +1,355 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <signal.h>
+
+#include "cfgtool_util.h"
+
+#include "ff_parser.h"
+#include "ff_ubx.h"
+#include "ff_nmea.h"
+#include "ff_rtcm3.h"
+#include "ff_spartn.h"
+#include "ff_novatel.h"
+
+#include "cfgtool_index.h"
+#include "cfgtool_extract.h"
+
+/* ****************************************************************************************************************** */
+
+const char *extractHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'extract':\n"
+"\n"
+"    Usage: cfgtool extract [-i <infile>] [-o <outfile>] [-y] [-t <range>]\n"
+"                           [-m <filter>]\n"
+"\n"
+"    Copies the messages selected by the message filter (-m) and time range\n"
+"    (-t) as they are (binary) from the input to the output. See the 'index'\n"
+"    command for the syntax of <range> and <filter>. The message filter can\n"
+"    also select entire protocols (e.g. UBX, NMEA, RTCM3, GARBAGE).\n"
+"\n"
+"    If there is an index for the input file, the messages are copied\n"
+"    directly using the index (the input is not parsed). Otherwise the input\n"
+"    is parsed (without decoding the messages). The time range requires an\n"
+"    index.\n"
+"\n"
+"    Examples:\n"
+"\n"
+"        cfgtool extract -i log.ubx -o raw.ubx -m UBX-RXM-RAWX,UBX-RXM-SFRBX\n"
+"        cfgtool index -i log.ubx\n"
+"        cfgtool extract -i log.ubx -o part.ubx -t 14:00,14:30 -m UBX,RTCM3\n"
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        PRINT("Aborting...");
+        gAbort = true;
+    }
+}
+
+// Write output in blocks of at least this size (the output may be a pipe, see ioWriteOutput())
+#define EXTRACT_WRITE_SIZE (256 * 1024)
+
+typedef struct EXTRACT_OUT_s
+{
+    uint64_t nMsgs;
+    uint64_t nBytes;
+    int      pending;   // Bytes added since the last ioWriteOutput()
+    bool     written;   // ioWriteOutput() called (output created)
+    bool     ok;
+
+} EXTRACT_OUT_t;
+
+static void _extractOut(EXTRACT_OUT_t *out, const uint8_t *data, const int size, const bool flush)
+{
+    if (size > 0)
+    {
+        ioAddOutputBin(data, size);
+        out->nMsgs++;
+        out->nBytes += size;
+        out->pending += size;
+    }
+    if ( out->ok && ( flush || (out->pending >= EXTRACT_WRITE_SIZE) ) )
+    {
+        out->ok = ioWriteOutput(out->written);
+        out->written = true;
+        out->pending = 0;
+    }
+}
+
+// The message filter is compiled into lookup tables (one bit per UBX class/message ID resp. RTCM3 message type), so
+// that matching doesn't need the message names. For other protocols, where names cannot be derived from a simple
+// ID, the name is only generated for the messages of the protocols that the filter asks for.
+typedef enum EXTRACT_SEL_e
+{
+    EXTRACT_SEL_NONE = 0,
+    EXTRACT_SEL_ALL,
+    EXTRACT_SEL_SOME,
+
+} EXTRACT_SEL_t;
+
+typedef struct EXTRACT_FILT_s
+{
+    const char    *spec;
+    EXTRACT_SEL_t  proto[PARSER_MSGTYPE_NOVATEL + 1];
+    uint8_t        ubx[(256 * 256) / 8];
+    uint8_t        rtcm3[4096 / 8];
+    uint8_t        rtcm3_4072[4096 / 8];
+
+} EXTRACT_FILT_t;
+
+#define _BIT_SET(_bits_, _ix_) (_bits_)[(_ix_) >> 3] |= (1 << ((_ix_) & 0x7))
+#define _BIT_GET(_bits_, _ix_) ( ((_bits_)[(_ix_) >> 3] & (1 << ((_ix_) & 0x7))) != 0 )
+
+// Check if any name in the spec starts with the prefix
+static bool _specHasPrefix(const char *spec, const char *prefix)
+{
+    const int len = strlen(prefix);
+    const char *filt = spec;
+    while (*filt != '\0')
+    {
+        if (strncmp(filt, prefix, len) == 0)
+        {
+            return true;
+        }
+        const char *comma = strchr(filt, ',');
+        if (comma == NULL)
+        {
+            break;
+        }
+        filt = comma + 1;
+    }
+    return false;
+}
+
+static void _extractCompile(EXTRACT_FILT_t *filt, const char *spec)
+{
+    memset(filt, 0, sizeof(*filt));
+    filt->spec = spec;
+    for (int type = 0; type < NUMOF(filt->proto); type++)
+    {
+        const char *protoName = parserMsgtypeName((PARSER_MSGTYPE_t)type);
+        char prefix[20];
+        snprintf(prefix, sizeof(prefix), "%s-", protoName);
+        if ( (spec == NULL) || indexMatchName(spec, protoName) )
+        {
+            filt->proto[type] = EXTRACT_SEL_ALL;
+        }
+        else if (_specHasPrefix(spec, prefix))
+        {
+            filt->proto[type] = EXTRACT_SEL_SOME;
+        }
+    }
+    char name[PARSER_MAX_NAME_SIZE];
+    if (filt->proto[PARSER_MSGTYPE_UBX] == EXTRACT_SEL_SOME)
+    {
+        for (int id = 0; id < (256 * 256); id++)
+        {
+            if (ubxMessageNameIds(name, sizeof(name), (id >> 8) & 0xff, id & 0xff) && indexMatchName(spec, name))
+            {
+                _BIT_SET(filt->ubx, id);
+            }
+        }
+    }
+    if (filt->proto[PARSER_MSGTYPE_RTCM3] == EXTRACT_SEL_SOME)
+    {
+        for (int type = 0; type < 4096; type++)
+        {
+            snprintf(name, sizeof(name), "RTCM3-TYPE%d", type);
+            if (indexMatchName(spec, name))
+            {
+                _BIT_SET(filt->rtcm3, type);
+            }
+            snprintf(name, sizeof(name), "RTCM3-TYPE4072_%d", type);
+            if (indexMatchName(spec, name))
+            {
+                _BIT_SET(filt->rtcm3_4072, type);
+            }
+        }
+    }
+}
+
+static bool _extractMatch(const EXTRACT_FILT_t *filt, const PARSER_MSG_t *msg)
+{
+    switch (filt->proto[msg->type])
+    {
+        case EXTRACT_SEL_NONE:
+            return false;
+        case EXTRACT_SEL_ALL:
+            return true;
+        case EXTRACT_SEL_SOME:
+            break;
+    }
+    char name[PARSER_MAX_NAME_SIZE];
+    switch (msg->type)
+    {
+        case PARSER_MSGTYPE_UBX:
+            return _BIT_GET(filt->ubx, (UBX_CLSID(msg->data) << 8) | UBX_MSGID(msg->data));
+        case PARSER_MSGTYPE_RTCM3:
+        {
+            const int type = RTCM3_TYPE(msg->data);
+            if (_BIT_GET(filt->rtcm3, type))
+            {
+                return true;
+            }
+            return (type == 4072) && (msg->size > (RTCM3_HEAD_SIZE + 2 + 1)) &&
+                _BIT_GET(filt->rtcm3_4072, RTCM3_4072_SUBTYPE(msg->data));
+        }
+        case PARSER_MSGTYPE_NMEA:
+            return nmeaMessageName(name, sizeof(name), msg->data, msg->size) && indexMatchName(filt->spec, name);
+        case PARSER_MSGTYPE_SPARTN:
+            return spartnMessageName(name, sizeof(name), msg->data, msg->size) && indexMatchName(filt->spec, name);
+        case PARSER_MSGTYPE_NOVATEL:
+            return novatelMessageName(name, sizeof(name), msg->data, msg->size) && indexMatchName(filt->spec, name);
+        case PARSER_MSGTYPE_GARBAGE:
+            break;
+    }
+    return false;
+}
+
+// Extract using the index, copy selected messages directly from the (mapped) input
+static int _extractIndexed(const INDEX_t *index, const char *timeRange, const char *msgFilter, EXTRACT_OUT_t *out)
+{
+    uint64_t size = 0;
+    const uint8_t *data = ioMapInput(&size);
+    uint64_t startOffs = 0;
+    uint64_t endOffs = size;
+    uint32_t startSeq = 1;
+    if ( (timeRange != NULL) && !indexTimeRange(index, timeRange, &startOffs, &startSeq, &endOffs) )
+    {
+        return EXIT_BADARGS;
+    }
+    uint64_t numSel = 0;
+    const INDEX_MSG_t **sel = indexSelect(index, msgFilter, startOffs, endOffs, &numSel);
+    if (sel == NULL)
+    {
+        return EXIT_OTHERFAIL;
+    }
+    for (uint64_t ix = 0; (ix < numSel) && out->ok && !gAbort; ix++)
+    {
+        _extractOut(out, &data[sel[ix]->offs], sel[ix]->size, false);
+    }
+    free(sel);
+    return EXIT_SUCCESS;
+}
+
+// Extract by parsing the input
+#define EXTRACT_FILL_LEVEL (PARSER_BUF_SIZE / 2)
+
+static int _extractParse(const char *msgFilter, EXTRACT_OUT_t *out)
+{
+    EXTRACT_FILT_t *filt = malloc(sizeof(EXTRACT_FILT_t));
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    if ( (filt == NULL) || (parser == NULL) )
+    {
+        free(filt);
+        free(parser);
+        return EXIT_OTHERFAIL;
+    }
+    _extractCompile(filt, msgFilter);
+    parserInit(parser);
+    parserSetTs(parser, PARSER_TS_NONE, NULL, NULL);
+    parserSetNames(parser, false);
+
+    PARSER_MSG_t msg;
+    bool eof = false;
+    while (out->ok && !gAbort)
+    {
+        if (!eof && ((parser->offs + parser->size) < EXTRACT_FILL_LEVEL))
+        {
+            const uint8_t *data = NULL;
+            const int num = ioGetInput(&data, parserSpace(parser));
+            if (num < 0)
+            {
+                eof = true;
+            }
+            else if (num > 0)
+            {
+                parserAdd(parser, data, num);
+            }
+        }
+        if (parserProcess(parser, &msg, false) || (eof && parserFlush(parser, &msg)))
+        {
+            if (_extractMatch(filt, &msg))
+            {
+                _extractOut(out, msg.data, msg.size, false);
+            }
+        }
+        else if (eof)
+        {
+            break;
+        }
+        else
+        {
+            SLEEP(5);
+        }
+    }
+    DEBUG("Parsed %" PRIu32 " messages (%" PRIu32 " bytes)", parser->nMsgs, parser->sMsgs);
+
+    free(filt);
+    free(parser);
+    return EXIT_SUCCESS;
+}
+
+int extractRun(const char *inName, const char *timeRange, const char *msgFilter)
+{
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    EXTRACT_OUT_t out = { .ok = true };
+    INDEX_t *index = ioMapInput(NULL) != NULL ? indexLoad(inName) : NULL;
+    int res = EXIT_SUCCESS;
+    if (index != NULL)
+    {
+        res = _extractIndexed(index, timeRange, msgFilter, &out);
+        indexFree(index);
+    }
+    else if (timeRange != NULL)
+    {
+        WARNING("Need an index for -t, use 'cfgtool index -i %s'!", inName);
+        return EXIT_OTHERFAIL;
+    }
+    else
+    {
+        res = _extractParse(msgFilter, &out);
+    }
+
+    if (res == EXIT_SUCCESS)
+    {
+        _extractOut(&out, NULL, 0, true);
+        PRINT("Extracted %" PRIu64 " messages (%" PRIu64 " bytes)", out.nMsgs, out.nBytes);
+    }
+    return (res != EXIT_SUCCESS) ? res : (out.ok ? EXIT_SUCCESS : EXIT_OTHERFAIL);
+}
+
+/* ****************************************************************************************************************** */
+// eof
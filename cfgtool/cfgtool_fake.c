@@ -0,0 +1,334 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "ff_stuff.h"
+#include "ff_time.h"
+#include "ff_crc.h"
+#include "ff_ubx.h"
+#include "ff_nmea.h"
+#include "ff_rtcm3.h"
+#include "ff_novatel.h"
+
+#include "cfgtool_fake.h"
+
+/* ****************************************************************************************************************** */
+
+// Small and fast pseudo-random numbers (xorshift32)
+uint32_t fakeRand(uint32_t *seed)
+{
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// The fake receiver tracks these satellites (two signals each)
+static const uint8_t kFakeGnssIds[] = { UBX_GNSSID_GPS, UBX_GNSSID_GAL, UBX_GNSSID_BDS, UBX_GNSSID_GLO };
+#define FAKE_NUM_SV   32
+#define FAKE_NUM_SIG  (2 * FAKE_NUM_SV)
+
+// The fake receiver's GPS week and leap seconds (GPS - UTC)
+#define FAKE_WEEK     2295
+#define FAKE_LEAPS    18
+
+// UTC date and time (and milliseconds) for the GPS time of week
+static void _fakeUtc(const uint32_t iTow, struct tm *utc, uint32_t *ms)
+{
+    const time_t posix = (time_t)ts2posix(wnoTow2ts(FAKE_WEEK, (double)(iTow / 1000)), FAKE_LEAPS, true);
+    NOT_WIN( gmtime_r(&posix, utc) );
+    IF_WIN( *utc = *gmtime(&posix) );
+    *ms = iTow % 1000;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int fakeUbxNavPvt(uint8_t *msg, const uint32_t iTow, uint32_t *seed)
+{
+    struct tm utc;
+    uint32_t ms;
+    _fakeUtc(iTow, &utc, &ms);
+    UBX_NAV_PVT_V1_GROUP0_t pvt;
+    memset(&pvt, 0, sizeof(pvt));
+    pvt.iTOW = iTow;
+    pvt.year = 1900 + utc.tm_year;
+    pvt.month = 1 + utc.tm_mon;
+    pvt.day = utc.tm_mday;
+    pvt.hour = utc.tm_hour;
+    pvt.min = utc.tm_min;
+    pvt.sec = utc.tm_sec;
+    pvt.nano = ms * 1000000;
+    pvt.valid = UBX_NAV_PVT_V1_VALID_VALIDDATE | UBX_NAV_PVT_V1_VALID_VALIDTIME | UBX_NAV_PVT_V1_VALID_FULLYRESOLVED;
+    pvt.fixType = UBX_NAV_PVT_V1_FIXTYPE_3D;
+    pvt.flags = UBX_NAV_PVT_V1_FLAGS_GNSSFIXOK;
+    pvt.numSV = 24;
+    pvt.lat = 473977000 + (int32_t)(fakeRand(seed) % 100);
+    pvt.lon = 85455000 + (int32_t)(fakeRand(seed) % 100);
+    pvt.height = 450000;
+    pvt.hMSL = 402000;
+    pvt.hAcc = 1000;
+    pvt.vAcc = 1500;
+    pvt.pDOP = 120;
+    return ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_PVT_MSGID, (const uint8_t *)&pvt, sizeof(pvt), msg);
+}
+
+int fakeUbxNavSat(uint8_t *msg, const uint32_t iTow, uint32_t *seed)
+{
+    uint8_t payload[sizeof(UBX_NAV_SAT_V1_GROUP0_t) + (FAKE_NUM_SV * sizeof(UBX_NAV_SAT_V1_GROUP1_t))];
+    const UBX_NAV_SAT_V1_GROUP0_t sat = { .iTOW = iTow, .version = UBX_NAV_SAT_V1_VERSION, .numSvs = FAKE_NUM_SV };
+    memcpy(payload, &sat, sizeof(sat));
+    int size = sizeof(sat);
+    for (int ix = 0; ix < FAKE_NUM_SV; ix++, size += sizeof(UBX_NAV_SAT_V1_GROUP1_t))
+    {
+        const UBX_NAV_SAT_V1_GROUP1_t sv =
+        {
+            .gnssId = kFakeGnssIds[ix % NUMOF(kFakeGnssIds)], .svId = 1 + (ix / NUMOF(kFakeGnssIds)),
+            .cno = 30 + (fakeRand(seed) % 20), .elev = 10 + ix, .azim = ix * 10, .flags = 0x0000190f
+        };
+        memcpy(&payload[size], &sv, sizeof(sv));
+    }
+    return ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_SAT_MSGID, payload, size, msg);
+}
+
+int fakeUbxNavSig(uint8_t *msg, const uint32_t iTow, uint32_t *seed)
+{
+    uint8_t payload[sizeof(UBX_NAV_SIG_V0_GROUP0_t) + (FAKE_NUM_SIG * sizeof(UBX_NAV_SIG_V0_GROUP1_t))];
+    const UBX_NAV_SIG_V0_GROUP0_t sig = { .iTOW = iTow, .version = UBX_NAV_SIG_V0_VERSION, .numSigs = FAKE_NUM_SIG };
+    memcpy(payload, &sig, sizeof(sig));
+    int size = sizeof(sig);
+    for (int ix = 0; ix < FAKE_NUM_SIG; ix++, size += sizeof(UBX_NAV_SIG_V0_GROUP1_t))
+    {
+        const int svIx = ix / 2;
+        const UBX_NAV_SIG_V0_GROUP1_t s =
+        {
+            .gnssId = kFakeGnssIds[svIx % NUMOF(kFakeGnssIds)], .svId = 1 + (svIx / NUMOF(kFakeGnssIds)),
+            .sigId = (ix % 2) == 0 ? 0 : 2, .cno = 30 + (fakeRand(seed) % 20),
+            .qualityInd = UBX_NAV_SIG_V0_QUALITYIND_CARRLOCK3, .sigFlags = 0x0029
+        };
+        memcpy(&payload[size], &s, sizeof(s));
+    }
+    return ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_SIG_MSGID, payload, size, msg);
+}
+
+int fakeUbxNavEoe(uint8_t *msg, const uint32_t iTow)
+{
+    const UBX_NAV_EOE_V0_GROUP0_t eoe = { .iTOW = iTow };
+    return ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_EOE_MSGID, (const uint8_t *)&eoe, sizeof(eoe), msg);
+}
+
+int fakeUbxRxmRawx(uint8_t *msg, const uint32_t iTow, uint32_t *seed)
+{
+    uint8_t payload[sizeof(UBX_RXM_RAWX_V1_GROUP0_t) + (FAKE_NUM_SIG * sizeof(UBX_RXM_RAWX_V1_GROUP1_t))];
+    const UBX_RXM_RAWX_V1_GROUP0_t rawx =
+    {
+        .rcvTow = (double)iTow * 1e-3, .week = FAKE_WEEK, .leapS = FAKE_LEAPS, .numMeas = FAKE_NUM_SIG,
+        .recStat = UBX_RXM_RAWX_V1_RECSTAT_LEAPSEC, .version = UBX_RXM_RAWX_V1_VERSION
+    };
+    memcpy(payload, &rawx, sizeof(rawx));
+    int size = sizeof(rawx);
+    for (int ix = 0; ix < FAKE_NUM_SIG; ix++, size += sizeof(UBX_RXM_RAWX_V1_GROUP1_t))
+    {
+        const int svIx = ix / 2;
+        const UBX_RXM_RAWX_V1_GROUP1_t meas =
+        {
+            .prMeas = 2.0e7 + (double)(fakeRand(seed) % 5000000), .cpMeas = 1.0e8 + (double)(fakeRand(seed) % 1000000),
+            .doMeas = (float)((int)(fakeRand(seed) % 8000) - 4000),
+            .gnssId = kFakeGnssIds[svIx % NUMOF(kFakeGnssIds)], .svId = 1 + (svIx / NUMOF(kFakeGnssIds)),
+            .sigId = (ix % 2) == 0 ? 0 : 2, .locktime = 64500, .cno = 30 + (fakeRand(seed) % 20),
+            .prStdev = 5, .cpStdev = 2, .doStdev = 4, .trkStat = 0x07
+        };
+        memcpy(&payload[size], &meas, sizeof(meas));
+    }
+    return ubxMakeMessage(UBX_RXM_CLSID, UBX_RXM_RAWX_MSGID, payload, size, msg);
+}
+
+// Based on tools/make_fake_ubxesfmeas.c
+int fakeUbxEsfMeas(uint8_t *msg, const uint32_t iTow, uint32_t *seed)
+{
+    uint8_t payload[sizeof(UBX_ESF_MEAS_V0_GROUP0_t) + (16 * sizeof(UBX_ESF_MEAS_V0_GROUP1_t))];
+    UBX_ESF_MEAS_V0_GROUP0_t meas;
+    memset(&meas, 0, sizeof(meas));
+    meas.timeTag = iTow;
+    meas.flags = 16 << 11;
+    memcpy(payload, &meas, sizeof(meas));
+    int size = sizeof(meas);
+    for (uint32_t dataType = 0; dataType < 16; dataType++, size += sizeof(UBX_ESF_MEAS_V0_GROUP1_t))
+    {
+        const UBX_ESF_MEAS_V0_GROUP1_t data = { .data = (dataType << 24) | (fakeRand(seed) & 0x00ffffff) };
+        memcpy(&payload[size], &data, sizeof(data));
+    }
+    return ubxMakeMessage(UBX_ESF_CLSID, UBX_ESF_MEAS_MSGID, payload, size, msg);
+}
+
+// Based on tools/make_fake_ubxesfstatus.c
+int fakeUbxEsfStatus(uint8_t *msg, const uint32_t iTow)
+{
+    uint8_t payload[sizeof(UBX_ESF_STATUS_V2_GROUP0_t) + (16 * sizeof(UBX_ESF_STATUS_V2_GROUP1_t))];
+    UBX_ESF_STATUS_V2_GROUP0_t status;
+    memset(&status, 0, sizeof(status));
+    status.iTOW = iTow;
+    status.version = UBX_ESF_STATUS_V2_VERSION;
+    status.numSens = 16;
+    memcpy(payload, &status, sizeof(status));
+    int size = sizeof(status);
+    for (int sensType = 0; sensType < 16; sensType++, size += sizeof(UBX_ESF_STATUS_V2_GROUP1_t))
+    {
+        const UBX_ESF_STATUS_V2_GROUP1_t sens = { .sensStatus1 = sensType, .sensStatus2 = 0 };
+        memcpy(&payload[size], &sens, sizeof(sens));
+    }
+    return ubxMakeMessage(UBX_ESF_CLSID, UBX_ESF_STATUS_MSGID, payload, size, msg);
+}
+
+// Based on tools/make_fake_ubxmonhw.c
+int fakeUbxMonHw(uint8_t *msg, const uint32_t n, uint32_t *seed)
+{
+    UBX_MON_HW_V0_GROUP0_t hw;
+    memset(&hw, 0, sizeof(hw));
+    hw.pinBank = 0x0001ffff;
+    hw.usedMask = 0x0001ffff;
+    for (int ix = 0; ix < NUMOF(hw.VP); ix++)
+    {
+        hw.VP[ix] = (n + ix) & 0xff;
+    }
+    hw.agcCnt = fakeRand(seed) % 8192;
+    return ubxMakeMessage(UBX_MON_CLSID, UBX_MON_HW_MSGID, (const uint8_t *)&hw, sizeof(hw), msg);
+}
+
+int fakeUbxMonVer(uint8_t *msg)
+{
+    uint8_t payload[sizeof(UBX_MON_VER_V0_GROUP0_t) + (6 * sizeof(UBX_MON_VER_V0_GROUP1_t))];
+    memset(payload, 0, sizeof(payload));
+    UBX_MON_VER_V0_GROUP0_t ver;
+    memset(&ver, 0, sizeof(ver));
+    snprintf(ver.swVersion, sizeof(ver.swVersion), "EXT CORE 1.00 (fake)");
+    snprintf(ver.hwVersion, sizeof(ver.hwVersion), "00190000");
+    memcpy(payload, &ver, sizeof(ver));
+    const char * const exts[] = { "ROM BASE 0x118B2060", "FWVER=HPG 1.32", "PROTVER=27.31", "MOD=ZED-F9P",
+        "GPS;GLO;GAL;BDS", "SBAS;QZSS" };
+    int size = sizeof(ver);
+    for (int ix = 0; ix < NUMOF(exts); ix++, size += sizeof(UBX_MON_VER_V0_GROUP1_t))
+    {
+        UBX_MON_VER_V0_GROUP1_t ext;
+        memset(&ext, 0, sizeof(ext));
+        snprintf(ext.extension, sizeof(ext.extension), "%s", exts[ix]);
+        memcpy(&payload[size], &ext, sizeof(ext));
+    }
+    return ubxMakeMessage(UBX_MON_CLSID, UBX_MON_VER_MSGID, payload, size, msg);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int fakeNmeaGga(uint8_t *msg, const uint32_t iTow)
+{
+    struct tm utc;
+    uint32_t ms;
+    _fakeUtc(iTow, &utc, &ms);
+    char payload[100];
+    snprintf(payload, sizeof(payload), "%02d%02d%02d.%02u,4723.86200,N,00832.73000,E,1,24,0.80,402.0,M,48.0,M,,",
+        utc.tm_hour, utc.tm_min, utc.tm_sec, ms / 10);
+    return nmeaMakeMessage("GN", "GGA", payload, (char *)msg);
+}
+
+int fakeNmeaRmc(uint8_t *msg, const uint32_t iTow)
+{
+    struct tm utc;
+    uint32_t ms;
+    _fakeUtc(iTow, &utc, &ms);
+    char payload[100];
+    snprintf(payload, sizeof(payload), "%02d%02d%02d.%02u,A,4723.86200,N,00832.73000,E,0.010,,%02d%02d%02d,,,A,V",
+        utc.tm_hour, utc.tm_min, utc.tm_sec, ms / 10, utc.tm_mday, 1 + utc.tm_mon, utc.tm_year % 100);
+    return nmeaMakeMessage("GN", "RMC", payload, (char *)msg);
+}
+
+int fakeNmeaGsa(uint8_t *msg)
+{
+    return nmeaMakeMessage("GN", "GSA", "A,3,01,03,06,09,12,17,19,22,,,,,1.40,0.80,1.10,1", (char *)msg);
+}
+
+int fakeNmeaGsv(uint8_t *msg, const uint32_t n)
+{
+    char payload[100];
+    snprintf(payload, sizeof(payload), "3,%u,12,%02u,45,120,42,%02u,30,200,38,%02u,60,300,45,%02u,15,045,33,1",
+        1 + (n % 3), 1 + (n % 32), 2 + (n % 30), 3 + (n % 29), 4 + (n % 28));
+    return nmeaMakeMessage("GP", "GSV", payload, (char *)msg);
+}
+
+int fakeNmeaTxt(uint8_t *msg, const char *text)
+{
+    char payload[100];
+    snprintf(payload, sizeof(payload), "01,01,02,%s", text);
+    return nmeaMakeMessage("GN", "TXT", payload, (char *)msg);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int fakeRtcm3(uint8_t *msg, const int type, const int size, uint32_t *seed)
+{
+    msg[0] = RTCM3_PREAMBLE;
+    msg[1] = (size >> 8) & 0x03;
+    msg[2] = size & 0xff;
+    for (int ix = 0; ix < size; ix++)
+    {
+        msg[RTCM3_HEAD_SIZE + ix] = fakeRand(seed);
+    }
+    msg[RTCM3_HEAD_SIZE + 0] = (type >> 4) & 0xff;
+    msg[RTCM3_HEAD_SIZE + 1] = (msg[RTCM3_HEAD_SIZE + 1] & 0x0f) | ((type & 0x0f) << 4);
+    const uint32_t crc = crcRtcm3(msg, RTCM3_HEAD_SIZE + size);
+    msg[RTCM3_HEAD_SIZE + size + 0] = (crc >> 16) & 0xff;
+    msg[RTCM3_HEAD_SIZE + size + 1] = (crc >>  8) & 0xff;
+    msg[RTCM3_HEAD_SIZE + size + 2] =  crc        & 0xff;
+    return size + RTCM3_FRAME_SIZE;
+}
+
+int fakeNovatel(uint8_t *msg, const uint16_t msgId, const int size, uint32_t *seed)
+{
+    // Long header (28 bytes), payload, CRC (4 bytes)
+    memset(msg, 0, 28);
+    msg[0] = NOVATEL_SYNC_1;
+    msg[1] = NOVATEL_SYNC_2;
+    msg[2] = NOVATEL_SYNC_3_LONG;
+    msg[3] = 28;
+    msg[4] = msgId & 0xff;
+    msg[5] = (msgId >> 8) & 0xff;
+    msg[8] = size & 0xff;
+    msg[9] = (size >> 8) & 0xff;
+    for (int ix = 0; ix < size; ix++)
+    {
+        msg[28 + ix] = fakeRand(seed);
+    }
+    const uint32_t crc = crcNovatel32(msg, 28 + size);
+    memcpy(&msg[28 + size], &crc, sizeof(crc));
+    return 28 + size + 4;
+}
+
+int fakeGarbage(uint8_t *msg, uint32_t *seed)
+{
+    const int size = 1 + (fakeRand(seed) % 100);
+    for (int ix = 0; ix < size; ix++)
+    {
+        msg[ix] = fakeRand(seed);
+    }
+    return size;
+}
+
+/* ****************************************************************************************************************** */
+// eof
@@ -0,0 +1,53 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __CFGTOOL_FAKE_H__
+#define __CFGTOOL_FAKE_H__
+
+/* ****************************************************************************************************************** */
+
+// Generators for plausible (but fake) messages, for the bench and sim commands. The functions write a complete message
+// (frame) to msg, which must have space for FAKE_MSG_MAX_SIZE bytes, and return the size of the message. The seed is
+// the state of a pseudo-random number generator, so that the messages are the same for each run.
+
+#define FAKE_MSG_MAX_SIZE 4096
+
+uint32_t fakeRand(uint32_t *seed);
+
+int fakeUbxNavPvt(uint8_t *msg, const uint32_t iTow, uint32_t *seed);
+int fakeUbxNavSat(uint8_t *msg, const uint32_t iTow, uint32_t *seed);
+int fakeUbxNavSig(uint8_t *msg, const uint32_t iTow, uint32_t *seed);
+int fakeUbxNavEoe(uint8_t *msg, const uint32_t iTow);
+int fakeUbxRxmRawx(uint8_t *msg, const uint32_t iTow, uint32_t *seed);
+int fakeUbxEsfMeas(uint8_t *msg, const uint32_t iTow, uint32_t *seed);
+int fakeUbxEsfStatus(uint8_t *msg, const uint32_t iTow);
+int fakeUbxMonHw(uint8_t *msg, const uint32_t n, uint32_t *seed);
+int fakeUbxMonVer(uint8_t *msg);
+int fakeNmeaGga(uint8_t *msg, const uint32_t iTow);
+int fakeNmeaRmc(uint8_t *msg, const uint32_t iTow);
+int fakeNmeaGsa(uint8_t *msg);
+int fakeNmeaGsv(uint8_t *msg, const uint32_t n);
+int fakeNmeaTxt(uint8_t *msg, const char *text);
+int fakeRtcm3(uint8_t *msg, const int type, const int size, uint32_t *seed);
+int fakeNovatel(uint8_t *msg, const uint16_t msgId, const int size, uint32_t *seed);
+int fakeGarbage(uint8_t *msg, uint32_t *seed);
+
+/* ****************************************************************************************************************** */
+#endif // __CFGTOOL_FAKE_H__
@@ -0,0 +1,769 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <signal.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif
+
+#include "cfgtool_util.h"
+
+#include "ff_ubx.h"
+#include "ff_parser.h"
+#include "ff_epoch.h"
+#include "ff_time.h"
+
+#include "cfgtool_index.h"
+
+/* ****************************************************************************************************************** */
+
+const char *indexHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'index':\n"
+"\n"
+"    Usage: cfgtool index [-i <infile>] [-o <outfile>] [-y]\n"
+"\n"
+"    This processes data from the input file through the parser and the epoch\n"
+"    detection and creates an index in <infile>.idx. The index lists the start\n"
+"    of each epoch with a valid time as well as all messages by name. Other\n"
+"    commands use it to quickly find data by time or message name, without\n"
+"    parsing the entire input. Information on the indexed data is output to\n"
+"    the <outfile>. The index must be re-created if the input file changes.\n"
+"\n"
+"    The time of an epoch is the GPS week and time of week. Without the GPS\n"
+"    week (e.g. only UBX-NAV-PVT), the week is inferred from the UTC date (e.g.\n"
+"    from UBX-NAV-PVT or NMEA-Gx-RMC) or from the previous epochs. Epochs with\n"
+"    only a time of day (e.g. only NMEA-Gx-GGA) cannot be indexed.\n"
+"\n"
+"    Time ranges (-t <from>[,<to>], either of <from> or <to> can be empty) are\n"
+"    given as GPS week number and time of week (<week>/<tow>, e.g. 2200/86400.5)\n"
+"    or as GPS time of day (<hh>:<mm>[:<ss>[.<sss>]], e.g. 14:03:27, meaning\n"
+"    the first occurence of that time in the input). The range includes all\n"
+"    messages of the epochs from <from> up to including <to>.\n"
+"\n"
+"    Message filters (-m <name>[,<name>...]) are message names (e.g. UBX-NAV-PVT)\n"
+"    or the first parts of them (e.g. UBX-NAV, NMEA-GN, RTCM3).\n"
+"\n"
+"    Example:\n"
+"\n"
+"        cfgtool index -i log.ubx\n"
+"        cfgtool parse -i log.ubx -t 14:03:27,14:03:30 -m UBX-NAV-PVT,NMEA\n"
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+
+// The index file (host byte order) consists of the header, followed by the types, the epochs and the messages. The
+// INDEX_t pointers point directly into the (memory mapped) file.
+
+#define INDEX_MAGIC   "FFINDEX\n"
+#define INDEX_VERSION 2
+
+typedef struct INDEX_HEAD_s
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t headSize;
+    uint64_t inSize;
+    int64_t  inMtime;
+    uint64_t numMsgs;
+    uint64_t numEpochs;
+    uint32_t numTypes;
+    uint32_t reserved[3];
+
+} INDEX_HEAD_t;
+
+// Same as cfgtool parse, so that message sequence numbers and offsets match its output
+#define INDEX_FILL_LEVEL (PARSER_BUF_SIZE / 2)
+
+#define INDEX_HASH_SIZE 4096 // Max number of message types
+
+typedef struct INDEX_BUILD_s
+{
+    INDEX_TYPE_t  types[INDEX_HASH_SIZE];
+    INDEX_MSG_t  *msgs[INDEX_HASH_SIZE];
+    uint64_t      alloc[INDEX_HASH_SIZE];
+    int           order[INDEX_HASH_SIZE];
+    int           numTypes;
+    INDEX_EPOCH_t *epochs;
+    uint64_t      numEpochs;
+    uint64_t      allocEpochs;
+    bool          haveWeek;    // Time of the last indexed epoch, to infer the week of epochs without
+    int32_t       lastWeek;
+    double        lastTow;
+    uint64_t      numMsgs;
+    EPOCH_t       coll;
+    EPOCH_t       epoch;
+
+} INDEX_BUILD_t;
+
+static bool _grow(void **arr, uint64_t *alloc, const uint64_t num, const size_t size)
+{
+    if (num < *alloc)
+    {
+        return true;
+    }
+    const uint64_t newAlloc = *alloc > 0 ? 2 * *alloc : 1024;
+    void *newArr = realloc(*arr, newAlloc * size);
+    if (newArr == NULL)
+    {
+        WARNING("malloc fail!");
+        return false;
+    }
+    *arr = newArr;
+    *alloc = newAlloc;
+    return true;
+}
+
+// FNV-1a
+static uint32_t _hash(const char *str)
+{
+    uint32_t hash = 2166136261u;
+    while (*str != '\0')
+    {
+        hash ^= (uint8_t)*str++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool _indexAddMsg(INDEX_BUILD_t *build, const PARSER_MSG_t *msg, const uint64_t offs)
+{
+    // Find type, or add new type
+    uint32_t ix = _hash(msg->name) % INDEX_HASH_SIZE;
+    for (int n = 0; n < INDEX_HASH_SIZE; n++)
+    {
+        INDEX_TYPE_t *type = &build->types[ix];
+        if (type->name[0] == '\0')
+        {
+            snprintf(type->name, sizeof(type->name), "%s", msg->name);
+            build->order[build->numTypes++] = ix;
+            break;
+        }
+        else if (strcmp(type->name, msg->name) == 0)
+        {
+            break;
+        }
+        ix = (ix + 1) % INDEX_HASH_SIZE;
+    }
+    INDEX_TYPE_t *type = &build->types[ix];
+    if ( (strcmp(type->name, msg->name) != 0) ||
+         !_grow((void **)&build->msgs[ix], &build->alloc[ix], type->num, sizeof(INDEX_MSG_t)) )
+    {
+        return false;
+    }
+    INDEX_MSG_t *im = &build->msgs[ix][type->num++];
+    im->offs = offs;
+    im->seq  = msg->seq;
+    im->size = msg->size;
+    build->numMsgs++;
+    return true;
+}
+
+#define WEEK_SECS 604800.0
+#define DAY_SECS   86400.0
+
+// Days since 1970-01-01 of a (proleptic Gregorian) date
+static int64_t _daysFromCivil(const int year, const int month, const int day)
+{
+    const int64_t y = (int64_t)year - (month <= 2 ? 1 : 0);
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - (era * 400);
+    const int64_t doy = (((153 * (month > 2 ? month - 3 : month + 9)) + 2) / 5) + day - 1;
+    const int64_t doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+    return (era * 146097) + doe - 719468;
+}
+
+// Determine GPS time of epoch, from the GPS week and time of week, or from the UTC date and time, or from the time of
+// week and the previous epoch
+static bool _indexEpochTime(INDEX_BUILD_t *build, const EPOCH_t *epoch, int32_t *week, double *tow)
+{
+    if (epoch->haveGpsWeek && epoch->haveGpsTow)
+    {
+        *week = epoch->gpsWeek;
+        *tow  = epoch->gpsTow;
+    }
+    else if (epoch->haveDate && epoch->haveTime)
+    {
+        const double posix = ((double)_daysFromCivil(epoch->year, epoch->month, epoch->day) * DAY_SECS) +
+            ((double)epoch->hour * 3600.0) + ((double)epoch->minute * 60.0) + epoch->second;
+        const double ts = posix2ts(posix, epoch->leapSeconds, epoch->haveLeapSeconds);
+        if (ts < 0.0)
+        {
+            return false;
+        }
+        // Prefer the receiver's time of week (e.g. UBX-NAV-PVT iTOW), which is not affected by the leap seconds
+        if (epoch->haveGpsTow)
+        {
+            *tow  = epoch->gpsTow;
+            *week = (int32_t)floor(((ts - epoch->gpsTow) / WEEK_SECS) + 0.5);
+        }
+        else
+        {
+            *week = (int32_t)floor(ts / WEEK_SECS);
+            *tow  = ts - ((double)*week * WEEK_SECS);
+        }
+    }
+    else if (epoch->haveGpsTow && build->haveWeek)
+    {
+        *tow  = epoch->gpsTow;
+        *week = build->lastWeek;
+        if (*tow < (build->lastTow - (WEEK_SECS / 2)))
+        {
+            (*week)++;
+        }
+    }
+    else
+    {
+        return false;
+    }
+    build->haveWeek = true;
+    build->lastWeek = *week;
+    build->lastTow  = *tow;
+    return true;
+}
+
+static bool _indexAddEpoch(INDEX_BUILD_t *build, const EPOCH_t *epoch, const uint64_t offs, const uint32_t seq)
+{
+    int32_t week = 0;
+    double tow = 0.0;
+    if (!_indexEpochTime(build, epoch, &week, &tow))
+    {
+        return true;
+    }
+    if (!_grow((void **)&build->epochs, &build->allocEpochs, build->numEpochs, sizeof(INDEX_EPOCH_t)))
+    {
+        return false;
+    }
+    INDEX_EPOCH_t *ie = &build->epochs[build->numEpochs++];
+    ie->offs    = offs;
+    ie->seq     = seq;
+    ie->gpsWeek = week;
+    ie->gpsTow  = tow;
+    return true;
+}
+
+static const INDEX_BUILD_t *gSortBuild;
+
+static int _typeCmp(const void *a, const void *b)
+{
+    return strcmp(gSortBuild->types[*(const int *)a].name, gSortBuild->types[*(const int *)b].name);
+}
+
+static bool _indexWrite(INDEX_BUILD_t *build, const char *idxName, const uint64_t inSize, const int64_t inMtime)
+{
+    gSortBuild = build;
+    qsort(build->order, build->numTypes, sizeof(*build->order), _typeCmp);
+
+    FILE *file = fopen(idxName, "wb");
+    if (file == NULL)
+    {
+        WARNING("Failed creating '%s': %s", idxName, strerror(errno));
+        return false;
+    }
+
+    INDEX_HEAD_t head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, INDEX_MAGIC, sizeof(head.magic));
+    head.version   = INDEX_VERSION;
+    head.headSize  = sizeof(head);
+    head.inSize    = inSize;
+    head.inMtime   = inMtime;
+    head.numMsgs   = build->numMsgs;
+    head.numEpochs = build->numEpochs;
+    head.numTypes  = build->numTypes;
+    bool res = (fwrite(&head, sizeof(head), 1, file) == 1);
+
+    uint64_t first = 0;
+    for (int n = 0; res && (n < build->numTypes); n++)
+    {
+        INDEX_TYPE_t *type = &build->types[build->order[n]];
+        type->first = first;
+        first += type->num;
+        res = (fwrite(type, sizeof(*type), 1, file) == 1);
+    }
+    if (res && (build->numEpochs > 0))
+    {
+        res = (fwrite(build->epochs, sizeof(*build->epochs), build->numEpochs, file) == build->numEpochs);
+    }
+    for (int n = 0; res && (n < build->numTypes); n++)
+    {
+        const int ix = build->order[n];
+        res = (fwrite(build->msgs[ix], sizeof(INDEX_MSG_t), build->types[ix].num, file) == build->types[ix].num);
+    }
+
+    if (!res)
+    {
+        WARNING("Failed writing '%s': %s", idxName, strerror(errno));
+    }
+    if (fclose(file) != 0)
+    {
+        res = false;
+    }
+    if (!res)
+    {
+        remove(idxName);
+    }
+    return res;
+}
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        PRINT("Aborting...");
+        gAbort = true;
+    }
+}
+
+int indexRun(const char *inName)
+{
+    uint64_t size = 0;
+    const uint8_t *data = ioMapInput(&size);
+    struct stat st;
+    if ( (data == NULL) || (stat(inName, &st) != 0) )
+    {
+        WARNING("Cannot index this input, need a (non-empty) regular file!");
+        return EXIT_OTHERFAIL;
+    }
+    char idxName[PATH_MAX];
+    if (snprintf(idxName, sizeof(idxName), "%s.idx", inName) >= (int)sizeof(idxName))
+    {
+        return EXIT_OTHERFAIL;
+    }
+
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    INDEX_BUILD_t *build = calloc(1, sizeof(INDEX_BUILD_t));
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    if ( (build == NULL) || (parser == NULL) || !epochInit(&build->coll) || !epochInit(&build->epoch) )
+    {
+        if (build != NULL)
+        {
+            epochFree(&build->coll);
+            epochFree(&build->epoch);
+        }
+        free(build);
+        free(parser);
+        return EXIT_OTHERFAIL;
+    }
+    parserInit(parser);
+    parserSetTs(parser, PARSER_TS_NONE, NULL, NULL);
+
+    bool res = true;
+    uint64_t inOffs = 0;
+    uint64_t msgOffs = 0;
+    uint64_t epochOffs = 0;
+    uint32_t epochSeq = 1;
+    while (res && !gAbort)
+    {
+        if ( (inOffs < size) && ((parser->offs + parser->size) < INDEX_FILL_LEVEL) )
+        {
+            const int num = (int)MIN((uint64_t)parserSpace(parser), size - inOffs);
+            parserAdd(parser, &data[inOffs], num);
+            inOffs += num;
+        }
+        PARSER_MSG_t msg;
+        const bool haveMsg = parserProcess(parser, &msg, true);
+        if ( !haveMsg && !((inOffs >= size) && parserFlush(parser, &msg)) )
+        {
+            if (inOffs >= size)
+            {
+                break;
+            }
+            continue;
+        }
+
+        // The message that completes an epoch is the first message of the next epoch, unless it's the end of epoch
+        // marker of the completed epoch
+        if (epochCollect(&build->coll, &msg, &build->epoch))
+        {
+            res = _indexAddEpoch(build, &build->epoch, epochOffs, epochSeq);
+            const bool isEoe = (msg.type == PARSER_MSGTYPE_UBX) &&
+                (UBX_CLSID(msg.data) == UBX_NAV_CLSID) && (UBX_MSGID(msg.data) == UBX_NAV_EOE_MSGID);
+            epochOffs = isEoe ? msgOffs + msg.size : msgOffs;
+            epochSeq = isEoe ? msg.seq + 1 : msg.seq;
+        }
+        res = res && _indexAddMsg(build, &msg, msgOffs);
+        msgOffs += msg.size;
+    }
+    if (!res)
+    {
+        WARNING("Too many message types!");
+    }
+
+    if (res && !gAbort)
+    {
+        res = _indexWrite(build, idxName, size, st.st_mtime);
+    }
+
+    if (res && !gAbort)
+    {
+        ioOutputStr("index %s: %" PRIu64 " bytes, %" PRIu64 " messages, %" PRIu64 " epochs, %d types\n",
+            idxName, size, build->numMsgs, build->numEpochs, build->numTypes);
+        if (build->numEpochs > 0)
+        {
+            const INDEX_EPOCH_t *e0 = &build->epochs[0];
+            const INDEX_EPOCH_t *e1 = &build->epochs[build->numEpochs - 1];
+            ioOutputStr("epochs %04d/%010.3f (seq %u) - %04d/%010.3f (seq %u)\n",
+                e0->gpsWeek, e0->gpsTow, e0->seq, e1->gpsWeek, e1->gpsTow, e1->seq);
+        }
+        for (int n = 0; n < build->numTypes; n++)
+        {
+            const int ix = build->order[n];
+            const INDEX_TYPE_t *type = &build->types[ix];
+            uint64_t typeSize = 0;
+            for (uint64_t m = 0; m < type->num; m++)
+            {
+                typeSize += build->msgs[ix][m].size;
+            }
+            ioOutputStr("type %-30s count %10" PRIu64 "  size %12" PRIu64 "\n", type->name, type->num, typeSize);
+        }
+        res = ioWriteOutput(false);
+    }
+
+    for (int ix = 0; ix < INDEX_HASH_SIZE; ix++)
+    {
+        free(build->msgs[ix]);
+    }
+    free(build->epochs);
+    epochFree(&build->coll);
+    epochFree(&build->epoch);
+    free(build);
+    free(parser);
+    return res && !gAbort ? EXIT_SUCCESS : EXIT_OTHERFAIL;
+}
+
+/* ****************************************************************************************************************** */
+
+INDEX_t *indexLoad(const char *inName)
+{
+    char idxName[PATH_MAX];
+    struct stat inSt;
+    struct stat idxSt;
+    if ( (inName == NULL) || (snprintf(idxName, sizeof(idxName), "%s.idx", inName) >= (int)sizeof(idxName)) ||
+         (stat(inName, &inSt) != 0) || (stat(idxName, &idxSt) != 0) || (idxSt.st_size < (off_t)sizeof(INDEX_HEAD_t)) )
+    {
+        return NULL;
+    }
+    FILE *file = fopen(idxName, "rb");
+    INDEX_t *index = calloc(1, sizeof(INDEX_t));
+    if ( (file == NULL) || (index == NULL) )
+    {
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        free(index);
+        return NULL;
+    }
+
+    index->_size = idxSt.st_size;
+#ifndef _WIN32
+    void *map = mmap(NULL, index->_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    index->_data = map != MAP_FAILED ? map : NULL;
+#else
+    index->_data = malloc(index->_size);
+    if ( (index->_data != NULL) && (fread(index->_data, index->_size, 1, file) != 1) )
+    {
+        free(index->_data);
+        index->_data = NULL;
+    }
+#endif
+    fclose(file);
+    if (index->_data == NULL)
+    {
+        WARNING("Failed reading '%s': %s", idxName, strerror(errno));
+        free(index);
+        return NULL;
+    }
+
+    const INDEX_HEAD_t *head = (const INDEX_HEAD_t *)index->_data;
+    if ( (memcmp(head->magic, INDEX_MAGIC, sizeof(head->magic)) != 0) || (head->version != INDEX_VERSION) ||
+         (head->headSize != sizeof(INDEX_HEAD_t)) ||
+         (index->_size != (sizeof(INDEX_HEAD_t) + (head->numTypes * sizeof(INDEX_TYPE_t)) +
+            (head->numEpochs * sizeof(INDEX_EPOCH_t)) + (head->numMsgs * sizeof(INDEX_MSG_t)))) )
+    {
+        WARNING("Bad index '%s'!", idxName);
+        indexFree(index);
+        return NULL;
+    }
+    if ( (head->inSize != (uint64_t)inSt.st_size) || (head->inMtime != (int64_t)inSt.st_mtime) )
+    {
+        WARNING("Outdated index '%s'!", idxName);
+        indexFree(index);
+        return NULL;
+    }
+
+    index->inSize    = head->inSize;
+    index->numMsgs   = head->numMsgs;
+    index->numEpochs = head->numEpochs;
+    index->numTypes  = head->numTypes;
+    index->types     = (const INDEX_TYPE_t *)&head[1];
+    index->epochs    = (const INDEX_EPOCH_t *)&index->types[index->numTypes];
+    index->msgs      = (const INDEX_MSG_t *)&index->epochs[index->numEpochs];
+    DEBUG("Loaded index '%s' (%" PRIu64 " messages, %" PRIu64 " epochs, %" PRIu32 " types)",
+        idxName, index->numMsgs, index->numEpochs, index->numTypes);
+    return index;
+}
+
+void indexFree(INDEX_t *index)
+{
+    if (index != NULL)
+    {
+#ifndef _WIN32
+        munmap(index->_data, index->_size);
+#else
+        free(index->_data);
+#endif
+        free(index);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// Parse time spec to seconds since GPS epoch, returns false for invalid spec, sets *t to NAN for empty spec
+static bool _parseTime(const char *spec, const int len, const INDEX_EPOCH_t *first, double *t)
+{
+    char str[100];
+    if (len >= (int)sizeof(str))
+    {
+        return false;
+    }
+    memcpy(str, spec, len);
+    str[len] = '\0';
+    if (len == 0)
+    {
+        *t = NAN;
+        return true;
+    }
+
+    int week = 0;
+    double tow = 0.0;
+    int hh = 0;
+    int mm = 0;
+    double ss = 0.0;
+    int n = 0;
+    if ( (sscanf(str, "%d/%lf%n", &week, &tow, &n) == 2) && (n == len) &&
+         (week >= 0) && (tow >= 0.0) && (tow < WEEK_SECS) )
+    {
+        *t = ((double)week * WEEK_SECS) + tow;
+        return true;
+    }
+    if ( ( ((sscanf(str, "%d:%d:%lf%n", &hh, &mm, &ss, &n) == 3) && (n == len)) ||
+           ((sscanf(str, "%d:%d%n", &hh, &mm, &n) == 2) && (n == len)) ) &&
+         (hh >= 0) && (hh < 24) && (mm >= 0) && (mm < 60) && (ss >= 0.0) && (ss < 61.0) )
+    {
+        // First occurence of that time of day
+        const double t0 = (first != NULL ? ((double)first->gpsWeek * WEEK_SECS) + first->gpsTow : 0.0);
+        const double tod = ((double)hh * 3600.0) + ((double)mm * 60.0) + ss;
+        *t = (floor(t0 / DAY_SECS) * DAY_SECS) + tod;
+        if (*t < (t0 - 0.0005))
+        {
+            *t += DAY_SECS;
+        }
+        return true;
+    }
+    return false;
+}
+
+static double _epochTime(const INDEX_EPOCH_t *epoch)
+{
+    return ((double)epoch->gpsWeek * WEEK_SECS) + epoch->gpsTow;
+}
+
+// Index of first epoch with time >= t (strict = false) or > t (strict = true)
+static uint64_t _findEpoch(const INDEX_t *index, const double t, const bool strict)
+{
+    uint64_t lo = 0;
+    uint64_t hi = index->numEpochs;
+    while (lo < hi)
+    {
+        const uint64_t mid = lo + ((hi - lo) / 2);
+        const double te = _epochTime(&index->epochs[mid]);
+        if (strict ? (te <= t) : (te < t))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool indexTimeRange(const INDEX_t *index, const char *spec, uint64_t *startOffs, uint32_t *startSeq, uint64_t *endOffs)
+{
+    if (index->numEpochs == 0)
+    {
+        WARNING("Index has no time information, cannot use time range '%s'!", spec);
+        return false;
+    }
+    const char *comma = strchr(spec, ',');
+    const int fromLen = comma != NULL ? (int)(comma - spec) : (int)strlen(spec);
+    const INDEX_EPOCH_t *first = index->numEpochs > 0 ? &index->epochs[0] : NULL;
+    double from = NAN;
+    double to = NAN;
+    if ( !_parseTime(spec, fromLen, first, &from) ||
+         ( (comma != NULL) && !_parseTime(&comma[1], strlen(&comma[1]), first, &to) ) )
+    {
+        WARNING("Bad time range '%s'!", spec);
+        return false;
+    }
+    // Single time: just that epoch
+    if (comma == NULL)
+    {
+        to = from;
+    }
+
+    *startOffs = 0;
+    *startSeq = 1;
+    *endOffs = index->inSize;
+    if (!isnan(from))
+    {
+        const uint64_t ix = _findEpoch(index, from, false);
+        if (ix < index->numEpochs)
+        {
+            *startOffs = index->epochs[ix].offs;
+            *startSeq = index->epochs[ix].seq;
+        }
+        else
+        {
+            *startOffs = index->inSize;
+        }
+    }
+    if (!isnan(to))
+    {
+        const uint64_t ix = _findEpoch(index, to, true);
+        if (ix < index->numEpochs)
+        {
+            *endOffs = index->epochs[ix].offs;
+        }
+    }
+    DEBUG("Time range '%s': %.3f - %.3f: offs %" PRIu64 " - %" PRIu64 " (seq %u)",
+        spec, from, to, *startOffs, *endOffs, *startSeq);
+    return true;
+}
+
+static int _indexMsgCmp(const void *a, const void *b)
+{
+    const INDEX_MSG_t *ma = *(const INDEX_MSG_t * const *)a;
+    const INDEX_MSG_t *mb = *(const INDEX_MSG_t * const *)b;
+    return ma->offs < mb->offs ? -1 : (ma->offs > mb->offs ? 1 : 0);
+}
+
+// Index of first message of a type at or after offs
+static uint64_t _indexFindMsg(const INDEX_t *index, const INDEX_TYPE_t *type, const uint64_t offs)
+{
+    const INDEX_MSG_t *msgs = &index->msgs[type->first];
+    uint64_t lo = 0;
+    uint64_t hi = type->num;
+    while (lo < hi)
+    {
+        const uint64_t mid = lo + ((hi - lo) / 2);
+        if (msgs[mid].offs < offs)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+const INDEX_MSG_t **indexSelect(const INDEX_t *index, const char *msgFilter, const uint64_t startOffs,
+    const uint64_t endOffs, uint64_t *numSel)
+{
+    int numTypes = 0;
+    uint64_t num = 0;
+    for (uint32_t ix = 0; ix < index->numTypes; ix++)
+    {
+        const INDEX_TYPE_t *type = &index->types[ix];
+        if ( (msgFilter == NULL) || indexMatchName(msgFilter, type->name) )
+        {
+            num += _indexFindMsg(index, type, endOffs) - _indexFindMsg(index, type, startOffs);
+            numTypes++;
+        }
+    }
+    const INDEX_MSG_t **sel = malloc((num > 0 ? num : 1) * sizeof(*sel));
+    if (sel == NULL)
+    {
+        WARNING("malloc fail!");
+        return NULL;
+    }
+    num = 0;
+    for (uint32_t ix = 0; ix < index->numTypes; ix++)
+    {
+        const INDEX_TYPE_t *type = &index->types[ix];
+        if ( (msgFilter == NULL) || indexMatchName(msgFilter, type->name) )
+        {
+            const uint64_t end = _indexFindMsg(index, type, endOffs);
+            for (uint64_t n = _indexFindMsg(index, type, startOffs); n < end; n++)
+            {
+                sel[num++] = &index->msgs[type->first + n];
+            }
+        }
+    }
+    if (numTypes > 1)
+    {
+        qsort(sel, num, sizeof(*sel), _indexMsgCmp);
+    }
+    DEBUG("Selected %" PRIu64 " messages of %d types", num, numTypes);
+    *numSel = num;
+    return sel;
+}
+
+bool indexMatchName(const char *spec, const char *name)
+{
+    const char *filt = spec;
+    while (*filt != '\0')
+    {
+        const char *comma = strchr(filt, ',');
+        const int len = comma != NULL ? (int)(comma - filt) : (int)strlen(filt);
+        if ( (len > 0) && (strncmp(filt, name, len) == 0) && ((name[len] == '\0') || (name[len] == '-')) )
+        {
+            return true;
+        }
+        filt += len;
+        if (*filt == ',')
+        {
+            filt++;
+        }
+    }
+    return false;
+}
+
+/* ****************************************************************************************************************** */
+// eof
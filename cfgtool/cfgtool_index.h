@@ -0,0 +1,89 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __CFGTOOL_INDEX_H__
+#define __CFGTOOL_INDEX_H__
+
+/* ****************************************************************************************************************** */
+
+const char *indexHelp(void);
+
+int indexRun(const char *inName);
+
+// Index of an input file, see cfgtool_index.c for the file format
+
+typedef struct INDEX_MSG_s
+{
+    uint64_t offs;      // Offset of the message in the input file
+    uint32_t seq;       // Message sequence number (1 = first message in the input file)
+    uint32_t size;      // Size of the message
+
+} INDEX_MSG_t;
+
+typedef struct INDEX_EPOCH_s
+{
+    uint64_t offs;      // Offset of the first message of the epoch
+    uint32_t seq;       // Sequence number of that message
+    int32_t  gpsWeek;   // GPS week number of the epoch
+    double   gpsTow;    // GPS time of week of the epoch
+
+} INDEX_EPOCH_t;
+
+typedef struct INDEX_TYPE_s
+{
+    char     name[112]; // Message name (PARSER_MSG_t.name)
+    uint64_t num;       // Number of messages
+    uint64_t first;     // Index of the first message in INDEX_t.msgs
+
+} INDEX_TYPE_t;
+
+typedef struct INDEX_s
+{
+    uint64_t             inSize;    // Size of the input file
+    uint64_t             numMsgs;   // Number of messages (of all types)
+    uint64_t             numEpochs; // Number of epochs (with valid time)
+    uint32_t             numTypes;  // Number of message types
+    const INDEX_TYPE_t  *types;     // Message types (sorted by name)
+    const INDEX_EPOCH_t *epochs;    // Epochs (in order of appearance)
+    const INDEX_MSG_t   *msgs;      // Messages (grouped by type, in order of appearance)
+    void                *_data;
+    uint64_t             _size;
+
+} INDEX_t;
+
+// Load index for input file (<inName>.idx), returns NULL if there's no or an outdated index
+INDEX_t *indexLoad(const char *inName);
+
+void indexFree(INDEX_t *index);
+
+// Find input range for a time range spec ("<from>[,<to>]", see indexHelp()), returns false if the spec is invalid or
+// if the index has no epochs
+bool indexTimeRange(const INDEX_t *index, const char *spec, uint64_t *startOffs, uint32_t *startSeq, uint64_t *endOffs);
+
+// Check if message name matches a message filter spec ("<name>[,<name>...]", see indexHelp())
+bool indexMatchName(const char *spec, const char *name);
+
+// Select messages matching a message filter spec (NULL = all messages) in the input range [startOffs, endOffs), returns
+// an array (to be free()d) of the selected messages sorted by offset, NULL on error
+const INDEX_MSG_t **indexSelect(const INDEX_t *index, const char *msgFilter, const uint64_t startOffs,
+    const uint64_t endOffs, uint64_t *numSel);
+
+/* ****************************************************************************************************************** */
+#endif // __CFGTOOL_INDEX_H__
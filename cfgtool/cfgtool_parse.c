@@ -17,9 +17,13 @@
 
 #include <string.h>
 #include <stddef.h>
+#include <inttypes.h>
+#include <errno.h>
 #include <signal.h>
+#include <pthread.h>
 
 #include "cfgtool_util.h"
+#include "cfgtool_index.h"
 
 #include "ff_ubx.h"
 #include "ff_parser.h"
@@ -36,6 +40,8 @@ const char *parseHelp(void)
 "Command 'parse':\n"
 "\n"
 "    Usage: cfgtool parse [-i <infile>] [-o <outfile>] [-y] [-x] [-e]\n"
+"                         [-E <format>] [-j <num>] [-t <from>[,<to>]]\n"
+"                         [-m <name>[,<name>...]]\n"
 "\n"
 "    This processes data from the input file through the parser and outputs\n"
 "    information on the found messages and optionally a hex dump of the messages.\n"
@@ -43,6 +49,24 @@ const char *parseHelp(void)
 "    or SIGTERM is received.\n"
 "\n"
 "    Add -e to enable epoch detection and to output detected epochs.\n"
+"\n"
+"    With -E <format> only the detected epochs are output (implies -e), in one\n"
+"    of the following formats (see ff/ff_epochfmt.h for details):\n"
+"\n"
+"        str   Text, same as with -e (but without the messages)\n"
+"        csv   CSV, with a header line\n"
+"        json  JSON, one object per line\n"
+"        bin   Binary records, one per epoch\n"
+"        col   Binary columnar blocks of up to " STRINGIFY(EPOCHCOL_DEF_MAX_EPOCHS) " epochs, with the signals\n"
+"\n"
+"    With -j <num> the input file is split into <num> regions that are parsed\n"
+"    concurrently. The output is the same as without -j. This does not work for\n"
+"    epoch detection (-e) and input from pipes or terminals.\n"
+"\n"
+"    With -t <from>[,<to>] only the messages in the given time range are output.\n"
+"    With -m <name>[,<name>...] only the messages with the given names are\n"
+"    output. Both use the index of the input file (see 'index' command), which\n"
+"    is required for -t. The statistics are for the output messages.\n"
 "\n";
 }
 
@@ -59,87 +83,609 @@ static void _sigHandler(int signal)
     }
 }
 
-int parseRun(const bool extraInfo, const bool doEpoch)
+// The parser is kept filled (at least to this level, unless at the end of the input), so that the detectors never have
+// to wait for more data. This makes the result independent of how the input data arrives, which parsing concurrently
+// relies on (see _parseJob()).
+#define PARSE_FILL_LEVEL (PARSER_BUF_SIZE / 2)
+
+// Maximum size of the output for one message
+#define PARSE_STR_SIZE (PARSER_MAX_NAME_SIZE + PARSER_MAX_INFO_SIZE + 100 + ((PARSER_BUF_SIZE / 16) + 1) * IO_HEXDUMP_LINE_SIZE)
+
+static void _outputStats(const PARSER_t *parser, const bool doEpoch, const uint32_t nEpochs);
+static void _parserUncount(PARSER_t *parser, const PARSER_MSG_t *msg);
+static int _parseParallel(const bool extraInfo, const int numJobs);
+static int _parseIndexed(INDEX_t *index, const bool extraInfo, const bool doEpoch, const EPOCHFMT_t epochFmt,
+    const bool doMsgs, const char *timeRange, const char *msgFilter);
+
+static void _outputMsg(const PARSER_MSG_t *msg, const uint32_t seq, const bool extraInfo)
+{
+    ioOutputStr("message %4u, size %4d, %-8s %-20s %s\n",
+        seq, msg->size, parserMsgtypeName(msg->type), msg->name, msg->info != NULL ? msg->info : "n/a");
+    if (extraInfo)
+    {
+        ioAddOutputHexdump(msg->data, msg->size);
+    }
+}
+
+static void _outputEpoch(EPOCH_t *epoch, const uint32_t nEpochs, const EPOCHFMT_t epochFmt)
+{
+    if (epochFmt == EPOCHFMT_STR)
+    {
+        ioOutputStr("epoch   %4d, size    0, NONE     EPOCH                %s\n", nEpochs, epochStr(epoch));
+    }
+    else
+    {
+        ioAddOutputEpoch(epoch);
+    }
+}
+
+int parseRun(const char *inName, const bool extraInfo, const bool doEpoch, const char *epochFormat, const int numJobs,
+    const char *timeRange, const char *msgFilter)
 {
+    // With an epoch format only the epochs are output
+    EPOCHFMT_t epochFmt = EPOCHFMT_STR;
+    if ( (epochFormat != NULL) && !epochfmtFromName(epochFormat, &epochFmt) )
+    {
+        WARNING("Illegal format '-E %s'!", epochFormat);
+        return EXIT_BADARGS;
+    }
+    const bool doMsgs = (epochFormat == NULL);
+
     uint32_t nEpochs = 0;
+    uint32_t nSkipped = 0; // Messages not output (-m), the parser counts only the output messages
 
     gAbort = false;
     signal(SIGINT, _sigHandler);
     signal(SIGTERM, _sigHandler);
     NOT_WIN( signal(SIGHUP, _sigHandler) );
 
-    PARSER_t parser;
-    parserInit(&parser);
+    if ( (timeRange != NULL) || (msgFilter != NULL) )
+    {
+        if (numJobs > 1)
+        {
+            WARNING("Cannot use -j with -t or -m!");
+            return EXIT_BADARGS;
+        }
+        INDEX_t *index = ioMapInput(NULL) != NULL ? indexLoad(inName) : NULL;
+        if (index != NULL)
+        {
+            const int res = _parseIndexed(index, extraInfo, doEpoch, epochFmt, doMsgs, timeRange, msgFilter);
+            indexFree(index);
+            return res;
+        }
+        else if (timeRange != NULL)
+        {
+            WARNING("Need an index for -t, use 'cfgtool index -i %s'!", inName);
+            return EXIT_OTHERFAIL;
+        }
+        DEBUG("No index, parsing entire input");
+    }
 
-    EPOCH_t coll;
-    EPOCH_t epoch;
-    PARSER_MSG_t msg;
-    epochInit(&coll);
-    bool done = false;
-    while (!(gAbort || done))
+    if (numJobs > 1)
     {
-        uint8_t buf[1000];
-        const int num = ioReadInput(buf, sizeof(buf));
-        if (num < 0) // eof
+        if (doEpoch)
         {
-            done = true;
+            WARNING("Cannot use -j with -e!");
+            return EXIT_BADARGS;
         }
-        else if (num == 0) // wait
+        if (ioMapInput(NULL) != NULL)
         {
-            SLEEP(5);
-            continue;
+            return _parseParallel(extraInfo, numJobs);
         }
-        if (num > 0)
+        WARNING("Cannot parse this input concurrently, using one job");
+    }
+
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    if (!epochInit(&coll) || !epochInit(&epoch) || !ioEpochOutputBegin(epochFmt))
+    {
+        epochFree(&coll);
+        epochFree(&epoch);
+        return EXIT_OTHERFAIL;
+    }
+
+    PARSER_t parser;
+    parserInit(&parser);
+    parserSetTs(&parser, PARSER_TS_NONE, NULL, NULL);
+
+    PARSER_MSG_t msg;
+    bool eof = false;
+    while (!gAbort)
+    {
+        if (!eof && ((parser.offs + parser.size) < PARSE_FILL_LEVEL))
         {
-            parserAdd(&parser, buf, num);
+            const uint8_t *data = NULL;
+            const int num = ioGetInput(&data, parserSpace(&parser));
+            if (num < 0) // eof
+            {
+                eof = true;
+            }
+            else if (num > 0)
+            {
+                parserAdd(&parser, data, num);
+            }
         }
 
-        while (parserProcess(&parser, &msg, true))
+        if (parserProcess(&parser, &msg, true))
         {
+            if ( (msgFilter != NULL) && !indexMatchName(msgFilter, msg.name) )
+            {
+                _parserUncount(&parser, &msg);
+                nSkipped++;
+                continue;
+            }
             if (doEpoch && epochCollect(&coll, &msg, &epoch))
             {
                 nEpochs++;
-                ioOutputStr("epoch   %4d, size    0, NONE     EPOCH                %s\n", nEpochs, epoch.str);
+                _outputEpoch(&epoch, nEpochs, epochFmt);
             }
-            ioOutputStr("message %4u, size %4d, %-8s %-20s %s\n",
-                msg.seq, msg.size, parserMsgtypeName(msg.type), msg.name, msg.info != NULL ? msg.info : "n/a");
-            if (extraInfo)
+            if (doMsgs)
             {
-                ioAddOutputHexdump(msg.data, msg.size);
+                _outputMsg(&msg, msg.seq + nSkipped, extraInfo);
             }
             if (!ioWriteOutput(parser.nMsgs == 1 ? false : true))
             {
-                break;
+                ioEpochOutputEnd();
+                epochFree(&coll);
+                epochFree(&epoch);
+                return EXIT_OTHERFAIL;
             }
         }
+        else if (eof)
+        {
+            break;
+        }
+        // Wait for more data
+        else
+        {
+            SLEEP(5);
+        }
     }
 
     // Anything left in parser?
     if (parserFlush(&parser, &msg))
     {
-        ioOutputStr("message %4u, size %4d, %-8s %-20s %s\n",
-            msg.seq, msg.size, parserMsgtypeName(msg.type), msg.name, msg.info != NULL ? msg.info : "n/a");
-        if (extraInfo)
+        if ( (msgFilter != NULL) && !indexMatchName(msgFilter, msg.name) )
+        {
+            _parserUncount(&parser, &msg);
+        }
+        else if (doMsgs)
         {
-            ioAddOutputHexdump(msg.data, msg.size);
+            _outputMsg(&msg, msg.seq + nSkipped, extraInfo);
+            ioWriteOutput(true);
         }
-        ioWriteOutput(true);
     }
 
-    ioOutputStr("stats UBX      count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser.nUbx,     parser.nMsgs > 0 ? (double)parser.nUbx     / (double)parser.nMsgs * 1e2 : 0.0, parser.sUbx,     parser.sMsgs > 0 ? (double)parser.sUbx     / (double)parser.sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats NMEA     count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser.nNmea,    parser.nMsgs > 0 ? (double)parser.nNmea    / (double)parser.nMsgs * 1e2 : 0.0, parser.sNmea,    parser.sMsgs > 0 ? (double)parser.sNmea    / (double)parser.sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats RTCM3    count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser.nRtcm3,   parser.nMsgs > 0 ? (double)parser.nRtcm3   / (double)parser.nMsgs * 1e2 : 0.0, parser.sRtcm3,   parser.sMsgs > 0 ? (double)parser.sRtcm3   / (double)parser.sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats SPARTN   count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser.nSpartn,  parser.nMsgs > 0 ? (double)parser.nSpartn  / (double)parser.nMsgs * 1e2 : 0.0, parser.sSpartn,  parser.sMsgs > 0 ? (double)parser.sSpartn  / (double)parser.sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats NOVATEL  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser.nUbx,     parser.nMsgs > 0 ? (double)parser.nNovatel / (double)parser.nMsgs * 1e2 : 0.0, parser.sNovatel, parser.sMsgs > 0 ? (double)parser.sNovatel / (double)parser.sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats GARBAGE  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser.nGarbage, parser.nMsgs > 0 ? (double)parser.nGarbage / (double)parser.nMsgs * 1e2 : 0.0, parser.sGarbage, parser.sMsgs > 0 ? (double)parser.sGarbage / (double)parser.sMsgs * 1e2 : 0.0);
-    ioOutputStr("stats Total    count %6u (100.0%%)  size %10u (100.0%%)\n", parser.nMsgs, parser.sMsgs);
-    if (doEpoch)
+    ioEpochOutputEnd();
+    if (doMsgs)
     {
-        ioOutputStr("stats EPOCH    count %6u (%5.1f%%)\n", nEpochs, parser.nMsgs > 0 ? (double)nEpochs / (double)parser.nMsgs * 1e2 : 0.0);
+        _outputStats(&parser, doEpoch, nEpochs);
     }
+    epochFree(&coll);
+    epochFree(&epoch);
 
     return ioWriteOutput(true) ? EXIT_SUCCESS : EXIT_OTHERFAIL;
 }
 
+static void _outputStats(const PARSER_t *parser, const bool doEpoch, const uint32_t nEpochs)
+{
+    ioOutputStr("stats UBX      count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nUbx,     parser->nMsgs > 0 ? (double)parser->nUbx     / (double)parser->nMsgs * 1e2 : 0.0, parser->sUbx,     parser->sMsgs > 0 ? (double)parser->sUbx     / (double)parser->sMsgs * 1e2 : 0.0);
+    ioOutputStr("stats NMEA     count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nNmea,    parser->nMsgs > 0 ? (double)parser->nNmea    / (double)parser->nMsgs * 1e2 : 0.0, parser->sNmea,    parser->sMsgs > 0 ? (double)parser->sNmea    / (double)parser->sMsgs * 1e2 : 0.0);
+    ioOutputStr("stats RTCM3    count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nRtcm3,   parser->nMsgs > 0 ? (double)parser->nRtcm3   / (double)parser->nMsgs * 1e2 : 0.0, parser->sRtcm3,   parser->sMsgs > 0 ? (double)parser->sRtcm3   / (double)parser->sMsgs * 1e2 : 0.0);
+    ioOutputStr("stats SPARTN   count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nSpartn,  parser->nMsgs > 0 ? (double)parser->nSpartn  / (double)parser->nMsgs * 1e2 : 0.0, parser->sSpartn,  parser->sMsgs > 0 ? (double)parser->sSpartn  / (double)parser->sMsgs * 1e2 : 0.0);
+    ioOutputStr("stats NOVATEL  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nNovatel, parser->nMsgs > 0 ? (double)parser->nNovatel / (double)parser->nMsgs * 1e2 : 0.0, parser->sNovatel, parser->sMsgs > 0 ? (double)parser->sNovatel / (double)parser->sMsgs * 1e2 : 0.0);
+    ioOutputStr("stats GARBAGE  count %6u (%5.1f%%)  size %10u (%5.1f%%)\n", parser->nGarbage, parser->nMsgs > 0 ? (double)parser->nGarbage / (double)parser->nMsgs * 1e2 : 0.0, parser->sGarbage, parser->sMsgs > 0 ? (double)parser->sGarbage / (double)parser->sMsgs * 1e2 : 0.0);
+    ioOutputStr("stats Total    count %6u (100.0%%)  size %10u (100.0%%)\n", parser->nMsgs, parser->sMsgs);
+    if (doEpoch)
+    {
+        ioOutputStr("stats EPOCH    count %6u (%5.1f%%)\n", nEpochs, parser->nMsgs > 0 ? (double)nEpochs / (double)parser->nMsgs * 1e2 : 0.0);
+    }
+}
+
+/* ****************************************************************************************************************** */
+
+// Parsing using the index: With a message filter the selected messages are taken from the index and parsed one by one
+// (the parser is empty after each message). Otherwise the input is parsed from the start of the time range to its end.
+
+static int _parseIndexed(INDEX_t *index, const bool extraInfo, const bool doEpoch, const EPOCHFMT_t epochFmt,
+    const bool doMsgs, const char *timeRange, const char *msgFilter)
+{
+    uint64_t size = 0;
+    const uint8_t *data = ioMapInput(&size);
+    uint64_t startOffs = 0;
+    uint64_t endOffs = size;
+    uint32_t startSeq = 1;
+    if ( (timeRange != NULL) && !indexTimeRange(index, timeRange, &startOffs, &startSeq, &endOffs) )
+    {
+        return EXIT_BADARGS;
+    }
+
+    // Select messages
+    const INDEX_MSG_t **sel = NULL;
+    uint64_t numSel = 0;
+    if (msgFilter != NULL)
+    {
+        sel = indexSelect(index, msgFilter, startOffs, endOffs, &numSel);
+        if (sel == NULL)
+        {
+            return EXIT_OTHERFAIL;
+        }
+    }
+
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    EPOCH_t *coll = calloc(1, sizeof(EPOCH_t));
+    EPOCH_t *epoch = calloc(1, sizeof(EPOCH_t));
+    if ( (parser == NULL) || (coll == NULL) || (epoch == NULL) || !epochInit(coll) || !epochInit(epoch) ||
+        !ioEpochOutputBegin(epochFmt) )
+    {
+        free(sel);
+        free(parser);
+        epochFree(coll);
+        epochFree(epoch);
+        free(coll);
+        free(epoch);
+        return EXIT_OTHERFAIL;
+    }
+    parserInit(parser);
+    parserSetTs(parser, PARSER_TS_NONE, NULL, NULL);
+
+    bool res = true;
+    uint32_t nEpochs = 0;
+    uint64_t selIx = 0;
+    uint32_t selSeq = 0;
+    uint64_t inOffs = startOffs;
+    uint64_t msgOffs = startOffs;
+    while (res && !gAbort)
+    {
+        PARSER_MSG_t msg;
+        uint32_t seq = 0;
+        // Next selected message, the messages parsed from it (normally only one) get consecutive sequence numbers
+        if (sel != NULL)
+        {
+            if (parserProcess(parser, &msg, true) || parserFlush(parser, &msg))
+            {
+                seq = selSeq++;
+            }
+            else if (selIx < numSel)
+            {
+                parserAdd(parser, &data[sel[selIx]->offs], sel[selIx]->size);
+                selSeq = sel[selIx]->seq;
+                selIx++;
+                continue;
+            }
+            else
+            {
+                break;
+            }
+        }
+        // Next message in range
+        else
+        {
+            if ( (inOffs < size) && ((parser->offs + parser->size) < PARSE_FILL_LEVEL) )
+            {
+                const int num = (int)MIN((uint64_t)parserSpace(parser), size - inOffs);
+                parserAdd(parser, &data[inOffs], num);
+                inOffs += num;
+            }
+            if ( !parserProcess(parser, &msg, true) && !((inOffs >= size) && parserFlush(parser, &msg)) )
+            {
+                if (inOffs >= size)
+                {
+                    break;
+                }
+                continue;
+            }
+            if (msgOffs >= endOffs)
+            {
+                _parserUncount(parser, &msg);
+                break;
+            }
+            msgOffs += msg.size;
+            seq = msg.seq + startSeq - 1;
+        }
+
+        if (doEpoch && epochCollect(coll, &msg, epoch))
+        {
+            nEpochs++;
+            _outputEpoch(epoch, nEpochs, epochFmt);
+        }
+        if (doMsgs)
+        {
+            _outputMsg(&msg, seq, extraInfo);
+        }
+        res = ioWriteOutput(parser->nMsgs == 1 ? false : true);
+    }
+
+    ioEpochOutputEnd();
+    if (res)
+    {
+        if (doMsgs)
+        {
+            _outputStats(parser, doEpoch, nEpochs);
+        }
+        res = ioWriteOutput(true);
+    }
+
+    free(sel);
+    free(parser);
+    epochFree(coll);
+    epochFree(epoch);
+    free(coll);
+    free(epoch);
+    return res ? EXIT_SUCCESS : EXIT_OTHERFAIL;
+}
+
+/* ****************************************************************************************************************** */
+
+// Parsing concurrently works like this:
+// - The input is split into regions, for each region the start of the first message (the "sync point") is found
+// - Each region is parsed by a job (thread) starting at its sync point
+// - A job continues past the end of its region until it finds a message that starts exactly at the sync point of a
+//   later region. As the parser result depends only on the data (see PARSE_FILL_LEVEL), the output of that later job
+//   is the same as if this job had continued. If the sync point turns out to be wrong (e.g. a message found inside the
+//   payload of another message), the job just continues to the next sync point.
+// - The output of the jobs is stitched together in the main thread, which also adds the message sequence numbers.
+
+typedef struct PARSE_JOB_s
+{
+    int             ix;
+    const uint8_t  *data;      // Entire input
+    uint64_t        size;
+    const uint64_t *starts;    // Sync points of all jobs
+    int             numJobs;
+    bool            extraInfo;
+    FILE           *out;       // Output records (see _parseJob())
+    int             stopIx;    // Job at whose sync point this job stopped, numJobs if it stopped at the end of input
+    bool            ok;
+    PARSER_t        parser;    // Parser, and statistics of the output messages
+    pthread_t       thread;
+
+} PARSE_JOB_t;
+
+// Find start of first message at or after offs
+static uint64_t _parseSync(const uint8_t *data, const uint64_t size, const uint64_t offs)
+{
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    if (parser == NULL)
+    {
+        return size;
+    }
+    parserInit(parser);
+    parserSetTs(parser, PARSER_TS_NONE, NULL, NULL);
+    uint64_t inOffs = offs;
+    uint64_t msgOffs = offs;
+    uint64_t syncOffs = size;
+    while (true)
+    {
+        if ( (inOffs < size) && ((parser->offs + parser->size) < PARSE_FILL_LEVEL) )
+        {
+            const int num = (int)MIN((uint64_t)parserSpace(parser), size - inOffs);
+            parserAdd(parser, &data[inOffs], num);
+            inOffs += num;
+        }
+        PARSER_MSG_t msg;
+        if (parserProcess(parser, &msg, false))
+        {
+            if (msg.type != PARSER_MSGTYPE_GARBAGE)
+            {
+                syncOffs = msgOffs;
+                break;
+            }
+            msgOffs += msg.size;
+        }
+        else if (inOffs >= size)
+        {
+            break;
+        }
+    }
+    free(parser);
+    return syncOffs;
+}
+
+static void _parserUncount(PARSER_t *parser, const PARSER_MSG_t *msg)
+{
+    parser->nMsgs--;
+    parser->sMsgs -= msg->size;
+    switch (msg->type)
+    {
+        case PARSER_MSGTYPE_UBX:     parser->nUbx--;     parser->sUbx     -= msg->size; break;
+        case PARSER_MSGTYPE_NMEA:    parser->nNmea--;    parser->sNmea    -= msg->size; break;
+        case PARSER_MSGTYPE_RTCM3:   parser->nRtcm3--;   parser->sRtcm3   -= msg->size; break;
+        case PARSER_MSGTYPE_SPARTN:  parser->nSpartn--;  parser->sSpartn  -= msg->size; break;
+        case PARSER_MSGTYPE_NOVATEL: parser->nNovatel--; parser->sNovatel -= msg->size; break;
+        case PARSER_MSGTYPE_GARBAGE: parser->nGarbage--; parser->sGarbage -= msg->size; break;
+    }
+}
+
+static void _parserAddStats(PARSER_t *sum, const PARSER_t *parser)
+{
+    sum->nMsgs    += parser->nMsgs;    sum->sMsgs    += parser->sMsgs;
+    sum->nUbx     += parser->nUbx;     sum->sUbx     += parser->sUbx;
+    sum->nNmea    += parser->nNmea;    sum->sNmea    += parser->sNmea;
+    sum->nRtcm3   += parser->nRtcm3;   sum->sRtcm3   += parser->sRtcm3;
+    sum->nSpartn  += parser->nSpartn;  sum->sSpartn  += parser->sSpartn;
+    sum->nNovatel += parser->nNovatel; sum->sNovatel += parser->sNovatel;
+    sum->nGarbage += parser->nGarbage; sum->sGarbage += parser->sGarbage;
+}
+
+// Output record: uint32_t size, followed by the output for the message without the leading "message <seq>"
+static bool _parseJobOutput(PARSE_JOB_t *job, const PARSER_MSG_t *msg, char *str, const int strSize)
+{
+    int len = snprintf(str, strSize, ", size %4d, %-8s %-20s %s\n",
+        msg->size, parserMsgtypeName(msg->type), msg->name, msg->info != NULL ? msg->info : "n/a");
+    len = MIN(len, strSize - 1);
+    if (job->extraInfo)
+    {
+        for (int ix = 0; (ix < msg->size) && ((len + IO_HEXDUMP_LINE_SIZE) < strSize); ix += 16)
+        {
+            len += ioHexdumpLine(&str[len], msg->data, msg->size, ix);
+        }
+    }
+    const uint32_t size = len;
+    return (fwrite(&size, sizeof(size), 1, job->out) == 1) && (fwrite(str, 1, len, job->out) == (size_t)len);
+}
+
+static void *_parseJob(void *arg)
+{
+    PARSE_JOB_t *job = (PARSE_JOB_t *)arg;
+    PARSER_t *parser = &job->parser;
+    parserInit(parser);
+    parserSetTs(parser, PARSER_TS_NONE, NULL, NULL);
+
+    const int strSize = PARSE_STR_SIZE;
+    char *str = malloc(strSize);
+    job->ok = (str != NULL);
+
+    uint64_t inOffs = job->starts[job->ix];
+    uint64_t msgOffs = inOffs;
+    int nextIx = job->ix + 1;
+    job->stopIx = job->numJobs;
+    while (job->ok && !gAbort)
+    {
+        if ( (inOffs < job->size) && ((parser->offs + parser->size) < PARSE_FILL_LEVEL) )
+        {
+            const int num = (int)MIN((uint64_t)parserSpace(parser), job->size - inOffs);
+            parserAdd(parser, &job->data[inOffs], num);
+            inOffs += num;
+        }
+
+        PARSER_MSG_t msg;
+        const bool haveMsg = parserProcess(parser, &msg, true);
+        const bool lastMsg = !haveMsg && (inOffs >= job->size);
+        if ( !haveMsg && !(lastMsg && parserFlush(parser, &msg)) )
+        {
+            if (lastMsg)
+            {
+                break;
+            }
+            continue;
+        }
+
+        // Stop if we're in sync with a later job
+        while ( (nextIx < job->numJobs) && (job->starts[nextIx] < msgOffs) )
+        {
+            nextIx++;
+        }
+        if ( (nextIx < job->numJobs) && (job->starts[nextIx] == msgOffs) && (msg.type != PARSER_MSGTYPE_GARBAGE) )
+        {
+            _parserUncount(parser, &msg);
+            job->stopIx = nextIx;
+            break;
+        }
+        msgOffs += msg.size;
+
+        job->ok = _parseJobOutput(job, &msg, str, strSize);
+        if (lastMsg)
+        {
+            break;
+        }
+    }
+
+    free(str);
+    TRACE("job %d: start=%" PRIu64 " end=%" PRIu64 " stop=%d nMsgs=%u ok=%d",
+        job->ix, job->starts[job->ix], msgOffs, job->stopIx, parser->nMsgs, job->ok);
+    return NULL;
+}
+
+static int _parseParallel(const bool extraInfo, const int numJobs)
+{
+    uint64_t size = 0;
+    const uint8_t *data = ioMapInput(&size);
+    // Find sync points, drop regions without any message
+    uint64_t *starts = calloc(numJobs, sizeof(uint64_t));
+    PARSE_JOB_t *jobs = calloc(numJobs, sizeof(PARSE_JOB_t));
+    char *str = malloc(PARSE_STR_SIZE);
+    PARSER_t *stats = malloc(sizeof(PARSER_t));
+    if ( (starts == NULL) || (jobs == NULL) || (str == NULL) || (stats == NULL) )
+    {
+        free(starts);
+        free(jobs);
+        free(str);
+        free(stats);
+        return EXIT_OTHERFAIL;
+    }
+    int nJobs = 1;
+    for (int ix = 1; ix < numJobs; ix++)
+    {
+        const uint64_t start = _parseSync(data, size, size * ix / numJobs);
+        if ( (start < size) && (start > starts[nJobs - 1]) )
+        {
+            starts[nJobs++] = start;
+        }
+    }
+    DEBUG("Parsing %" PRIu64 " bytes using %d jobs", size, nJobs);
+
+    // Start jobs
+    bool res = true;
+    for (int ix = 0; ix < nJobs; ix++)
+    {
+        PARSE_JOB_t *job = &jobs[ix];
+        job->ix        = ix;
+        job->data      = data;
+        job->size      = size;
+        job->starts    = starts;
+        job->numJobs   = nJobs;
+        job->extraInfo = extraInfo;
+        job->out       = tmpfile();
+        if ( (job->out == NULL) || (pthread_create(&job->thread, NULL, _parseJob, job) != 0) )
+        {
+            WARNING("Failed starting job: %s", strerror(errno));
+            if (job->out != NULL)
+            {
+                fclose(job->out);
+                job->out = NULL;
+            }
+            res = false;
+            gAbort = true;
+            break;
+        }
+    }
+
+    // Collect the output of the jobs in sync
+    parserInit(stats);
+    int nextIx = 0;
+    for (int ix = 0; ix < nJobs; ix++)
+    {
+        PARSE_JOB_t *job = &jobs[ix];
+        if (job->out == NULL)
+        {
+            continue;
+        }
+        pthread_join(job->thread, NULL);
+        if (ix == nextIx)
+        {
+            nextIx = job->stopIx;
+            res = res && job->ok && (fflush(job->out) == 0) && (fseek(job->out, 0, SEEK_SET) == 0);
+            _parserAddStats(stats, &job->parser);
+            for (uint32_t n = 0; res && (n < job->parser.nMsgs); n++)
+            {
+                uint32_t len = 0;
+                res = (fread(&len, sizeof(len), 1, job->out) == 1) && (len <= PARSE_STR_SIZE) &&
+                    (fread(str, 1, len, job->out) == len);
+                if (res)
+                {
+                    const uint32_t seq = stats->nMsgs - job->parser.nMsgs + n + 1;
+                    ioOutputStr("message %4u", seq);
+                    ioAddOutputBin((const uint8_t *)str, len);
+                    res = ioWriteOutput(seq == 1 ? false : true);
+                }
+            }
+        }
+        fclose(job->out);
+    }
+
+    if (res)
+    {
+        _outputStats(stats, false, 0);
+        res = ioWriteOutput(true);
+    }
+
+    free(starts);
+    free(jobs);
+    free(str);
+    free(stats);
+    return res ? EXIT_SUCCESS : EXIT_OTHERFAIL;
+}
+
 /* ****************************************************************************************************************** */
 // eof
@@ -25,7 +25,8 @@
 
 const char *parseHelp(void);
 
-int parseRun(const bool extraInfo, const bool doEpoch);
+int parseRun(const char *inName, const bool extraInfo, const bool doEpoch, const char *epochFormat, const int numJobs,
+    const char *timeRange, const char *msgFilter);
 
 /* ****************************************************************************************************************** */
 #endif // __CFGTOOL_PARSE_H__
@@ -0,0 +1,568 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef _WIN32
+#  include <io.h>
+#endif
+
+#include "cfgtool_util.h"
+
+#include "ff_rx.h"
+#include "ff_rxlog.h"
+
+#include "cfgtool_record.h"
+
+/* ****************************************************************************************************************** */
+
+const char *recordHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'record':\n"
+"\n"
+"    Usage: cfgtool record -p <port> -o <outfile> [-y] [-n] [-f <format>]\n"
+"                          [-S <size>] [-T <duration>]\n"
+"\n"
+"    Connects to the receiver and records the received data until SIGINT\n"
+"    (e.g. CTRL-C)"NOT_WIN(", SIGHUP")" or SIGTERM is received. The <format> is 'raw' (default),\n"
+"    which records the data as received, or 'log', which records each message\n"
+"    with its source and arrival time (see ff_rxlog.h).\n"
+"\n"
+"    With -S <size> (bytes, or with suffix k, M or G) and -T <duration>\n"
+"    (seconds, or with suffix s, m or h) a new output file is started when the\n"
+"    current file reaches that size resp. after that time. The <outfile> is a\n"
+"    strftime(3) format (UTC) for the file names. If the file exists (and -y\n"
+"    is not given) a number is appended to the name. Files are synced to disk\n"
+"    when they are closed. Statistics (bytes, messages, garbage) are printed for\n"
+"    each file.\n"
+"\n"
+"    The data is written to the file(s) by a separate thread, so that slow\n"
+"    storage does not block receiving. Only if the storage is too slow for\n"
+"    too long, data is dropped (and reported).\n"
+"\n"
+"    Returns success (0) if receiver was detected and at least one message was\n"
+"    received. Otherwise returns "STRINGIFY(EXIT_RXFAIL)" (rx not detected), "STRINGIFY(EXIT_RXNODATA)" (no messages)\n"
+"    or "STRINGIFY(EXIT_OTHERFAIL)" (failed writing output).\n"
+"\n"
+"    Examples:\n"
+"\n"
+#ifdef _WIN32
+"        cfgtool record -p COM3 -o rec.ubx\n"
+#else
+"        cfgtool record -p /dev/ttyACM0 -o rec.ubx\n"
+"        cfgtool record -p /dev/ttyACM0 -o rec_%Y%m%d_%H%M.ubx -T 1h -n\n"
+"        cfgtool record -p tcp://rx:12345 -o rec_%Y%m%d.log -f log -S 1G\n"
+#endif
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        if (!gAbort)
+        {
+            PRINT("Aborting...");
+        }
+        gAbort = true;
+    }
+}
+
+// The receiver (main thread) adds the messages to the fill buffer. Every REC_SWAP_INTERVAL (or when it's full) it
+// hands it over to the writer thread and continues with the other buffer. If the writer is still busy with the other
+// buffer, the fill buffer grows (up to REC_BUF_SIZE_MAX, after which data is dropped).
+#define REC_BUF_SIZE       (4 * 1024 * 1024)
+#define REC_BUF_SIZE_MAX   (256 * 1024 * 1024)
+#define REC_SWAP_INTERVAL  100
+
+// Messages in the buffers
+typedef struct REC_HEAD_s
+{
+    uint64_t ts;
+    uint16_t size;
+    uint8_t  src;
+    uint8_t  type;
+    uint8_t  pad[4];
+
+} REC_HEAD_t;
+
+typedef struct REC_STATS_s
+{
+    uint64_t bytes;
+    uint32_t msgs;
+    uint32_t garbage;
+    uint64_t garbageBytes;
+    uint32_t dropped;
+    uint64_t t0;
+
+} REC_STATS_t;
+
+typedef struct REC_BUF_s
+{
+    uint8_t    *data;
+    int         size;
+    int         alloc;
+    bool        rotate;     // Close file after writing this buffer
+    REC_STATS_t stats;      // Statistics of the file (if rotate)
+
+} REC_BUF_t;
+
+typedef struct REC_s
+{
+    // Shared
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    REC_BUF_t       bufs[2];
+    int             fillIx;     // Buffer the receiver fills, the other is (being) written if pending
+    bool            pending;
+    bool            stop;
+    bool            error;
+    // Writer
+    const char     *outName;
+    bool            overwrite;
+    bool            doLog;
+    char            path[PATH_MAX];
+    FILE           *file;
+    RXLOG_t        *log;
+    pthread_t       thread;
+
+} REC_t;
+
+static bool _recOpen(REC_t *rec)
+{
+    // Output to stdout
+    if ( !rec->doLog && (strcmp(rec->outName, "-") == 0) )
+    {
+        rec->file = stdout;
+        snprintf(rec->path, sizeof(rec->path), "-");
+        return true;
+    }
+
+    // Make file name, add number if it exists
+    char name[PATH_MAX - 20];
+    const time_t now = time(NULL);
+    struct tm tm;
+    NOT_WIN( gmtime_r(&now, &tm) );
+    IF_WIN( tm = *gmtime(&now) );
+    if (strftime(name, sizeof(name), rec->outName, &tm) == 0)
+    {
+        WARNING("Bad output file name '%s'!", rec->outName);
+        return false;
+    }
+    snprintf(rec->path, sizeof(rec->path), "%s", name);
+    for (int n = 1; !rec->overwrite && (access(rec->path, F_OK) == 0); n++)
+    {
+        snprintf(rec->path, sizeof(rec->path), "%s.%d", name, n);
+    }
+
+    if (rec->doLog)
+    {
+        rec->log = rxlogCreate(rec->path, false, 0);
+    }
+    else
+    {
+        rec->file = fopen(rec->path, "wb");
+        if (rec->file == NULL)
+        {
+            WARNING("Failed opening '%s' for writing: %s!", rec->path, strerror(errno));
+        }
+    }
+    if ( (rec->log == NULL) && (rec->file == NULL) )
+    {
+        return false;
+    }
+    PRINT("Recording to %s", rec->path);
+    return true;
+}
+
+static bool _recClose(REC_t *rec, const REC_STATS_t *stats)
+{
+    bool res = true;
+    if (rec->log != NULL)
+    {
+        res = rxlogSync(rec->log);
+        res = rxlogClose(rec->log) && res;
+        rec->log = NULL;
+    }
+    else if (rec->file == stdout)
+    {
+        res = (fflush(rec->file) == 0);
+        rec->file = NULL;
+    }
+    else if (rec->file != NULL)
+    {
+        res = (fflush(rec->file) == 0);
+#ifdef _WIN32
+        res = res && (_commit(fileno(rec->file)) == 0);
+#else
+        res = res && (fsync(fileno(rec->file)) == 0);
+#endif
+        res = (fclose(rec->file) == 0) && res;
+        rec->file = NULL;
+    }
+    if (!res)
+    {
+        WARNING("Failed writing '%s': %s", rec->path, strerror(errno));
+    }
+
+    const double dt = (double)(TIME() - stats->t0) * 1e-3;
+    PRINT("Recorded %s: %.1fs, %" PRIu64 " bytes (%.1f kB/s), %u messages, %u garbage (%" PRIu64 " bytes), %u dropped",
+        rec->path, dt, stats->bytes, dt > 0.0 ? (double)stats->bytes / dt * 1e-3 : 0.0,
+        stats->msgs, stats->garbage, stats->garbageBytes, stats->dropped);
+    return res;
+}
+
+static bool _recWriteBuf(REC_t *rec, const REC_BUF_t *buf)
+{
+    int offs = 0;
+    while (offs < buf->size)
+    {
+        REC_HEAD_t head;
+        memcpy(&head, &buf->data[offs], sizeof(head));
+        const uint8_t *data = &buf->data[offs + sizeof(head)];
+        offs += sizeof(head) + head.size;
+        if (rec->log != NULL)
+        {
+            if (!rxlogWrite(rec->log, head.ts, (PARSER_MSGSRC_t)head.src, (PARSER_MSGTYPE_t)head.type, data, head.size))
+            {
+                return false;
+            }
+        }
+        else if (fwrite(data, head.size, 1, rec->file) != 1)
+        {
+            WARNING("Failed writing '%s': %s", rec->path, strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *_recWriter(void *arg)
+{
+    REC_t *rec = (REC_t *)arg;
+    pthread_mutex_lock(&rec->mutex);
+    while (true)
+    {
+        while (!rec->pending && !rec->stop)
+        {
+            pthread_cond_wait(&rec->cond, &rec->mutex);
+        }
+        if (!rec->pending)
+        {
+            break;
+        }
+        REC_BUF_t *buf = &rec->bufs[1 - rec->fillIx];
+        pthread_mutex_unlock(&rec->mutex);
+
+        bool ok = true;
+        if ( (rec->file == NULL) && (rec->log == NULL) && (buf->size > 0) )
+        {
+            ok = _recOpen(rec);
+        }
+        ok = ok && _recWriteBuf(rec, buf);
+        if ( buf->rotate && ((rec->file != NULL) || (rec->log != NULL)) )
+        {
+            ok = _recClose(rec, &buf->stats) && ok;
+        }
+
+        pthread_mutex_lock(&rec->mutex);
+        buf->size = 0;
+        buf->rotate = false;
+        rec->pending = false;
+        if (!ok)
+        {
+            rec->error = true;
+        }
+    }
+    pthread_mutex_unlock(&rec->mutex);
+    return NULL;
+}
+
+// Hand over fill buffer to the writer, returns false if the writer is still busy
+static bool _recSwap(REC_t *rec, const bool rotate, const REC_STATS_t *stats)
+{
+    bool res = false;
+    pthread_mutex_lock(&rec->mutex);
+    if (!rec->pending)
+    {
+        REC_BUF_t *buf = &rec->bufs[rec->fillIx];
+        buf->rotate = rotate;
+        buf->stats = *stats;
+        rec->fillIx = 1 - rec->fillIx;
+        rec->pending = true;
+        pthread_cond_signal(&rec->cond);
+        res = true;
+    }
+    pthread_mutex_unlock(&rec->mutex);
+    return res;
+}
+
+static bool _recAdd(REC_t *rec, const uint64_t ts, const PARSER_MSG_t *msg)
+{
+    // The fill buffer is ours, no need to lock
+    REC_BUF_t *buf = &rec->bufs[rec->fillIx];
+    const int size = sizeof(REC_HEAD_t) + msg->size;
+    if ( (buf->size + size) > buf->alloc )
+    {
+        const int alloc = buf->alloc + REC_BUF_SIZE;
+        uint8_t *data = alloc <= REC_BUF_SIZE_MAX ? realloc(buf->data, alloc) : NULL;
+        if (data == NULL)
+        {
+            return false;
+        }
+        buf->data = data;
+        buf->alloc = alloc;
+    }
+    const REC_HEAD_t head = { .ts = ts, .size = msg->size, .src = msg->src, .type = msg->type };
+    memcpy(&buf->data[buf->size], &head, sizeof(head));
+    memcpy(&buf->data[buf->size + sizeof(head)], msg->data, msg->size);
+    buf->size += size;
+    return true;
+}
+
+static bool _parseSuffix(const char *str, const char *suffixes, const uint64_t *mults, uint64_t *val)
+{
+    if (str == NULL)
+    {
+        *val = 0;
+        return true;
+    }
+    double v = 0.0;
+    char suffix = '\0';
+    int n = 0;
+    const int num = sscanf(str, "%lf%c%n", &v, &suffix, &n);
+    if ( (v <= 0.0) || !( (num == 1) || ( (num == 2) && (str[n] == '\0') && (strchr(suffixes, suffix) != NULL) ) ) )
+    {
+        return false;
+    }
+    *val = (uint64_t)(v * (double)(num == 2 ? mults[strchr(suffixes, suffix) - suffixes] : 1));
+    return *val > 0;
+}
+
+int recordRun(const char *portArg, const char *outName, const bool overwrite, const bool noProbe,
+    const char *format, const char *rotateSize, const char *rotateTime)
+{
+    const uint64_t sizeMults[] = { 1000, 1000000, 1000000000 };
+    const uint64_t timeMults[] = { 1, 60, 3600 };
+    uint64_t rotSize = 0;
+    uint64_t rotTime = 0;
+    if (!_parseSuffix(rotateSize, "kMG", sizeMults, &rotSize))
+    {
+        WARNING("Illegal size '-S %s'!", rotateSize);
+        return EXIT_BADARGS;
+    }
+    if (!_parseSuffix(rotateTime, "smh", timeMults, &rotTime))
+    {
+        WARNING("Illegal duration '-T %s'!", rotateTime);
+        return EXIT_BADARGS;
+    }
+    rotTime *= 1000;
+    const bool doLog = (format != NULL) && (strcmp(format, "log") == 0);
+    if ( (format != NULL) && !doLog && (strcmp(format, "raw") != 0) )
+    {
+        WARNING("Illegal format '-f %s'!", format);
+        return EXIT_BADARGS;
+    }
+    if ( (strcmp(outName, "-") == 0) && (doLog || (rotSize > 0) || (rotTime > 0)) )
+    {
+        WARNING("Need '-o <outfile>' for -f log, -S and -T!");
+        return EXIT_BADARGS;
+    }
+
+    REC_t *rec = calloc(1, sizeof(REC_t));
+    if (rec == NULL)
+    {
+        return EXIT_OTHERFAIL;
+    }
+    rec->outName   = outName;
+    rec->overwrite = overwrite;
+    rec->doLog     = doLog;
+    for (int ix = 0; ix < NUMOF(rec->bufs); ix++)
+    {
+        rec->bufs[ix].data = malloc(REC_BUF_SIZE);
+        rec->bufs[ix].alloc = REC_BUF_SIZE;
+    }
+    pthread_mutex_init(&rec->mutex, NULL);
+    pthread_cond_init(&rec->cond, NULL);
+
+    RX_OPTS_t opts = RX_OPTS_DEFAULT();
+    if (noProbe)
+    {
+        opts.autobaud = false;
+        opts.detect   = RX_DET_NONE;
+    }
+    RX_t *rx = NULL;
+    int res = EXIT_SUCCESS;
+    if ( (rec->bufs[0].data == NULL) || (rec->bufs[1].data == NULL) )
+    {
+        res = EXIT_OTHERFAIL;
+    }
+    // Open (first) output file now, so that we fail early
+    else if (!_recOpen(rec))
+    {
+        res = EXIT_OTHERFAIL;
+    }
+    else
+    {
+        rx = rxInit(portArg, &opts);
+        if ( (rx == NULL) || !rxOpen(rx) )
+        {
+            res = EXIT_RXFAIL;
+        }
+    }
+    if ( (res == EXIT_SUCCESS) && (pthread_create(&rec->thread, NULL, _recWriter, rec) != 0) )
+    {
+        WARNING("Failed starting writer: %s", strerror(errno));
+        res = EXIT_OTHERFAIL;
+    }
+    if (res != EXIT_SUCCESS)
+    {
+        if (rx != NULL)
+        {
+            rxClose(rx);
+            free(rx);
+        }
+        if (rec->file != NULL)
+        {
+            fclose(rec->file);
+        }
+        rxlogClose(rec->log);
+        free(rec->bufs[0].data);
+        free(rec->bufs[1].data);
+        free(rec);
+        return res;
+    }
+
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    PRINT("Recording received data...");
+    REC_STATS_t stats = { .t0 = TIME() };
+    uint64_t tSwap = stats.t0;
+    uint32_t nMsgs = 0;
+    bool rotate = false;
+    bool error = false;
+    bool flushed = false;
+    while (!flushed && !error)
+    {
+        // Get next message, or at the end whatever is left in the parser (one message at a time, until it's empty)
+        PARSER_MSG_t *msg = NULL;
+        if (!gAbort)
+        {
+            msg = rxGetNextMessage(rx);
+        }
+        else
+        {
+            msg = rxFlushMessage(rx);
+            flushed = (msg == NULL);
+        }
+        const uint64_t now = TIME();
+        if (msg != NULL)
+        {
+            nMsgs++;
+            if (_recAdd(rec, timeMonoNs(), msg))
+            {
+                stats.bytes += msg->size;
+                stats.msgs++;
+                if (msg->type == PARSER_MSGTYPE_GARBAGE)
+                {
+                    stats.garbage++;
+                    stats.garbageBytes += msg->size;
+                }
+            }
+            else
+            {
+                if (stats.dropped == 0)
+                {
+                    WARNING("Output too slow, dropping data!");
+                }
+                stats.dropped++;
+            }
+            if ( ( (rotSize > 0) && (stats.bytes >= rotSize) ) || ( (rotTime > 0) && ((now - stats.t0) >= rotTime) ) )
+            {
+                rotate = true;
+            }
+        }
+        else if (!flushed)
+        {
+            SLEEP(5);
+        }
+
+        // Hand over data to the writer, start new file if necessary
+        const REC_BUF_t *buf = &rec->bufs[rec->fillIx];
+        if ( (rotate || (buf->size >= REC_BUF_SIZE) || (((now - tSwap) >= REC_SWAP_INTERVAL) && (buf->size > 0))) &&
+             _recSwap(rec, rotate, &stats) )
+        {
+            tSwap = now;
+            if (rotate)
+            {
+                rotate = false;
+                memset(&stats, 0, sizeof(stats));
+                stats.t0 = now;
+            }
+        }
+
+        pthread_mutex_lock(&rec->mutex);
+        error = rec->error;
+        pthread_mutex_unlock(&rec->mutex);
+    }
+
+    // Write remaining data and stop writer
+    while (!error && !_recSwap(rec, true, &stats))
+    {
+        SLEEP(5);
+    }
+    pthread_mutex_lock(&rec->mutex);
+    rec->stop = true;
+    pthread_cond_signal(&rec->cond);
+    pthread_mutex_unlock(&rec->mutex);
+    pthread_join(rec->thread, NULL);
+    if ( (rec->file != NULL) || (rec->log != NULL) )
+    {
+        _recClose(rec, &stats);
+    }
+
+    rxClose(rx);
+    free(rx);
+    error = rec->error;
+    pthread_mutex_destroy(&rec->mutex);
+    pthread_cond_destroy(&rec->cond);
+    free(rec->bufs[0].data);
+    free(rec->bufs[1].data);
+    free(rec);
+
+    return error ? EXIT_OTHERFAIL : (nMsgs > 0 ? EXIT_SUCCESS : EXIT_RXNODATA);
+}
+
+/* ****************************************************************************************************************** */
+// eof
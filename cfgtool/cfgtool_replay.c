@@ -0,0 +1,365 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <math.h>
+#include <signal.h>
+
+#include "cfgtool_util.h"
+
+#include "ff_port.h"
+#include "ff_parser.h"
+#include "ff_epoch.h"
+#include "ff_rxlog.h"
+
+#include "cfgtool_replay.h"
+
+/* ****************************************************************************************************************** */
+
+const char *replayHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'replay':\n"
+"\n"
+"    Usage: cfgtool replay -i <infile> -p <port> [-s <speed>]\n"
+"\n"
+"    Sends the messages from the input file to a port (for example, to test\n"
+"    an application that connects to a receiver). The messages are sent with\n"
+"    their original timing, or faster or slower by a factor <speed> (e.g. '10'\n"
+"    or '0.5', default '1'), or as fast as possible (<speed> 'max').\n"
+"\n"
+"    For logs from the 'record' command (-f log) the timing is given by the\n"
+"    recorded arrival times of the messages. Only the messages received from\n"
+"    the receiver are sent. For other input the timing is reconstructed from\n"
+"    the navigation epochs (GPS time) in the data: all messages of an epoch\n"
+"    are sent at once at the time of the epoch.\n"
+"\n"
+"    Returns success (0) if all messages were sent, "STRINGIFY(EXIT_OTHERFAIL)" otherwise.\n"
+"\n"
+"    Examples:\n"
+"\n"
+"        cfgtool replay -i rec.log -p tcp://localhost:12345\n"
+"        cfgtool replay -i data.ubx -p /dev/ttyUSB0:921600 -s max\n"
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        PRINT("Aborting...");
+        gAbort = true;
+    }
+}
+
+// Messages that are due are collected in the output buffer. It is written to the port before sleeping until the next
+// message is due (or when it's full), so that we don't do a write() for each message when sending fast.
+#define REPLAY_OUT_SIZE (64 * 1024)
+
+typedef struct REPLAY_s
+{
+    PORT_t    port;
+    double    speed;       // Speed factor, 0 = max
+    bool      anchored;    // Have time reference
+    uint64_t  refTs;       // Time reference: message timestamp [ns]..
+    uint64_t  refMono;     // ..and the corresponding monotonic time [ns]
+    uint64_t  lastTs;      // Last message timestamp [ns]
+    uint8_t   out[REPLAY_OUT_SIZE];
+    int       outSize;
+    bool      error;
+    uint32_t  nMsgs;
+    uint64_t  nBytes;
+    uint64_t  maxLate;     // Maximum lateness [ns]
+
+} REPLAY_t;
+
+static bool _replayFlush(REPLAY_t *rp)
+{
+    if ( !rp->error && (rp->outSize > 0) && !portWrite(&rp->port, rp->out, rp->outSize) )
+    {
+        WARNING("Failed writing to port!");
+        rp->error = true;
+    }
+    rp->outSize = 0;
+    return !rp->error;
+}
+
+// Send data at given time (or right away if !timed)
+static bool _replaySend(REPLAY_t *rp, const bool timed, const uint64_t ts, const uint8_t *data, const int size)
+{
+    if (timed && (rp->speed > 0.0))
+    {
+        // Start, or re-start if time goes backwards (e.g. concatenated logs)
+        if (!rp->anchored || (ts < rp->lastTs))
+        {
+            rp->anchored = true;
+            rp->refTs = ts;
+            rp->refMono = timeMonoNs();
+        }
+        rp->lastTs = ts;
+        const uint64_t deadline = rp->refMono + (uint64_t)((double)(ts - rp->refTs) / rp->speed);
+        const uint64_t now = timeMonoNs();
+        if (deadline > now)
+        {
+            if (!_replayFlush(rp))
+            {
+                return false;
+            }
+            while (!gAbort && !sleepUntilMonoNs(deadline))
+            {
+                // interrupted, try again
+            }
+        }
+        else if ((now - deadline) > rp->maxLate)
+        {
+            rp->maxLate = now - deadline;
+        }
+    }
+
+    int offs = 0;
+    while ( (offs < size) && !rp->error )
+    {
+        if (rp->outSize >= REPLAY_OUT_SIZE)
+        {
+            _replayFlush(rp);
+        }
+        const int num = MIN(size - offs, REPLAY_OUT_SIZE - rp->outSize);
+        memcpy(&rp->out[rp->outSize], &data[offs], num);
+        rp->outSize += num;
+        offs += num;
+    }
+    rp->nBytes += size;
+    return !rp->error;
+}
+
+// Replay log from the 'record' command, using the recorded timestamps
+static void _replayLog(REPLAY_t *rp, const char *inName)
+{
+    RXLOG_t *log = rxlogOpen(inName);
+    if (log == NULL)
+    {
+        rp->error = true;
+        return;
+    }
+    RXLOG_REC_t rec;
+    while (!gAbort && !rp->error && rxlogRead(log, &rec))
+    {
+        if (rec.src == PARSER_MSGSRC_FROM_RX)
+        {
+            _replaySend(rp, true, rec.ts, rec.data, rec.size);
+            rp->nMsgs++;
+        }
+    }
+    rxlogClose(log);
+}
+
+// Replay other data, using the epoch timestamps. We collect the messages until an epoch is complete and then send
+// them all at the epoch time. Messages before the first epoch are sent right away.
+#define REPLAY_FILL_LEVEL (PARSER_BUF_SIZE / 2)
+
+static void _replayRaw(REPLAY_t *rp)
+{
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    if (!epochInit(&coll) || !epochInit(&epoch))
+    {
+        epochFree(&coll);
+        epochFree(&epoch);
+        rp->error = true;
+        return;
+    }
+    PARSER_t parser;
+    parserInit(&parser);
+    parserSetTs(&parser, PARSER_TS_NONE, NULL, NULL);
+    PARSER_MSG_t msg;
+
+    uint8_t *queue = NULL;
+    int queueSize = 0;
+    int queueAlloc = 0;
+    uint32_t queueMsgs = 0;
+    bool timed = false; // Have seen a timed epoch
+
+    bool eof = false;
+    bool done = false;
+    while (!done && !gAbort && !rp->error)
+    {
+        if (!eof && ((parser.offs + parser.size) < REPLAY_FILL_LEVEL))
+        {
+            const uint8_t *data = NULL;
+            const int num = ioGetInput(&data, parserSpace(&parser));
+            if (num < 0)
+            {
+                eof = true;
+            }
+            else if (num > 0)
+            {
+                parserAdd(&parser, data, num);
+            }
+        }
+
+        bool haveMsg = parserProcess(&parser, &msg, true);
+        if (!haveMsg && eof)
+        {
+            haveMsg = parserFlush(&parser, &msg);
+            done = true;
+        }
+        if (!haveMsg)
+        {
+            continue;
+        }
+
+        // Epoch complete, send messages collected so far. The epoch is completed by the first message of the next
+        // epoch, or by the UBX-NAV-EOE, which belongs to the completed epoch.
+        bool isEoe = false;
+        if (epochCollect(&coll, &msg, &epoch))
+        {
+            isEoe = (strcmp(msg.name, "UBX-NAV-EOE") == 0);
+            uint64_t ts = 0;
+            if (epoch.haveGpsTow)
+            {
+                timed = true;
+                ts = (uint64_t)llround(
+                    ((epoch.haveGpsWeek ? (double)epoch.gpsWeek * (7.0 * 86400.0) : 0.0) + epoch.gpsTow) * 1e9);
+            }
+            else
+            {
+                ts = rp->lastTs;
+            }
+            if (isEoe)
+            {
+                queueMsgs++;
+                _replaySend(rp, timed, ts, queue, queueSize);
+                _replaySend(rp, timed, ts, msg.data, msg.size);
+            }
+            else
+            {
+                _replaySend(rp, timed, ts, queue, queueSize);
+            }
+            rp->nMsgs += queueMsgs;
+            queueSize = 0;
+            queueMsgs = 0;
+        }
+        if (isEoe)
+        {
+            continue;
+        }
+
+        // Collect message
+        if ( (queueSize + msg.size) > queueAlloc )
+        {
+            const int alloc = queueAlloc + (PARSER_BUF_SIZE * 4);
+            uint8_t *q = realloc(queue, alloc);
+            if (q == NULL)
+            {
+                WARNING("Epoch too large!");
+                rp->error = true;
+                break;
+            }
+            queue = q;
+            queueAlloc = alloc;
+        }
+        memcpy(&queue[queueSize], msg.data, msg.size);
+        queueSize += msg.size;
+        queueMsgs++;
+    }
+
+    // Send the remaining messages (incomplete epoch)
+    if (!gAbort)
+    {
+        _replaySend(rp, false, 0, queue, queueSize);
+        rp->nMsgs += queueMsgs;
+    }
+    free(queue);
+    epochFree(&coll);
+    epochFree(&epoch);
+}
+
+int replayRun(const char *inName, const char *portArg, const char *speed)
+{
+    REPLAY_t *rp = calloc(1, sizeof(REPLAY_t));
+    if (rp == NULL)
+    {
+        return EXIT_OTHERFAIL;
+    }
+    rp->speed = 1.0;
+    if (speed != NULL)
+    {
+        int n = 0;
+        if (strcmp(speed, "max") == 0)
+        {
+            rp->speed = 0.0;
+        }
+        else if ( (sscanf(speed, "%lf%n", &rp->speed, &n) != 1) || (speed[n] != '\0') || !(rp->speed > 0.0) )
+        {
+            WARNING("Illegal speed '-s %s'!", speed);
+            free(rp);
+            return EXIT_BADARGS;
+        }
+    }
+
+    uint64_t inSize = 0;
+    const uint8_t *inData = ioMapInput(&inSize);
+    const bool isLog = (inData != NULL) && rxlogIsLog(inData, (int)MIN(inSize, (uint64_t)RXLOG_HEAD_SIZE));
+
+    if (!portInit(&rp->port, portArg) || !portOpen(&rp->port))
+    {
+        free(rp);
+        return EXIT_OTHERFAIL;
+    }
+    // We do our own timing, don't throttle TCP output to the (virtual) baudrate
+    if (rp->port.type == PORT_TYPE_TCP)
+    {
+        rp->port.baudrate = 0;
+    }
+
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    PRINT("Replaying %s (%s) to %s, speed %s", inName, isLog ? "log" : "raw", portArg,
+        rp->speed > 0.0 ? (speed != NULL ? speed : "1") : "max");
+    const uint64_t t0 = timeMonoNs();
+    if (isLog)
+    {
+        _replayLog(rp, inName);
+    }
+    else
+    {
+        _replayRaw(rp);
+    }
+    _replayFlush(rp);
+    const double dur = (double)(timeMonoNs() - t0) * 1e-9;
+
+    PRINT("Sent %" PRIu32 " messages, %" PRIu64 " bytes in %.1fs (%.1f kB/s), max. late %.1fms", rp->nMsgs,
+        rp->nBytes, dur, dur > 0.0 ? (double)rp->nBytes / dur * 1e-3 : 0.0, (double)rp->maxLate * 1e-6);
+
+    portClose(&rp->port);
+    const bool ok = !rp->error && !gAbort;
+    free(rp);
+    return ok ? EXIT_SUCCESS : EXIT_OTHERFAIL;
+}
+
+/* ****************************************************************************************************************** */
+// eof
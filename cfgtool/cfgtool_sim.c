@@ -0,0 +1,1232 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#define _GNU_SOURCE // posix_openpt() and friends
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <errno.h>
+#ifndef _WIN32
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <termios.h>
+#  include <sys/stat.h>
+#endif
+
+#include "cfgtool_util.h"
+
+#include "ff_port.h"
+#include "ff_parser.h"
+#include "ff_ubx.h"
+
+#include "cfgtool_fake.h"
+#include "cfgtool_sim.h"
+
+/* ****************************************************************************************************************** */
+
+#define SIM_DEFAULT_BAUDRATE  115200
+#define SIM_DEFAULT_MSGS      "UBX-NAV-PVT,UBX-NAV-EOE,NMEA-STANDARD-GGA,NMEA-STANDARD-RMC"
+#define SIM_TXBUF_SIZE        8192        // Size of the (simulated) receiver's output buffer [bytes]
+#define SIM_BOOT_TIME         500         // Time the receiver is silent after a reset [ms]
+#define SIM_RESTART_TIME      1000        // Time without navigation epochs after a GNSS restart [ms]
+#define SIM_LOOP_TIMEOUT      5           // Maximum time to wait for input [ms]
+
+const char *simHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'sim':\n"
+"\n"
+"    Usage: cfgtool sim -p <path> [-m <spec>]\n"
+"\n"
+"    Simulates a receiver on a pseudo-terminal, for example to test and\n"
+"    benchmark the receiver handling (detection, autobaud, configuration,\n"
+"    reset, ...) of this and other tools without a real receiver. A symlink\n"
+"    <path> to the pseudo-terminal device is created. Other commands (or other\n"
+"    applications) can connect to the simulated receiver on that port.\n"
+"\n"
+"    The simulated receiver responds to UBX-MON-VER polls, UBX-CFG-VALGET,\n"
+"    UBX-CFG-VALSET (with transactions), UBX-CFG-VALDEL, UBX-CFG-CFG and\n"
+"    UBX-CFG-RST much like a real receiver does. It has a RAM, BBR, Flash and\n"
+"    Default configuration layer for all known configuration items. The baudrate\n"
+"    (CFG-UART1-BAUDRATE), the measurement rate (CFG-RATE-MEAS, CFG-RATE-NAV),\n"
+"    the output protocols (CFG-UART1OUTPROT-*) and the output rate of the\n"
+"    simulated messages (CFG-MSGOUT-*_UART1) are used. Messages are output at\n"
+"    the configured baudrate. Messages that do not fit the output buffer\n"
+"    ("STRINGIFY(SIM_TXBUF_SIZE)" bytes) are dropped. If the other side of the pseudo-\n"
+"    terminal uses a different baudrate, the input is ignored and the output\n"
+"    is garbage.\n"
+"\n"
+"    The <spec> is a comma-separated list of messages to output and settings.\n"
+"    Messages are given as <name>[:<rate>] (default rate 1, i.e. every\n"
+"    navigation epoch). They set the output rate in the Default layer. The\n"
+"    default is '"SIM_DEFAULT_MSGS"'.\n"
+"    Available messages are:\n"
+"\n"
+"        UBX-NAV-PVT, UBX-NAV-SAT, UBX-NAV-SIG, UBX-NAV-EOE, UBX-RXM-RAWX,\n"
+"        UBX-MON-HW, NMEA-STANDARD-GGA, NMEA-STANDARD-RMC, NMEA-STANDARD-GSA,\n"
+"        NMEA-STANDARD-GSV, RTCM-3X-TYPE1005, RTCM-3X-TYPE1077\n"
+"\n"
+"    Settings are given as <setting>=<value>:\n"
+"\n"
+"        baudrate=<baudrate>  Default baudrate (default "STRINGIFY(SIM_DEFAULT_BAUDRATE)")\n"
+"        hz=<rate>            Default navigation rate [Hz] (default 1)\n"
+"        errors=<n>           Corrupt on average one in <n> output bytes\n"
+"        stall=<ms>           Stop input and output for <ms> milliseconds\n"
+"        stallint=<s>         Interval of the stalls [s] (default 10)\n"
+"        reset=<s>            Spontaneously reset every <s> seconds\n"
+"\n"
+"    The simulated receiver runs until interrupted (SIGINT, SIGTERM). With\n"
+"    multiple -p the receivers are simulated concurrently. This command is not\n"
+"    available on Windows.\n"
+"\n"
+"    Examples:\n"
+"\n"
+"        cfgtool sim -p /tmp/rx &\n"
+"        cfgtool status -p /tmp/rx@115200\n"
+"\n"
+"        cfgtool sim -p /tmp/rx1 -p /tmp/rx2 -m baudrate=9600,UBX-RXM-RAWX:5 &\n"
+"        cfgtool rx2list -p /tmp/rx1 -l Default\n"
+"\n"
+"        cfgtool sim -p /tmp/rx -m errors=1000,stall=1500,stallint=5,reset=60\n"
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+#ifndef _WIN32
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        PRINT("Aborting...");
+        gAbort = true;
+    }
+}
+
+// Simulated messages, in output order for each epoch
+typedef enum SIM_MSG_e
+{
+    SIM_MSG_UBX_NAV_PVT = 0, SIM_MSG_UBX_NAV_SAT, SIM_MSG_UBX_NAV_SIG, SIM_MSG_UBX_RXM_RAWX, SIM_MSG_UBX_MON_HW,
+    SIM_MSG_NMEA_GGA, SIM_MSG_NMEA_RMC, SIM_MSG_NMEA_GSA, SIM_MSG_NMEA_GSV,
+    SIM_MSG_RTCM3_1005, SIM_MSG_RTCM3_1077, SIM_MSG_UBX_NAV_EOE,
+    _SIM_MSG_NUM
+} SIM_MSG_t;
+
+typedef enum SIM_PROTO_e { SIM_PROTO_UBX = 0, SIM_PROTO_NMEA, SIM_PROTO_RTCM3, _SIM_PROTO_NUM } SIM_PROTO_t;
+
+typedef struct SIM_MSGDEF_s
+{
+    const char  *name;
+    SIM_PROTO_t  proto;
+    uint8_t      clsId; // UBX only
+    uint8_t      msgId; // UBX only
+} SIM_MSGDEF_t;
+
+static const SIM_MSGDEF_t kSimMsgs[_SIM_MSG_NUM] =
+{
+    [SIM_MSG_UBX_NAV_PVT]  = { .name = "UBX-NAV-PVT",        .proto = SIM_PROTO_UBX,   .clsId = UBX_NAV_CLSID, .msgId = UBX_NAV_PVT_MSGID  },
+    [SIM_MSG_UBX_NAV_SAT]  = { .name = "UBX-NAV-SAT",        .proto = SIM_PROTO_UBX,   .clsId = UBX_NAV_CLSID, .msgId = UBX_NAV_SAT_MSGID  },
+    [SIM_MSG_UBX_NAV_SIG]  = { .name = "UBX-NAV-SIG",        .proto = SIM_PROTO_UBX,   .clsId = UBX_NAV_CLSID, .msgId = UBX_NAV_SIG_MSGID  },
+    [SIM_MSG_UBX_RXM_RAWX] = { .name = "UBX-RXM-RAWX",       .proto = SIM_PROTO_UBX,   .clsId = UBX_RXM_CLSID, .msgId = UBX_RXM_RAWX_MSGID },
+    [SIM_MSG_UBX_MON_HW]   = { .name = "UBX-MON-HW",         .proto = SIM_PROTO_UBX,   .clsId = UBX_MON_CLSID, .msgId = UBX_MON_HW_MSGID   },
+    [SIM_MSG_NMEA_GGA]     = { .name = "NMEA-STANDARD-GGA",  .proto = SIM_PROTO_NMEA  },
+    [SIM_MSG_NMEA_RMC]     = { .name = "NMEA-STANDARD-RMC",  .proto = SIM_PROTO_NMEA  },
+    [SIM_MSG_NMEA_GSA]     = { .name = "NMEA-STANDARD-GSA",  .proto = SIM_PROTO_NMEA  },
+    [SIM_MSG_NMEA_GSV]     = { .name = "NMEA-STANDARD-GSV",  .proto = SIM_PROTO_NMEA  },
+    [SIM_MSG_RTCM3_1005]   = { .name = "RTCM-3X-TYPE1005",   .proto = SIM_PROTO_RTCM3 },
+    [SIM_MSG_RTCM3_1077]   = { .name = "RTCM-3X-TYPE1077",   .proto = SIM_PROTO_RTCM3 },
+    [SIM_MSG_UBX_NAV_EOE]  = { .name = "UBX-NAV-EOE",        .proto = SIM_PROTO_UBX,   .clsId = UBX_NAV_CLSID, .msgId = UBX_NAV_EOE_MSGID  },
+};
+
+// Configuration database
+typedef struct SIM_CFG_s
+{
+    const UBLOXCFG_ITEM_t **items;
+    int                     nItems;
+    UBLOXCFG_VALUE_t       *val[UBLOXCFG_LAYER_DEFAULT + 1];  // Values for each layer
+    bool                   *have[UBLOXCFG_LAYER_DEFAULT + 1]; // Value set in layer (BBR and Flash only)
+    int                     ixMsgs[_SIM_MSG_NUM];             // Index of the CFG-MSGOUT-*_UART1 items
+    int                     ixProtos[_SIM_PROTO_NUM];         // Index of the CFG-UART1OUTPROT-* items
+    int                     ixBaudrate;
+    int                     ixRateMeas;
+    int                     ixRateNav;
+    UBLOXCFG_KEYVAL_t      *trans;                            // Pending UBX-CFG-VALSET transaction
+    int                     nTrans;
+    uint8_t                 transLayers;
+    bool                    transActive;
+} SIM_CFG_t;
+
+typedef struct SIM_STATS_s
+{
+    uint32_t nEpochs;
+    uint32_t nMsgs;
+    uint64_t nBytes;
+    uint32_t nDropMsgs;   // Messages not fitting into the output buffer
+    uint64_t nDropBytes;  // Bytes that could not be written to the pseudo-terminal
+    uint64_t nBadBytes;   // Corrupted output bytes
+    uint64_t nInBytes;
+    uint32_t nCmds;       // Handled UBX commands and polls
+    uint32_t nResets;
+    uint32_t nStalls;
+} SIM_STATS_t;
+
+typedef struct SIM_s
+{
+    // Pseudo-terminal
+    const char  *path;
+    char         ptsName[200];
+    int          master;
+    int          slave;      // We keep the slave open, so that the master doesn't see hangups
+    bool         symlinked;
+
+    // Settings
+    uint32_t     errors;     // Corrupt one in this many bytes (0 = disabled)
+    uint32_t     stallDur;   // [ms]
+    uint32_t     stallInt;   // [ms]
+    uint32_t     resetInt;   // [ms]
+
+    // Receiver state
+    SIM_CFG_t    cfg;
+    uint32_t     seed;
+    int          baudrate;   // Current baudrate
+    int          newBaudrate;
+    int          baudrateOffs; // Switch to the new baudrate once this many bytes have been sent (-1 = no switch)
+    bool         booting;
+    bool         gnssRunning;
+    uint64_t     bootEnd;
+    uint64_t     restartEnd;
+    uint64_t     stallEnd;
+    uint64_t     nextStall;
+    uint64_t     nextReset;
+    int64_t      lastEpoch;  // Number of the last navigation epoch (since GPS epoch)
+    uint32_t     navCnt;
+    int          navPeriod;  // [ms]
+    bool         protos[_SIM_PROTO_NUM];
+    int          rates[_SIM_MSG_NUM];
+
+    // Output
+    uint8_t      txBuf[SIM_TXBUF_SIZE];
+    int          txSize;
+    double       txCredit;   // Number of bytes that can be sent at the current baudrate
+    uint64_t     txLast;
+
+    // Input
+    PARSER_t     parser;
+
+    SIM_STATS_t  stats;
+} SIM_t;
+
+/* ****************************************************************************************************************** */
+
+static int _simBaudrateValue(const int baudrate)
+{
+    const int baudrates[]  = { PORT_BAUDRATES };
+    const int baudvalues[] = { PORT_BAUDVALUES };
+    for (int ix = 0; ix < NUMOF(baudrates); ix++)
+    {
+        if (baudrates[ix] == baudrate)
+        {
+            return baudvalues[ix];
+        }
+    }
+    return 0;
+}
+
+// Baudrate the other side of the pseudo-terminal uses
+static int _simClientBaudrate(SIM_t *sim)
+{
+    struct termios settings;
+    if (tcgetattr(sim->slave, &settings) != 0)
+    {
+        return 0;
+    }
+    const speed_t speed = cfgetospeed(&settings);
+    const int baudrates[]  = { PORT_BAUDRATES };
+    const int baudvalues[] = { PORT_BAUDVALUES };
+    for (int ix = 0; ix < NUMOF(baudrates); ix++)
+    {
+        if ((speed_t)baudvalues[ix] == speed)
+        {
+            return baudrates[ix];
+        }
+    }
+    return 0;
+}
+
+static bool _simOpen(SIM_t *sim)
+{
+    sim->master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (sim->master < 0)
+    {
+        WARNING("%s: Failed creating pseudo-terminal: %s", sim->path, strerror(errno));
+        return false;
+    }
+    const char *pts = NULL;
+    if ( (grantpt(sim->master) != 0) || (unlockpt(sim->master) != 0) || ((pts = ptsname(sim->master)) == NULL) )
+    {
+        WARNING("%s: Failed setting up pseudo-terminal: %s", sim->path, strerror(errno));
+        return false;
+    }
+    snprintf(sim->ptsName, sizeof(sim->ptsName), "%s", pts);
+
+    sim->slave = open(sim->ptsName, O_RDWR | O_NOCTTY);
+    struct termios settings;
+    if ( (sim->slave < 0) || (tcgetattr(sim->slave, &settings) != 0) )
+    {
+        WARNING("%s: Failed opening %s: %s", sim->path, sim->ptsName, strerror(errno));
+        return false;
+    }
+    cfmakeraw(&settings);
+    cfsetispeed(&settings, _simBaudrateValue(sim->baudrate));
+    cfsetospeed(&settings, _simBaudrateValue(sim->baudrate));
+    if ( (tcsetattr(sim->slave, TCSANOW, &settings) != 0) ||
+         (fcntl(sim->master, F_SETFL, fcntl(sim->master, F_GETFL) | O_NONBLOCK) != 0) )
+    {
+        WARNING("%s: Failed configuring %s: %s", sim->path, sim->ptsName, strerror(errno));
+        return false;
+    }
+
+    // Replace stale symlinks to pseudo-terminals (from a previous run), but nothing else
+    struct stat st;
+    if (lstat(sim->path, &st) == 0)
+    {
+        char target[sizeof(sim->ptsName)];
+        const int len = S_ISLNK(st.st_mode) ? readlink(sim->path, target, sizeof(target) - 1) : -1;
+        if (len > 0)
+        {
+            target[len] = '\0';
+        }
+        if ( (len <= 0) || (strncmp(target, "/dev/pts/", 9) != 0) )
+        {
+            WARNING("%s: File exists (and is not a symlink to a pseudo-terminal)!", sim->path);
+            return false;
+        }
+        unlink(sim->path);
+    }
+    if (symlink(sim->ptsName, sim->path) != 0)
+    {
+        WARNING("%s: Failed creating symlink to %s: %s", sim->path, sim->ptsName, strerror(errno));
+        return false;
+    }
+    sim->symlinked = true;
+    return true;
+}
+
+static void _simClose(SIM_t *sim)
+{
+    if (sim->symlinked)
+    {
+        unlink(sim->path);
+    }
+    if (sim->slave >= 0)
+    {
+        close(sim->slave);
+    }
+    if (sim->master >= 0)
+    {
+        close(sim->master);
+    }
+}
+
+/* ****************************************************************************************************************** */
+
+static int _simCfgIx(const SIM_t *sim, const uint32_t id)
+{
+    for (int ix = 0; ix < sim->cfg.nItems; ix++)
+    {
+        if (sim->cfg.items[ix]->id == id)
+        {
+            return ix;
+        }
+    }
+    return -1;
+}
+
+static bool _simCfgHave(const SIM_t *sim, const UBLOXCFG_LAYER_t layer, const int ix)
+{
+    return (sim->cfg.have[layer] == NULL) || sim->cfg.have[layer][ix];
+}
+
+// Key ID or wildcard (UBX-CFG-VALGET, UBX-CFG-VALDEL) matches item ID
+static bool _simCfgMatch(const uint32_t key, const uint32_t id)
+{
+    if (key == UBX_CFG_VALGET_V0_ALL_WILDCARD)
+    {
+        return true;
+    }
+    else if ((key & 0x0000ffff) == 0x0000ffff)
+    {
+        return (key & 0x0fff0000) == (id & 0x0fff0000);
+    }
+    else
+    {
+        return key == id;
+    }
+}
+
+static bool _simCfgInit(SIM_t *sim)
+{
+    SIM_CFG_t *cfg = &sim->cfg;
+    cfg->items = ubloxcfg_getAllItems(&cfg->nItems);
+    for (int layer = UBLOXCFG_LAYER_RAM; layer <= UBLOXCFG_LAYER_DEFAULT; layer++)
+    {
+        cfg->val[layer] = calloc(cfg->nItems, sizeof(UBLOXCFG_VALUE_t));
+        if (cfg->val[layer] == NULL)
+        {
+            return false;
+        }
+        if ( (layer == UBLOXCFG_LAYER_BBR) || (layer == UBLOXCFG_LAYER_FLASH) )
+        {
+            cfg->have[layer] = calloc(cfg->nItems, sizeof(bool));
+            if (cfg->have[layer] == NULL)
+            {
+                return false;
+            }
+        }
+    }
+    cfg->ixBaudrate = _simCfgIx(sim, UBLOXCFG_CFG_UART1_BAUDRATE_ID);
+    cfg->ixRateMeas = _simCfgIx(sim, UBLOXCFG_CFG_RATE_MEAS_ID);
+    cfg->ixRateNav  = _simCfgIx(sim, UBLOXCFG_CFG_RATE_NAV_ID);
+    cfg->ixProtos[SIM_PROTO_UBX]   = _simCfgIx(sim, UBLOXCFG_CFG_UART1OUTPROT_UBX_ID);
+    cfg->ixProtos[SIM_PROTO_NMEA]  = _simCfgIx(sim, UBLOXCFG_CFG_UART1OUTPROT_NMEA_ID);
+    cfg->ixProtos[SIM_PROTO_RTCM3] = _simCfgIx(sim, UBLOXCFG_CFG_UART1OUTPROT_RTCM3X_ID);
+    for (int msg = 0; msg < _SIM_MSG_NUM; msg++)
+    {
+        const UBLOXCFG_MSGRATE_t *rate = ubloxcfg_getMsgRateCfg(kSimMsgs[msg].name);
+        cfg->ixMsgs[msg] = (rate != NULL) && (rate->itemUart1 != NULL) ? _simCfgIx(sim, rate->itemUart1->id) : -1;
+        if (cfg->ixMsgs[msg] < 0)
+        {
+            WARNING("No output rate configuration for %s!", kSimMsgs[msg].name);
+            return false;
+        }
+    }
+    if ( (cfg->ixBaudrate < 0) || (cfg->ixRateMeas < 0) || (cfg->ixRateNav < 0) || (cfg->ixProtos[SIM_PROTO_UBX] < 0) ||
+         (cfg->ixProtos[SIM_PROTO_NMEA] < 0) || (cfg->ixProtos[SIM_PROTO_RTCM3] < 0) )
+    {
+        WARNING("Missing configuration items!");
+        return false;
+    }
+
+    UBLOXCFG_VALUE_t *def = cfg->val[UBLOXCFG_LAYER_DEFAULT];
+    def[cfg->ixRateMeas].U2 = 1000;
+    def[cfg->ixRateNav].U2 = 1;
+    def[cfg->ixProtos[SIM_PROTO_UBX]].L = true;
+    def[cfg->ixProtos[SIM_PROTO_NMEA]].L = true;
+    def[cfg->ixProtos[SIM_PROTO_RTCM3]].L = true;
+    return true;
+}
+
+static void _simCfgFree(SIM_t *sim)
+{
+    for (int layer = UBLOXCFG_LAYER_RAM; layer <= UBLOXCFG_LAYER_DEFAULT; layer++)
+    {
+        free(sim->cfg.val[layer]);
+        free(sim->cfg.have[layer]);
+    }
+    free(sim->cfg.trans);
+}
+
+// Configuration in RAM changed, use it
+static void _simCfgApply(SIM_t *sim)
+{
+    const UBLOXCFG_VALUE_t *ram = sim->cfg.val[UBLOXCFG_LAYER_RAM];
+    for (int msg = 0; msg < _SIM_MSG_NUM; msg++)
+    {
+        sim->rates[msg] = ram[sim->cfg.ixMsgs[msg]].U1;
+    }
+    for (int proto = 0; proto < _SIM_PROTO_NUM; proto++)
+    {
+        sim->protos[proto] = ram[sim->cfg.ixProtos[proto]].L;
+    }
+    sim->navPeriod = MAX(25, (int)ram[sim->cfg.ixRateMeas].U2) * MAX(1, (int)ram[sim->cfg.ixRateNav].U2);
+    const int baudrate = ram[sim->cfg.ixBaudrate].U4;
+    if ( (baudrate != sim->baudrate) && (_simBaudrateValue(baudrate) != 0) )
+    {
+        sim->newBaudrate = baudrate;
+    }
+}
+
+// Load RAM layer from the other layers, as the receiver does on startup
+static void _simCfgLoad(SIM_t *sim)
+{
+    SIM_CFG_t *cfg = &sim->cfg;
+    for (int ix = 0; ix < cfg->nItems; ix++)
+    {
+        cfg->val[UBLOXCFG_LAYER_RAM][ix] =
+            cfg->have[UBLOXCFG_LAYER_BBR][ix]   ? cfg->val[UBLOXCFG_LAYER_BBR][ix]   :
+            cfg->have[UBLOXCFG_LAYER_FLASH][ix] ? cfg->val[UBLOXCFG_LAYER_FLASH][ix] :
+                                                  cfg->val[UBLOXCFG_LAYER_DEFAULT][ix];
+    }
+    _simCfgApply(sim);
+}
+
+static void _simCfgSet(SIM_t *sim, const UBLOXCFG_KEYVAL_t *kv, const int nKv, const uint8_t layers)
+{
+    const UBLOXCFG_LAYER_t setLayers[] = { UBLOXCFG_LAYER_RAM, UBLOXCFG_LAYER_BBR, UBLOXCFG_LAYER_FLASH };
+    const uint8_t setFlags[] =
+        { UBX_CFG_VALSET_V1_LAYER_RAM, UBX_CFG_VALSET_V1_LAYER_BBR, UBX_CFG_VALSET_V1_LAYER_FLASH };
+    for (int kvIx = 0; kvIx < nKv; kvIx++)
+    {
+        const int ix = _simCfgIx(sim, kv[kvIx].id);
+        for (int lIx = 0; (ix >= 0) && (lIx < NUMOF(setLayers)); lIx++)
+        {
+            if ((layers & setFlags[lIx]) != 0)
+            {
+                sim->cfg.val[setLayers[lIx]][ix] = kv[kvIx].val;
+                if (sim->cfg.have[setLayers[lIx]] != NULL)
+                {
+                    sim->cfg.have[setLayers[lIx]][ix] = true;
+                }
+            }
+        }
+    }
+    if ((layers & UBX_CFG_VALSET_V1_LAYER_RAM) != 0)
+    {
+        _simCfgApply(sim);
+    }
+}
+
+/* ****************************************************************************************************************** */
+
+static bool _simTxQueue(SIM_t *sim, const uint8_t *data, const int size)
+{
+    if ((sim->txSize + size) > (int)sizeof(sim->txBuf))
+    {
+        sim->stats.nDropMsgs++;
+        return false;
+    }
+    memcpy(&sim->txBuf[sim->txSize], data, size);
+    sim->txSize += size;
+    sim->stats.nMsgs++;
+    return true;
+}
+
+static void _simTxUbx(SIM_t *sim, const uint8_t clsId, const uint8_t msgId, const uint8_t *payload, const int size)
+{
+    uint8_t msg[UBX_FRAME_SIZE + UBX_CFG_VALGET_V1_MAX_SIZE];
+    const int msgSize = ubxMakeMessage(clsId, msgId, payload, size, msg);
+    _simTxQueue(sim, msg, msgSize);
+}
+
+static void _simTxAck(SIM_t *sim, const PARSER_MSG_t *msg, const bool ack)
+{
+    const UBX_ACK_ACK_V0_GROUP0_t payload = { .clsId = UBX_CLSID(msg->data), .msgId = UBX_MSGID(msg->data) };
+    _simTxUbx(sim, UBX_ACK_CLSID, ack ? UBX_ACK_ACK_MSGID : UBX_ACK_NAK_MSGID, (const uint8_t *)&payload, sizeof(payload));
+}
+
+static void _simTxMsg(SIM_t *sim, const SIM_MSG_t msgType, const uint32_t iTow)
+{
+    uint8_t msg[FAKE_MSG_MAX_SIZE];
+    int size = 0;
+    switch (msgType)
+    {
+        case SIM_MSG_UBX_NAV_PVT:  size = fakeUbxNavPvt(msg, iTow, &sim->seed);  break;
+        case SIM_MSG_UBX_NAV_SAT:  size = fakeUbxNavSat(msg, iTow, &sim->seed);  break;
+        case SIM_MSG_UBX_NAV_SIG:  size = fakeUbxNavSig(msg, iTow, &sim->seed);  break;
+        case SIM_MSG_UBX_RXM_RAWX: size = fakeUbxRxmRawx(msg, iTow, &sim->seed); break;
+        case SIM_MSG_UBX_MON_HW:   size = fakeUbxMonHw(msg, sim->navCnt, &sim->seed); break;
+        case SIM_MSG_UBX_NAV_EOE:  size = fakeUbxNavEoe(msg, iTow);              break;
+        case SIM_MSG_NMEA_GGA:     size = fakeNmeaGga(msg, iTow);                break;
+        case SIM_MSG_NMEA_RMC:     size = fakeNmeaRmc(msg, iTow);                break;
+        case SIM_MSG_NMEA_GSA:     size = fakeNmeaGsa(msg);                      break;
+        case SIM_MSG_NMEA_GSV:
+            for (uint32_t n = 0; n < 2; n++)
+            {
+                _simTxQueue(sim, msg, fakeNmeaGsv(msg, n));
+            }
+            size = fakeNmeaGsv(msg, 2);
+            break;
+        case SIM_MSG_RTCM3_1005:   size = fakeRtcm3(msg, 1005, 19, &sim->seed);  break;
+        case SIM_MSG_RTCM3_1077:   size = fakeRtcm3(msg, 1077, 100 + (fakeRand(&sim->seed) % 400), &sim->seed); break;
+        case _SIM_MSG_NUM:         break;
+    }
+    if (size > 0)
+    {
+        _simTxQueue(sim, msg, size);
+    }
+}
+
+static void _simTxBoot(SIM_t *sim)
+{
+    const char * const boot[] = { "u-blox AG - www.u-blox.com", "HW UBX 9 00190000", "EXT CORE 1.00 (fake)",
+        "ROM BASE 0x118B2060", "FWVER=HPG 1.32", "PROTVER=27.31", "MOD=ZED-F9P" };
+    for (int ix = 0; sim->protos[SIM_PROTO_NMEA] && (ix < NUMOF(boot)); ix++)
+    {
+        uint8_t msg[FAKE_MSG_MAX_SIZE];
+        _simTxQueue(sim, msg, fakeNmeaTxt(msg, boot[ix]));
+    }
+}
+
+// Send queued data at the current baudrate
+static void _simTx(SIM_t *sim, const uint64_t now)
+{
+    const double bytesPerMs = (double)sim->baudrate / 10.0 / 1e3;
+    sim->txCredit = MIN(sim->txCredit + ((double)(now - sim->txLast) * bytesPerMs),
+        (4.0 * SIM_LOOP_TIMEOUT * bytesPerMs) + 1.0);
+    sim->txLast = now;
+
+    int num = MIN(sim->txSize, (int)sim->txCredit);
+    if (sim->baudrateOffs >= 0)
+    {
+        num = MIN(num, sim->baudrateOffs);
+    }
+    if (num > 0)
+    {
+        if (sim->errors > 0)
+        {
+            for (int ix = 0; ix < num; ix++)
+            {
+                if ((fakeRand(&sim->seed) % sim->errors) == 0)
+                {
+                    sim->txBuf[ix] ^= 1 + (fakeRand(&sim->seed) % 255);
+                    sim->stats.nBadBytes++;
+                }
+            }
+        }
+        // Wrong baudrate on the other side
+        if (_simClientBaudrate(sim) != sim->baudrate)
+        {
+            for (int ix = 0; ix < num; ix++)
+            {
+                sim->txBuf[ix] = fakeRand(&sim->seed) & 0xf7;
+            }
+        }
+
+        const int res = write(sim->master, sim->txBuf, num);
+        // Nobody reading on the other side, the data is lost
+        if (res < 0)
+        {
+            sim->stats.nDropBytes += num;
+        }
+        else
+        {
+            sim->stats.nBytes += res;
+            num = res;
+        }
+        sim->txSize -= num;
+        sim->txCredit -= num;
+        if (sim->txSize > 0)
+        {
+            memmove(&sim->txBuf[0], &sim->txBuf[num], sim->txSize);
+        }
+        if (sim->baudrateOffs >= 0)
+        {
+            sim->baudrateOffs -= num;
+        }
+    }
+
+    // Baudrate change after the response (UBX-ACK-ACK) to the configuration change has been sent
+    if (sim->baudrateOffs == 0)
+    {
+        DEBUG("%s: baudrate %d -> %d", sim->path, sim->baudrate, sim->newBaudrate);
+        sim->baudrate = sim->newBaudrate;
+        sim->newBaudrate = 0;
+        sim->baudrateOffs = -1;
+    }
+}
+
+/* ****************************************************************************************************************** */
+
+static void _simReset(SIM_t *sim, const uint8_t resetMode, const uint64_t now)
+{
+    switch (resetMode)
+    {
+        case UBX_CFG_RST_V0_RESETMODE_GNSS_STOP:
+            DEBUG("%s: GNSS stop", sim->path);
+            sim->gnssRunning = false;
+            break;
+        case UBX_CFG_RST_V0_RESETMODE_GNSS_START:
+            DEBUG("%s: GNSS start", sim->path);
+            sim->gnssRunning = true;
+            break;
+        case UBX_CFG_RST_V0_RESETMODE_GNSS:
+            DEBUG("%s: GNSS restart", sim->path);
+            sim->gnssRunning = true;
+            sim->restartEnd = now + SIM_RESTART_TIME;
+            break;
+        default:
+            DEBUG("%s: reset", sim->path);
+            sim->stats.nResets++;
+            sim->booting = true;
+            sim->bootEnd = now + SIM_BOOT_TIME;
+            sim->txSize = 0;
+            sim->baudrateOffs = -1;
+            sim->newBaudrate = 0;
+            sim->cfg.transActive = false;
+            parserInit(&sim->parser);
+            break;
+    }
+}
+
+static void _simBoot(SIM_t *sim, const uint64_t now)
+{
+    sim->booting = false;
+    _simCfgLoad(sim);
+    if (sim->newBaudrate != 0)
+    {
+        sim->baudrate = sim->newBaudrate;
+        sim->newBaudrate = 0;
+    }
+    sim->gnssRunning = true;
+    sim->restartEnd = now + SIM_RESTART_TIME;
+    sim->txCredit = 0.0;
+    sim->txLast = now;
+    _simTxBoot(sim);
+    DEBUG("%s: boot, baudrate %d, navigation period %dms", sim->path, sim->baudrate, sim->navPeriod);
+}
+
+static void _simValget(SIM_t *sim, const PARSER_MSG_t *msg)
+{
+    const int payloadSize = msg->size - UBX_FRAME_SIZE;
+    const int keysSize = payloadSize - (int)sizeof(UBX_CFG_VALGET_V0_GROUP0_t);
+    if ( (keysSize < 4) || ((keysSize % 4) != 0) || (keysSize > UBX_CFG_VALGET_V0_KEYS_MAX) ||
+         (UBX_CFG_VALGET_VERSION_GET(msg->data) != UBX_CFG_VALGET_V0_VERSION) )
+    {
+        _simTxAck(sim, msg, false);
+        return;
+    }
+    UBX_CFG_VALGET_V0_GROUP0_t head;
+    memcpy(&head, &msg->data[UBX_HEAD_SIZE], sizeof(head));
+    UBLOXCFG_LAYER_t layer;
+    switch (head.layer)
+    {
+        case UBX_CFG_VALGET_V0_LAYER_RAM:     layer = UBLOXCFG_LAYER_RAM;     break;
+        case UBX_CFG_VALGET_V0_LAYER_BBR:     layer = UBLOXCFG_LAYER_BBR;     break;
+        case UBX_CFG_VALGET_V0_LAYER_FLASH:   layer = UBLOXCFG_LAYER_FLASH;   break;
+        case UBX_CFG_VALGET_V0_LAYER_DEFAULT: layer = UBLOXCFG_LAYER_DEFAULT; break;
+        default:
+            _simTxAck(sim, msg, false);
+            return;
+    }
+
+    // Collect the requested page of matching items
+    UBLOXCFG_KEYVAL_t kv[UBX_CFG_VALGET_V1_MAX_KV];
+    int nKv = 0;
+    int nMatch = 0;
+    for (int keyIx = 0; keyIx < (keysSize / 4); keyIx++)
+    {
+        uint32_t key;
+        memcpy(&key, &msg->data[UBX_HEAD_SIZE + sizeof(head) + (4 * keyIx)], sizeof(key));
+        bool known = false;
+        for (int ix = 0; ix < sim->cfg.nItems; ix++)
+        {
+            if (!_simCfgMatch(key, sim->cfg.items[ix]->id))
+            {
+                continue;
+            }
+            known = true;
+            if (!_simCfgHave(sim, layer, ix))
+            {
+                continue;
+            }
+            if ( (nMatch >= head.position) && (nKv < NUMOF(kv)) )
+            {
+                kv[nKv].id = sim->cfg.items[ix]->id;
+                kv[nKv].val = sim->cfg.val[layer][ix];
+                nKv++;
+            }
+            nMatch++;
+        }
+        if (!known)
+        {
+            _simTxAck(sim, msg, false);
+            return;
+        }
+    }
+    if (nKv == 0)
+    {
+        _simTxAck(sim, msg, false);
+        return;
+    }
+
+    uint8_t payload[UBX_CFG_VALGET_V1_MAX_SIZE];
+    const UBX_CFG_VALGET_V1_GROUP0_t respHead =
+        { .version = UBX_CFG_VALGET_V1_VERSION, .layer = head.layer, .position = head.position };
+    memcpy(payload, &respHead, sizeof(respHead));
+    int dataSize = 0;
+    ubloxcfg_makeData(&payload[sizeof(respHead)], UBX_CFG_VALGET_V1_CFGDATA_MAX, kv, nKv, &dataSize);
+    _simTxUbx(sim, UBX_CFG_CLSID, UBX_CFG_VALGET_MSGID, payload, sizeof(respHead) + dataSize);
+    _simTxAck(sim, msg, true);
+}
+
+static void _simValset(SIM_t *sim, const PARSER_MSG_t *msg)
+{
+    const int payloadSize = msg->size - UBX_FRAME_SIZE;
+    const int version = UBX_CFG_VALSET_VERSION_GET(msg->data);
+    UBLOXCFG_KEYVAL_t kv[UBX_CFG_VALSET_V1_MAX_KV];
+    int nKv = 0;
+    bool ok = (payloadSize >= (int)sizeof(UBX_CFG_VALSET_V1_GROUP0_t)) &&
+        ( (version == UBX_CFG_VALSET_V0_VERSION) || (version == UBX_CFG_VALSET_V1_VERSION) ) &&
+        ubloxcfg_parseData(&msg->data[UBX_HEAD_SIZE + sizeof(UBX_CFG_VALSET_V1_GROUP0_t)],
+            payloadSize - sizeof(UBX_CFG_VALSET_V1_GROUP0_t), kv, NUMOF(kv), &nKv);
+    UBX_CFG_VALSET_V1_GROUP0_t head;
+    memcpy(&head, &msg->data[UBX_HEAD_SIZE], sizeof(head));
+    if (version == UBX_CFG_VALSET_V0_VERSION)
+    {
+        head.transaction = UBX_CFG_VALSET_V1_TRANSACTION_NONE;
+    }
+    const uint8_t layers = head.layers &
+        (UBX_CFG_VALSET_V1_LAYER_RAM | UBX_CFG_VALSET_V1_LAYER_BBR | UBX_CFG_VALSET_V1_LAYER_FLASH);
+    ok = ok && (layers != 0);
+    for (int kvIx = 0; ok && (kvIx < nKv); kvIx++)
+    {
+        if ( (_simCfgIx(sim, kv[kvIx].id) < 0) ||
+             ( (kv[kvIx].id == UBLOXCFG_CFG_UART1_BAUDRATE_ID) && (_simBaudrateValue(kv[kvIx].val.U4) == 0) ) )
+        {
+            ok = false;
+        }
+    }
+    if ( ok && ( (head.transaction == UBX_CFG_VALSET_V1_TRANSACTION_CONTINUE) ||
+                 (head.transaction == UBX_CFG_VALSET_V1_TRANSACTION_END) ) &&
+         (!sim->cfg.transActive || (sim->cfg.transLayers != layers)) )
+    {
+        ok = false;
+    }
+    if (!ok)
+    {
+        sim->cfg.transActive = false;
+        _simTxAck(sim, msg, false);
+        return;
+    }
+
+    switch (head.transaction)
+    {
+        case UBX_CFG_VALSET_V1_TRANSACTION_BEGIN:
+            sim->cfg.transActive = true;
+            sim->cfg.transLayers = layers;
+            sim->cfg.nTrans = 0;
+            // fall through
+        case UBX_CFG_VALSET_V1_TRANSACTION_CONTINUE:
+        case UBX_CFG_VALSET_V1_TRANSACTION_END:
+        {
+            UBLOXCFG_KEYVAL_t *trans = realloc(sim->cfg.trans, (sim->cfg.nTrans + nKv) * sizeof(*trans));
+            if ( (trans == NULL) && ((sim->cfg.nTrans + nKv) > 0) )
+            {
+                sim->cfg.transActive = false;
+                _simTxAck(sim, msg, false);
+                return;
+            }
+            sim->cfg.trans = trans;
+            memcpy(&sim->cfg.trans[sim->cfg.nTrans], kv, nKv * sizeof(*kv));
+            sim->cfg.nTrans += nKv;
+            if (head.transaction == UBX_CFG_VALSET_V1_TRANSACTION_END)
+            {
+                _simCfgSet(sim, sim->cfg.trans, sim->cfg.nTrans, layers);
+                sim->cfg.transActive = false;
+                sim->cfg.nTrans = 0;
+            }
+            break;
+        }
+        default:
+            _simCfgSet(sim, kv, nKv, layers);
+            break;
+    }
+    _simTxAck(sim, msg, true);
+}
+
+static void _simValdel(SIM_t *sim, const PARSER_MSG_t *msg)
+{
+    const int payloadSize = msg->size - UBX_FRAME_SIZE;
+    const int keysSize = payloadSize - (int)sizeof(UBX_CFG_VALDEL_V1_GROUP0_t);
+    if ( (keysSize < 4) || ((keysSize % 4) != 0) || (keysSize > UBX_CFG_VALDEL_V1_KEYS_MAX) )
+    {
+        _simTxAck(sim, msg, false);
+        return;
+    }
+    UBX_CFG_VALDEL_V1_GROUP0_t head;
+    memcpy(&head, &msg->data[UBX_HEAD_SIZE], sizeof(head));
+    for (int keyIx = 0; keyIx < (keysSize / 4); keyIx++)
+    {
+        uint32_t key;
+        memcpy(&key, &msg->data[UBX_HEAD_SIZE + sizeof(head) + (4 * keyIx)], sizeof(key));
+        for (int ix = 0; ix < sim->cfg.nItems; ix++)
+        {
+            if (_simCfgMatch(key, sim->cfg.items[ix]->id))
+            {
+                if ((head.layers & UBX_CFG_VALDEL_V1_LAYER_BBR) != 0)
+                {
+                    sim->cfg.have[UBLOXCFG_LAYER_BBR][ix] = false;
+                }
+                if ((head.layers & UBX_CFG_VALDEL_V1_LAYER_FLASH) != 0)
+                {
+                    sim->cfg.have[UBLOXCFG_LAYER_FLASH][ix] = false;
+                }
+            }
+        }
+    }
+    _simTxAck(sim, msg, true);
+}
+
+static void _simCfgCfg(SIM_t *sim, const PARSER_MSG_t *msg)
+{
+    const int payloadSize = msg->size - UBX_FRAME_SIZE;
+    if ( (payloadSize != (UBX_CFG_CFG_V0_MIN_SIZE - UBX_FRAME_SIZE)) &&
+         (payloadSize != (UBX_CFG_CFG_V0_MAX_SIZE - UBX_FRAME_SIZE)) )
+    {
+        _simTxAck(sim, msg, false);
+        return;
+    }
+    UBX_CFG_CFG_V0_GROUP0_t head;
+    memcpy(&head, &msg->data[UBX_HEAD_SIZE], sizeof(head));
+    const uint8_t devices = payloadSize > (int)sizeof(head) ? msg->data[UBX_HEAD_SIZE + sizeof(head)] :
+        (UBX_CFG_CFG_V0_DEVICE_BBR | UBX_CFG_CFG_V0_DEVICE_FLASH);
+    const UBLOXCFG_LAYER_t layers[] = { UBLOXCFG_LAYER_BBR, UBLOXCFG_LAYER_FLASH };
+    const uint8_t flags[] = { UBX_CFG_CFG_V0_DEVICE_BBR, UBX_CFG_CFG_V0_DEVICE_FLASH };
+    for (int lIx = 0; lIx < NUMOF(layers); lIx++)
+    {
+        if ((devices & flags[lIx]) == 0)
+        {
+            continue;
+        }
+        if (head.clearMask != UBX_CFG_CFG_V0_CLEAR_NONE)
+        {
+            memset(sim->cfg.have[layers[lIx]], 0, sim->cfg.nItems * sizeof(bool));
+        }
+        if (head.saveMask != UBX_CFG_CFG_V0_SAVE_NONE)
+        {
+            memcpy(sim->cfg.val[layers[lIx]], sim->cfg.val[UBLOXCFG_LAYER_RAM], sim->cfg.nItems * sizeof(UBLOXCFG_VALUE_t));
+            memset(sim->cfg.have[layers[lIx]], true, sim->cfg.nItems * sizeof(bool));
+        }
+    }
+    if (head.loadMask != UBX_CFG_CFG_V0_LOAD_NONE)
+    {
+        _simCfgLoad(sim);
+    }
+    _simTxAck(sim, msg, true);
+}
+
+static void _simHandleUbx(SIM_t *sim, const PARSER_MSG_t *msg, const uint32_t iTow, const uint64_t now)
+{
+    const uint8_t clsId = UBX_CLSID(msg->data);
+    const uint8_t msgId = UBX_MSGID(msg->data);
+    const bool isPoll = (msg->size == UBX_FRAME_SIZE);
+    DEBUG("%s: received %s (size %d)", sim->path, msg->name, msg->size);
+    sim->stats.nCmds++;
+
+    if (clsId == UBX_CFG_CLSID)
+    {
+        switch (msgId)
+        {
+            case UBX_CFG_VALGET_MSGID: _simValget(sim, msg); break;
+            case UBX_CFG_VALSET_MSGID: _simValset(sim, msg); break;
+            case UBX_CFG_VALDEL_MSGID: _simValdel(sim, msg); break;
+            case UBX_CFG_CFG_MSGID:    _simCfgCfg(sim, msg); break;
+            case UBX_CFG_RST_MSGID:
+                if (msg->size == UBX_CFG_RST_V0_SIZE)
+                {
+                    _simReset(sim, msg->data[UBX_HEAD_SIZE + 2], now);
+                }
+                break;
+            default:
+                _simTxAck(sim, msg, false);
+                break;
+        }
+    }
+    else if ( (clsId == UBX_UPD_CLSID) && (msgId == UBX_UPD_SAFEBOOT_MSGID) )
+    {
+        _simReset(sim, UBX_CFG_RST_V0_RESETMODE_HW_FORCED, now);
+    }
+    else if ( isPoll && (clsId == UBX_MON_CLSID) && (msgId == UBX_MON_VER_MSGID) )
+    {
+        uint8_t ver[FAKE_MSG_MAX_SIZE];
+        _simTxQueue(sim, ver, fakeUbxMonVer(ver));
+    }
+    else if (isPoll)
+    {
+        for (int msgType = 0; msgType < _SIM_MSG_NUM; msgType++)
+        {
+            if ( (kSimMsgs[msgType].proto == SIM_PROTO_UBX) &&
+                 (kSimMsgs[msgType].clsId == clsId) && (kSimMsgs[msgType].msgId == msgId) )
+            {
+                _simTxMsg(sim, msgType, iTow);
+                break;
+            }
+        }
+    }
+
+    // Switch the baudrate after the response to the configuration change has been sent
+    if ( (sim->newBaudrate != 0) && (sim->baudrateOffs < 0) && !sim->booting )
+    {
+        sim->baudrateOffs = sim->txSize;
+    }
+}
+
+static void _simRx(SIM_t *sim, const uint32_t iTow, const uint64_t now)
+{
+    uint8_t buf[1024];
+    const int num = read(sim->master, buf, sizeof(buf));
+    if (num <= 0)
+    {
+        return;
+    }
+    sim->stats.nInBytes += num;
+
+    // Receiver not listening, or other side uses wrong baudrate
+    if (sim->booting || (_simClientBaudrate(sim) != sim->baudrate))
+    {
+        return;
+    }
+
+    parserAdd(&sim->parser, buf, num);
+    PARSER_MSG_t msg;
+    while (!sim->booting && parserProcess(&sim->parser, &msg, false))
+    {
+        if (msg.type == PARSER_MSGTYPE_UBX)
+        {
+            _simHandleUbx(sim, &msg, iTow, now);
+        }
+    }
+}
+
+/* ****************************************************************************************************************** */
+
+static bool _simParseSpec(SIM_t *sim, const char *spec)
+{
+    char str[1000];
+    if (snprintf(str, sizeof(str), "%s", spec) >= (int)sizeof(str))
+    {
+        WARNING("Spec too long!");
+        return false;
+    }
+    UBLOXCFG_VALUE_t *def = sim->cfg.val[UBLOXCFG_LAYER_DEFAULT];
+    bool haveMsgs = false;
+    char *save = NULL;
+    for (char *tok = strtok_r(str, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save))
+    {
+        char *sep = strchr(tok, '=');
+        if (sep == NULL)
+        {
+            sep = strchr(tok, ':');
+        }
+        int value = 1;
+        int n = 0;
+        if (sep != NULL)
+        {
+            *sep = '\0';
+            if ( (sscanf(&sep[1], "%d%n", &value, &n) != 1) || (sep[1 + n] != '\0') || (value < 0) )
+            {
+                WARNING("Bad value in '%s=%s'!", tok, &sep[1]);
+                return false;
+            }
+        }
+
+        if (strcmp(tok, "baudrate") == 0)
+        {
+            if (_simBaudrateValue(value) == 0)
+            {
+                WARNING("Bad baudrate %d!", value);
+                return false;
+            }
+            def[sim->cfg.ixBaudrate].U4 = value;
+        }
+        else if (strcmp(tok, "hz") == 0)
+        {
+            if ( (value < 1) || (value > 40) )
+            {
+                WARNING("Bad rate %d!", value);
+                return false;
+            }
+            def[sim->cfg.ixRateMeas].U2 = 1000 / value;
+        }
+        else if (strcmp(tok, "errors") == 0)
+        {
+            sim->errors = value;
+        }
+        else if (strcmp(tok, "stall") == 0)
+        {
+            sim->stallDur = value;
+        }
+        else if (strcmp(tok, "stallint") == 0)
+        {
+            sim->stallInt = value * 1000;
+        }
+        else if (strcmp(tok, "reset") == 0)
+        {
+            sim->resetInt = value * 1000;
+        }
+        else
+        {
+            int msgType = 0;
+            while ( (msgType < _SIM_MSG_NUM) && (strcasecmp(tok, kSimMsgs[msgType].name) != 0) )
+            {
+                msgType++;
+            }
+            if ( (msgType >= _SIM_MSG_NUM) || (value > 255) )
+            {
+                WARNING("Bad message or setting '%s'!", tok);
+                return false;
+            }
+            // First message given replaces the default messages
+            if (!haveMsgs)
+            {
+                for (int ix = 0; ix < _SIM_MSG_NUM; ix++)
+                {
+                    def[sim->cfg.ixMsgs[ix]].U1 = 0;
+                }
+                haveMsgs = true;
+            }
+            def[sim->cfg.ixMsgs[msgType]].U1 = value;
+        }
+    }
+    return true;
+}
+
+static void _simRun(SIM_t *sim)
+{
+    const uint64_t t0 = TIME();
+    sim->booting = true;
+    sim->bootEnd = t0;
+    sim->nextStall = t0 + sim->stallInt;
+    sim->nextReset = t0 + sim->resetInt;
+    sim->lastEpoch = -1;
+    while (!gAbort)
+    {
+        // GPS time of week [ms], approximately (UTC + 18 leap seconds)
+        const uint64_t gpsMs = (timeRealNs() / 1000000) - (UINT64_C(315964800) * 1000) + 18000;
+        const uint32_t iTow = gpsMs % (7 * 86400000);
+        const uint64_t now = TIME();
+
+        if ( (sim->resetInt > 0) && (now >= sim->nextReset) )
+        {
+            _simReset(sim, UBX_CFG_RST_V0_RESETMODE_HW_FORCED, now);
+            sim->nextReset = now + sim->resetInt;
+        }
+        if (sim->booting && (now >= sim->bootEnd))
+        {
+            _simBoot(sim, now);
+        }
+        if ( (sim->stallDur > 0) && (now >= sim->nextStall) )
+        {
+            DEBUG("%s: stall %ums", sim->path, sim->stallDur);
+            sim->stats.nStalls++;
+            sim->stallEnd = now + sim->stallDur;
+            sim->nextStall = now + sim->stallInt;
+        }
+        const bool stalled = (now < sim->stallEnd);
+
+        // Commands
+        if (!stalled)
+        {
+            _simRx(sim, iTow, now);
+        }
+
+        // Navigation epoch
+        const int64_t epoch = gpsMs / sim->navPeriod;
+        if ( (epoch != sim->lastEpoch) && !sim->booting && sim->gnssRunning && (now >= sim->restartEnd) )
+        {
+            const uint32_t epochTow = (epoch * sim->navPeriod) % (7 * 86400000);
+            for (int msgType = 0; msgType < _SIM_MSG_NUM; msgType++)
+            {
+                const int rate = sim->rates[msgType];
+                if ( (rate > 0) && ((sim->navCnt % rate) == 0) && sim->protos[kSimMsgs[msgType].proto] )
+                {
+                    _simTxMsg(sim, msgType, epochTow);
+                }
+            }
+            sim->navCnt++;
+            sim->stats.nEpochs++;
+        }
+        sim->lastEpoch = epoch;
+
+        // Output
+        if (stalled || sim->booting)
+        {
+            sim->txLast = now;
+        }
+        else
+        {
+            _simTx(sim, now);
+        }
+
+        struct pollfd fds = { .fd = sim->master, .events = POLLIN };
+        poll(&fds, 1, SIM_LOOP_TIMEOUT);
+    }
+}
+
+int simRun(const char *portArg, const char *spec)
+{
+    SIM_t *sim = calloc(1, sizeof(SIM_t));
+    if (sim == NULL)
+    {
+        return EXIT_OTHERFAIL;
+    }
+    sim->master = -1;
+    sim->slave = -1;
+    sim->baudrateOffs = -1;
+    sim->stallInt = 10000;
+    sim->path = strncmp(portArg, "ser://", 6) == 0 ? &portArg[6] : portArg;
+    for (const char *c = sim->path; *c != '\0'; c++)
+    {
+        sim->seed = (sim->seed * 31) + (uint8_t)*c;
+    }
+    sim->seed |= 1;
+    parserInit(&sim->parser);
+
+    if (!_simCfgInit(sim) || !_simParseSpec(sim, spec != NULL ? spec : SIM_DEFAULT_MSGS))
+    {
+        _simCfgFree(sim);
+        free(sim);
+        return EXIT_BADARGS;
+    }
+    sim->baudrate = sim->cfg.val[UBLOXCFG_LAYER_DEFAULT][sim->cfg.ixBaudrate].U4;
+    if (sim->baudrate == 0)
+    {
+        sim->baudrate = SIM_DEFAULT_BAUDRATE;
+        sim->cfg.val[UBLOXCFG_LAYER_DEFAULT][sim->cfg.ixBaudrate].U4 = SIM_DEFAULT_BAUDRATE;
+    }
+
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    int res = EXIT_OTHERFAIL;
+    if (_simOpen(sim))
+    {
+        PRINT("%s: simulating receiver on %s, baudrate %d", sim->path, sim->ptsName, sim->baudrate);
+        _simRun(sim);
+        res = EXIT_SUCCESS;
+        PRINT("%s: %u epochs, %u messages, %"PRIu64" bytes, %u dropped messages, %"PRIu64" dropped bytes, "
+            "%"PRIu64" corrupted bytes, %"PRIu64" input bytes, %u commands, %u resets, %u stalls", sim->path,
+            sim->stats.nEpochs, sim->stats.nMsgs, sim->stats.nBytes, sim->stats.nDropMsgs, sim->stats.nDropBytes,
+            sim->stats.nBadBytes, sim->stats.nInBytes, sim->stats.nCmds, sim->stats.nResets, sim->stats.nStalls);
+    }
+    _simClose(sim);
+    _simCfgFree(sim);
+    free(sim);
+    return res;
+}
+
+/* ****************************************************************************************************************** */
+#else // _WIN32
+
+int simRun(const char *portArg, const char *spec)
+{
+    UNUSED(portArg);
+    UNUSED(spec);
+    WARNING("The 'sim' command is not available on Windows!");
+    return EXIT_OTHERFAIL;
+}
+
+#endif // _WIN32
+/* ****************************************************************************************************************** */
+// eof
@@ -0,0 +1,534 @@
+// clang-format off
+/* ****************************************************************************************************************** */
+// u-blox positioning receivers configuration tool
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <math.h>
+#include <signal.h>
+
+#include "cfgtool_util.h"
+
+#include "ff_rx.h"
+#include "ff_parser.h"
+#include "ff_epoch.h"
+#include "ff_rxlog.h"
+
+#include "cfgtool_stats.h"
+
+/* ****************************************************************************************************************** */
+
+#define STATS_LIVE_INTERVAL 10 // [s]
+
+const char *statsHelp(void)
+{
+    return
+// -----------------------------------------------------------------------------
+"Command 'stats':\n"
+"\n"
+"    Usage: cfgtool stats -i <infile> | -p <port> [-o <outfile>] [-y] [-x] [-n]\n"
+"\n"
+"    Outputs statistics on the messages in the input file (-i) or received from\n"
+"    a receiver (-p, until SIGINT (e.g. CTRL-C)"NOT_WIN(", SIGHUP")" or SIGTERM is received).\n"
+"    For each message (name) this reports:\n"
+"\n"
+"    - the number of messages, their rate [Hz] and bandwidth [B/s],\n"
+"    - the share of the link capacity at the port's baudrate [%] (-p only,\n"
+"      assuming 10 bits per byte),\n"
+"    - the interval between messages [ms] (mean, median, 99th percentile and\n"
+"      maximum), and\n"
+"    - the latency of the messages relative to the first message of their\n"
+"      navigation epoch [ms] (mean, 99th percentile and maximum).\n"
+"\n"
+"    With -p the statistics are output every "STRINGIFY(STATS_LIVE_INTERVAL)" seconds and at the end.\n"
+"\n"
+"    The timing is given by the arrival time of the messages (-p), the arrival\n"
+"    times recorded in the log ('record -f log') or, for other input files,\n"
+"    by the navigation epochs (GPS time) in the data. In the latter case there\n"
+"    is no latency information. With -x histograms of the intervals and\n"
+"    latencies are output.\n"
+"\n"
+"    Examples:\n"
+"\n"
+"        cfgtool stats -i log.ubx\n"
+#ifdef _WIN32
+"        cfgtool stats -p COM3\n"
+#else
+"        cfgtool stats -p /dev/ttyUSB0 -x\n"
+#endif
+"\n";
+}
+
+/* ****************************************************************************************************************** */
+
+static bool gAbort;
+
+static void _sigHandler(int signal)
+{
+    if ( (signal == SIGINT) || (signal == SIGTERM) NOT_WIN(|| (signal == SIGHUP)) )
+    {
+        PRINT("Aborting...");
+        gAbort = true;
+    }
+}
+
+// Histograms have logarithmic bins with four sub-bins per power of two (i.e. a resolution of 25% or better): bins 0-3
+// are 0-3us, bins 4-7 are 4-7us, bins 8-11 are 8-9, 10-11, 12-13 and 14-15us, and so on. The last bin has everything
+// larger (> 33s).
+#define STATS_HIST_BINS    100
+#define STATS_MAX_NAMES   1024  // must be a power of 2
+#define STATS_MAX_GAP       60  // [s], larger gaps (or time going backwards) start a new segment
+
+typedef struct STATS_HIST_s
+{
+    uint64_t  num;
+    double    sum;        // [ns]
+    uint64_t  min;        // [ns]
+    uint64_t  max;        // [ns]
+    uint32_t  bins[STATS_HIST_BINS];
+
+} STATS_HIST_t;
+
+typedef struct STATS_MSG_s
+{
+    char              name[PARSER_MAX_NAME_SIZE];
+    PARSER_MSGTYPE_t  type;
+    uint64_t          count;
+    uint64_t          bytes;
+    uint64_t          lastTs;
+    uint32_t          lastSeg;
+    STATS_HIST_t      interval;
+    STATS_HIST_t      latency;
+
+} STATS_MSG_t;
+
+typedef struct STATS_s
+{
+    STATS_MSG_t       msgs[STATS_MAX_NAMES];   // Hash table (open addressing) of messages by name
+    int               numMsgs;
+    STATS_MSG_t       other;                   // All messages if the table is full
+    bool              haveLatency;             // Timestamps are arrival times
+    bool              haveTs;
+    uint64_t          lastTs;
+    uint64_t          dur;                     // Total duration of all segments [ns]
+    uint32_t          seg;                     // Segment (continuous timestamps)
+    uint64_t          epochTs;                 // Timestamp of first message of the current epoch
+    bool              haveEpochTs;
+    bool              epochStart;              // Next message starts epoch
+    uint64_t          nEpochs;
+    int               baudrate;
+    EPOCH_t           coll;
+    EPOCH_t           epoch;
+
+} STATS_t;
+
+static void _histAdd(STATS_HIST_t *hist, const uint64_t val)
+{
+    const uint64_t us = val / 1000;
+    int bin = (int)us;
+    if (us >= 4)
+    {
+        const int e = 63 - __builtin_clzll(us);
+        bin = (4 * (e - 1)) + (int)((us >> (e - 2)) & 0x3);
+    }
+    hist->bins[bin < STATS_HIST_BINS ? bin : (STATS_HIST_BINS - 1)]++;
+    if ( (hist->num == 0) || (val < hist->min) )
+    {
+        hist->min = val;
+    }
+    if (val > hist->max)
+    {
+        hist->max = val;
+    }
+    hist->num++;
+    hist->sum += (double)val;
+}
+
+// Upper end of bin [us]
+static uint64_t _histUpper(const int bin)
+{
+    if (bin < 4)
+    {
+        return bin + 1;
+    }
+    const int e = (bin / 4) + 1;
+    return (uint64_t)(5 + (bin % 4)) << (e - 2);
+}
+
+// Percentile estimate [ms] (upper end of the bin, within the min/max range)
+static double _histPerc(const STATS_HIST_t *hist, const double perc)
+{
+    const uint64_t thrs = (uint64_t)ceil((double)hist->num * perc);
+    uint64_t sum = 0;
+    uint64_t val = hist->max;
+    for (int bin = 0; bin < (STATS_HIST_BINS - 1); bin++)
+    {
+        sum += hist->bins[bin];
+        if (sum >= thrs)
+        {
+            val = _histUpper(bin) * 1000;
+            break;
+        }
+    }
+    return (double)MAX(MIN(val, hist->max), hist->min) * 1e-6;
+}
+
+static STATS_MSG_t *_statsGetMsg(STATS_t *stats, const PARSER_MSG_t *msg)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char *c = msg->name; *c != '\0'; c++)
+    {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    for (int n = 0; n < STATS_MAX_NAMES; n++)
+    {
+        STATS_MSG_t *entry = &stats->msgs[(hash + n) & (STATS_MAX_NAMES - 1)];
+        if (entry->name[0] == '\0')
+        {
+            // Keep one free slot so that lookups terminate
+            if (stats->numMsgs >= (STATS_MAX_NAMES - 1))
+            {
+                break;
+            }
+            snprintf(entry->name, sizeof(entry->name), "%s", msg->name);
+            entry->type = msg->type;
+            stats->numMsgs++;
+            return entry;
+        }
+        else if (strcmp(entry->name, msg->name) == 0)
+        {
+            return entry;
+        }
+    }
+    return &stats->other;
+}
+
+// Add message, ts = arrival time [ns] (or epoch time)
+static void _statsAdd(STATS_t *stats, const PARSER_MSG_t *msg, const bool haveTs, const uint64_t ts)
+{
+    STATS_MSG_t *entry = _statsGetMsg(stats, msg);
+    entry->count++;
+    entry->bytes += msg->size;
+
+    // Epoch detection, the epoch is completed by the first message of the next epoch (or UBX-NAV-EOE)
+    const bool isEoe = (msg->type == PARSER_MSGTYPE_UBX) && (strcmp(msg->name, "UBX-NAV-EOE") == 0);
+    if (epochCollect(&stats->coll, msg, &stats->epoch))
+    {
+        stats->nEpochs++;
+        stats->epochStart = !isEoe;
+    }
+    if (haveTs)
+    {
+        // Start a new segment if time jumps
+        if (stats->haveTs && (ts >= stats->lastTs) && ((ts - stats->lastTs) <= ((uint64_t)STATS_MAX_GAP * 1000000000)))
+        {
+            stats->dur += ts - stats->lastTs;
+        }
+        else
+        {
+            stats->seg++;
+            stats->haveEpochTs = false;
+        }
+        stats->haveTs = true;
+        stats->lastTs = ts;
+
+        if (stats->epochStart)
+        {
+            stats->epochTs = ts;
+            stats->haveEpochTs = true;
+        }
+        if ( (entry->count > 1) && (entry->lastSeg == stats->seg) )
+        {
+            _histAdd(&entry->interval, ts - entry->lastTs);
+        }
+        entry->lastTs = ts;
+        entry->lastSeg = stats->seg;
+        if (stats->haveLatency && stats->haveEpochTs)
+        {
+            _histAdd(&entry->latency, ts - stats->epochTs);
+        }
+    }
+    stats->epochStart = isEoe;
+}
+
+static int _statsMsgCmp(const void *a, const void *b)
+{
+    const STATS_MSG_t *ma = *(const STATS_MSG_t * const *)a;
+    const STATS_MSG_t *mb = *(const STATS_MSG_t * const *)b;
+    return strcmp(ma->name, mb->name);
+}
+
+static void _statsOutputMsg(const STATS_t *stats, const STATS_MSG_t *msg, const double dur, const bool extraInfo)
+{
+    const double rate = dur > 0.0 ? (double)msg->count / dur : 0.0;
+    const double bw   = dur > 0.0 ? (double)msg->bytes / dur : 0.0;
+    char link[20] = "     -";
+    if (stats->baudrate > 0)
+    {
+        snprintf(link, sizeof(link), "%6.2f", bw * 10.0 / (double)stats->baudrate * 1e2);
+    }
+    char interval[100] = "        -        -        -        -";
+    if (msg->interval.num > 0)
+    {
+        snprintf(interval, sizeof(interval), "%8.1f %8.1f %8.1f %8.1f",
+            msg->interval.sum / (double)msg->interval.num * 1e-6, _histPerc(&msg->interval, 0.5),
+            _histPerc(&msg->interval, 0.99), (double)msg->interval.max * 1e-6);
+    }
+    char latency[100] = "        -        -        -";
+    if (msg->latency.num > 0)
+    {
+        snprintf(latency, sizeof(latency), "%8.1f %8.1f %8.1f",
+            msg->latency.sum / (double)msg->latency.num * 1e-6, _histPerc(&msg->latency, 0.99),
+            (double)msg->latency.max * 1e-6);
+    }
+    ioOutputStr("stats %-24s %8" PRIu64 " %8.2f %10.1f %s %s %s\n",
+        msg->name, msg->count, rate, bw, link, interval, latency);
+
+    if (extraInfo)
+    {
+        const STATS_HIST_t *hists[] = { &msg->interval, &msg->latency };
+        const char *names[] = { "interval", "latency" };
+        for (int ix = 0; ix < NUMOF(hists); ix++)
+        {
+            if (hists[ix]->num == 0)
+            {
+                continue;
+            }
+            ioOutputStr("hist  %-24s %-8s", msg->name, names[ix]);
+            for (int bin = 0; bin < STATS_HIST_BINS; bin++)
+            {
+                if (hists[ix]->bins[bin] > 0)
+                {
+                    ioOutputStr(" <%.3f:%u", (double)_histUpper(bin) * 1e-3, hists[ix]->bins[bin]);
+                }
+            }
+            ioOutputStr("\n");
+        }
+    }
+}
+
+static bool _statsOutput(const STATS_t *stats, const bool extraInfo, const bool append)
+{
+    const double dur = (double)stats->dur * 1e-9;
+    const STATS_MSG_t *sorted[STATS_MAX_NAMES];
+    int num = 0;
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    for (int ix = 0; ix < STATS_MAX_NAMES; ix++)
+    {
+        if (stats->msgs[ix].name[0] != '\0')
+        {
+            sorted[num++] = &stats->msgs[ix];
+            count += stats->msgs[ix].count;
+            bytes += stats->msgs[ix].bytes;
+        }
+    }
+    qsort(sorted, num, sizeof(*sorted), _statsMsgCmp);
+
+    ioOutputStr("# duration %.3fs (%" PRIu32 " segments), %" PRIu64 " epochs, baudrate %d\n",
+        dur, stats->seg, stats->nEpochs, stats->baudrate);
+    ioOutputStr("#     %-24s %8s %8s %10s %6s %8s %8s %8s %8s %8s %8s %8s\n", "name",
+        "count", "rate", "bandw", "link", "int_mean", "int_p50", "int_p99", "int_max", "lat_mean", "lat_p99", "lat_max");
+    ioOutputStr("#     %-24s %8s %8s %10s %6s %8s %8s %8s %8s %8s %8s %8s\n", "",
+        "", "[Hz]", "[B/s]", "[%]", "[ms]", "[ms]", "[ms]", "[ms]", "[ms]", "[ms]", "[ms]");
+    for (int ix = 0; ix < num; ix++)
+    {
+        _statsOutputMsg(stats, sorted[ix], dur, extraInfo);
+    }
+    if (stats->other.count > 0)
+    {
+        _statsOutputMsg(stats, &stats->other, dur, extraInfo);
+        count += stats->other.count;
+        bytes += stats->other.bytes;
+    }
+    STATS_MSG_t total = { .count = count, .bytes = bytes };
+    snprintf(total.name, sizeof(total.name), "Total");
+    _statsOutputMsg(stats, &total, dur, false);
+    return ioWriteOutput(append);
+}
+
+/* ****************************************************************************************************************** */
+
+#define STATS_FILL_LEVEL (PARSER_BUF_SIZE / 2)
+
+static int _statsFile(STATS_t *stats, const char *inName, const bool extraInfo)
+{
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    if (parser == NULL)
+    {
+        return EXIT_OTHERFAIL;
+    }
+    parserInit(parser);
+
+    uint64_t inSize = 0;
+    const uint8_t *inData = ioMapInput(&inSize);
+    RXLOG_t *log = NULL;
+    if ( (inData != NULL) && rxlogIsLog(inData, (int)MIN(inSize, (uint64_t)RXLOG_HEAD_SIZE)) )
+    {
+        log = rxlogOpen(inName);
+        if (log == NULL)
+        {
+            free(parser);
+            return EXIT_OTHERFAIL;
+        }
+        stats->haveLatency = true;
+    }
+    parserSetTs(parser, log != NULL ? PARSER_TS_CHUNK : PARSER_TS_NONE, NULL, NULL);
+
+    PARSER_MSG_t msg;
+    bool eof = false;
+    while (!gAbort)
+    {
+        // Log: feed records to parser with their timestamps, and use them for the received messages
+        if (log != NULL)
+        {
+            if (parserProcess(parser, &msg, false) || (eof && parserFlush(parser, &msg)))
+            {
+                _statsAdd(stats, &msg, true, msg.ts);
+                continue;
+            }
+            else if (eof)
+            {
+                break;
+            }
+            RXLOG_REC_t rec;
+            do
+            {
+                eof = !rxlogRead(log, &rec);
+            }
+            while (!eof && (rec.src != PARSER_MSGSRC_FROM_RX));
+            if (!eof)
+            {
+                rxlogToParser(parser, &rec);
+            }
+        }
+        // Other input: use time of the last completed epoch
+        else
+        {
+            if (!eof && ((parser->offs + parser->size) < STATS_FILL_LEVEL))
+            {
+                const uint8_t *data = NULL;
+                const int num = ioGetInput(&data, parserSpace(parser));
+                if (num < 0)
+                {
+                    eof = true;
+                }
+                else if (num > 0)
+                {
+                    parserAdd(parser, data, num);
+                }
+            }
+            if (parserProcess(parser, &msg, false) || (eof && parserFlush(parser, &msg)))
+            {
+                const uint64_t nEpochs = stats->nEpochs;
+                const bool haveTs = (nEpochs > 0) && stats->epoch.haveGpsTow;
+                const uint64_t ts = haveTs ? (uint64_t)llround(((stats->epoch.haveGpsWeek ?
+                    (double)stats->epoch.gpsWeek * (7.0 * 86400.0) : 0.0) + stats->epoch.gpsTow) * 1e9) : 0;
+                _statsAdd(stats, &msg, haveTs, ts);
+            }
+            else if (eof)
+            {
+                break;
+            }
+        }
+    }
+
+    rxlogClose(log);
+    free(parser);
+    return _statsOutput(stats, extraInfo, false) ? EXIT_SUCCESS : EXIT_OTHERFAIL;
+}
+
+static int _statsRx(STATS_t *stats, const char *portArg, const bool extraInfo, const bool noProbe)
+{
+    RX_OPTS_t opts = RX_OPTS_DEFAULT();
+    if (noProbe)
+    {
+        opts.autobaud = false;
+        opts.detect   = RX_DET_NONE;
+    }
+    RX_t *rx = rxInit(portArg, &opts);
+    if ( (rx == NULL) || !rxOpen(rx) )
+    {
+        free(rx);
+        return EXIT_RXFAIL;
+    }
+    stats->haveLatency = true;
+    stats->baudrate = rxGetBaudrate(rx);
+
+    PRINT("Collecting statistics...");
+    bool res = true;
+    bool append = false;
+    uint64_t tOut = TIME();
+    while (!gAbort && res)
+    {
+        PARSER_MSG_t *msg = rxGetNextMessage(rx);
+        if (msg != NULL)
+        {
+            _statsAdd(stats, msg, true, timeMonoNs());
+        }
+        else
+        {
+            SLEEP(5);
+        }
+        if ( (TIME() - tOut) >= (STATS_LIVE_INTERVAL * 1000) )
+        {
+            tOut = TIME();
+            res = _statsOutput(stats, extraInfo, append);
+            append = true;
+        }
+    }
+    const uint32_t nMsgs = rxGetParser(rx)->nMsgs;
+    rxClose(rx);
+    free(rx);
+
+    if (res)
+    {
+        res = _statsOutput(stats, extraInfo, append);
+    }
+    return res ? (nMsgs > 0 ? EXIT_SUCCESS : EXIT_RXNODATA) : EXIT_OTHERFAIL;
+}
+
+int statsRun(const char *inName, const char *portArg, const bool extraInfo, const bool noProbe)
+{
+    STATS_t *stats = calloc(1, sizeof(STATS_t));
+    if ( (stats == NULL) || !epochInit(&stats->coll) || !epochInit(&stats->epoch) )
+    {
+        if (stats != NULL)
+        {
+            epochFree(&stats->coll);
+            epochFree(&stats->epoch);
+        }
+        free(stats);
+        return EXIT_OTHERFAIL;
+    }
+    snprintf(stats->other.name, sizeof(stats->other.name), "Other");
+
+    gAbort = false;
+    signal(SIGINT, _sigHandler);
+    signal(SIGTERM, _sigHandler);
+    NOT_WIN( signal(SIGHUP, _sigHandler) );
+
+    const int res = portArg != NULL ? _statsRx(stats, portArg, extraInfo, noProbe) : _statsFile(stats, inName, extraInfo);
+    epochFree(&stats->coll);
+    epochFree(&stats->epoch);
+    free(stats);
+    return res;
+}
+
+/* ****************************************************************************************************************** */
+// eof
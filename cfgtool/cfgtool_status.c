@@ -25,6 +25,8 @@
 #include "ff_rx.h"
 #include "ff_ubx.h"
 #include "ff_epoch.h"
+#include "ff_epochhist.h"
+#include "ff_prof.h"
 
 #include "cfgtool_status.h"
 
@@ -42,12 +44,20 @@ const char *statusHelp(void)
 "    detected epoch. This requires navigation messages, such as UBX-NAV-PVT to\n"
 "    be enabled. The program stops when SIGINT (e.g. CTRL-C)"NOT_WIN(", SIGHUP")"\n"
 "    or SIGTERM is received.\n"
+"\n"
+"    With -x, statistics over the last five minutes (fix rates, accuracy,\n"
+"    position spread, mean number of signals per C/N0 bin) are printed every\n"
+"    ten seconds.\n"
+"\n"
+"    If cfgtool was built with profiling (FF_PROF), a summary of the hot path\n"
+"    timings is printed at the end"NOT_WIN(" and on SIGUSR1")".\n"
 "\n";
 }
 
 /* ****************************************************************************************************************** */
 
 static bool gAbort;
+static bool gProfDump;
 
 static void _sigHandler(int signal)
 {
@@ -56,6 +66,12 @@ static void _sigHandler(int signal)
         PRINT("Aborting...");
         gAbort = true;
     }
+#ifndef _WIN32
+    else if (signal == SIGUSR1)
+    {
+        gProfDump = true;
+    }
+#endif
 }
 
 typedef struct INFO_s
@@ -115,12 +131,12 @@ static void _statusColour(const STATUS_COLOUR_t colour)
 
 #define COLOUR(col) if (colours) { _statusColour(CONCAT(STATUS_COLOUR_, col)); }
 
-static bool _printInfo(const bool colours, const INFO_t *info, const EPOCH_t *epoch)
+static bool _printInfo(const bool colours, const INFO_t *info, EPOCH_t *epoch)
 {
     ioOutputStr("%4u %4u %4u %4u %4u %4u %5u | ",
         info->nUbx, info->nNmea, info->nRtcm3, info->nSpartn, info->nNova, info->nGarb, epoch != NULL ? epoch->seq : 0);
 
-    const char *epochStr = "no navigation data";
+    const char *str = "no navigation data";
 
     if (epoch != NULL)
     {
@@ -151,10 +167,10 @@ static bool _printInfo(const bool colours, const INFO_t *info, const EPOCH_t *ep
                 break;
         }
 
-        epochStr = epoch->str;
+        str = epochStr(epoch);
     }
 
-    ioOutputStr("%s", epochStr);
+    ioOutputStr("%s", str);
     ioWriteOutput(true);
 
     COLOUR(OFF);
@@ -163,6 +179,24 @@ static bool _printInfo(const bool colours, const INFO_t *info, const EPOCH_t *ep
     return ioWriteOutput(true);
 }
 
+static bool _printStats(EPOCHHIST_t *hist)
+{
+    EPOCHHIST_STATS_t stats;
+    epochhistStats(hist, &stats);
+    ioOutputStr("Stats %5.1fs %5d epochs | fix %5.1f%% float %5.1f%% fixed %5.1f%% | hAcc %.3f (%.3f) max %.3f m | "
+        "CEP %.3f 2DRMS %.3f m | C/N0 trk/nav",
+        (double)stats.span * 1e-3, stats.numEpochs, stats.fixRate * 1e2, stats.rtkFloatRate * 1e2,
+        stats.rtkFixedRate * 1e2, stats.horizAccMean, stats.horizAccStd, stats.horizAccMax, stats.cep, stats.drms2);
+    const double num = stats.numSigCnoHist > 0 ? (double)stats.numSigCnoHist : 1.0;
+    for (int bin = 0; bin < EPOCH_SIGCNOHIST_NUM; bin++)
+    {
+        ioOutputStr(" %d:%.1f/%.1f", EPOCH_SIGCNOHIST_IX2CNO_L(bin),
+            (double)stats.sigCnoHistTrk[bin] / num, (double)stats.sigCnoHistNav[bin] / num);
+    }
+    ioOutputStr("\n");
+    return ioWriteOutput(true);
+}
+
 int statusRun(const char *portArg, const bool extraInfo, const bool noProbe)
 {
     RX_OPTS_t opts = RX_OPTS_DEFAULT();
@@ -178,10 +212,25 @@ int statusRun(const char *portArg, const bool extraInfo, const bool noProbe)
         return EXIT_RXFAIL;
     }
 
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    if (!epochInit(&coll) || !epochInit(&epoch))
+    {
+        epochFree(&coll);
+        epochFree(&epoch);
+        rxClose(rx);
+        free(rx);
+        return EXIT_OTHERFAIL;
+    }
+
     DEBUG_CFG_t debugCfg;
     debugGetCfg(&debugCfg);
 
-    (void)extraInfo;
+    EPOCHHIST_t *hist = NULL;
+    if (extraInfo)
+    {
+        hist = epochhistCreate(5 * 60 * 20, 5 * 60 * 1000); // 5 minutes at up to 20 Hz
+    }
 
     INFO_t info;
     memset(&info, 0, sizeof(info));
@@ -190,10 +239,12 @@ int statusRun(const char *portArg, const bool extraInfo, const bool noProbe)
     signal(SIGINT, _sigHandler);
     signal(SIGTERM, _sigHandler);
     NOT_WIN( signal(SIGHUP, _sigHandler) );
-
-    EPOCH_t coll;
-    EPOCH_t epoch;
-    epochInit(&coll);
+    gProfDump = false;
+    if (profEnabled())
+    {
+        NOT_WIN( signal(SIGUSR1, _sigHandler) );
+        profReset();
+    }
 
     PRINT("Dumping receiver status...");
 
@@ -201,9 +252,15 @@ int statusRun(const char *portArg, const bool extraInfo, const bool noProbe)
     ioWriteOutput(false);
 
     uint64_t lastEpoch = TIME();
+    uint64_t lastStats = lastEpoch;
 
     while (!gAbort)
     {
+        if (gProfDump)
+        {
+            gProfDump = false;
+            profDump();
+        }
         const uint64_t now = TIME();
         PARSER_MSG_t *msg = rxGetNextMessage(rx);
         if (msg != NULL)
@@ -217,6 +274,7 @@ int statusRun(const char *portArg, const bool extraInfo, const bool noProbe)
                 {
                     break;
                 }
+                epochhistAdd(hist, &epoch);
             }
             switch (msg->type)
             {
@@ -265,9 +323,22 @@ int statusRun(const char *portArg, const bool extraInfo, const bool noProbe)
             _printInfo(debugCfg.colour, &info, NULL);
             lastEpoch = now;
         }
+        if ( (hist != NULL) && ((now - lastStats) >= 10000) )
+        {
+            _printStats(hist);
+            lastStats = now;
+        }
     }
     bool res = ioWriteOutput(true);
 
+    if (profEnabled())
+    {
+        profDump();
+    }
+
+    epochhistDestroy(hist);
+    epochFree(&coll);
+    epochFree(&epoch);
     rxClose(rx);
     free(rx);
 
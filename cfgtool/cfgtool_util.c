@@ -24,6 +24,10 @@
 #include <stdarg.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif
 
 #include "ubloxcfg/ubloxcfg.h"
 
@@ -39,6 +43,7 @@ bool         gOutOverwrite;
 static char  gOutName[PATH_MAX];
 FILE        *gOutFile;
 int          gOutLineNr;
+static bool  gOutQuiet;
 
 void ioSetInput(const char *name, FILE *file)
 {
@@ -65,6 +70,11 @@ void ioSetOutput(const char *name, FILE *file, const bool overwrite)
     gOutOverwrite = overwrite;
 }
 
+void ioSetOutputQuiet(const bool quiet)
+{
+    gOutQuiet = quiet;
+}
+
 IO_LINE_t *ioGetNextInputLine(void)
 {
     static char line[INPUT_MAX_LINE_LEN];
@@ -137,50 +147,193 @@ int ioReadInput(uint8_t *data, const int size)
 }
 
 
-static char gOutputBuf[1024 * 1024] = { 0 };
-static int gOutputBufSize = 0;
+// Input from regular files is memory mapped and handed out directly, other inputs (pipes, terminals, ...) are read in
+// large blocks of what is currently available
+#define INPUT_BLOCK_SIZE (64 * 1024)
 
-void ioOutputStr(const char *fmt, ...)
+static const uint8_t *gInMap;
+static uint64_t       gInMapSize;
+static uint64_t       gInMapOffs;
+static bool           gInMapTried;
+
+const uint8_t *ioMapInput(uint64_t *size)
 {
-    const int totSize = sizeof(gOutputBuf);
-    if (gOutputBufSize >= totSize)
+#ifndef _WIN32
+    if (!gInMapTried)
     {
-        return;
+        gInMapTried = true;
+        const int fd = fileno(gInFile);
+        struct stat st;
+        if ( (fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0) )
+        {
+            void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED)
+            {
+                madvise(map, st.st_size, MADV_SEQUENTIAL);
+                gInMap = map;
+                gInMapSize = st.st_size;
+                gInMapOffs = 0;
+                DEBUG("Mapped input '%s' (%" PRIu64 " bytes)", gInName, gInMapSize);
+            }
+            else
+            {
+                DEBUG("Failed mapping input '%s': %s", gInName, strerror(errno));
+            }
+        }
     }
+#endif
+    if (size != NULL)
+    {
+        *size = gInMapSize;
+    }
+    return gInMap;
+}
 
-    const int remSize = totSize - gOutputBufSize;
+int ioGetInput(const uint8_t **data, const int size)
+{
+    if ( (data == NULL) || (size <= 0) )
+    {
+        return 0;
+    }
 
-    va_list args;
-    va_start(args, fmt);
-    const int writeSize = vsnprintf(&gOutputBuf[gOutputBufSize], remSize, fmt, args);
-    va_end(args);
+    if (ioMapInput(NULL) != NULL)
+    {
+        const int num = (int)MIN((uint64_t)size, gInMapSize - gInMapOffs);
+        if (num <= 0)
+        {
+            return -1;
+        }
+        *data = &gInMap[gInMapOffs];
+        gInMapOffs += num;
+        return num;
+    }
 
-    if (writeSize > remSize)
+    static uint8_t buf[INPUT_BLOCK_SIZE];
+    const int num = read(fileno(gInFile), buf, MIN(size, (int)sizeof(buf)));
+    if (num > 0)
+    {
+        *data = buf;
+        return num;
+    }
+    else if (num == 0)
+    {
+        return -1;
+    }
+    else if ( (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR) )
     {
-        gOutputBufSize = totSize;
+        return 0;
     }
     else
     {
-        gOutputBufSize += writeSize;
+        WARNING("Failed reading '%s': %s", gInName, strerror(errno));
+        return -1;
     }
 }
 
-void ioAddOutputBin(const uint8_t *data, const int size)
+// Output is collected in a buffer and written to the output file descriptor in large blocks. The output is opened on
+// the first ioWriteOutput() call, before that the buffer grows as needed (so that commands can decide not to produce
+// output at all). Output to regular files is written once a block is full (or on ioCloseOutput()), output to
+// terminals, pipes, etc. is written on every ioWriteOutput() call.
+#define OUTPUT_BLOCK_SIZE (4 * 1024 * 1024)
+
+static char  *gOutputBuf;
+static int    gOutputBufSize;
+static int    gOutputBufAlloc;
+static int    gOutputFd = -1;
+static bool   gOutputIsFile;
+static bool   gOutputFail;
+
+static bool _outputFlush(void)
 {
-    const int totSize = sizeof(gOutputBuf);
-    if (gOutputBufSize >= totSize)
+    if (gOutputFd < 0)
     {
-        return;
+        return true;
     }
+    int offs = 0;
+    while (!gOutputFail && (offs < gOutputBufSize))
+    {
+        const int res = write(gOutputFd, &gOutputBuf[offs], gOutputBufSize - offs);
+        if (res > 0)
+        {
+            offs += res;
+        }
+        else if ( (res < 0) && ((errno == EINTR) || (errno == EAGAIN)) )
+        {
+            continue;
+        }
+        else
+        {
+            WARNING("Failed writing '%s': %s", gOutName, res < 0 ? strerror(errno) : "Unknown error");
+            gOutputFail = true;
+        }
+    }
+    TRACE("Wrote %d bytes to '%s'.", offs, gOutName);
+    gOutputBufSize = 0;
+    return !gOutputFail;
+}
 
-    const int remSize = totSize - gOutputBufSize;
-    if (remSize < size)
+// Make sure there's space for size more bytes in the output buffer
+static bool _outputReserve(const int size)
+{
+    if ( (gOutputBufSize + size) <= gOutputBufAlloc )
     {
-        return;
+        return true;
+    }
+    if ( (gOutputFd >= 0) && (gOutputBufSize > 0) )
+    {
+        _outputFlush();
+        if ( size <= gOutputBufAlloc )
+        {
+            return true;
+        }
+    }
+    int newAlloc = MAX(gOutputBufAlloc, OUTPUT_BLOCK_SIZE);
+    while (newAlloc < (gOutputBufSize + size))
+    {
+        newAlloc *= 2;
+    }
+    char *newBuf = realloc(gOutputBuf, newAlloc);
+    if (newBuf == NULL)
+    {
+        WARNING("Failed allocating output buffer (%d bytes)!", newAlloc);
+        return false;
     }
+    gOutputBuf = newBuf;
+    gOutputBufAlloc = newAlloc;
+    return true;
+}
 
-    memcpy(&gOutputBuf[gOutputBufSize], data, size);
-    gOutputBufSize += size;
+void ioOutputStr(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    va_list args2;
+    va_copy(args2, args);
+    const int remSize = gOutputBufAlloc - gOutputBufSize;
+    const int writeSize = vsnprintf(remSize > 0 ? &gOutputBuf[gOutputBufSize] : NULL, remSize, fmt, args);
+    va_end(args);
+    if ( (writeSize >= remSize) && (writeSize > 0) )
+    {
+        if (_outputReserve(writeSize + 1))
+        {
+            vsnprintf(&gOutputBuf[gOutputBufSize], gOutputBufAlloc - gOutputBufSize, fmt, args2);
+            gOutputBufSize += writeSize;
+        }
+    }
+    else if (writeSize > 0)
+    {
+        gOutputBufSize += writeSize;
+    }
+    va_end(args2);
+}
+
+void ioAddOutputBin(const uint8_t *data, const int size)
+{
+    if ( (size > 0) && _outputReserve(size) )
+    {
+        memcpy(&gOutputBuf[gOutputBufSize], data, size);
+        gOutputBufSize += size;
+    }
 }
 
 void ioAddOutputHex(const uint8_t *data, const int size, const int wordsPerLine, const bool ugly)
@@ -223,87 +376,199 @@ void ioAddOutputC(const uint8_t *data, const int size, const int wordsPerLine, c
     }
 }
 
-void ioAddOutputHexdump(const uint8_t *data, const int size)
+int ioHexdumpLine(char *str, const uint8_t *data, const int size, const int ix)
 {
     const char i2hex[] = "0123456789abcdef";
-    const uint8_t *pData = data;
-    for (int ix = 0; ix < size; )
-    {
-        char str[70];
-        memset(str, ' ', sizeof(str));
-        str[50] = '|';
-        str[67] = '|';
-        str[68] = '\0';
-        for (int ix2 = 0; (ix2 < 16) && ((ix + ix2) < size); ix2++)
+    char hex[70];
+    memset(hex, ' ', sizeof(hex));
+    hex[50] = '|';
+    hex[67] = '|';
+    hex[68] = '\0';
+    for (int ix2 = 0; (ix2 < 16) && ((ix + ix2) < size); ix2++)
+    {
+        //           1         2         3         4         5         6
+        // 012345678901234567890123456789012345678901234567890123456789012345678
+        // xx xx xx xx xx xx xx xx  xx xx xx xx xx xx xx xx  |................|\0
+        // 0  1  2  3  4  5  6  7   8  9  10 11 12 13 14 15
+        const uint8_t c = data[ix + ix2];
+        int pos1 = 3 * ix2;
+        int pos2 = 51 + ix2;
+        if (ix2 > 7)
         {
-            //           1         2         3         4         5         6
-            // 012345678901234567890123456789012345678901234567890123456789012345678
-            // xx xx xx xx xx xx xx xx  xx xx xx xx xx xx xx xx  |................|\0
-            // 0  1  2  3  4  5  6  7   8  9  10 11 12 13 14 15
-            const uint8_t c = pData[ix + ix2];
-            int pos1 = 3 * ix2;
-            int pos2 = 51 + ix2;
-            if (ix2 > 7)
-            {
-                   pos1++;
-            }
-            str[pos1    ] = i2hex[ (c >> 4) & 0xf ];
-            str[pos1 + 1] = i2hex[  c       & 0xf ];
-
-            str[pos2] = isprint((int)c) ? c : '.';
+            pos1++;
         }
-        ioOutputStr("0x%04"PRIx8" %05d  %s\n", ix, ix, str);
-        ix += 16;
+        hex[pos1    ] = i2hex[ (c >> 4) & 0xf ];
+        hex[pos1 + 1] = i2hex[  c       & 0xf ];
+
+        hex[pos2] = isprint((int)c) ? c : '.';
     }
+    return snprintf(str, IO_HEXDUMP_LINE_SIZE, "0x%04"PRIx8" %05d  %s\n", ix, ix, hex);
 }
 
-bool ioWriteOutput(const bool append)
+void ioAddOutputHexdump(const uint8_t *data, const int size)
 {
-    const int totSize = sizeof(gOutputBuf);
-    if (gOutputBufSize >= totSize)
+    for (int ix = 0; ix < size; ix += 16)
     {
-        WARNING("Too much output data, not writing to '%s'!", gOutName);
-        return false;
+        char str[IO_HEXDUMP_LINE_SIZE];
+        const int len = ioHexdumpLine(str, data, size, ix);
+        ioAddOutputBin((const uint8_t *)str, len);
     }
+}
 
-    const char *failStr = NULL;
-    bool res = true;
-    if ( (gOutFile != stdout) && (gOutFile != stderr) )
+bool ioWriteOutput(const bool append)
+{
+    // Open output
+    if ( (gOutputFd < 0) && !gOutputFail )
     {
-        if (!append && !gOutOverwrite && (access(gOutName, F_OK) == 0))
+        const char *failStr = NULL;
+        if ( (gOutFile == stdout) || (gOutFile == stderr) )
+        {
+            fflush(gOutFile);
+            gOutputFd = fileno(gOutFile);
+        }
+        else if (!append && !gOutOverwrite && (access(gOutName, F_OK) == 0))
         {
             failStr = "File already exists";
-            res = false;
         }
-
-        if (res)
+        else
         {
-            gOutFile = fopen(gOutName, append ? "a" : "w");
-            if (gOutFile == NULL)
+            gOutputFd = open(gOutName, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC) IF_WIN(| O_BINARY), 0666);
+            if (gOutputFd < 0)
             {
                 failStr = strerror(errno);
+            }
+        }
+        if (gOutputFd < 0)
+        {
+            WARNING("Failed writing '%s': %s", gOutName, failStr == NULL ? "Unknown error" : failStr);
+            gOutputFail = true;
+            gOutputBufSize = 0;
+            return false;
+        }
+        struct stat st;
+        gOutputIsFile = (fstat(gOutputFd, &st) == 0) && S_ISREG(st.st_mode);
+        if (!append && !gOutQuiet)
+        {
+            PRINT("Writing output to '%s'.", gOutName);
+        }
+    }
+
+    // Write output, for files only once we have a full block
+    if (gOutputFail)
+    {
+        gOutputBufSize = 0;
+        return false;
+    }
+    else if (!gOutputIsFile || (gOutputBufSize >= OUTPUT_BLOCK_SIZE))
+    {
+        return _outputFlush();
+    }
+    else
+    {
+        return true;
+    }
+}
+
+bool ioCloseOutput(void)
+{
+    bool res = true;
+    if (gOutputFd >= 0)
+    {
+        res = _outputFlush();
+        if ( (gOutFile != stdout) && (gOutFile != stderr) )
+        {
+            if (close(gOutputFd) != 0)
+            {
+                WARNING("Failed closing '%s': %s", gOutName, strerror(errno));
                 res = false;
             }
         }
+        gOutputFd = -1;
     }
+    free(gOutputBuf);
+    gOutputBuf = NULL;
+    gOutputBufSize = 0;
+    gOutputBufAlloc = 0;
+    return res && !gOutputFail;
+}
+
+// Epoch output in the formats of ff_epochfmt.h. Text output (EPOCHFMT_STR) is left to the commands, as they all
+// format it a bit differently. Columnar blocks are output when they are full and at the end.
+
+static EPOCHFMT_t  gEpochFmt;
+static EPOCHCOL_t *gEpochCol;
 
-    if (res)
+static void _outputEpochCol(void)
+{
+    int size = 0;
+    const uint8_t *block = epochcolFlush(gEpochCol, &size);
+    if (block != NULL)
     {
-        if (!append)
+        ioAddOutputBin(block, size);
+    }
+}
+
+bool ioEpochOutputBegin(const EPOCHFMT_t fmt)
+{
+    gEpochFmt = fmt;
+    switch (fmt)
+    {
+        case EPOCHFMT_CSV:
         {
-            PRINT("Writing output to '%s'.", gOutName);
+            char str[EPOCHFMT_STR_SIZE];
+            ioAddOutputBin((const uint8_t *)str, epochfmtCsvHeader(str, sizeof(str)));
+            break;
         }
-        TRACE("Writing output to '%s' (%d bytes).", gOutName, gOutputBufSize);
-        res = (int)fwrite(gOutputBuf, 1, gOutputBufSize, gOutFile) == gOutputBufSize;
+        case EPOCHFMT_COL:
+            gEpochCol = epochcolCreate(0, true);
+            return gEpochCol != NULL;
+        case EPOCHFMT_STR:
+        case EPOCHFMT_JSON:
+        case EPOCHFMT_BIN:
+            break;
     }
+    return true;
+}
 
-    gOutputBufSize = 0;
+void ioAddOutputEpoch(EPOCH_t *epoch)
+{
+    switch (gEpochFmt)
+    {
+        case EPOCHFMT_CSV:
+        case EPOCHFMT_JSON:
+        {
+            char str[EPOCHFMT_STR_SIZE];
+            const int len = gEpochFmt == EPOCHFMT_CSV ?
+                epochfmtCsv(str, sizeof(str), epoch) : epochfmtJson(str, sizeof(str), epoch);
+            ioAddOutputBin((const uint8_t *)str, len);
+            break;
+        }
+        case EPOCHFMT_BIN:
+        {
+            uint8_t data[EPOCHFMT_BIN_SIZE];
+            ioAddOutputBin(data, epochfmtBin(data, sizeof(data), epoch));
+            break;
+        }
+        case EPOCHFMT_COL:
+            if (!epochcolAdd(gEpochCol, epoch))
+            {
+                _outputEpochCol();
+                epochcolAdd(gEpochCol, epoch);
+            }
+            break;
+        case EPOCHFMT_STR:
+            break;
+    }
+}
 
-    if (!res)
+void ioEpochOutputEnd(void)
+{
+    if (gEpochCol != NULL)
     {
-        WARNING("Failed writing '%s': %s", gOutName, failStr == NULL ? "Unknown error" : failStr);
+        _outputEpochCol();
+        epochcolDestroy(gEpochCol);
+        gEpochCol = NULL;
     }
-    return res;
 }
 
 /* ****************************************************************************************************************** */
@@ -23,6 +23,7 @@
 #include "ubloxcfg/ubloxcfg.h"
 #include "ff_debug.h"
 #include "ff_stuff.h"
+#include "ff_epochfmt.h"
 
 #ifndef __CFGTOOL_UTIL_H__
 #define __CFGTOOL_UTIL_H__
@@ -44,15 +45,24 @@ typedef struct IO_LINE_s
 } IO_LINE_t;
 
 void ioSetOutput(const char *name, FILE *file, const bool overwrite);
+void ioSetOutputQuiet(const bool quiet);
 void ioSetInput(const char *name, FILE *file);
 IO_LINE_t *ioGetNextInputLine(void);
 int  ioReadInput(uint8_t *data, const int size);
+int  ioGetInput(const uint8_t **data, const int size);
+const uint8_t *ioMapInput(uint64_t *size);
 void ioOutputStr(const char *fmt, ...);
 void ioAddOutputBin(const uint8_t *data, const int size);
 void ioAddOutputHex(const uint8_t *data, const int size, const int wordsPerLine, const bool ugly);
 void ioAddOutputHexdump(const uint8_t *data, const int size);
+#define IO_HEXDUMP_LINE_SIZE 100
+int  ioHexdumpLine(char *str, const uint8_t *data, const int size, const int ix);
 void ioAddOutputC(const uint8_t *data, const int size, const int wordsPerLine, const char *indent);
 bool ioWriteOutput(const bool append);
+bool ioCloseOutput(void);
+bool ioEpochOutputBegin(const EPOCHFMT_t fmt);
+void ioAddOutputEpoch(EPOCH_t *epoch);
+void ioEpochOutputEnd(void);
 
 bool layersStringToFlags(const char *layers, bool *ram, bool *bbr, bool *flash, bool *def);
 
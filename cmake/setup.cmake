@@ -84,6 +84,16 @@ if (NOT FF_VERSION_IS_SET) # Do this only once. E.g. when running the top-level
 endif()
 
 
+########################################################################################################################
+# Hot path profiling (ff_prof.h), off by default: cmake -DFF_PROF=ON
+if (NOT FF_PROF_IS_SET)
+    if (FF_PROF)
+        add_compile_definitions(FF_PROF=1)
+    endif()
+    set(FF_PROF_IS_SET ON)
+endif()
+
+
 ########################################################################################################################
 # Some debugging
 message(STATUS "ff: CMAKE_INSTALL_PREFIX=${CMAKE_INSTALL_PREFIX}")
@@ -91,6 +101,7 @@ message(STATUS "ff: CMAKE_PREFIX_PATH=${CMAKE_PREFIX_PATH}")
 message(STATUS "ff: CMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}")
 message(STATUS "ff: FF_VERSION_NUMBER=${FF_VERSION_NUMBER}")
 message(STATUS "ff: FF_VERSION_STRING=${FF_VERSION_STRING}")
+message(STATUS "ff: FF_PROF=${FF_PROF}")
 
 
 ########################################################################################################################
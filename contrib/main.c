@@ -27,9 +27,16 @@ int main()
 
 	const uint64_t tOffs = TIME() - timeOfDay(); // Offset between wall clock and parser time reference
 
-	EPOCH_t coll;
-	EPOCH_t epoch;
-	epochInit(&coll);
+	EPOCH_t coll = { 0 };
+	EPOCH_t epoch = { 0 };
+	if (!epochInit(&coll) || !epochInit(&epoch)) {
+		epochFree(&coll);
+		epochFree(&epoch);
+		rxClose(rx);
+		free(rx);
+		printf("epoch init failed\n");
+		return -1;
+	}
 
 	printf("Dumping received data...\n");
 	while (true)
@@ -103,6 +110,8 @@ int main()
 		}
 	}
 
+	epochFree(&coll);
+	epochFree(&epoch);
 	rxClose(rx);
 	free(rx);
 	return 0;
@@ -30,6 +30,7 @@
 #include "ff_debug.h"
 #include "ff_trafo.h"
 #include "ff_time.h"
+#include "ff_prof.h"
 
 #include "ff_epoch.h"
 
@@ -38,9 +39,158 @@
 //#define EPOCH_DEBUG(fmt, args...) DEBUG("epoch: " fmt, ## args)
 #define EPOCH_DEBUG(...) /* nothing */
 
-void epochInit(EPOCH_t *coll)
+// Carve an array of the given size from the memory, or only count the size if mem is NULL
+static void *_epochCarve(uint8_t *mem, size_t *offs, const size_t size)
+{
+    void *ptr = mem != NULL ? &mem[*offs] : NULL;
+    *offs += (size + 7) & ~(size_t)7;
+    return ptr;
+}
+
+static size_t _epochLayout(EPOCH_t *coll, uint8_t *mem, const int maxSig, const int maxSat)
+{
+    size_t offs = 0;
+    EPOCH_SIGNALS_t *sig = &coll->signals;
+    sig->gnss       = _epochCarve(mem, &offs, maxSig * sizeof(*sig->gnss));
+    sig->signal     = _epochCarve(mem, &offs, maxSig * sizeof(*sig->signal));
+    sig->band       = _epochCarve(mem, &offs, maxSig * sizeof(*sig->band));
+    sig->prRes      = _epochCarve(mem, &offs, maxSig * sizeof(*sig->prRes));
+    sig->cno        = _epochCarve(mem, &offs, maxSig * sizeof(*sig->cno));
+    sig->use        = _epochCarve(mem, &offs, maxSig * sizeof(*sig->use));
+    sig->corr       = _epochCarve(mem, &offs, maxSig * sizeof(*sig->corr));
+    sig->iono       = _epochCarve(mem, &offs, maxSig * sizeof(*sig->iono));
+    sig->health     = _epochCarve(mem, &offs, maxSig * sizeof(*sig->health));
+    sig->satIx      = _epochCarve(mem, &offs, maxSig * sizeof(*sig->satIx));
+    sig->sv         = _epochCarve(mem, &offs, maxSig * sizeof(*sig->sv));
+    sig->gloFcn     = _epochCarve(mem, &offs, maxSig * sizeof(*sig->gloFcn));
+    sig->prUsed     = _epochCarve(mem, &offs, maxSig * sizeof(*sig->prUsed));
+    sig->crUsed     = _epochCarve(mem, &offs, maxSig * sizeof(*sig->crUsed));
+    sig->doUsed     = _epochCarve(mem, &offs, maxSig * sizeof(*sig->doUsed));
+    sig->anyUsed    = _epochCarve(mem, &offs, maxSig * sizeof(*sig->anyUsed));
+    sig->prCorrUsed = _epochCarve(mem, &offs, maxSig * sizeof(*sig->prCorrUsed));
+    sig->crCorrUsed = _epochCarve(mem, &offs, maxSig * sizeof(*sig->crCorrUsed));
+    sig->doCorrUsed = _epochCarve(mem, &offs, maxSig * sizeof(*sig->doCorrUsed));
+    EPOCH_SATELLITES_t *sat = &coll->satellites;
+    sat->gnss       = _epochCarve(mem, &offs, maxSat * sizeof(*sat->gnss));
+    sat->orbUsed    = _epochCarve(mem, &offs, maxSat * sizeof(*sat->orbUsed));
+    sat->orbAvail   = _epochCarve(mem, &offs, maxSat * sizeof(*sat->orbAvail));
+    sat->azim       = _epochCarve(mem, &offs, maxSat * sizeof(*sat->azim));
+    sat->sv         = _epochCarve(mem, &offs, maxSat * sizeof(*sat->sv));
+    sat->elev       = _epochCarve(mem, &offs, maxSat * sizeof(*sat->elev));
+    const int maxSort = MAX(maxSig, maxSat);
+    coll->_sortKeys = _epochCarve(mem, &offs, maxSort * sizeof(*coll->_sortKeys));
+    coll->_sortTmp  = _epochCarve(mem, &offs, maxSort * sizeof(uint64_t));
+    return offs;
+}
+
+// Messages relevant for epoch detection and collection, keep in sync with _detectUbx(), _collectUbx(), _detectNmea()
+// and _collectNmea(). UBX-NAV messages by message ID, NMEA (standard sentences) by formatter.
+static const bool kEpochUbxNavRelevant[256] =
+{
+    [UBX_NAV_EOE_MSGID]      = true, [UBX_NAV_PVT_MSGID]      = true, [UBX_NAV_SAT_MSGID]       = true,
+    [UBX_NAV_ORB_MSGID]      = true, [UBX_NAV_STATUS_MSGID]   = true, [UBX_NAV_SIG_MSGID]       = true,
+    [UBX_NAV_CLOCK_MSGID]    = true, [UBX_NAV_DOP_MSGID]      = true, [UBX_NAV_POSECEF_MSGID]   = true,
+    [UBX_NAV_POSLLH_MSGID]   = true, [UBX_NAV_VELECEF_MSGID]  = true, [UBX_NAV_VELNED_MSGID]    = true,
+    [UBX_NAV_GEOFENCE_MSGID] = true, [UBX_NAV_TIMEUTC_MSGID]  = true, [UBX_NAV_TIMELS_MSGID]    = true,
+    [UBX_NAV_TIMEGPS_MSGID]  = true, [UBX_NAV_TIMEGLO_MSGID]  = true, [UBX_NAV_TIMEBDS_MSGID]   = true,
+    [UBX_NAV_TIMEGAL_MSGID]  = true, [UBX_NAV_SVIN_MSGID]     = true, [UBX_NAV_ODO_MSGID]       = true,
+    [UBX_NAV_HPPOSLLH_MSGID] = true, [UBX_NAV_HPPOSECEF_MSGID] = true, [UBX_NAV_RELPOSNED_MSGID] = true,
+};
+#define _EPOCH_NMEA_KEY(_a_, _b_, _c_) ( ((uint32_t)(_a_) << 16) | ((uint32_t)(_b_) << 8) | (uint32_t)(_c_) )
+static const uint32_t kEpochNmeaRelevant[] =
+{
+    _EPOCH_NMEA_KEY('G', 'G', 'A'), _EPOCH_NMEA_KEY('R', 'M', 'C'), _EPOCH_NMEA_KEY('G', 'L', 'L'),
+    _EPOCH_NMEA_KEY('G', 'S', 'V'), _EPOCH_NMEA_KEY('G', 'S', 'A'), _EPOCH_NMEA_KEY('G', 'S', 'T'),
+    _EPOCH_NMEA_KEY('V', 'T', 'G'), _EPOCH_NMEA_KEY('Z', 'D', 'A'),
+};
+
+// Check if message is relevant, without decoding it
+static bool _epochRelevant(const PARSER_MSG_t *msg)
+{
+    switch (msg->type)
+    {
+        case PARSER_MSGTYPE_UBX:
+        {
+            if (UBX_CLSID(msg->data) != UBX_NAV_CLSID)
+            {
+                return false;
+            }
+            return kEpochUbxNavRelevant[UBX_MSGID(msg->data)];
+        }
+        case PARSER_MSGTYPE_NMEA:
+        {
+            // 0123456
+            // $GNGGA,...
+            if ( (msg->size < 11) || (msg->data[6] != ',') )
+            {
+                return false;
+            }
+            const uint32_t key = _EPOCH_NMEA_KEY(msg->data[3], msg->data[4], msg->data[5]);
+            for (int ix = 0; ix < NUMOF(kEpochNmeaRelevant); ix++)
+            {
+                if (key == kEpochNmeaRelevant[ix])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+bool epochInit(EPOCH_t *coll)
+{
+    return epochInitSize(coll, EPOCH_DEF_MAX_SIGNALS, EPOCH_DEF_MAX_SATELLITES);
+}
+
+bool epochInitSize(EPOCH_t *coll, const int maxSignals, const int maxSatellites)
 {
     memset(coll, 0, sizeof(*coll));
+    // The sort keys hold the index in the lower 16 bits
+    const int maxSig = CLIP(maxSignals, 0, 0xffff);
+    const int maxSat = CLIP(maxSatellites, 0, 0xffff);
+    const size_t size = _epochLayout(coll, NULL, maxSig, maxSat);
+    uint8_t *mem = calloc(1, size);
+    if (mem == NULL)
+    {
+        WARNING("epoch: malloc fail");
+        memset(coll, 0, sizeof(*coll));
+        return false;
+    }
+    _epochLayout(coll, mem, maxSig, maxSat);
+    coll->_mem = mem;
+    coll->signals.max = maxSig;
+    coll->satellites.max = maxSat;
+    return true;
+}
+
+void epochFree(EPOCH_t *coll)
+{
+    if (coll != NULL)
+    {
+        free(coll->_mem);
+        memset(coll, 0, sizeof(*coll));
+    }
+}
+
+// Clear collected data, but keep the arrays
+static void _epochClear(EPOCH_t *coll)
+{
+    EPOCH_SIGNALS_t signals = coll->signals;
+    EPOCH_SATELLITES_t satellites = coll->satellites;
+    void *mem = coll->_mem;
+    uint64_t *sortKeys = coll->_sortKeys;
+    void *sortTmp = coll->_sortTmp;
+    memset(coll, 0, sizeof(*coll));
+    signals.num = 0;
+    satellites.num = 0;
+    coll->signals = signals;
+    coll->satellites = satellites;
+    coll->_mem = mem;
+    coll->_sortKeys = sortKeys;
+    coll->_sortTmp = sortTmp;
 }
 
 // "Quality" (precision) if information: UBX better than NMEA, UBX high-precision messages better than normal UBX
@@ -68,6 +218,8 @@ typedef struct EPOCH_COLLECT_s
     COLL_QUAL_t  haveRelPos;
     bool         relPosValid;
     COLL_QUAL_t  haveDiffAge;
+    COLL_QUAL_t  haveNumSv;
+    COLL_QUAL_t  haveDop;
 } EPOCH_COLLECT_t;
 
 STATIC_ASSERT(SIZEOF_MEMBER(EPOCH_t, _collect) >= sizeof(EPOCH_COLLECT_t));
@@ -79,17 +231,63 @@ typedef struct EPOCH_DETECT_s
     bool         haveUbxItow;
     int          nmeaMs;
     bool         haveNmeaMs;
+    uint32_t     expected;     // Expected messages (EPOCH_EXPECT_e bits)
+    uint32_t     seen;         // Seen messages (EPOCH_EXPECT_e bits) for ubxItow
+    uint32_t     doneItow;     // iTOW of the last completed epoch
+    bool         haveDoneItow;
+    bool         noStrings;    // Stringification disabled
 } EPOCH_DETECT_t;
 
 STATIC_ASSERT(SIZEOF_MEMBER(EPOCH_t, _detect) >= sizeof(EPOCH_DETECT_t));
 
-static bool _detectUbx(EPOCH_DETECT_t *detect, const PARSER_MSG_t *msg);
+// Epoch detection result (bits)
+typedef enum DETECT_e
+{
+    DETECT_NONE   = 0x00, // Nothing detected, message belongs to current epoch
+    DETECT_BEFORE = 0x01, // Epoch complete before this message, which belongs to the next epoch
+    DETECT_AFTER  = 0x02, // Epoch complete with this message
+    DETECT_SKIP   = 0x04, // Message belongs to an already completed epoch, ignore it
+} DETECT_t;
+
+// Derived data not yet calculated (EPOCH_t._lazy bits)
+typedef enum LAZY_e
+{
+    LAZY_NONE      = 0x00,
+    LAZY_LLH       = 0x01, // llh from xyz
+    LAZY_XYZ       = 0x02, // xyz from llh
+    LAZY_POSIXTIME = 0x04, // _posixTime from gpsWeek and gpsTow
+    LAZY_LATENCY   = 0x08, // _latency from _posixTime and ts
+    LAZY_STR       = 0x10, // _str
+    LAZY_UPTIMESTR = 0x20, // _uptimeStr from uptime
+} LAZY_t;
+
+static int _detectUbx(EPOCH_DETECT_t *detect, const PARSER_MSG_t *msg);
 static bool _detectNmea(EPOCH_DETECT_t *detect, const NMEA_MSG_t *nmea);
 
 static void _collectUbx(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const PARSER_MSG_t *msg);
 static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG_t *nmea);
 
 static void _epochComplete(const EPOCH_COLLECT_t *collect, EPOCH_t *epoch);
+static void _epochOutput(EPOCH_t *coll, EPOCH_t *epoch);
+
+void epochSetExpected(EPOCH_t *coll, const uint32_t expected)
+{
+    if (coll != NULL)
+    {
+        EPOCH_DETECT_t *detect = (EPOCH_DETECT_t *)coll->_detect;
+        detect->expected = expected;
+        detect->seen = 0;
+    }
+}
+
+void epochSetStrings(EPOCH_t *coll, const bool enable)
+{
+    if (coll != NULL)
+    {
+        EPOCH_DETECT_t *detect = (EPOCH_DETECT_t *)coll->_detect;
+        detect->noStrings = !enable;
+    }
+}
 
 bool epochCollect(EPOCH_t *coll, const PARSER_MSG_t *msg, EPOCH_t *epoch)
 {
@@ -97,10 +295,16 @@ bool epochCollect(EPOCH_t *coll, const PARSER_MSG_t *msg, EPOCH_t *epoch)
     {
         return false;
     }
+    // Ignore messages that are neither used for detection nor for collection, without decoding them
+    if (!_epochRelevant(msg))
+    {
+        return false;
+    }
     EPOCH_COLLECT_t *collect = (EPOCH_COLLECT_t *)coll->_collect;
     EPOCH_DETECT_t  *detect  = (EPOCH_DETECT_t *)coll->_detect;
+    PROF_START(t0);
 
-    // Decode NMEA here, as this is quite expensive
+    // Decode NMEA here, once, as it is needed for both detection and collection
     NMEA_MSG_t nmea;
     bool haveNmea = false;
     if (msg->type == PARSER_MSGTYPE_NMEA)
@@ -109,137 +313,190 @@ bool epochCollect(EPOCH_t *coll, const PARSER_MSG_t *msg, EPOCH_t *epoch)
     }
 
     // Detect end of epoch / start of next epoch
-    bool complete = false;
+    int detected = DETECT_NONE;
     switch (msg->type)
     {
         case PARSER_MSGTYPE_UBX:
-            complete = _detectUbx(detect, msg);
-            if (complete)
+            detected = _detectUbx(detect, msg);
+            if ((detected & (DETECT_BEFORE | DETECT_AFTER)) != 0)
             {
                 detect->haveNmeaMs = false;
             }
             break;
         case PARSER_MSGTYPE_NMEA:
-            if (haveNmea)
+            if (haveNmea && _detectNmea(detect, &nmea))
             {
-                complete = _detectNmea(detect, &nmea);
-                if (complete)
-                {
-                    detect->haveUbxItow = false;
-                }
+                detected = DETECT_BEFORE;
+                detect->haveUbxItow = false;
+                detect->seen = 0;
             }
             break;
         default:
             break;
     }
-    // TODO: in case of UBX-NAV-EOE, output that first and complete epoch on next call (if it can be done nicely..)
 
-    // Output epoch
-    if (complete)
+    // Output epoch, this message belongs to the next epoch
+    if ((detected & DETECT_BEFORE) != 0)
     {
-        detect->seq++;
-        if (epoch != NULL)
+        _epochOutput(coll, epoch);
+    }
+
+    // Collect data
+    if ((detected & DETECT_SKIP) == 0)
+    {
+        switch (msg->type)
         {
-            memcpy(epoch, coll, sizeof(*epoch));
-            epoch->seq = detect->seq;
-            _epochComplete(collect, epoch);
+            case PARSER_MSGTYPE_UBX:
+                _collectUbx(coll, collect, msg);
+                break;
+            case PARSER_MSGTYPE_NMEA:
+                if (haveNmea)
+                {
+                    _collectNmea(coll, collect, &nmea);
+                }
+                break;
+            default:
+                break;
         }
-
-        // Initialise collector
-        const EPOCH_DETECT_t saveDetect = *detect;
-        memset(coll, 0, sizeof(*coll));
-        *detect = saveDetect;
-
-        //DEBUG("epoch %u ubx %u %d nmea %d %d", seq, tow, detectHaveTow, ms, detectHaveMs);
     }
 
-    // Collect data
-    switch (msg->type)
+    // Output epoch, this message was the last one of the epoch
+    if ((detected & DETECT_AFTER) != 0)
     {
-        case PARSER_MSGTYPE_UBX:
-            _collectUbx(coll, collect, msg);
-            break;
-        case PARSER_MSGTYPE_NMEA:
-            if (haveNmea)
-            {
-                _collectNmea(coll, collect, &nmea);
-            }
-            break;
-        default:
-            break;
+        _epochOutput(coll, epoch);
     }
 
+    const bool complete = ((detected & (DETECT_BEFORE | DETECT_AFTER)) != 0);
+    PROF_STOP(t0, PROF_EPOCH_COLLECT);
     return complete;
 }
 
-static bool _detectUbx(EPOCH_DETECT_t *detect, const PARSER_MSG_t *msg)
+static void _epochOutput(EPOCH_t *coll, EPOCH_t *epoch)
+{
+    EPOCH_DETECT_t *detect = (EPOCH_DETECT_t *)coll->_detect;
+    detect->seq++;
+    const EPOCH_DETECT_t saveDetect = *detect;
+
+    // Hand the collected data to the user and take the user's (old) arrays for collecting the next epoch
+    if (epoch != NULL)
+    {
+        const EPOCH_t tmp = *epoch;
+        *epoch = *coll;
+        *coll = tmp;
+        epoch->seq = saveDetect.seq;
+        PROF_START(t0);
+        _epochComplete((const EPOCH_COLLECT_t *)epoch->_collect, epoch);
+        if (saveDetect.noStrings)
+        {
+            epoch->_lazy &= ~(LAZY_STR | LAZY_UPTIMESTR);
+        }
+        PROF_STOP(t0, PROF_EPOCH_COMPLETE);
+    }
+
+    // Initialise collector
+    _epochClear(coll);
+    *detect = saveDetect;
+}
+
+static int _detectUbx(EPOCH_DETECT_t *detect, const PARSER_MSG_t *msg)
 {
     const uint8_t clsId = UBX_CLSID(msg->data);
     if (clsId != UBX_NAV_CLSID)
     {
-        return false;
+        return DETECT_NONE;
     }
     const uint8_t msgId = UBX_MSGID(msg->data);
-    bool complete = false;
+    uint32_t expect = 0;
+    int iTowOffs = -1;
     switch (msgId)
     {
         case UBX_NAV_EOE_MSGID:
-            EPOCH_DEBUG("detect %s", msg->name);
-            detect->haveUbxItow = false;
-            complete = true;
-            break;
-        case UBX_NAV_PVT_MSGID:
-        case UBX_NAV_SAT_MSGID:
-        case UBX_NAV_ORB_MSGID:
-        case UBX_NAV_STATUS_MSGID:
-        case UBX_NAV_SIG_MSGID:
-        case UBX_NAV_CLOCK_MSGID:
-        case UBX_NAV_DOP_MSGID:
-        case UBX_NAV_POSECEF_MSGID:
-        case UBX_NAV_POSLLH_MSGID:
-        case UBX_NAV_VELECEF_MSGID:
-        case UBX_NAV_VELNED_MSGID:
-        case UBX_NAV_GEOFENCE_MSGID:
-        case UBX_NAV_TIMEUTC_MSGID:
-        case UBX_NAV_TIMELS_MSGID:
-        case UBX_NAV_TIMEGPS_MSGID:
-        case UBX_NAV_TIMEGLO_MSGID:
-        case UBX_NAV_TIMEBDS_MSGID:
-        case UBX_NAV_TIMEGAL_MSGID:
-            if (msg->size > (UBX_FRAME_SIZE + 4))
+            if ( (detect->expected != 0) && (msg->size == UBX_NAV_EOE_V0_SIZE) )
             {
                 uint32_t iTow;
                 memcpy(&iTow, &msg->data[UBX_HEAD_SIZE], sizeof(iTow));
-                if (detect->haveUbxItow && (detect->ubxItow != iTow))
+                // Already completed (by the expected messages)
+                if (detect->haveDoneItow && (detect->doneItow == iTow))
                 {
-                    EPOCH_DEBUG("detect %s %u != %u", msg->name, detect->ubxItow, iTow);
-                    complete = true;
+                    EPOCH_DEBUG("detect %s %u skip", msg->name, iTow);
+                    return DETECT_SKIP;
                 }
-                detect->ubxItow = iTow;
-                detect->haveUbxItow = true;
+                detect->doneItow = iTow;
+                detect->haveDoneItow = true;
             }
-            break;
-        case UBX_NAV_SVIN_MSGID:
-        case UBX_NAV_ODO_MSGID:
-        case UBX_NAV_HPPOSLLH_MSGID:
-        case UBX_NAV_HPPOSECEF_MSGID:
-        case UBX_NAV_RELPOSNED_MSGID:
-            if (msg->size > (UBX_FRAME_SIZE + 4 + 4))
-            {
-                uint32_t iTow;
-                memcpy(&iTow, &msg->data[UBX_HEAD_SIZE + 4], sizeof(iTow));
-                if (detect->haveUbxItow && (detect->ubxItow != iTow))
-                {
-                    EPOCH_DEBUG("detect %s %u != %u", msg->name, detect->ubxItow, iTow);
-                    complete = true;
-                }
-                detect->ubxItow = iTow;
-                detect->haveUbxItow = true;
-            }
-            break;
+            EPOCH_DEBUG("detect %s", msg->name);
+            detect->haveUbxItow = false;
+            detect->seen = 0;
+            return DETECT_BEFORE;
+        case UBX_NAV_PVT_MSGID:       expect = EPOCH_EXPECT_UBX_NAV_PVT;       iTowOffs = 0; break;
+        case UBX_NAV_SAT_MSGID:       expect = EPOCH_EXPECT_UBX_NAV_SAT;       iTowOffs = 0; break;
+        case UBX_NAV_ORB_MSGID:       expect = EPOCH_EXPECT_UBX_NAV_ORB;       iTowOffs = 0; break;
+        case UBX_NAV_STATUS_MSGID:    expect = EPOCH_EXPECT_UBX_NAV_STATUS;    iTowOffs = 0; break;
+        case UBX_NAV_SIG_MSGID:       expect = EPOCH_EXPECT_UBX_NAV_SIG;       iTowOffs = 0; break;
+        case UBX_NAV_CLOCK_MSGID:     expect = EPOCH_EXPECT_UBX_NAV_CLOCK;     iTowOffs = 0; break;
+        case UBX_NAV_DOP_MSGID:       expect = EPOCH_EXPECT_UBX_NAV_DOP;       iTowOffs = 0; break;
+        case UBX_NAV_POSECEF_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_POSECEF;   iTowOffs = 0; break;
+        case UBX_NAV_POSLLH_MSGID:    expect = EPOCH_EXPECT_UBX_NAV_POSLLH;    iTowOffs = 0; break;
+        case UBX_NAV_VELECEF_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_VELECEF;   iTowOffs = 0; break;
+        case UBX_NAV_VELNED_MSGID:    expect = EPOCH_EXPECT_UBX_NAV_VELNED;    iTowOffs = 0; break;
+        case UBX_NAV_GEOFENCE_MSGID:  expect = EPOCH_EXPECT_UBX_NAV_GEOFENCE;  iTowOffs = 0; break;
+        case UBX_NAV_TIMEUTC_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_TIMEUTC;   iTowOffs = 0; break;
+        case UBX_NAV_TIMELS_MSGID:    expect = EPOCH_EXPECT_UBX_NAV_TIMELS;    iTowOffs = 0; break;
+        case UBX_NAV_TIMEGPS_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_TIMEGPS;   iTowOffs = 0; break;
+        case UBX_NAV_TIMEGLO_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_TIMEGLO;   iTowOffs = 0; break;
+        case UBX_NAV_TIMEBDS_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_TIMEBDS;   iTowOffs = 0; break;
+        case UBX_NAV_TIMEGAL_MSGID:   expect = EPOCH_EXPECT_UBX_NAV_TIMEGAL;   iTowOffs = 0; break;
+        case UBX_NAV_SVIN_MSGID:      expect = EPOCH_EXPECT_UBX_NAV_SVIN;      iTowOffs = 4; break;
+        case UBX_NAV_ODO_MSGID:       expect = EPOCH_EXPECT_UBX_NAV_ODO;       iTowOffs = 4; break;
+        case UBX_NAV_HPPOSLLH_MSGID:  expect = EPOCH_EXPECT_UBX_NAV_HPPOSLLH;  iTowOffs = 4; break;
+        case UBX_NAV_HPPOSECEF_MSGID: expect = EPOCH_EXPECT_UBX_NAV_HPPOSECEF; iTowOffs = 4; break;
+        case UBX_NAV_RELPOSNED_MSGID: expect = EPOCH_EXPECT_UBX_NAV_RELPOSNED; iTowOffs = 4; break;
+    }
+    if ( (iTowOffs < 0) || (msg->size <= (UBX_FRAME_SIZE + iTowOffs + 4)) )
+    {
+        return DETECT_NONE;
     }
 
-    return complete;
+    uint32_t iTow;
+    memcpy(&iTow, &msg->data[UBX_HEAD_SIZE + iTowOffs], sizeof(iTow));
+
+    // Late message for an epoch that was completed already (only with expected messages, see epochSetExpected())
+    if ( (detect->expected != 0) && detect->haveDoneItow && (detect->doneItow == iTow) )
+    {
+        EPOCH_DEBUG("detect %s %u skip", msg->name, iTow);
+        return DETECT_SKIP;
+    }
+
+    // Next epoch started, the previous one is complete
+    int res = DETECT_NONE;
+    if (detect->haveUbxItow && (detect->ubxItow != iTow))
+    {
+        EPOCH_DEBUG("detect %s %u != %u", msg->name, detect->ubxItow, iTow);
+        if (detect->expected != 0)
+        {
+            detect->doneItow = detect->ubxItow;
+            detect->haveDoneItow = true;
+        }
+        detect->seen = 0;
+        res = DETECT_BEFORE;
+    }
+    detect->ubxItow = iTow;
+    detect->haveUbxItow = true;
+
+    // All expected messages seen, complete now. Unless we already completed the previous epoch above, in which
+    // case this will happen with the next message with this iTOW.
+    detect->seen |= expect;
+    if ( (detect->expected != 0) && ((detect->seen & detect->expected) == detect->expected) && (res == DETECT_NONE) )
+    {
+        EPOCH_DEBUG("detect %s %u expected", msg->name, iTow);
+        detect->doneItow = iTow;
+        detect->haveDoneItow = true;
+        detect->haveUbxItow = false;
+        detect->seen = 0;
+        res = DETECT_AFTER;
+    }
+
+    return res;
 }
 
 static bool _detectNmea(EPOCH_DETECT_t *detect, const NMEA_MSG_t *nmea)
@@ -251,15 +508,23 @@ static bool _detectNmea(EPOCH_DETECT_t *detect, const NMEA_MSG_t *nmea)
         case NMEA_TYPE_NONE:
         case NMEA_TYPE_TXT:
         case NMEA_TYPE_GSV:
+        case NMEA_TYPE_GSA:
+        case NMEA_TYPE_VTG:
             break;
         case NMEA_TYPE_GGA:
-            ms = (int)floor(nmea->gga.time.second * 1e3);
+            ms = nmea->gga.time.valid ? (int)floor(nmea->gga.time.second * 1e3) : -1;
+            break;
+        case NMEA_TYPE_GST:
+            ms = nmea->gst.time.valid ? (int)floor(nmea->gst.time.second * 1e3) : -1;
+            break;
+        case NMEA_TYPE_ZDA:
+            ms = nmea->zda.time.valid ? (int)floor(nmea->zda.time.second * 1e3) : -1;
             break;
         case NMEA_TYPE_RMC:
-            ms = (int)floor(nmea->rmc.time.second * 1e3);
+            ms = nmea->rmc.time.valid ? (int)floor(nmea->rmc.time.second * 1e3) : -1;
             break;
         case NMEA_TYPE_GLL:
-            ms = (int)floor(nmea->gll.time.second * 1e3);
+            ms = nmea->gll.time.valid ? (int)floor(nmea->gll.time.second * 1e3) : -1;
             break;
     }
     if (ms >= 0)
@@ -547,7 +812,12 @@ const char * const kEpochBandStrs[] =
     [EPOCH_BAND_L5]      = "L5",
 };
 
-static const char *_epochSvStr(const EPOCH_GNSS_t gnss, const uint8_t sv)
+const char *epochBandStr(const EPOCH_BAND_t band)
+{
+    return (band >= 0) && (band < NUMOF(kEpochBandStrs)) ? kEpochBandStrs[band] : kEpochBandStrs[EPOCH_BAND_UNKNOWN];
+}
+
+const char *epochSvStr(const EPOCH_GNSS_t gnss, const int sv)
 {
     switch (gnss)
     {
@@ -781,20 +1051,86 @@ static const char * const kEpochOrbStrs[] =
     [EPOCH_SATORB_OTHER] = "OTHER",
 };
 
-static int _epochSigInfoSort(const void *a, const void *b)
+const char *epochSigUseStr(const EPOCH_SIGUSE_t use)
+{
+    return (use >= 0) && (use < NUMOF(kEpochSiqUseStrs)) ? kEpochSiqUseStrs[use] : kEpochSiqUseStrs[EPOCH_SIGUSE_UNKNOWN];
+}
+
+const char *epochSigCorrStr(const EPOCH_SIGCORR_t corr)
+{
+    return (corr >= 0) && (corr < NUMOF(kEpochSigCorrStrs)) ? kEpochSigCorrStrs[corr] : kEpochSigCorrStrs[EPOCH_SIGCORR_UNKNOWN];
+}
+
+const char *epochSigIonoStr(const EPOCH_SIGIONO_t iono)
 {
-    const EPOCH_SIGINFO_t *sA = (const EPOCH_SIGINFO_t *)a;
-    const EPOCH_SIGINFO_t *sB = (const EPOCH_SIGINFO_t *)b;
-    return (int32_t)(sA->_order - sB->_order);
+    return (iono >= 0) && (iono < NUMOF(kEpochSigIonoStrs)) ? kEpochSigIonoStrs[iono] : kEpochSigIonoStrs[EPOCH_SIGIONO_UNKNOWN];
 }
 
-static int _epochSatInfoSort(const void *a, const void *b)
+const char *epochSigHealthStr(const EPOCH_SIGHEALTH_t health)
 {
-    const EPOCH_SATINFO_t *sA = (const EPOCH_SATINFO_t *)a;
-    const EPOCH_SATINFO_t *sB = (const EPOCH_SATINFO_t *)b;
-    return (int32_t)(sA->_order - sB->_order);
+    return (health >= 0) && (health < NUMOF(kEpochSigHealthStrs)) ? kEpochSigHealthStrs[health] : kEpochSigHealthStrs[EPOCH_SIGHEALTH_UNKNOWN];
 }
 
+const char *epochSatOrbStr(const EPOCH_SATORB_t orb)
+{
+    return (orb >= 0) && (orb < NUMOF(kEpochOrbStrs)) ? kEpochOrbStrs[orb] : kEpochOrbStrs[EPOCH_SATORB_NONE];
+}
+
+// Sort keys have the sort order in bits 16..47 and the (original) index in the lower 16 bits. The keys are sorted
+// using a (stable) LSD radix sort, i.e. a counting sort for each byte of the sort order, starting with the least
+// significant byte. Bytes that are the same for all keys are skipped. As the keys are initially in order of the index,
+// the result is the same as a comparison sort of the keys.
+static void _epochSortKeys(uint64_t *keys, const int num, uint64_t *tmp)
+{
+    uint64_t *src = keys;
+    uint64_t *dst = tmp;
+    for (int shift = 16; shift < 48; shift += 8)
+    {
+        int counts[256];
+        memset(counts, 0, sizeof(counts));
+        for (int ix = 0; ix < num; ix++)
+        {
+            counts[(src[ix] >> shift) & 0xff]++;
+        }
+        if (counts[(src[0] >> shift) & 0xff] == num)
+        {
+            continue;
+        }
+        int offs = 0;
+        for (int bucket = 0; bucket < NUMOF(counts); bucket++)
+        {
+            const int count = counts[bucket];
+            counts[bucket] = offs;
+            offs += count;
+        }
+        for (int ix = 0; ix < num; ix++)
+        {
+            dst[counts[(src[ix] >> shift) & 0xff]++] = src[ix];
+        }
+        uint64_t *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys)
+    {
+        memcpy(keys, src, num * sizeof(*keys));
+    }
+}
+
+// Reorder array according to the (sorted) sort keys
+static void _epochPermute(void *arr, const size_t size, const int num, const uint64_t *keys, void *tmp)
+{
+    const uint8_t *src = (const uint8_t *)arr;
+    uint8_t *dst = (uint8_t *)tmp;
+    for (int ix = 0; ix < num; ix++)
+    {
+        memcpy(&dst[ix * size], &src[(keys[ix] & 0xffff) * size], size);
+    }
+    memcpy(arr, tmp, num * size);
+}
+
+#define _EPOCH_PERMUTE(_arr_, _num_, _keys_, _tmp_) _epochPermute((_arr_), sizeof(*(_arr_)), (_num_), (_keys_), (_tmp_))
+
 static void _collectUbx(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const PARSER_MSG_t *msg)
 {
     const uint8_t clsId = UBX_CLSID(msg->data);
@@ -901,11 +1237,19 @@ static void _collectUbx(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const PARSER_MS
                     coll->velAcc    = pvt.sAcc * UBX_NAV_PVT_V1_SACC_SCALE;
                 }
 
-                coll->pDOP        = (float)pvt.pDOP * UBX_NAV_PVT_V1_PDOP_SCALE;
-                coll->havePdop    = true;
+                if (collect->haveDop < HAVE_UBX)
+                {
+                    collect->haveDop  = HAVE_UBX;
+                    coll->pDOP        = (float)pvt.pDOP * UBX_NAV_PVT_V1_PDOP_SCALE;
+                    coll->havePdop    = true;
+                }
 
-                coll->numSv       = pvt.numSV;
-                coll->haveNumSv   = true;
+                if (collect->haveNumSv < HAVE_UBX)
+                {
+                    collect->haveNumSv = HAVE_UBX;
+                    coll->numSv       = pvt.numSV;
+                    coll->haveNumSv   = true;
+                }
 
                 if (collect->haveGpsTow < HAVE_UBX)
                 {
@@ -1022,29 +1366,28 @@ static void _collectUbx(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const PARSER_MS
                     collect->haveSig = HAVE_UBX;
                     UBX_NAV_SIG_V0_GROUP0_t head;
                     memcpy(&head, &msg->data[UBX_HEAD_SIZE], sizeof(head));
-                    int ix;
-                    for (coll->numSignals = 0, ix = 0; (coll->numSignals < (int)head.numSigs) && (coll->numSignals < NUMOF(coll->signals)); coll->numSignals++, ix++)
+                    EPOCH_SIGNALS_t *sig = &coll->signals;
+                    for (sig->num = 0; (sig->num < (int)head.numSigs) && (sig->num < sig->max); sig->num++)
                     {
+                        const int ix = sig->num;
                         UBX_NAV_SIG_V0_GROUP1_t uInfo;
                         memcpy(&uInfo, &msg->data[UBX_HEAD_SIZE + sizeof(UBX_NAV_SIG_V0_GROUP0_t) + (ix * sizeof(uInfo))], sizeof(uInfo));
-                        EPOCH_SIGINFO_t *eInfo = &coll->signals[ix];
-                        eInfo->valid       = true;
-                        eInfo->gnss        = _ubxGnssIdToGnss(uInfo.gnssId);
-                        eInfo->sv          = uInfo.svId;
-                        eInfo->signal      = _ubxSigIdToSignal(uInfo.gnssId, uInfo.sigId);
-                        eInfo->gloFcn      = (int)uInfo.freqId - 7;
-                        eInfo->prRes       = (float)uInfo.prRes * (float)UBX_NAV_SIG_V0_PRRES_SCALE;
-                        eInfo->cno         = uInfo.cno;
-                        eInfo->prUsed      = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_PR_USED);
-                        eInfo->crUsed      = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_CR_USED);
-                        eInfo->doUsed      = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_DO_USED);
-                        eInfo->prCorrUsed  = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_PR_CORR_USED);
-                        eInfo->crCorrUsed  = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_CR_CORR_USED);
-                        eInfo->doCorrUsed  = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_DO_CORR_USED);
-                        eInfo->use         = _ubxSigUse(uInfo.qualityInd);
-                        eInfo->corr        = _ubxSigCorrSource(uInfo.corrSource);
-                        eInfo->iono        = _ubxIonoModel(uInfo.ionoModel);
-                        eInfo->health      = _ubxSigHealth(UBX_NAV_SIG_V0_SIGFLAGS_HEALTH_GET(uInfo.sigFlags));
+                        sig->gnss[ix]       = _ubxGnssIdToGnss(uInfo.gnssId);
+                        sig->sv[ix]         = uInfo.svId;
+                        sig->signal[ix]     = _ubxSigIdToSignal(uInfo.gnssId, uInfo.sigId);
+                        sig->gloFcn[ix]     = (int)uInfo.freqId - 7;
+                        sig->prRes[ix]      = (float)uInfo.prRes * (float)UBX_NAV_SIG_V0_PRRES_SCALE;
+                        sig->cno[ix]        = uInfo.cno;
+                        sig->prUsed[ix]     = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_PR_USED);
+                        sig->crUsed[ix]     = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_CR_USED);
+                        sig->doUsed[ix]     = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_DO_USED);
+                        sig->prCorrUsed[ix] = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_PR_CORR_USED);
+                        sig->crCorrUsed[ix] = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_CR_CORR_USED);
+                        sig->doCorrUsed[ix] = FLAG(uInfo.sigFlags, UBX_NAV_SIG_V0_SIGFLAGS_DO_CORR_USED);
+                        sig->use[ix]        = _ubxSigUse(uInfo.qualityInd);
+                        sig->corr[ix]       = _ubxSigCorrSource(uInfo.corrSource);
+                        sig->iono[ix]       = _ubxIonoModel(uInfo.ionoModel);
+                        sig->health[ix]     = _ubxSigHealth(UBX_NAV_SIG_V0_SIGFLAGS_HEALTH_GET(uInfo.sigFlags));
                     }
                 }
             }
@@ -1058,42 +1401,43 @@ static void _collectUbx(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const PARSER_MS
                     collect->haveSat = HAVE_UBX;
                     UBX_NAV_SAT_V1_GROUP0_t head;
                     memcpy(&head, &msg->data[UBX_HEAD_SIZE], sizeof(head));
-                    int ix;
-                    for (coll->numSatellites = 0, ix = 0; (coll->numSatellites < (int)head.numSvs) && (coll->numSatellites < NUMOF(coll->satellites)); coll->numSatellites++, ix++)
+                    EPOCH_SATELLITES_t *sat = &coll->satellites;
+                    for (sat->num = 0; (sat->num < (int)head.numSvs) && (sat->num < sat->max); sat->num++)
                     {
+                        const int ix = sat->num;
                         UBX_NAV_SAT_V1_GROUP1_t uInfo;
                         memcpy(&uInfo, &msg->data[UBX_HEAD_SIZE + sizeof(UBX_NAV_SAT_V1_GROUP0_t) + (ix * sizeof(uInfo))], sizeof(uInfo));
-                        EPOCH_SATINFO_t *eInfo = &coll->satellites[ix];
-                        eInfo->valid       = true;
-                        eInfo->gnss        = _ubxGnssIdToGnss(uInfo.gnssId);
-                        eInfo->sv          = uInfo.svId;
-                        const int orbSrc = UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_GET(uInfo.flags);
-                        eInfo->orbUsed = EPOCH_SATORB_NONE;
-                        eInfo->azim = uInfo.azim;
-                        eInfo->elev = uInfo.elev;
-                        switch (orbSrc)
+                        sat->gnss[ix] = _ubxGnssIdToGnss(uInfo.gnssId);
+                        sat->sv[ix]   = uInfo.svId;
+                        sat->azim[ix] = uInfo.azim;
+                        sat->elev[ix] = uInfo.elev;
+                        EPOCH_SATORB_t orbUsed = EPOCH_SATORB_NONE;
+                        switch (UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_GET(uInfo.flags))
                         {
                             case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_NONE: break;
-                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_EPH:    eInfo->orbUsed = EPOCH_SATORB_EPH; break;
-                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_ALM:    eInfo->orbUsed = EPOCH_SATORB_ALM; break;
+                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_EPH:    orbUsed = EPOCH_SATORB_EPH; break;
+                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_ALM:    orbUsed = EPOCH_SATORB_ALM; break;
                             case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_ANO:    /* FALLTHROUGH */
-                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_ANA:    eInfo->orbUsed = EPOCH_SATORB_PRED; break;
+                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_ANA:    orbUsed = EPOCH_SATORB_PRED; break;
                             case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_OTHER1: /* FALLTHROUGH */
                             case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_OTHER2: /* FALLTHROUGH */
-                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_OTHER3: eInfo->orbUsed = EPOCH_SATORB_OTHER; break;
+                            case UBX_NAV_SAT_V1_FLAGS_ORBITSOURCE_OTHER3: orbUsed = EPOCH_SATORB_OTHER; break;
                         }
+                        sat->orbUsed[ix] = orbUsed;
+                        int orbAvail = 0;
                         if (FLAG(uInfo.flags, UBX_NAV_SAT_V1_FLAGS_EPHAVAIL))
                         {
-                            eInfo->orbAvail |= BIT(EPOCH_SATORB_EPH);
+                            orbAvail |= BIT(EPOCH_SATORB_EPH);
                         }
                         if (FLAG(uInfo.flags, UBX_NAV_SAT_V1_FLAGS_ALMAVAIL))
                         {
-                            eInfo->orbAvail |= BIT(EPOCH_SATORB_ALM);
+                            orbAvail |= BIT(EPOCH_SATORB_ALM);
                         }
                         if (FLAG(uInfo.flags, UBX_NAV_SAT_V1_FLAGS_ANOAVAIL) || FLAG(uInfo.flags, UBX_NAV_SAT_V1_FLAGS_AOPAVAIL))
                         {
-                            eInfo->orbAvail |= BIT(EPOCH_SATORB_PRED);
+                            orbAvail |= BIT(EPOCH_SATORB_PRED);
                         }
+                        sat->orbAvail[ix] = orbAvail;
                     }
                 }
             }
@@ -1145,7 +1489,7 @@ static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG
     {
         case NMEA_TYPE_GGA:
             EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
-            if (collect->haveTime < HAVE_NMEA)
+            if ( nmea->gga.time.valid && (collect->haveTime < HAVE_NMEA) )
             {
                 collect->haveTime = HAVE_NMEA;
                 coll->hour      = nmea->gga.time.hour;
@@ -1185,8 +1529,9 @@ static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG
                 coll->diffAge = nmea->gga.diffAge;
                 coll->haveDiffAge = true;
             }
-            if (!coll->haveNumSv)
+            if (collect->haveNumSv < HAVE_NMEA)
             {
+                collect->haveNumSv = HAVE_NMEA;
                 coll->numSv       = nmea->gga.numSv;
                 coll->haveNumSv   = true;
             }
@@ -1194,7 +1539,7 @@ static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG
 
         case NMEA_TYPE_RMC:
             EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
-            if (collect->haveTime < HAVE_NMEA)
+            if ( nmea->rmc.time.valid && (collect->haveTime < HAVE_NMEA) )
             {
                 collect->haveTime = HAVE_NMEA;
                 coll->hour      = nmea->rmc.time.hour;
@@ -1202,7 +1547,7 @@ static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG
                 coll->second    = nmea->rmc.time.second;
                 coll->haveTime  = nmea->rmc.time.valid;
             }
-            if (collect->haveDate < HAVE_NMEA)
+            if ( nmea->rmc.date.valid && (collect->haveDate < HAVE_NMEA) )
             {
                 collect->haveDate = HAVE_NMEA;
                 coll->day       = nmea->rmc.date.day;
@@ -1240,7 +1585,7 @@ static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG
 
         case NMEA_TYPE_GLL:
             EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
-            if (collect->haveTime < HAVE_NMEA)
+            if ( nmea->gll.time.valid && (collect->haveTime < HAVE_NMEA) )
             {
                 collect->haveTime = HAVE_NMEA;
                 coll->hour      = nmea->gll.time.hour;
@@ -1281,47 +1626,127 @@ static void _collectNmea(EPOCH_t *coll, EPOCH_COLLECT_t *collect, const NMEA_MSG
             if (collect->haveSat <= HAVE_NMEA) // multiple NMEA-Gx-GSV messages!
             {
                 collect->haveSat = HAVE_NMEA;
-                for (int ix = 0; (ix < nmea->gsv.nSvs) && (coll->numSatellites < (int)NUMOF(coll->satellites)); ix++)
+                EPOCH_SATELLITES_t *sat = &coll->satellites;
+                for (int ix = 0; (ix < nmea->gsv.nSvs) && (sat->num < sat->max); ix++)
                 {
-                    EPOCH_SATINFO_t *sat = &coll->satellites[coll->numSatellites];
-                    sat->gnss      = _nmeaGnssToGnss(nmea->gsv.svs[ix].gnss);
-                    sat->sv        = nmea->gsv.svs[ix].svId;
-                    sat->orbUsed   = EPOCH_SATORB_EPH;       // presumably..
-                    sat->orbAvail |= BIT(EPOCH_SATORB_EPH);  // presumably..
-                    sat->elev      = nmea->gsv.svs[ix].elev;
-                    sat->azim      = nmea->gsv.svs[ix].azim;
-                    coll->numSatellites++;
+                    const int satIx = sat->num;
+                    sat->gnss[satIx]     = _nmeaGnssToGnss(nmea->gsv.svs[ix].gnss);
+                    sat->sv[satIx]       = nmea->gsv.svs[ix].svId;
+                    sat->orbUsed[satIx]  = EPOCH_SATORB_EPH;       // presumably..
+                    sat->orbAvail[satIx] = BIT(EPOCH_SATORB_EPH);  // presumably..
+                    sat->elev[satIx]     = nmea->gsv.svs[ix].elev;
+                    sat->azim[satIx]     = nmea->gsv.svs[ix].azim;
+                    sat->num++;
                 }
             }
             if (collect->haveSig <= HAVE_NMEA) // multiple NMEA-Gx-GSV messages!
             {
                 collect->haveSig = HAVE_NMEA;
-                for (int ix = 0; (ix < nmea->gsv.nSvs) && (coll->numSignals < (int)NUMOF(coll->signals)); ix++)
+                EPOCH_SIGNALS_t *sig = &coll->signals;
+                for (int ix = 0; (ix < nmea->gsv.nSvs) && (sig->num < sig->max); ix++)
                 {
-                    EPOCH_SIGINFO_t *sig = &coll->signals[coll->numSignals];
-                    switch (nmea->gsv.svs[ix].gnss)
-                    {
-                        case NMEA_GNSS_UNKNOWN: sig->gnss = EPOCH_GNSS_UNKNOWN; break;
-                        case NMEA_GNSS_GPS:     sig->gnss = EPOCH_GNSS_GPS;     break;
-                        case NMEA_GNSS_GLO:     sig->gnss = EPOCH_GNSS_GLO;     break;
-                        case NMEA_GNSS_BDS:     sig->gnss = EPOCH_GNSS_BDS;     break;
-                        case NMEA_GNSS_GAL:     sig->gnss = EPOCH_GNSS_GAL;     break;
-                        case NMEA_GNSS_SBAS:    sig->gnss = EPOCH_GNSS_SBAS;    break;
-                        case NMEA_GNSS_QZSS:    sig->gnss = EPOCH_GNSS_QZSS;    break;
-                        case NMEA_GNSS_NAVIC:   sig->gnss = EPOCH_GNSS_NAVIC;   break;
-                    }
-                    sig->gnss      = _nmeaGnssToGnss(nmea->gsv.svs[ix].gnss);
-                    sig->sv        = nmea->gsv.svs[ix].svId;
-                    sig->signal    = _nmeaSignalToSignal(nmea->gsv.svs[ix].sig);
-                    sig->cno       = nmea->gsv.svs[ix].cno;
-                    sig->use       = EPOCH_SIGUSE_CODELOCK;   // presumably..
-                    sig->health    = EPOCH_SIGHEALTH_HEALTHY; // presumably..
-                    sig->prUsed    = true; // presumably..
-                    coll->numSignals++;
+                    const int sigIx = sig->num;
+                    sig->gnss[sigIx]       = _nmeaGnssToGnss(nmea->gsv.svs[ix].gnss);
+                    sig->sv[sigIx]         = nmea->gsv.svs[ix].svId;
+                    sig->signal[sigIx]     = _nmeaSignalToSignal(nmea->gsv.svs[ix].sig);
+                    sig->gloFcn[sigIx]     = 0;
+                    sig->prRes[sigIx]      = 0.0f;
+                    sig->cno[sigIx]        = nmea->gsv.svs[ix].cno;
+                    sig->use[sigIx]        = EPOCH_SIGUSE_CODELOCK;   // presumably..
+                    sig->corr[sigIx]       = EPOCH_SIGCORR_UNKNOWN;
+                    sig->iono[sigIx]       = EPOCH_SIGIONO_UNKNOWN;
+                    sig->health[sigIx]     = EPOCH_SIGHEALTH_HEALTHY; // presumably..
+                    sig->prUsed[sigIx]     = true; // presumably..
+                    sig->crUsed[sigIx]     = false;
+                    sig->doUsed[sigIx]     = false;
+                    sig->prCorrUsed[sigIx] = false;
+                    sig->crCorrUsed[sigIx] = false;
+                    sig->doCorrUsed[sigIx] = false;
+                    sig->num++;
                 }
             }
             break;
 
+        case NMEA_TYPE_GSA:
+            EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
+            // Multiple NMEA-Gx-GSA messages (one per GNSS), the sum of the used satellites is better than the GGA
+            // numSv, which may be limited to 12
+            if (collect->haveNumSv < HAVE_BETTER_NMEA)
+            {
+                collect->haveNumSv = HAVE_BETTER_NMEA;
+                coll->numSv       = 0;
+            }
+            if (collect->haveNumSv == HAVE_BETTER_NMEA)
+            {
+                coll->numSv      += nmea->gsa.nSvs;
+                coll->haveNumSv   = true;
+            }
+            if ( (nmea->gsa.pDOP > -DBL_EPSILON) && (collect->haveDop < HAVE_NMEA) )
+            {
+                collect->haveDop  = HAVE_NMEA;
+                coll->pDOP        = nmea->gsa.pDOP;
+                coll->havePdop    = true;
+            }
+            break;
+
+        case NMEA_TYPE_GST:
+            EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
+            if ( nmea->gst.time.valid && (collect->haveTime < HAVE_NMEA) )
+            {
+                collect->haveTime = HAVE_NMEA;
+                coll->hour      = nmea->gst.time.hour;
+                coll->minute    = nmea->gst.time.minute;
+                coll->second    = nmea->gst.time.second;
+                coll->haveTime  = nmea->gst.time.valid;
+            }
+            if (nmea->gst.valid)
+            {
+                if (collect->haveHacc < HAVE_NMEA)
+                {
+                    collect->haveHacc = HAVE_NMEA;
+                    coll->horizAcc = sqrt( (nmea->gst.stdLat * nmea->gst.stdLat) + (nmea->gst.stdLon * nmea->gst.stdLon) );
+                }
+                if (collect->haveVacc < HAVE_NMEA)
+                {
+                    collect->haveVacc = HAVE_NMEA;
+                    coll->vertAcc     = nmea->gst.stdAlt;
+                }
+            }
+            break;
+
+        case NMEA_TYPE_VTG:
+            EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
+            if ( nmea->vtg.valid && (nmea->vtg.fix != NMEA_FIX_NOFIX) && (collect->haveVel < HAVE_NMEA) )
+            {
+                collect->haveVel = HAVE_NMEA;
+                const double sog = nmea->vtg.sogk * (1000.0 / 3600.0);
+                const double cog = deg2rad(nmea->vtg.cogt);
+                coll->velNed[0] = sog * cos(cog);
+                coll->velNed[1] = sog * sin(cog);
+                coll->velNed[2] = 0.0; // n/a
+            }
+            break;
+
+        case NMEA_TYPE_ZDA:
+            EPOCH_DEBUG("collect %s %s", nmea->talker, nmea->formatter);
+            if ( nmea->zda.time.valid && (collect->haveTime < HAVE_NMEA) )
+            {
+                collect->haveTime = HAVE_NMEA;
+                coll->hour      = nmea->zda.time.hour;
+                coll->minute    = nmea->zda.time.minute;
+                coll->second    = nmea->zda.time.second;
+                coll->haveTime  = nmea->zda.time.valid;
+            }
+            if ( nmea->zda.date.valid && (collect->haveDate < HAVE_BETTER_NMEA) ) // full year, unlike RMC
+            {
+                collect->haveDate = HAVE_BETTER_NMEA;
+                coll->day       = nmea->zda.date.day;
+                coll->month     = nmea->zda.date.month;
+                coll->year      = nmea->zda.date.year;
+                coll->haveDate  = nmea->zda.date.valid;
+            }
+            break;
+
         case NMEA_TYPE_NONE:
         case NMEA_TYPE_TXT:
             break;
@@ -1332,20 +1757,20 @@ static void _epochComplete(const EPOCH_COLLECT_t *collect, EPOCH_t *epoch)
 {
     epoch->valid = true;
     epoch->ts = TIME();
-    const double now = posixNow();
+    epoch->_lazy = LAZY_POSIXTIME | LAZY_LATENCY | LAZY_STR | LAZY_UPTIMESTR;
 
-    // Convert stuff, prefer better quality, FIXME: this assumes WGS84...
+    // Convert stuff (later, see epochLlh() and epochXyz()), prefer better quality
 
     if (collect->haveLlh > collect->haveXyz)
     {
         EPOCH_DEBUG("complete: llh (%d) -> xyz (%d)", collect->haveLlh, collect->haveXyz);
-        llh2xyz_vec(epoch->llh, epoch->xyz);
+        epoch->_lazy |= LAZY_XYZ;
         epoch->havePos = epoch->fix > EPOCH_FIX_NOFIX;
     }
     else if (collect->haveXyz > collect->haveLlh)
     {
         EPOCH_DEBUG("complete: xyz (%d) -> llh (%d)", collect->haveXyz, collect->haveLlh);
-        xyz2llh_vec(epoch->xyz, epoch->llh);
+        epoch->_lazy |= LAZY_LLH;
         epoch->havePos = epoch->fix > EPOCH_FIX_NOFIX;
     }
     else
@@ -1378,111 +1803,126 @@ static void _epochComplete(const EPOCH_COLLECT_t *collect, EPOCH_t *epoch)
         epoch->vel3d = sqrt( velNEsq + (epoch->velNed[2] * epoch->velNed[2]) );
     }
 
-    // Stringify and sort list of satellites
-    for (int ix = 0; ix < epoch->numSatellites; ix++)
+    // Sort list of satellites
+    EPOCH_SATELLITES_t *sat = &epoch->satellites;
+    if (sat->num > 1)
     {
-        EPOCH_SATINFO_t *sat = &epoch->satellites[ix];
-        sat->gnssStr    = sat->gnss    < NUMOF(kEpochGnssStrs) ? kEpochGnssStrs[sat->gnss]   : kEpochGnssStrs[EPOCH_GNSS_UNKNOWN];
-        sat->orbUsedStr = sat->orbUsed < NUMOF(kEpochOrbStrs)  ? kEpochOrbStrs[sat->orbUsed] : kEpochOrbStrs[EPOCH_SATORB_NONE];
-        sat->svStr      = _epochSvStr(sat->gnss, sat->sv);
-        sat->_order     = ((sat->gnss & 0xff) << 24) | ((sat->sv & 0xff) << 16);
+        uint64_t *keys = epoch->_sortKeys;
+        for (int ix = 0; ix < sat->num; ix++)
+        {
+            keys[ix] = ((uint64_t)sat->gnss[ix] << 32) | ((uint64_t)sat->sv[ix] << 16) | (uint64_t)ix;
+        }
+        _epochSortKeys(keys, sat->num, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sat->gnss,     sat->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sat->sv,       sat->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sat->orbUsed,  sat->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sat->orbAvail, sat->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sat->elev,     sat->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sat->azim,     sat->num, keys, epoch->_sortTmp);
     }
-    qsort(epoch->satellites, epoch->numSatellites, sizeof(*epoch->satellites), _epochSatInfoSort);
 
     // Create lookup table for signal to satellite
-    uint8_t satIxs[EPOCH_NUM_SV] = { [0 ... (EPOCH_NUM_SV-1)] = EPOCH_NO_SV };
-    for (int ix = 0; ix < epoch->numSatellites; ix++)
+    int16_t satIxs[EPOCH_NUM_SV];
+    memset(satIxs, 0xff, sizeof(satIxs)); // -1
+    for (int ix = 0; ix < sat->num; ix++)
     {
-        EPOCH_SATINFO_t *sat = &epoch->satellites[ix];
-        satIxs[ epochSvToIx(sat->gnss, sat->sv) ] = ix;
+        const int svIx = epochSvToIx(sat->gnss[ix], sat->sv[ix]);
+        if (svIx < EPOCH_NUM_SV)
+        {
+            satIxs[svIx] = ix;
+        }
     }
 
-    // Process, stringify and sort list of signals
-    for (int ix = 0; ix < epoch->numSignals; ix++)
+    // Process and sort list of signals
+    EPOCH_SIGNALS_t *sig = &epoch->signals;
+    for (int ix = 0; ix < sig->num; ix++)
     {
-        EPOCH_SIGINFO_t *sig = &epoch->signals[ix];
-        switch (sig->signal)
+        EPOCH_BAND_t band = EPOCH_BAND_UNKNOWN;
+        switch (sig->signal[ix])
         {
-            case EPOCH_SIGNAL_UNKNOWN:    sig->band = EPOCH_BAND_UNKNOWN; break;
-            case EPOCH_SIGNAL_GPS_L1CA:   sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_GPS_L2C:    sig->band = EPOCH_BAND_L2; break;
-            case EPOCH_SIGNAL_SBAS_L1CA:  sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_GAL_E1:     sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_GAL_E5B:    sig->band = EPOCH_BAND_L2; break;
-            case EPOCH_SIGNAL_GAL_E5A:    sig->band = EPOCH_BAND_L5; break;
-            case EPOCH_SIGNAL_BDS_B1C:    sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_BDS_B1I:    sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_BDS_B2A:    sig->band = EPOCH_BAND_L5; break;
-            case EPOCH_SIGNAL_BDS_B2I:    sig->band = EPOCH_BAND_L2; break;
-            case EPOCH_SIGNAL_BDS_B3I:    sig->band = EPOCH_BAND_E6; break;
-            case EPOCH_SIGNAL_QZSS_L1CA:  sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_QZSS_L1S:   sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_QZSS_L2C:   sig->band = EPOCH_BAND_L2; break;
-            case EPOCH_SIGNAL_GLO_L1OF:   sig->band = EPOCH_BAND_L1; break;
-            case EPOCH_SIGNAL_GLO_L2OF:   sig->band = EPOCH_BAND_L2; break;
-            case EPOCH_SIGNAL_GPS_L5:     sig->band = EPOCH_BAND_L5; break;
-            case EPOCH_SIGNAL_GAL_E6:     sig->band = EPOCH_BAND_E6; break;
-            case EPOCH_SIGNAL_QZSS_L5:    sig->band = EPOCH_BAND_L5; break;
-            case EPOCH_SIGNAL_NAVIC_L5A:  sig->band = EPOCH_BAND_L5; break;
+            case EPOCH_SIGNAL_UNKNOWN:    band = EPOCH_BAND_UNKNOWN; break;
+            case EPOCH_SIGNAL_GPS_L1CA:   band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_GPS_L2C:    band = EPOCH_BAND_L2; break;
+            case EPOCH_SIGNAL_SBAS_L1CA:  band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_GAL_E1:     band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_GAL_E5B:    band = EPOCH_BAND_L2; break;
+            case EPOCH_SIGNAL_GAL_E5A:    band = EPOCH_BAND_L5; break;
+            case EPOCH_SIGNAL_BDS_B1C:    band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_BDS_B1I:    band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_BDS_B2A:    band = EPOCH_BAND_L5; break;
+            case EPOCH_SIGNAL_BDS_B2I:    band = EPOCH_BAND_L2; break;
+            case EPOCH_SIGNAL_BDS_B3I:    band = EPOCH_BAND_E6; break;
+            case EPOCH_SIGNAL_QZSS_L1CA:  band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_QZSS_L1S:   band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_QZSS_L2C:   band = EPOCH_BAND_L2; break;
+            case EPOCH_SIGNAL_GLO_L1OF:   band = EPOCH_BAND_L1; break;
+            case EPOCH_SIGNAL_GLO_L2OF:   band = EPOCH_BAND_L2; break;
+            case EPOCH_SIGNAL_GPS_L5:     band = EPOCH_BAND_L5; break;
+            case EPOCH_SIGNAL_GAL_E6:     band = EPOCH_BAND_E6; break;
+            case EPOCH_SIGNAL_QZSS_L5:    band = EPOCH_BAND_L5; break;
+            case EPOCH_SIGNAL_NAVIC_L5A:  band = EPOCH_BAND_L5; break;
         }
-        sig->anyUsed     = sig->prUsed || sig->crUsed || sig->doUsed;
-        sig->gnssStr     = sig->gnss   < NUMOF(kEpochGnssStrs)      ? kEpochGnssStrs[sig->gnss]        : kEpochGnssStrs[EPOCH_GNSS_UNKNOWN];
-        sig->svStr       = _epochSvStr(sig->gnss, sig->sv);
-        sig->signalStr   = sig->signal < NUMOF(kEpochSignalStrs)    ? kEpochSignalStrs[sig->signal]    : kEpochSignalStrs[EPOCH_SIGNAL_UNKNOWN];
-        sig->bandStr     = sig->band   < NUMOF(kEpochBandStrs)      ? kEpochBandStrs[sig->band]        : kEpochBandStrs[EPOCH_BAND_UNKNOWN];
-        sig->useStr      = sig->use    < NUMOF(kEpochSiqUseStrs)    ? kEpochSiqUseStrs[sig->use]       : kEpochSiqUseStrs[EPOCH_SIGUSE_UNKNOWN];
-        sig->corrStr     = sig->corr   < NUMOF(kEpochSigCorrStrs)   ? kEpochSigCorrStrs[sig->corr]     : kEpochSigCorrStrs[EPOCH_SIGCORR_UNKNOWN];
-        sig->ionoStr     = sig->iono   < NUMOF(kEpochSigIonoStrs)   ? kEpochSigIonoStrs[sig->iono]     : kEpochSigIonoStrs[EPOCH_SIGIONO_UNKNOWN];
-        sig->healthStr   = sig->health < NUMOF(kEpochSigHealthStrs) ? kEpochSigHealthStrs[sig->health] : kEpochSigHealthStrs[EPOCH_SIGHEALTH_UNKNOWN];
-        sig->satIx       = satIxs[epochSvToIx(sig->gnss, sig->sv)];
-
-        sig->_order = ((sig->gnss & 0xff) << 24) | ((sig->sv & 0xffff) << 8) | ((sig->signal & 0xff) << 0);
+        sig->band[ix]    = band;
+        sig->anyUsed[ix] = sig->prUsed[ix] || sig->crUsed[ix] || sig->doUsed[ix];
+        const int svIx   = epochSvToIx(sig->gnss[ix], sig->sv[ix]);
+        sig->satIx[ix]   = svIx < EPOCH_NUM_SV ? satIxs[svIx] : -1;
     }
-    qsort(&epoch->signals, epoch->numSignals, sizeof(*epoch->signals), _epochSigInfoSort);
-
-    // TODO: time/date <--(leapSec)--> wno/tow
-
-    // Stringify fix type
-    epoch->fixStr = epoch->fixOk ? "UNKN" : "(UNKN)";
-    switch (epoch->fix)
+    if (sig->num > 1)
     {
-        case EPOCH_FIX_UNKNOWN: break;
-        case EPOCH_FIX_NOFIX:        epoch->fixStr = epoch->fixOk ? "NOFIX"        : "(NOFIX)";        break;
-        case EPOCH_FIX_DRONLY:       epoch->fixStr = epoch->fixOk ? "DR"           : "(DR)";           break;
-        case EPOCH_FIX_TIME:         epoch->fixStr = epoch->fixOk ? "TIME"         : "(TIME)";         break;
-        case EPOCH_FIX_S2D:          epoch->fixStr = epoch->fixOk ? "S2D"          : "(2D)";           break;
-        case EPOCH_FIX_S3D:          epoch->fixStr = epoch->fixOk ? "S3D"          : "(3D)";           break;
-        case EPOCH_FIX_S3D_DR:       epoch->fixStr = epoch->fixOk ? "S3D+DR"       : "(3D+DR)";        break;
-        case EPOCH_FIX_RTK_FLOAT:    epoch->fixStr = epoch->fixOk ? "RTK_FLOAT"    : "(RTK_FLOAT)";    break;
-        case EPOCH_FIX_RTK_FIXED:    epoch->fixStr = epoch->fixOk ? "RTK_FIXED"    : "(RTK_FIXED)";    break;
-        case EPOCH_FIX_RTK_FLOAT_DR: epoch->fixStr = epoch->fixOk ? "RTK_FLOAT_DR" : "(RTK_FLOAT_DR)"; break;
-        case EPOCH_FIX_RTK_FIXED_DR: epoch->fixStr = epoch->fixOk ? "RTK_FIXED_DR" : "(RTK_FIXED_DR)"; break;
+        uint64_t *keys = epoch->_sortKeys;
+        for (int ix = 0; ix < sig->num; ix++)
+        {
+            keys[ix] = ((uint64_t)sig->gnss[ix] << 40) | ((uint64_t)sig->sv[ix] << 24) |
+                ((uint64_t)(sig->signal[ix] & 0xff) << 16) | (uint64_t)ix;
+        }
+        _epochSortKeys(keys, sig->num, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->gnss,       sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->sv,         sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->signal,     sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->band,       sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->gloFcn,     sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->prRes,      sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->cno,        sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->use,        sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->corr,       sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->iono,       sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->health,     sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->prUsed,     sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->crUsed,     sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->doUsed,     sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->anyUsed,    sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->prCorrUsed, sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->crCorrUsed, sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->doCorrUsed, sig->num, keys, epoch->_sortTmp);
+        _EPOCH_PERMUTE(sig->satIx,      sig->num, keys, epoch->_sortTmp);
     }
 
+    // TODO: time/date <--(leapSec)--> wno/tow
+
     // Count number of signals (and satellites) used, calculate CN0 histogram
-    if (epoch->numSignals > 0)
+    if (sig->num > 0)
     {
         epoch->haveNumSig = true;
         epoch->haveNumSat = true;
         epoch->haveSigCnoHist = true;
-        const char *prevSvStr = "";
-        for (int ix = 0; ix < epoch->numSignals; ix++)
+        EPOCH_GNSS_t prevGnss = EPOCH_GNSS_UNKNOWN;
+        int prevSv = -1;
+        for (int ix = 0; ix < sig->num; ix++)
         {
-            const EPOCH_SIGINFO_t *sig = &epoch->signals[ix];
-            if (sig->use < EPOCH_SIGUSE_ACQUIRED)
+            if (sig->use[ix] < EPOCH_SIGUSE_ACQUIRED)
             {
                 continue;
             }
 
-            const int histIx = EPOCH_SIGCNOHIST_CNO2IX(sig->cno);
+            const int histIx = EPOCH_SIGCNOHIST_CNO2IX((int)sig->cno[ix]);
             epoch->sigCnoHistTrk[histIx]++;
 
-            if (sig->anyUsed)
+            if (sig->anyUsed[ix])
             {
                 epoch->sigCnoHistNav[histIx]++;
 
                 epoch->numSigUsed++;
-                switch (sig->gnss)
+                switch (sig->gnss[ix])
                 {
                     case EPOCH_GNSS_GPS:   epoch->numSigUsedGps++;   break;
                     case EPOCH_GNSS_GLO:   epoch->numSigUsedGlo++;   break;
@@ -1494,10 +1934,10 @@ static void _epochComplete(const EPOCH_COLLECT_t *collect, EPOCH_t *epoch)
                     case EPOCH_GNSS_UNKNOWN: break;
                 }
 
-                if (/*strcmp(prevSvStr, sig->svStr) != 0*/ prevSvStr != sig->svStr)
+                if ( (sig->gnss[ix] != prevGnss) || (sig->sv[ix] != prevSv) )
                 {
                     epoch->numSatUsed++;
-                    switch (sig->gnss)
+                    switch (sig->gnss[ix])
                     {
                         case EPOCH_GNSS_GPS:   epoch->numSatUsedGps++;   break;
                         case EPOCH_GNSS_GLO:   epoch->numSatUsedGlo++;   break;
@@ -1509,74 +1949,161 @@ static void _epochComplete(const EPOCH_COLLECT_t *collect, EPOCH_t *epoch)
                         case EPOCH_GNSS_UNKNOWN: break;
                     }
                 }
-                prevSvStr = sig->svStr;
+                prevGnss = sig->gnss[ix];
+                prevSv = sig->sv[ix];
             }
         }
     }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
 
-    // Uptime string
-    if (epoch->haveUptime)
+const double *epochLlh(EPOCH_t *epoch)
+{
+    // FIXME: this assumes WGS84...
+    if ((epoch->_lazy & LAZY_LLH) != 0)
     {
-        bool anyway = false;
-        int offs = 0;
-        double val = epoch->uptime;
-        // Days
-        if (val > 86400.0)
-        {
-            const int days = floor(val / 86400.0);
-            offs += snprintf(&epoch->uptimeStr[offs], sizeof(epoch->uptimeStr) - offs, "%dd", days);
-            val -= (double)days * 86400.0;
-            anyway = true;
-        }
-        // Hours
-        if (anyway || (val > 3600.0))
-        {
-            const int hours = floor(val / 3600.0);
-            offs += snprintf(&epoch->uptimeStr[offs], sizeof(epoch->uptimeStr) - offs, " %dh", hours);
-            val -= (double)hours * 3600.0;
-            anyway = true;
-        }
-        // Minutes
-        if (anyway || (val > 60.0))
-        {
-            const int minutes = floor(val / 60.0);
-            offs += snprintf(&epoch->uptimeStr[offs], sizeof(epoch->uptimeStr) - offs, " %dm", minutes);
-            val -= (double)minutes * 60.0;
-            anyway = true;
-        }
-        // Seconds
-        {
-            offs += snprintf(&epoch->uptimeStr[offs], sizeof(epoch->uptimeStr) - offs, anyway ? " %.1fs" : "%.1fs", val);
-        }
+        xyz2llh_vec(epoch->xyz, epoch->llh);
+        epoch->_lazy &= ~LAZY_LLH;
     }
+    return epoch->llh;
+}
 
-    // Time and date
-    if (epoch->haveGpsWeek && epoch->haveGpsTow)
+const double *epochXyz(EPOCH_t *epoch)
+{
+    if ((epoch->_lazy & LAZY_XYZ) != 0)
     {
-        epoch->posixTime = ts2posix(wnoTow2ts(epoch->gpsWeek, epoch->gpsTow), epoch->leapSeconds, epoch->haveLeapSeconds);
-        epoch->havePosixTime = true;
+        llh2xyz_vec(epoch->llh, epoch->xyz);
+        epoch->_lazy &= ~LAZY_XYZ;
+    }
+    return epoch->xyz;
+}
 
+bool epochPosixTime(EPOCH_t *epoch, double *posixTime)
+{
+    if ( !epoch->haveGpsWeek || !epoch->haveGpsTow )
+    {
+        return false;
     }
     // else if (epoch->haveDate && epoch->haveTime) // FIXME TODO
     // {
     //     ...
     // }
+    if ((epoch->_lazy & LAZY_POSIXTIME) != 0)
+    {
+        epoch->_posixTime = ts2posix(wnoTow2ts(epoch->gpsWeek, epoch->gpsTow), epoch->leapSeconds, epoch->haveLeapSeconds);
+        epoch->_lazy &= ~LAZY_POSIXTIME;
+    }
+    if (posixTime != NULL)
+    {
+        *posixTime = epoch->_posixTime;
+    }
+    return true;
+}
+
+bool epochLatency(EPOCH_t *epoch, float *latency)
+{
+    double posixTime;
+    if (!epochPosixTime(epoch, &posixTime))
+    {
+        return false;
+    }
+    if ((epoch->_lazy & LAZY_LATENCY) != 0)
+    {
+        // Wall clock time at completion of the epoch
+        const double now = posixNow() - ((double)(TIME() - epoch->ts) * 1e-3);
+        epoch->_latency = now - posixTime;
+        epoch->_lazy &= ~LAZY_LATENCY;
+    }
+    if (latency != NULL)
+    {
+        *latency = epoch->_latency;
+    }
+    return (epoch->_latency > 0.0f) && (epoch->_latency <= 2.0f); // Only when reading a live receiver
+}
+
+const char *epochFixStr(const EPOCH_t *epoch)
+{
+    switch (epoch->fix)
+    {
+        case EPOCH_FIX_UNKNOWN: break;
+        case EPOCH_FIX_NOFIX:        return epoch->fixOk ? "NOFIX"        : "(NOFIX)";
+        case EPOCH_FIX_DRONLY:       return epoch->fixOk ? "DR"           : "(DR)";
+        case EPOCH_FIX_TIME:         return epoch->fixOk ? "TIME"         : "(TIME)";
+        case EPOCH_FIX_S2D:          return epoch->fixOk ? "S2D"          : "(2D)";
+        case EPOCH_FIX_S3D:          return epoch->fixOk ? "S3D"          : "(3D)";
+        case EPOCH_FIX_S3D_DR:       return epoch->fixOk ? "S3D+DR"       : "(3D+DR)";
+        case EPOCH_FIX_RTK_FLOAT:    return epoch->fixOk ? "RTK_FLOAT"    : "(RTK_FLOAT)";
+        case EPOCH_FIX_RTK_FIXED:    return epoch->fixOk ? "RTK_FIXED"    : "(RTK_FIXED)";
+        case EPOCH_FIX_RTK_FLOAT_DR: return epoch->fixOk ? "RTK_FLOAT_DR" : "(RTK_FLOAT_DR)";
+        case EPOCH_FIX_RTK_FIXED_DR: return epoch->fixOk ? "RTK_FIXED_DR" : "(RTK_FIXED_DR)";
+    }
+    return epoch->fixOk ? "UNKN" : "(UNKN)";
+}
+
+const char *epochUptimeStr(EPOCH_t *epoch)
+{
+    if ((epoch->_lazy & LAZY_UPTIMESTR) == 0)
+    {
+        return epoch->_uptimeStr;
+    }
+    epoch->_lazy &= ~LAZY_UPTIMESTR;
+    if (!epoch->haveUptime)
+    {
+        return epoch->_uptimeStr;
+    }
+
+    bool anyway = false;
+    int offs = 0;
+    double val = epoch->uptime;
+    // Days
+    if (val > 86400.0)
+    {
+        const int days = floor(val / 86400.0);
+        offs += snprintf(&epoch->_uptimeStr[offs], sizeof(epoch->_uptimeStr) - offs, "%dd", days);
+        val -= (double)days * 86400.0;
+        anyway = true;
+    }
+    // Hours
+    if (anyway || (val > 3600.0))
+    {
+        const int hours = floor(val / 3600.0);
+        offs += snprintf(&epoch->_uptimeStr[offs], sizeof(epoch->_uptimeStr) - offs, " %dh", hours);
+        val -= (double)hours * 3600.0;
+        anyway = true;
+    }
+    // Minutes
+    if (anyway || (val > 60.0))
+    {
+        const int minutes = floor(val / 60.0);
+        offs += snprintf(&epoch->_uptimeStr[offs], sizeof(epoch->_uptimeStr) - offs, " %dm", minutes);
+        val -= (double)minutes * 60.0;
+        anyway = true;
+    }
+    // Seconds
+    {
+        offs += snprintf(&epoch->_uptimeStr[offs], sizeof(epoch->_uptimeStr) - offs, anyway ? " %.1fs" : "%.1fs", val);
+    }
+    return epoch->_uptimeStr;
+}
 
-    // Latency
-    if (epoch->havePosixTime)
+const char *epochStr(EPOCH_t *epoch)
+{
+    if ((epoch->_lazy & LAZY_STR) == 0)
     {
-        epoch->latency = now - epoch->posixTime;
-        epoch->haveLatency = ((epoch->latency > 0.0f) && (epoch->latency <= 2.0f)); // Only when reading a live receiver
+        return epoch->_str;
     }
+    epoch->_lazy &= ~LAZY_STR;
 
-    // Epoch info stringification
-    snprintf(epoch->str, sizeof(epoch->str),
+    const double *llh = epochLlh(epoch);
+    snprintf(epoch->_str, sizeof(epoch->_str),
         "%-12s %2d %04d-%02d-%02d (%c) %02d:%02d:%06.3f (%c) %+11.7f %+12.7f (%5.1f) %+5.0f (%5.1f) %4.1f",
-        epoch->fixStr, epoch->numSv,
+        epochFixStr(epoch), epoch->numSv,
         epoch->year, epoch->month, epoch->day, epoch->haveDate ? (epoch->confDate ? 'Y' : 'y') : 'N',
         epoch->hour, epoch->minute, epoch->second < 0.001 ? 0.0 : epoch->second, epoch->haveTime ? (epoch->confTime ? 'Y' : 'y') : 'N',
-        rad2deg(epoch->llh[0]), rad2deg(epoch->llh[1]), epoch->horizAcc, epoch->llh[2], epoch->vertAcc,
+        rad2deg(llh[0]), rad2deg(llh[1]), epoch->horizAcc, llh[2], epoch->vertAcc,
         epoch->pDOP);
+    return epoch->_str;
 }
 
 const char *epochStrHeader(void)
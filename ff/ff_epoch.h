@@ -52,6 +52,7 @@
 
     parserInit(&parser);
     epochInit(&coll);
+    epochInit(&epoch);
 
     while (true)
     {
@@ -78,7 +79,7 @@
                 // Have a complete epoch?
                 if (haveEpoch)
                 {
-                    printf("epoch: %s\n", epoch.str);
+                    printf("epoch: %s\n", epochStr(&epoch));
                 }
                 // else: we have no epoch yet
             }
@@ -90,6 +91,9 @@
             }
         }
     }
+
+    epochFree(&coll);
+    epochFree(&epoch);
     \endcode
 
     \b Notes
@@ -103,6 +107,10 @@
         u-blox receivers have UBX-NAV-EOE for this.
       - A new sequence of navigation data messages is detected by a changed time (iTOW field in UBX-NAV messages, or
         the time field in NMEA messages)
+    - Optionally, a set of expected messages can be configured (see epochSetExpected()). The epoch is then complete
+      as soon as all these messages have been seen for the same iTOW (or earlier, when detected by the other methods).
+      This is useful for UBX-only setups that don't have UBX-NAV-EOE. It is not recommended to use it with NMEA
+      messages, as these do not carry the iTOW.
     - The consequence of the two detection methods are:
       - If a end-of-epoch marker is available, epochDetect() returns true and provides the epoch data right away as
         soon as this marker message is received. There is no delay besides the time it takes the receiver to
@@ -111,6 +119,9 @@
         change can only be observed in a subsequent navigation solution output, epochDetect() returns true only once the
         receiver starts to output a next navigation solution. That is, if the navigation output rate is 1Hz, the
         epochDetect() repots the epoch with 1s delay (or 0.5s at 2Hz, etc.)
+    - Derived data, such as the strings or the ECEF position calculated from lat/lon/height, is only calculated when
+      requested (and then only once per epoch), see e.g. epochStr() and epochXyz(). Stringification can be disabled
+      entirely using epochSetStrings().
 
     @{
 */
@@ -246,41 +257,31 @@ typedef enum EPOCH_BAND_e
     // Keep in sync with kEpochBandStrs!
 } EPOCH_BAND_t;
 
-//! Signal information
-typedef struct EPOCH_SIGINFO_s
+//! Signals (structure of arrays, index 0..num-1, the arrays are allocated by epochInit())
+typedef struct EPOCH_SIGNALS_s
 {
-    bool              valid;
-    EPOCH_GNSS_t      gnss;
-    uint8_t           sv;
-    EPOCH_SIGNAL_t    signal;
-    EPOCH_BAND_t      band;
-    int8_t            gloFcn;
-    float             prRes;
-    float             cno;
-    EPOCH_SIGUSE_t    use;
-    EPOCH_SIGCORR_t   corr;
-    EPOCH_SIGIONO_t   iono;
-    EPOCH_SIGHEALTH_t health;
-    bool              prUsed;
-    bool              crUsed;
-    bool              doUsed;
-    bool              anyUsed;
-    bool              prCorrUsed;
-    bool              crCorrUsed;
-    bool              doCorrUsed;
-    const char       *gnssStr;
-    const char       *svStr;
-    const char       *signalStr;
-    const char       *bandStr;
-    const char       *useStr;
-    const char       *corrStr;
-    const char       *ionoStr;
-    const char       *healthStr;
-    int               satIx;
-
-    // Private
-    uint32_t          _order;
-} EPOCH_SIGINFO_t;
+    int                num;        //!< Number of signals
+    int                max;        //!< Size of the arrays
+    EPOCH_GNSS_t      *gnss;       //!< GNSS
+    uint8_t           *sv;         //!< SV number
+    EPOCH_SIGNAL_t    *signal;     //!< Signal
+    EPOCH_BAND_t      *band;       //!< Frequency band
+    int8_t            *gloFcn;     //!< GLONASS frequency channel number
+    float             *prRes;      //!< Pseudorange residual [m]
+    float             *cno;        //!< Signal strength [dBHz]
+    EPOCH_SIGUSE_t    *use;        //!< Signal use
+    EPOCH_SIGCORR_t   *corr;       //!< Correction data availability
+    EPOCH_SIGIONO_t   *iono;       //!< Ionosphere corrections
+    EPOCH_SIGHEALTH_t *health;     //!< Signal health
+    bool              *prUsed;     //!< Pseudorange used
+    bool              *crUsed;     //!< Carrier range used
+    bool              *doUsed;     //!< Doppler used
+    bool              *anyUsed;    //!< Any of the above used
+    bool              *prCorrUsed; //!< Pseudorange corrections used
+    bool              *crCorrUsed; //!< Carrier range corrections used
+    bool              *doCorrUsed; //!< Doppler corrections used
+    int16_t           *satIx;      //!< Index into EPOCH_SATELLITES_t arrays, -1 if there is no satellite info
+} EPOCH_SIGNALS_t;
 
 //! Satellite orbit source
 typedef enum EPOCH_SATORB_e
@@ -293,23 +294,18 @@ typedef enum EPOCH_SATORB_e
     // Keep in sync with kEpochOrbStrs!
 } EPOCH_SATORB_t;
 
-//! Satellite information
-typedef struct EPOCH_SATINFO_s
+//! Satellites (structure of arrays, index 0..num-1, the arrays are allocated by epochInit())
+typedef struct EPOCH_SATELLITES_s
 {
-    bool              valid;
-    EPOCH_GNSS_t      gnss;
-    uint8_t           sv;
-    EPOCH_SATORB_t    orbUsed;
-    int               orbAvail; //!< Bits of EPOCH_SATORB_e
-    int8_t            elev;     //!< Elevation [deg] (-90..+90), only valid if orbUsed > EPOCH_SATORB_NONE
-    int16_t           azim;     //!< Azimuth [deg] (0..359), only valid if orbUsed > EPOCH_SATORB_NONE
-    const char       *gnssStr;
-    const char       *svStr;
-    const char       *orbUsedStr;
-
-    // Private
-    uint32_t          _order;
-} EPOCH_SATINFO_t;
+    int                num;        //!< Number of satellites
+    int                max;        //!< Size of the arrays
+    EPOCH_GNSS_t      *gnss;       //!< GNSS
+    uint8_t           *sv;         //!< SV number
+    EPOCH_SATORB_t    *orbUsed;    //!< Orbit used
+    int               *orbAvail;   //!< Orbits available (bits of EPOCH_SATORB_e)
+    int8_t            *elev;       //!< Elevation [deg] (-90..+90), only valid if orbUsed > EPOCH_SATORB_NONE
+    int16_t           *azim;       //!< Azimuth [deg] (0..359), only valid if orbUsed > EPOCH_SATORB_NONE
+} EPOCH_SATELLITES_t;
 
 
 // CNo histogram
@@ -321,18 +317,20 @@ typedef struct EPOCH_SATINFO_s
 #define EPOCH_SIGCNOHIST_IX2CNO_H(ix)  (EPOCH_SIGCNOHIST_IX2CNO_L((ix) + 1) - 1)
 
 //! Navigation epoch data
+/*!
+    Some derived data is only calculated when requested using the corresponding functions: epochStr(), epochFixStr(),
+    epochUptimeStr(), epochLlh(), epochXyz(), epochPosixTime() and epochLatency()
+*/
 typedef struct EPOCH_s
 {
     // Public
     bool                valid;
     uint32_t            seq;
-    uint64_t            ts;
-    char                str[256];
+    uint64_t            ts;          //!< Time of completion of the epoch [ms] (TIME())
 
     bool                haveFix;
     EPOCH_FIX_t         fix;
     bool                fixOk;
-    const char         *fixStr;
 
     bool                haveNumSv;
     int                 numSv;
@@ -341,8 +339,8 @@ typedef struct EPOCH_s
     float               pDOP;
 
     bool                havePos;
-    double              llh[3];
-    double              xyz[3];
+    double              llh[3];      //!< Position [rad, rad, m], use epochLlh() if only ECEF was available
+    double              xyz[3];      //!< Position [m], use epochXyz() if only lat/lon/height was available
     double              horizAcc;
     double              vertAcc;
     double              posAcc;
@@ -385,21 +383,12 @@ typedef struct EPOCH_s
     double              gpsTow;
     double              gpsTowAcc;
 
-    bool                havePosixTime;
-    double              posixTime;
-
     bool                haveClock;
     double              clockBias;
     double              clockDrift;
 
-    bool                haveLatency;
-    float               latency;
-
-    EPOCH_SIGINFO_t     signals[100];
-    int                 numSignals;
-
-    EPOCH_SATINFO_t     satellites[100];
-    int                 numSatellites;
+    EPOCH_SIGNALS_t     signals;     //!< Signals, sorted by gnss, sv and signal
+    EPOCH_SATELLITES_t  satellites;  //!< Satellites, sorted by gnss and sv
 
     bool                haveNumSig;
     int                 numSigUsed;
@@ -430,11 +419,18 @@ typedef struct EPOCH_s
 
     bool                haveUptime;
     double              uptime;
-    char                uptimeStr[20];
 
     // Private states for epoch detection and collection
-    uint64_t            _detect[3];
-    uint64_t            _collect[8];
+    uint64_t            _detect[6];
+    uint64_t            _collect[9];
+    void               *_mem;        // Memory for the signals and satellites arrays
+    uint64_t           *_sortKeys;   // Scratch space for sorting the signals and satellites
+    void               *_sortTmp;
+    uint32_t            _lazy;       // Derived data not yet calculated (bits, see ff_epoch.c)
+    double              _posixTime;  // Memory for epochPosixTime()
+    float               _latency;    // Memory for epochLatency()
+    char                _str[256];   // Memory for epochStr()
+    char                _uptimeStr[20]; // Memory for epochUptimeStr()
 
 } EPOCH_t;
 
@@ -457,11 +453,88 @@ typedef struct EPOCH_s
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-//! Initialise epoch collector
+#define EPOCH_DEF_MAX_SIGNALS    255 //!< Default size of the signals arrays (max. number of signals in UBX-NAV-SIG)
+#define EPOCH_DEF_MAX_SATELLITES 255 //!< Default size of the satellites arrays (max. number of SVs in UBX-NAV-SAT)
+
+//! Initialise epoch collector or epoch
+/*!
+    Both the collector and the epoch passed to epochCollect() must be initialised, with the same size, and both must
+    be released using epochFree(). This allocates the signals and satellites arrays of the default size.
+
+    \param[out]  coll  collector or epoch structure
+
+    \returns true on success, false on failure (out of memory)
+*/
+bool epochInit(EPOCH_t *coll);
+
+//! Initialise epoch collector or epoch, with given size of the signals and satellites arrays
+/*!
+    The collector and the epoch passed to epochCollect() must be initialised with the same sizes. As they swap their
+    arrays, different sizes would alternate from epoch to epoch, and the smaller one would truncate the data.
+
+    \param[out]  coll           collector or epoch structure
+    \param[in]   maxSignals     size of the signals arrays
+    \param[in]   maxSatellites  size of the satellites arrays
+
+    \returns true on success, false on failure (out of memory)
+*/
+bool epochInitSize(EPOCH_t *coll, const int maxSignals, const int maxSatellites);
+
+//! Release epoch collector or epoch
+/*!
+    \param[in,out]  coll  collector or epoch structure, initialised by epochInit() or epochInitSize()
+*/
+void epochFree(EPOCH_t *coll);
+
+//! Expected messages (bits) for early epoch completion
+typedef enum EPOCH_EXPECT_e
+{
+    EPOCH_EXPECT_NONE              = 0x00000000, //!< No expected messages (early completion disabled)
+    EPOCH_EXPECT_UBX_NAV_PVT       = 0x00000001, //!< UBX-NAV-PVT
+    EPOCH_EXPECT_UBX_NAV_SAT       = 0x00000002, //!< UBX-NAV-SAT
+    EPOCH_EXPECT_UBX_NAV_SIG       = 0x00000004, //!< UBX-NAV-SIG
+    EPOCH_EXPECT_UBX_NAV_ORB       = 0x00000008, //!< UBX-NAV-ORB
+    EPOCH_EXPECT_UBX_NAV_STATUS    = 0x00000010, //!< UBX-NAV-STATUS
+    EPOCH_EXPECT_UBX_NAV_CLOCK     = 0x00000020, //!< UBX-NAV-CLOCK
+    EPOCH_EXPECT_UBX_NAV_DOP       = 0x00000040, //!< UBX-NAV-DOP
+    EPOCH_EXPECT_UBX_NAV_POSECEF   = 0x00000080, //!< UBX-NAV-POSECEF
+    EPOCH_EXPECT_UBX_NAV_POSLLH    = 0x00000100, //!< UBX-NAV-POSLLH
+    EPOCH_EXPECT_UBX_NAV_VELECEF   = 0x00000200, //!< UBX-NAV-VELECEF
+    EPOCH_EXPECT_UBX_NAV_VELNED    = 0x00000400, //!< UBX-NAV-VELNED
+    EPOCH_EXPECT_UBX_NAV_GEOFENCE  = 0x00000800, //!< UBX-NAV-GEOFENCE
+    EPOCH_EXPECT_UBX_NAV_TIMEUTC   = 0x00001000, //!< UBX-NAV-TIMEUTC
+    EPOCH_EXPECT_UBX_NAV_TIMELS    = 0x00002000, //!< UBX-NAV-TIMELS
+    EPOCH_EXPECT_UBX_NAV_TIMEGPS   = 0x00004000, //!< UBX-NAV-TIMEGPS
+    EPOCH_EXPECT_UBX_NAV_TIMEGLO   = 0x00008000, //!< UBX-NAV-TIMEGLO
+    EPOCH_EXPECT_UBX_NAV_TIMEBDS   = 0x00010000, //!< UBX-NAV-TIMEBDS
+    EPOCH_EXPECT_UBX_NAV_TIMEGAL   = 0x00020000, //!< UBX-NAV-TIMEGAL
+    EPOCH_EXPECT_UBX_NAV_SVIN      = 0x00040000, //!< UBX-NAV-SVIN
+    EPOCH_EXPECT_UBX_NAV_ODO       = 0x00080000, //!< UBX-NAV-ODO
+    EPOCH_EXPECT_UBX_NAV_HPPOSLLH  = 0x00100000, //!< UBX-NAV-HPPOSLLH
+    EPOCH_EXPECT_UBX_NAV_HPPOSECEF = 0x00200000, //!< UBX-NAV-HPPOSECEF
+    EPOCH_EXPECT_UBX_NAV_RELPOSNED = 0x00400000, //!< UBX-NAV-RELPOSNED
+} EPOCH_EXPECT_t;
+
+//! Configure expected messages for early epoch completion
 /*!
-    \param[out]  coll  collector structure
+    \param[in,out]  coll      collector structure (initialised by epochInit())
+    \param[in]      expected  expected messages (bits of EPOCH_EXPECT_e), EPOCH_EXPECT_NONE to disable
+
+    \note Once all expected messages have been seen for an iTOW, the epoch is output with the last of these messages.
+          Any further UBX-NAV messages (including UBX-NAV-EOE) with the same iTOW are ignored. Without expected
+          messages no messages are ignored, and a late message starts a new epoch.
 */
-void epochInit(EPOCH_t *coll);
+void epochSetExpected(EPOCH_t *coll, const uint32_t expected);
+
+//! Enable or disable stringification
+/*!
+    \param[in,out]  coll    collector structure (initialised by epochInit())
+    \param[in]      enable  true to enable (default), false to disable stringification
+
+    \note With stringification disabled, epochStr() and epochUptimeStr() return an empty string for all epochs output
+          by this collector.
+*/
+void epochSetStrings(EPOCH_t *coll, const bool enable);
 
 //! Collect message, determine if a complete epoch is available
 /*!
@@ -473,17 +546,77 @@ void epochInit(EPOCH_t *coll);
 
     \note While \c coll has the same type as \c epoch, it must not be used by the user. Only the data returned in
           \c epoch is valid, consistent and complete.
+
+    \note The data is not copied. Instead, the collector and the epoch swap their signals and satellites arrays. That
+          is, a (shallow) copy of \c epoch made by the user shares the arrays, which are overwritten by subsequent
+          calls to epochCollect(). Therefore \c epoch (unless NULL) must be initialised with the same size as \c coll,
+          see epochInitSize().
 */
 bool epochCollect(EPOCH_t *coll, const PARSER_MSG_t *msg, EPOCH_t *epoch);
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+//! Epoch stringification
+/*!
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+    \returns a string with the most important data of the epoch (see epochStrHeader()), or an empty string if
+             stringification is disabled (see epochSetStrings())
+*/
+const char *epochStr(EPOCH_t *epoch);
+
 //! Epoch stringification header
 /*!
-    \returns a header string that corresponds to the data in the string in EPOCH_t.str
+    \returns a header string that corresponds to the data in the string returned by epochStr()
 */
 const char *epochStrHeader(void);
 
+//! Stringify fix type
+/*!
+    \param[in]  epoch  epoch (as returned by epochCollect())
+    \returns a concise string for the fix type ("S3D", "RTK_FIXED", etc., in brackets if the fix is not OK)
+*/
+const char *epochFixStr(const EPOCH_t *epoch);
+
+//! Stringify receiver uptime
+/*!
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+    \returns a string for the uptime ("1d 2h 3m 4.5s", etc.), or an empty string if the uptime is not available
+             or stringification is disabled (see epochSetStrings())
+*/
+const char *epochUptimeStr(EPOCH_t *epoch);
+
+//! Get position as latitude, longitude and height
+/*!
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+    \returns the position [rad, rad, m], calculated from the ECEF position if necessary, only valid if havePos is set
+*/
+const double *epochLlh(EPOCH_t *epoch);
+
+//! Get position as ECEF coordinates
+/*!
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+    \returns the position [m], calculated from the lat/lon/height position if necessary, only valid if havePos is set
+*/
+const double *epochXyz(EPOCH_t *epoch);
+
+//! Get POSIX time of the epoch
+/*!
+    \param[in,out]  epoch      epoch (as returned by epochCollect())
+    \param[out]     posixTime  POSIX time [s]
+    \returns true if the time is available (and \c posixTime is valid), false otherwise
+*/
+bool epochPosixTime(EPOCH_t *epoch, double *posixTime);
+
+//! Get latency of the epoch
+/*!
+    \param[in,out]  epoch    epoch (as returned by epochCollect())
+    \param[out]     latency  latency [s] of the epoch completion relative to the epoch time
+    \returns true if the latency is available (and \c latency is valid), false otherwise
+
+    \note The latency is only available when reading from a live receiver, i.e. if it is between 0 and 2 seconds.
+*/
+bool epochLatency(EPOCH_t *epoch, float *latency);
+
 //! Stringify gnss identifier
 /*!
     \param[in] gnss  GNSS identifier
@@ -505,6 +638,56 @@ const char *epochSignalStr(const EPOCH_SIGNAL_t signal);
 */
 EPOCH_GNSS_t epochSignalGnss(const EPOCH_SIGNAL_t signal);
 
+//! Stringify satellite
+/*!
+    \param[in]  gnss  GNSS identifier
+    \param[in]  sv    SV number
+    \returns a concise unique string for the satellite ("G01", "E12", etc.)
+*/
+const char *epochSvStr(const EPOCH_GNSS_t gnss, const int sv);
+
+//! Stringify frequency band
+/*!
+    \param[in]  band  frequency band
+    \returns a concise unique string for the band ("L1", "E6", etc.)
+*/
+const char *epochBandStr(const EPOCH_BAND_t band);
+
+//! Stringify signal use
+/*!
+    \param[in]  use  signal use
+    \returns a concise unique string for the signal use ("CODELOCK", etc.)
+*/
+const char *epochSigUseStr(const EPOCH_SIGUSE_t use);
+
+//! Stringify signal correction data availability
+/*!
+    \param[in]  corr  signal correction data availability
+    \returns a concise unique string for the corrections ("RTCM3-OSR", etc.)
+*/
+const char *epochSigCorrStr(const EPOCH_SIGCORR_t corr);
+
+//! Stringify ionosphere corrections
+/*!
+    \param[in]  iono  ionosphere corrections
+    \returns a concise unique string for the corrections ("KLOB-GPS", etc.)
+*/
+const char *epochSigIonoStr(const EPOCH_SIGIONO_t iono);
+
+//! Stringify signal health
+/*!
+    \param[in]  health  signal health
+    \returns a concise unique string for the health ("HEALTHY", etc.)
+*/
+const char *epochSigHealthStr(const EPOCH_SIGHEALTH_t health);
+
+//! Stringify satellite orbit source
+/*!
+    \param[in]  orb  orbit source
+    \returns a concise unique string for the orbit source ("EPH", "ALM", etc.)
+*/
+const char *epochSatOrbStr(const EPOCH_SATORB_t orb);
+
 
 //! GNSS + SV to index
 /*!
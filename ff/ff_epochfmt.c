@@ -0,0 +1,696 @@
+// clang-format off
+// flipflip's navigation epoch serialisation
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "ff_debug.h"
+#include "ff_stuff.h"
+#include "ff_trafo.h"
+
+#include "ff_epochfmt.h"
+
+/* ****************************************************************************************************************** */
+
+// Fields, see the table in ff_epochfmt.h
+typedef enum FIELD_e
+{
+    FIELD_TS = 0, FIELD_SEQ, FIELD_FIX, FIELD_FIXOK, FIELD_NUMSV, FIELD_PDOP, FIELD_GPSWEEK, FIELD_GPSTOW,
+    FIELD_GPSTOWACC, FIELD_YEAR, FIELD_MONTH, FIELD_DAY, FIELD_HOUR, FIELD_MINUTE, FIELD_SECOND, FIELD_TIMEACC,
+    FIELD_LEAPSECONDS, FIELD_LAT, FIELD_LON, FIELD_HEIGHT, FIELD_HEIGHTMSL, FIELD_HORIZACC, FIELD_VERTACC,
+    FIELD_POSACC, FIELD_VELN, FIELD_VELE, FIELD_VELD, FIELD_VEL2D, FIELD_VELACC, FIELD_RELLEN, FIELD_RELN,
+    FIELD_RELE, FIELD_RELD, FIELD_RELACCN, FIELD_RELACCE, FIELD_RELACCD, FIELD_CLOCKBIAS, FIELD_CLOCKDRIFT,
+    FIELD_DIFFAGE, FIELD_UPTIME, FIELD_NUMSIGUSED, FIELD_NUMSATUSED, FIELD_NUMSIGNALS, FIELD_NUMSATELLITES,
+    _FIELD_NUM
+} FIELD_t;
+
+typedef struct FIELD_INFO_s
+{
+    const char      *name;
+    EPOCHFMT_TYPE_t  type;
+    int              decimals; // For CSV and JSON
+} FIELD_INFO_t;
+
+static const FIELD_INFO_t kFieldInfo[_FIELD_NUM] =
+{
+    [FIELD_TS]            = { "ts",            EPOCHFMT_TYPE_U64,  0 },
+    [FIELD_SEQ]           = { "seq",           EPOCHFMT_TYPE_U32,  0 },
+    [FIELD_FIX]           = { "fix",           EPOCHFMT_TYPE_U8,   0 },
+    [FIELD_FIXOK]         = { "fixOk",         EPOCHFMT_TYPE_U8,   0 },
+    [FIELD_NUMSV]         = { "numSv",         EPOCHFMT_TYPE_U16,  0 },
+    [FIELD_PDOP]          = { "pDOP",          EPOCHFMT_TYPE_F32,  2 },
+    [FIELD_GPSWEEK]       = { "gpsWeek",       EPOCHFMT_TYPE_U16,  0 },
+    [FIELD_GPSTOW]        = { "gpsTow",        EPOCHFMT_TYPE_F64,  3 },
+    [FIELD_GPSTOWACC]     = { "gpsTowAcc",     EPOCHFMT_TYPE_F32,  6 },
+    [FIELD_YEAR]          = { "year",          EPOCHFMT_TYPE_U16,  0 },
+    [FIELD_MONTH]         = { "month",         EPOCHFMT_TYPE_U8,   0 },
+    [FIELD_DAY]           = { "day",           EPOCHFMT_TYPE_U8,   0 },
+    [FIELD_HOUR]          = { "hour",          EPOCHFMT_TYPE_U8,   0 },
+    [FIELD_MINUTE]        = { "minute",        EPOCHFMT_TYPE_U8,   0 },
+    [FIELD_SECOND]        = { "second",        EPOCHFMT_TYPE_F64,  3 },
+    [FIELD_TIMEACC]       = { "timeAcc",       EPOCHFMT_TYPE_F32,  9 },
+    [FIELD_LEAPSECONDS]   = { "leapSeconds",   EPOCHFMT_TYPE_I8,   0 },
+    [FIELD_LAT]           = { "lat",           EPOCHFMT_TYPE_F64,  9 },
+    [FIELD_LON]           = { "lon",           EPOCHFMT_TYPE_F64,  9 },
+    [FIELD_HEIGHT]        = { "height",        EPOCHFMT_TYPE_F64,  4 },
+    [FIELD_HEIGHTMSL]     = { "heightMsl",     EPOCHFMT_TYPE_F64,  4 },
+    [FIELD_HORIZACC]      = { "horizAcc",      EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_VERTACC]       = { "vertAcc",       EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_POSACC]        = { "posAcc",        EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_VELN]          = { "velN",          EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_VELE]          = { "velE",          EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_VELD]          = { "velD",          EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_VEL2D]         = { "vel2d",         EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_VELACC]        = { "velAcc",        EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_RELLEN]        = { "relLen",        EPOCHFMT_TYPE_F64,  4 },
+    [FIELD_RELN]          = { "relN",          EPOCHFMT_TYPE_F64,  4 },
+    [FIELD_RELE]          = { "relE",          EPOCHFMT_TYPE_F64,  4 },
+    [FIELD_RELD]          = { "relD",          EPOCHFMT_TYPE_F64,  4 },
+    [FIELD_RELACCN]       = { "relAccN",       EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_RELACCE]       = { "relAccE",       EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_RELACCD]       = { "relAccD",       EPOCHFMT_TYPE_F32,  4 },
+    [FIELD_CLOCKBIAS]     = { "clockBias",     EPOCHFMT_TYPE_F64, 12 },
+    [FIELD_CLOCKDRIFT]    = { "clockDrift",    EPOCHFMT_TYPE_F64, 12 },
+    [FIELD_DIFFAGE]       = { "diffAge",       EPOCHFMT_TYPE_F32,  1 },
+    [FIELD_UPTIME]        = { "uptime",        EPOCHFMT_TYPE_F64,  3 },
+    [FIELD_NUMSIGUSED]    = { "numSigUsed",    EPOCHFMT_TYPE_U16,  0 },
+    [FIELD_NUMSATUSED]    = { "numSatUsed",    EPOCHFMT_TYPE_U16,  0 },
+    [FIELD_NUMSIGNALS]    = { "numSignals",    EPOCHFMT_TYPE_U16,  0 },
+    [FIELD_NUMSATELLITES] = { "numSatellites", EPOCHFMT_TYPE_U16,  0 },
+};
+
+STATIC_ASSERT(_FIELD_NUM <= 64); // Bits in the valid mask
+
+// Field values of one epoch
+typedef struct VALUES_s
+{
+    uint64_t valid;
+    union
+    {
+        uint64_t u;
+        int64_t  i;
+        double   f;
+    } v[_FIELD_NUM];
+} VALUES_t;
+
+static int _typeSize(const EPOCHFMT_TYPE_t type)
+{
+    switch (type)
+    {
+        case EPOCHFMT_TYPE_U8:
+        case EPOCHFMT_TYPE_I8:
+            return 1;
+        case EPOCHFMT_TYPE_U16:
+            return 2;
+        case EPOCHFMT_TYPE_U32:
+        case EPOCHFMT_TYPE_F32:
+            return 4;
+        case EPOCHFMT_TYPE_U64:
+        case EPOCHFMT_TYPE_F64:
+            break;
+    }
+    return 8;
+}
+
+// Binary record field offsets: ts, then the double, float, uint32_t, uint16_t and uint8_t/int8_t fields, in field order
+// (see ff_epochfmt.h)
+static const int kBinOffs[_FIELD_NUM] =
+{
+    [FIELD_TS]          =  16,
+    [FIELD_GPSTOW]      =  24, [FIELD_SECOND]      =  32, [FIELD_LAT]         =  40, [FIELD_LON]         =  48,
+    [FIELD_HEIGHT]      =  56, [FIELD_HEIGHTMSL]   =  64, [FIELD_RELLEN]      =  72, [FIELD_RELN]        =  80,
+    [FIELD_RELE]        =  88, [FIELD_RELD]        =  96, [FIELD_CLOCKBIAS]   = 104, [FIELD_CLOCKDRIFT]  = 112,
+    [FIELD_UPTIME]      = 120,
+    [FIELD_PDOP]        = 128, [FIELD_GPSTOWACC]   = 132, [FIELD_TIMEACC]     = 136, [FIELD_HORIZACC]    = 140,
+    [FIELD_VERTACC]     = 144, [FIELD_POSACC]      = 148, [FIELD_VELN]        = 152, [FIELD_VELE]        = 156,
+    [FIELD_VELD]        = 160, [FIELD_VEL2D]       = 164, [FIELD_VELACC]      = 168, [FIELD_RELACCN]     = 172,
+    [FIELD_RELACCE]     = 176, [FIELD_RELACCD]     = 180, [FIELD_DIFFAGE]     = 184,
+    [FIELD_SEQ]         = 188,
+    [FIELD_NUMSV]       = 192, [FIELD_GPSWEEK]     = 194, [FIELD_YEAR]        = 196, [FIELD_NUMSIGUSED]  = 198,
+    [FIELD_NUMSATUSED]  = 200, [FIELD_NUMSIGNALS]  = 202, [FIELD_NUMSATELLITES] = 204,
+    [FIELD_FIX]         = 206, [FIELD_FIXOK]       = 207, [FIELD_MONTH]       = 208, [FIELD_DAY]         = 209,
+    [FIELD_HOUR]        = 210, [FIELD_MINUTE]      = 211, [FIELD_LEAPSECONDS] = 212,
+};
+
+STATIC_ASSERT(_FIELD_NUM == 44); // Update kBinOffs[] and EPOCHFMT_BIN_SIZE when adding fields
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+#define _SET(_field_, _type_, _valid_, _value_) \
+    if (_valid_) { vals->valid |= UINT64_C(1) << (_field_); vals->v[_field_]._type_ = (_value_); } \
+    else { vals->v[_field_].u = 0; }
+
+static void _epochValues(EPOCH_t *epoch, VALUES_t *vals)
+{
+    vals->valid = 0;
+    const double *llh = epoch->havePos ? epochLlh(epoch) : NULL;
+    _SET(FIELD_TS,            u, true,                  epoch->ts);
+    _SET(FIELD_SEQ,           u, true,                  epoch->seq);
+    _SET(FIELD_FIX,           u, epoch->haveFix,        epoch->fix);
+    _SET(FIELD_FIXOK,         u, epoch->haveFix,        epoch->fixOk ? 1 : 0);
+    _SET(FIELD_NUMSV,         u, epoch->haveNumSv,      epoch->numSv);
+    _SET(FIELD_PDOP,          f, epoch->havePdop,       epoch->pDOP);
+    _SET(FIELD_GPSWEEK,       u, epoch->haveGpsWeek,    epoch->gpsWeek);
+    _SET(FIELD_GPSTOW,        f, epoch->haveGpsTow,     epoch->gpsTow);
+    _SET(FIELD_GPSTOWACC,     f, epoch->haveGpsTow,     epoch->gpsTowAcc);
+    _SET(FIELD_YEAR,          u, epoch->haveDate,       epoch->year);
+    _SET(FIELD_MONTH,         u, epoch->haveDate,       epoch->month);
+    _SET(FIELD_DAY,           u, epoch->haveDate,       epoch->day);
+    _SET(FIELD_HOUR,          u, epoch->haveTime,       epoch->hour);
+    _SET(FIELD_MINUTE,        u, epoch->haveTime,       epoch->minute);
+    _SET(FIELD_SECOND,        f, epoch->haveTime,       epoch->second);
+    _SET(FIELD_TIMEACC,       f, epoch->haveTime,       epoch->timeAcc);
+    _SET(FIELD_LEAPSECONDS,   i, epoch->haveLeapSeconds, epoch->leapSeconds);
+    _SET(FIELD_LAT,           f, llh != NULL,           rad2deg(llh[0]));
+    _SET(FIELD_LON,           f, llh != NULL,           rad2deg(llh[1]));
+    _SET(FIELD_HEIGHT,        f, llh != NULL,           llh[2]);
+    _SET(FIELD_HEIGHTMSL,     f, epoch->haveMsl,        epoch->heightMsl);
+    _SET(FIELD_HORIZACC,      f, epoch->havePos,        epoch->horizAcc);
+    _SET(FIELD_VERTACC,       f, epoch->havePos,        epoch->vertAcc);
+    _SET(FIELD_POSACC,        f, epoch->havePos,        epoch->posAcc);
+    _SET(FIELD_VELN,          f, epoch->haveVel,        epoch->velNed[0]);
+    _SET(FIELD_VELE,          f, epoch->haveVel,        epoch->velNed[1]);
+    _SET(FIELD_VELD,          f, epoch->haveVel,        epoch->velNed[2]);
+    _SET(FIELD_VEL2D,         f, epoch->haveVel,        epoch->vel2d);
+    _SET(FIELD_VELACC,        f, epoch->haveVel,        epoch->velAcc);
+    _SET(FIELD_RELLEN,        f, epoch->haveRelPos,     epoch->relLen);
+    _SET(FIELD_RELN,          f, epoch->haveRelPos,     epoch->relNed[0]);
+    _SET(FIELD_RELE,          f, epoch->haveRelPos,     epoch->relNed[1]);
+    _SET(FIELD_RELD,          f, epoch->haveRelPos,     epoch->relNed[2]);
+    _SET(FIELD_RELACCN,       f, epoch->haveRelPos,     epoch->relAcc[0]);
+    _SET(FIELD_RELACCE,       f, epoch->haveRelPos,     epoch->relAcc[1]);
+    _SET(FIELD_RELACCD,       f, epoch->haveRelPos,     epoch->relAcc[2]);
+    _SET(FIELD_CLOCKBIAS,     f, epoch->haveClock,      epoch->clockBias);
+    _SET(FIELD_CLOCKDRIFT,    f, epoch->haveClock,      epoch->clockDrift);
+    _SET(FIELD_DIFFAGE,       f, epoch->haveDiffAge,    epoch->diffAge);
+    _SET(FIELD_UPTIME,        f, epoch->haveUptime,     epoch->uptime);
+    _SET(FIELD_NUMSIGUSED,    u, epoch->haveNumSig,     epoch->numSigUsed);
+    _SET(FIELD_NUMSATUSED,    u, epoch->haveNumSat,     epoch->numSatUsed);
+    _SET(FIELD_NUMSIGNALS,    u, true,                  epoch->signals.num);
+    _SET(FIELD_NUMSATELLITES, u, true,                  epoch->satellites.num);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static inline void _put16(uint8_t *p, const uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static inline void _put32(uint8_t *p, const uint32_t v)
+{
+    _put16(&p[0], v & 0xffff);
+    _put16(&p[2], (v >> 16) & 0xffff);
+}
+
+static inline void _put64(uint8_t *p, const uint64_t v)
+{
+    _put32(&p[0], v & 0xffffffff);
+    _put32(&p[4], (v >> 32) & 0xffffffff);
+}
+
+static inline void _putF32(uint8_t *p, const float v)
+{
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    _put32(p, u);
+}
+
+static inline void _putF64(uint8_t *p, const double v)
+{
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+    _put64(p, u);
+}
+
+// Store field value (little-endian)
+static void _putValue(uint8_t *p, const EPOCHFMT_TYPE_t type, const VALUES_t *vals, const int field)
+{
+    switch (type)
+    {
+        case EPOCHFMT_TYPE_U8:
+            p[0] = (uint8_t)vals->v[field].u;
+            break;
+        case EPOCHFMT_TYPE_I8:
+            p[0] = (uint8_t)(int8_t)vals->v[field].i;
+            break;
+        case EPOCHFMT_TYPE_U16:
+            _put16(p, (uint16_t)vals->v[field].u);
+            break;
+        case EPOCHFMT_TYPE_U32:
+            _put32(p, (uint32_t)vals->v[field].u);
+            break;
+        case EPOCHFMT_TYPE_U64:
+            _put64(p, vals->v[field].u);
+            break;
+        case EPOCHFMT_TYPE_F32:
+            _putF32(p, (float)vals->v[field].f);
+            break;
+        case EPOCHFMT_TYPE_F64:
+            _putF64(p, vals->v[field].f);
+            break;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static const uint64_t kPow10[] =
+{
+    UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+    UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000), UINT64_C(10000000000), UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+};
+
+// Write unsigned integer, returns number of characters
+static int _fmtU64(char *str, uint64_t val)
+{
+    char tmp[20];
+    int num = 0;
+    do
+    {
+        tmp[num++] = '0' + (val % 10);
+        val /= 10;
+    }
+    while (val > 0);
+    for (int ix = 0; ix < num; ix++)
+    {
+        str[ix] = tmp[num - 1 - ix];
+    }
+    return num;
+}
+
+static int _fmtI64(char *str, const int64_t val)
+{
+    if (val < 0)
+    {
+        str[0] = '-';
+        return 1 + _fmtU64(&str[1], (uint64_t)0 - (uint64_t)val);
+    }
+    return _fmtU64(str, (uint64_t)val);
+}
+
+// Write fixed-point number, returns number of characters, or 0 for NaN and infinity
+static int _fmtFix(char *str, const double val, const int decimals)
+{
+    if (!isfinite(val))
+    {
+        return 0;
+    }
+    const double scaled = val * (double)kPow10[decimals];
+    if (fabs(scaled) > 9.0e18)
+    {
+        return snprintf(str, 32, "%.*e", decimals, val);
+    }
+    const int64_t ival = llround(scaled);
+    const uint64_t uval = ival < 0 ? (uint64_t)0 - (uint64_t)ival : (uint64_t)ival;
+    int len = 0;
+    if (ival < 0)
+    {
+        str[len++] = '-';
+    }
+    len += _fmtU64(&str[len], uval / kPow10[decimals]);
+    if (decimals > 0)
+    {
+        str[len++] = '.';
+        uint64_t frac = uval % kPow10[decimals];
+        for (int ix = decimals; ix > 0; ix--)
+        {
+            str[len + ix - 1] = '0' + (frac % 10);
+            frac /= 10;
+        }
+        len += decimals;
+    }
+    return len;
+}
+
+// Write field value, returns number of characters, 0 if invalid
+static int _fmtValue(char *str, const VALUES_t *vals, const int field)
+{
+    if ((vals->valid & (UINT64_C(1) << field)) == 0)
+    {
+        return 0;
+    }
+    switch (kFieldInfo[field].type)
+    {
+        case EPOCHFMT_TYPE_I8:
+            return _fmtI64(str, vals->v[field].i);
+        case EPOCHFMT_TYPE_F32:
+        case EPOCHFMT_TYPE_F64:
+            return _fmtFix(str, vals->v[field].f, kFieldInfo[field].decimals);
+        case EPOCHFMT_TYPE_U8:
+        case EPOCHFMT_TYPE_U16:
+        case EPOCHFMT_TYPE_U32:
+        case EPOCHFMT_TYPE_U64:
+            break;
+    }
+    return _fmtU64(str, vals->v[field].u);
+}
+
+/* ****************************************************************************************************************** */
+
+bool epochfmtFromName(const char *name, EPOCHFMT_t *fmt)
+{
+    static const struct { const char *name; EPOCHFMT_t fmt; } kFormats[] =
+    {
+        { "str", EPOCHFMT_STR }, { "csv", EPOCHFMT_CSV }, { "json", EPOCHFMT_JSON },
+        { "bin", EPOCHFMT_BIN }, { "col", EPOCHFMT_COL },
+    };
+    for (int ix = 0; (name != NULL) && (ix < NUMOF(kFormats)); ix++)
+    {
+        if (strcmp(name, kFormats[ix].name) == 0)
+        {
+            if (fmt != NULL)
+            {
+                *fmt = kFormats[ix].fmt;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+int epochfmtCsvHeader(char *str, const int size)
+{
+    if ( (str == NULL) || (size < EPOCHFMT_STR_SIZE) )
+    {
+        return 0;
+    }
+    int len = 0;
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        const int nameLen = strlen(kFieldInfo[field].name);
+        memcpy(&str[len], kFieldInfo[field].name, nameLen);
+        len += nameLen;
+        str[len++] = (field < (_FIELD_NUM - 1)) ? ',' : '\n';
+    }
+    str[len] = '\0';
+    return len;
+}
+
+int epochfmtCsv(char *str, const int size, EPOCH_t *epoch)
+{
+    if ( (str == NULL) || (size < EPOCHFMT_STR_SIZE) || (epoch == NULL) )
+    {
+        return 0;
+    }
+    VALUES_t vals;
+    _epochValues(epoch, &vals);
+    int len = 0;
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        len += _fmtValue(&str[len], &vals, field);
+        str[len++] = (field < (_FIELD_NUM - 1)) ? ',' : '\n';
+    }
+    str[len] = '\0';
+    return len;
+}
+
+int epochfmtJson(char *str, const int size, EPOCH_t *epoch)
+{
+    if ( (str == NULL) || (size < EPOCHFMT_STR_SIZE) || (epoch == NULL) )
+    {
+        return 0;
+    }
+    VALUES_t vals;
+    _epochValues(epoch, &vals);
+    int len = 0;
+    str[len++] = '{';
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        str[len++] = '"';
+        const int nameLen = strlen(kFieldInfo[field].name);
+        memcpy(&str[len], kFieldInfo[field].name, nameLen);
+        len += nameLen;
+        str[len++] = '"';
+        str[len++] = ':';
+        const int valLen = _fmtValue(&str[len], &vals, field);
+        if (valLen > 0)
+        {
+            len += valLen;
+        }
+        else
+        {
+            memcpy(&str[len], "null", 4);
+            len += 4;
+        }
+        if (field < (_FIELD_NUM - 1))
+        {
+            str[len++] = ',';
+        }
+    }
+    str[len++] = '}';
+    str[len++] = '\n';
+    str[len] = '\0';
+    return len;
+}
+
+int epochfmtBin(uint8_t *data, const int size, EPOCH_t *epoch)
+{
+    if ( (data == NULL) || (size < EPOCHFMT_BIN_SIZE) || (epoch == NULL) )
+    {
+        return 0;
+    }
+    VALUES_t vals;
+    _epochValues(epoch, &vals);
+    memset(data, 0, EPOCHFMT_BIN_SIZE);
+    data[0] = EPOCHFMT_BIN_SYNC_1;
+    data[1] = EPOCHFMT_BIN_SYNC_2;
+    _put16(&data[2], EPOCHFMT_BIN_SIZE);
+    _put16(&data[4], EPOCHFMT_VERSION);
+    _put64(&data[8], vals.valid);
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        _putValue(&data[kBinOffs[field]], kFieldInfo[field].type, &vals, field);
+    }
+    return EPOCHFMT_BIN_SIZE;
+}
+
+/* ****************************************************************************************************************** */
+
+// Signal columns
+typedef enum SIGCOL_e
+{
+    SIGCOL_EPOCH = 0, SIGCOL_GNSS, SIGCOL_SV, SIGCOL_SIGNAL, SIGCOL_BAND, SIGCOL_GLOFCN, SIGCOL_USE, SIGCOL_CORR,
+    SIGCOL_IONO, SIGCOL_HEALTH, SIGCOL_FLAGS, SIGCOL_CNO, SIGCOL_PRRES,
+    _SIGCOL_NUM
+} SIGCOL_t;
+
+static const FIELD_INFO_t kSigColInfo[_SIGCOL_NUM] =
+{
+    [SIGCOL_EPOCH]  = { "epoch",  EPOCHFMT_TYPE_U32, 0 },
+    [SIGCOL_GNSS]   = { "gnss",   EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_SV]     = { "sv",     EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_SIGNAL] = { "signal", EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_BAND]   = { "band",   EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_GLOFCN] = { "gloFcn", EPOCHFMT_TYPE_I8,  0 },
+    [SIGCOL_USE]    = { "use",    EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_CORR]   = { "corr",   EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_IONO]   = { "iono",   EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_HEALTH] = { "health", EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_FLAGS]  = { "flags",  EPOCHFMT_TYPE_U8,  0 },
+    [SIGCOL_CNO]    = { "cno",    EPOCHFMT_TYPE_F32, 0 },
+    [SIGCOL_PRRES]  = { "prRes",  EPOCHFMT_TYPE_F32, 0 },
+};
+
+#define COL_HEAD_SIZE 32
+#define COL_PAD(size) (((size) + 7) & ~7)
+
+typedef struct EPOCHCOL_s
+{
+    int       maxEpochs;
+    int       maxSignals;
+    bool      signals;
+    int       numEpochs;
+    int       numSignals;
+    uint8_t  *valid;                 // Valid mask column
+    uint8_t  *cols[_FIELD_NUM];      // Field columns (little-endian values)
+    uint8_t  *sigCols[_SIGCOL_NUM];  // Signal columns (little-endian values)
+    uint8_t  *block;                 // Output block
+    int       blockSize;
+    void     *mem;
+} EPOCHCOL_t;
+
+EPOCHCOL_t *epochcolCreate(const int maxEpochs, const bool signals)
+{
+    EPOCHCOL_t *col = malloc(sizeof(EPOCHCOL_t));
+    if (col == NULL)
+    {
+        WARNING("epochcol: malloc fail!");
+        return NULL;
+    }
+    memset(col, 0, sizeof(*col));
+    col->maxEpochs  = maxEpochs > 0 ? maxEpochs : EPOCHCOL_DEF_MAX_EPOCHS;
+    col->maxSignals = signals ? MAX(col->maxEpochs * 64, 0xffff) : 0;
+    col->signals    = signals;
+
+    // One allocation for all columns and the output block
+    int size = COL_PAD(col->maxEpochs * 8);
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        size += COL_PAD(col->maxEpochs * _typeSize(kFieldInfo[field].type));
+    }
+    for (int sigCol = 0; signals && (sigCol < _SIGCOL_NUM); sigCol++)
+    {
+        size += COL_PAD(col->maxSignals * _typeSize(kSigColInfo[sigCol].type));
+    }
+    const int colsSize = size;
+    size += COL_HEAD_SIZE + ((1 + _FIELD_NUM + _SIGCOL_NUM) * EPOCHFMT_COL_DESC_SIZE);
+    col->blockSize = size;
+    col->mem = malloc(colsSize + size);
+    if (col->mem == NULL)
+    {
+        WARNING("epochcol: malloc fail!");
+        free(col);
+        return NULL;
+    }
+
+    uint8_t *mem = col->mem;
+    col->valid = mem;
+    mem += COL_PAD(col->maxEpochs * 8);
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        col->cols[field] = mem;
+        mem += COL_PAD(col->maxEpochs * _typeSize(kFieldInfo[field].type));
+    }
+    for (int sigCol = 0; signals && (sigCol < _SIGCOL_NUM); sigCol++)
+    {
+        col->sigCols[sigCol] = mem;
+        mem += COL_PAD(col->maxSignals * _typeSize(kSigColInfo[sigCol].type));
+    }
+    col->block = mem;
+    return col;
+}
+
+void epochcolDestroy(EPOCHCOL_t *col)
+{
+    if (col != NULL)
+    {
+        free(col->mem);
+        free(col);
+    }
+}
+
+bool epochcolAdd(EPOCHCOL_t *col, EPOCH_t *epoch)
+{
+    if ( (col == NULL) || (epoch == NULL) )
+    {
+        return false;
+    }
+    const int numSig = col->signals ? MIN(epoch->signals.num, col->maxSignals) : 0;
+    if ( (col->numEpochs >= col->maxEpochs) || ((col->numSignals + numSig) > col->maxSignals) )
+    {
+        return false;
+    }
+
+    VALUES_t vals;
+    _epochValues(epoch, &vals);
+    const int row = col->numEpochs;
+    _put64(&col->valid[row * 8], vals.valid);
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        const EPOCHFMT_TYPE_t type = kFieldInfo[field].type;
+        _putValue(&col->cols[field][row * _typeSize(type)], type, &vals, field);
+    }
+
+    const EPOCH_SIGNALS_t *sigs = &epoch->signals;
+    for (int ix = 0; ix < numSig; ix++)
+    {
+        const int sigRow = col->numSignals + ix;
+        _put32(&col->sigCols[SIGCOL_EPOCH][sigRow * 4], row);
+        col->sigCols[SIGCOL_GNSS][sigRow]   = sigs->gnss[ix];
+        col->sigCols[SIGCOL_SV][sigRow]     = sigs->sv[ix];
+        col->sigCols[SIGCOL_SIGNAL][sigRow] = sigs->signal[ix];
+        col->sigCols[SIGCOL_BAND][sigRow]   = sigs->band[ix];
+        col->sigCols[SIGCOL_GLOFCN][sigRow] = (uint8_t)sigs->gloFcn[ix];
+        col->sigCols[SIGCOL_USE][sigRow]    = sigs->use[ix];
+        col->sigCols[SIGCOL_CORR][sigRow]   = sigs->corr[ix];
+        col->sigCols[SIGCOL_IONO][sigRow]   = sigs->iono[ix];
+        col->sigCols[SIGCOL_HEALTH][sigRow] = sigs->health[ix];
+        col->sigCols[SIGCOL_FLAGS][sigRow]  =
+            (sigs->prUsed[ix]     ? 0x01 : 0x00) | (sigs->crUsed[ix]     ? 0x02 : 0x00) |
+            (sigs->doUsed[ix]     ? 0x04 : 0x00) | (sigs->prCorrUsed[ix] ? 0x08 : 0x00) |
+            (sigs->crCorrUsed[ix] ? 0x10 : 0x00) | (sigs->doCorrUsed[ix] ? 0x20 : 0x00);
+        _putF32(&col->sigCols[SIGCOL_CNO][sigRow * 4], sigs->cno[ix]);
+        _putF32(&col->sigCols[SIGCOL_PRRES][sigRow * 4], sigs->prRes[ix]);
+    }
+
+    col->numEpochs++;
+    col->numSignals += numSig;
+    return true;
+}
+
+// Add column descriptor and data to block
+static int _colAdd(uint8_t *block, const int descIx, int offs, const char *name, const EPOCHFMT_TYPE_t type,
+    const uint8_t *data, const int num)
+{
+    uint8_t *desc = &block[COL_HEAD_SIZE + (descIx * EPOCHFMT_COL_DESC_SIZE)];
+    memset(desc, 0, EPOCHFMT_COL_DESC_SIZE);
+    memcpy(desc, name, MIN((int)strlen(name), 19));
+    desc[20] = type;
+    desc[21] = _typeSize(type);
+    const int size = num * _typeSize(type);
+    memcpy(&block[offs], data, size);
+    memset(&block[offs + size], 0, COL_PAD(size) - size);
+    return offs + COL_PAD(size);
+}
+
+const uint8_t *epochcolFlush(EPOCHCOL_t *col, int *size)
+{
+    if ( (col == NULL) || (col->numEpochs == 0) )
+    {
+        return NULL;
+    }
+    uint8_t *block = col->block;
+    const int numCols = 1 + _FIELD_NUM;
+    const int numSigCols = col->signals ? _SIGCOL_NUM : 0;
+
+    int offs = COL_HEAD_SIZE + ((numCols + numSigCols) * EPOCHFMT_COL_DESC_SIZE);
+    offs = _colAdd(block, 0, offs, "valid", EPOCHFMT_TYPE_U64, col->valid, col->numEpochs);
+    for (int field = 0; field < _FIELD_NUM; field++)
+    {
+        offs = _colAdd(block, 1 + field, offs, kFieldInfo[field].name, kFieldInfo[field].type, col->cols[field],
+            col->numEpochs);
+    }
+    for (int sigCol = 0; sigCol < numSigCols; sigCol++)
+    {
+        offs = _colAdd(block, numCols + sigCol, offs, kSigColInfo[sigCol].name, kSigColInfo[sigCol].type,
+            col->sigCols[sigCol], col->numSignals);
+    }
+
+    memset(block, 0, COL_HEAD_SIZE);
+    memcpy(&block[0], "FFEPCOL\n", 8);
+    _put16(&block[8], EPOCHFMT_VERSION);
+    _put16(&block[10], numCols);
+    _put16(&block[12], numSigCols);
+    _put32(&block[16], col->numEpochs);
+    _put32(&block[20], col->numSignals);
+    _put32(&block[24], offs);
+
+    col->numEpochs = 0;
+    col->numSignals = 0;
+    if (size != NULL)
+    {
+        *size = offs;
+    }
+    return block;
+}
+
+/* ****************************************************************************************************************** */
+// eof
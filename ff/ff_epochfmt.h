@@ -0,0 +1,219 @@
+// clang-format off
+// flipflip's navigation epoch serialisation
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef __FF_EPOCHFMT_H__
+#define __FF_EPOCHFMT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ff_epoch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ****************************************************************************************************************** */
+
+// Epoch serialisation for high-rate export
+//
+// All formats use the same fields (in this order, the number is the field index):
+//
+//    0 ts            uint64_t  [ms]     EPOCH_t.ts           22 vertAcc       float     [m]      EPOCH_t.vertAcc
+//    1 seq           uint32_t           EPOCH_t.seq          23 posAcc        float     [m]      EPOCH_t.posAcc
+//    2 fix           uint8_t            EPOCH_FIX_t          24 velN          float     [m/s]    EPOCH_t.velNed[0]
+//    3 fixOk         uint8_t            EPOCH_t.fixOk        25 velE          float     [m/s]    EPOCH_t.velNed[1]
+//    4 numSv         uint16_t           EPOCH_t.numSv        26 velD          float     [m/s]    EPOCH_t.velNed[2]
+//    5 pDOP          float              EPOCH_t.pDOP         27 vel2d         float     [m/s]    EPOCH_t.vel2d
+//    6 gpsWeek       uint16_t           EPOCH_t.gpsWeek      28 velAcc        float     [m/s]    EPOCH_t.velAcc
+//    7 gpsTow        double    [s]      EPOCH_t.gpsTow       29 relLen        double    [m]      EPOCH_t.relLen
+//    8 gpsTowAcc     float     [s]      EPOCH_t.gpsTowAcc    30 relN          double    [m]      EPOCH_t.relNed[0]
+//    9 year          uint16_t           EPOCH_t.year         31 relE          double    [m]      EPOCH_t.relNed[1]
+//   10 month         uint8_t            EPOCH_t.month        32 relD          double    [m]      EPOCH_t.relNed[2]
+//   11 day           uint8_t            EPOCH_t.day          33 relAccN       float     [m]      EPOCH_t.relAcc[0]
+//   12 hour          uint8_t            EPOCH_t.hour         34 relAccE       float     [m]      EPOCH_t.relAcc[1]
+//   13 minute        uint8_t            EPOCH_t.minute       35 relAccD       float     [m]      EPOCH_t.relAcc[2]
+//   14 second        double    [s]      EPOCH_t.second       36 clockBias     double    [s]      EPOCH_t.clockBias
+//   15 timeAcc       float     [s]      EPOCH_t.timeAcc      37 clockDrift    double    [s/s]    EPOCH_t.clockDrift
+//   16 leapSeconds   int8_t    [s]      EPOCH_t.leapSeconds  38 diffAge       float     [s]      EPOCH_t.diffAge
+//   17 lat           double    [deg]    epochLlh()           39 uptime        double    [s]      EPOCH_t.uptime
+//   18 lon           double    [deg]    epochLlh()           40 numSigUsed    uint16_t           EPOCH_t.numSigUsed
+//   19 height        double    [m]      epochLlh()           41 numSatUsed    uint16_t           EPOCH_t.numSatUsed
+//   20 heightMsl     double    [m]      EPOCH_t.heightMsl    42 numSignals    uint16_t           EPOCH_t.signals.num
+//   21 horizAcc      float     [m]      EPOCH_t.horizAcc     43 numSatellites uint16_t           EPOCH_t.satellites.num
+//
+// Fields are valid if the corresponding EPOCH_t.have... flag is set. ts, seq, numSignals and numSatellites are always
+// valid. In the binary formats bit n of the valid mask is set if field n is valid (and invalid fields are 0). In CSV
+// invalid fields are empty and in JSON they are null.
+//
+// Binary record (EPOCHFMT_BIN_SIZE bytes, all values little-endian, fields ordered by size for natural alignment):
+//
+//     0  uint8_t   sync 1 (EPOCHFMT_BIN_SYNC_1)
+//     1  uint8_t   sync 2 (EPOCHFMT_BIN_SYNC_2)
+//     2  uint16_t  record size (EPOCHFMT_BIN_SIZE)
+//     4  uint16_t  version (EPOCHFMT_VERSION)
+//     6  uint16_t  reserved (0)
+//     8  uint64_t  valid mask
+//    16  ...       fields: ts, then the double fields, then the float fields, then seq, then the uint16_t fields, then
+//                  the uint8_t/int8_t fields (in the order of the table above), then 3 bytes padding
+//
+// Columnar block (one array per field, all values little-endian, see epochcolCreate()):
+//
+//     0  char[8]   magic "FFEPCOL\n"
+//     8  uint16_t  version (EPOCHFMT_VERSION)
+//    10  uint16_t  number of epoch columns (valid mask column plus one column per field)
+//    12  uint16_t  number of signal columns (0 if the block has no signals)
+//    14  uint16_t  reserved (0)
+//    16  uint32_t  number of epochs (rows of the epoch columns)
+//    20  uint32_t  number of signals (rows of the signal columns)
+//    24  uint32_t  block size [bytes]
+//    28  uint32_t  reserved (0)
+//    32  column descriptors (EPOCHFMT_COL_DESC_SIZE bytes each, epoch columns then signal columns):
+//           0  char[20]  name (nul-terminated)
+//          20  uint8_t   type (EPOCHFMT_TYPE_t)
+//          21  uint8_t   size of one element [bytes]
+//          22  uint16_t  reserved (0)
+//     ...  column data, each column padded to a multiple of 8 bytes
+//
+//   The signal columns are: epoch (uint32_t, row of the epoch in the block), gnss, sv, signal, band (uint8_t,
+//   EPOCH_SIGNALS_t), gloFcn (int8_t), use, corr, iono, health (uint8_t), flags (uint8_t, bits: 0 prUsed, 1 crUsed,
+//   2 doUsed, 3 prCorrUsed, 4 crCorrUsed, 5 doCorrUsed), cno (float), prRes (float)
+//
+// CSV (one line per epoch, see epochfmtCsvHeader()) and JSON (one object per line) are formatted without printf().
+
+#define EPOCHFMT_VERSION        1      //!< Binary formats version
+#define EPOCHFMT_BIN_SYNC_1     0xfe   //!< Binary record sync byte 1
+#define EPOCHFMT_BIN_SYNC_2     0x45   //!< Binary record sync byte 2 ('E')
+#define EPOCHFMT_BIN_SIZE       216    //!< Binary record size [bytes]
+#define EPOCHFMT_COL_DESC_SIZE  24     //!< Columnar block column descriptor size [bytes]
+#define EPOCHFMT_STR_SIZE       4096   //!< Min. size of buffers for epochfmtCsv() and epochfmtJson()
+
+//! Output formats
+typedef enum EPOCHFMT_e
+{
+    EPOCHFMT_STR = 0,  //!< Text (epochStr())
+    EPOCHFMT_CSV,      //!< CSV
+    EPOCHFMT_JSON,     //!< JSON
+    EPOCHFMT_BIN,      //!< Binary records
+    EPOCHFMT_COL,      //!< Columnar blocks
+} EPOCHFMT_t;
+
+//! Field (column) types
+typedef enum EPOCHFMT_TYPE_e
+{
+    EPOCHFMT_TYPE_U8 = 1,  //!< uint8_t
+    EPOCHFMT_TYPE_I8,      //!< int8_t
+    EPOCHFMT_TYPE_U16,     //!< uint16_t
+    EPOCHFMT_TYPE_U32,     //!< uint32_t
+    EPOCHFMT_TYPE_U64,     //!< uint64_t
+    EPOCHFMT_TYPE_F32,     //!< float
+    EPOCHFMT_TYPE_F64,     //!< double
+} EPOCHFMT_TYPE_t;
+
+//! Get output format from name
+/*!
+    \param[in]   name  format name ("str", "csv", "json", "bin" or "col")
+    \param[out]  fmt   format
+
+    \returns true if the name was valid, false otherwise
+*/
+bool epochfmtFromName(const char *name, EPOCHFMT_t *fmt);
+
+//! Format CSV header line
+/*!
+    \param[out]  str   string buffer, at least EPOCHFMT_STR_SIZE bytes
+    \param[in]   size  size of the string buffer
+
+    \returns the length of the string (incl. the "\n"), 0 if the buffer is too small
+*/
+int epochfmtCsvHeader(char *str, const int size);
+
+//! Format epoch as CSV line
+/*!
+    \param[out]     str    string buffer, at least EPOCHFMT_STR_SIZE bytes
+    \param[in]      size   size of the string buffer
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+
+    \returns the length of the string (incl. the "\n"), 0 if the buffer is too small
+*/
+int epochfmtCsv(char *str, const int size, EPOCH_t *epoch);
+
+//! Format epoch as JSON object (on one line)
+/*!
+    \param[out]     str    string buffer, at least EPOCHFMT_STR_SIZE bytes
+    \param[in]      size   size of the string buffer
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+
+    \returns the length of the string (incl. the "\n"), 0 if the buffer is too small
+*/
+int epochfmtJson(char *str, const int size, EPOCH_t *epoch);
+
+//! Format epoch as binary record
+/*!
+    \param[out]     data   buffer, at least EPOCHFMT_BIN_SIZE bytes
+    \param[in]      size   size of the buffer
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+
+    \returns the size of the record (EPOCHFMT_BIN_SIZE), 0 if the buffer is too small
+*/
+int epochfmtBin(uint8_t *data, const int size, EPOCH_t *epoch);
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+//! Columnar batch handle
+typedef struct EPOCHCOL_s EPOCHCOL_t;
+
+#define EPOCHCOL_DEF_MAX_EPOCHS 1000 //!< Default number of epochs per columnar block
+
+//! Create columnar batch
+/*!
+    \param[in]  maxEpochs  max. number of epochs in a block, 0 for EPOCHCOL_DEF_MAX_EPOCHS
+    \param[in]  signals    include the signal columns
+
+    \returns the batch handle, or NULL on failure (out of memory)
+*/
+EPOCHCOL_t *epochcolCreate(const int maxEpochs, const bool signals);
+
+//! Destroy columnar batch
+/*!
+    \param[in]  col  batch handle, can be NULL
+*/
+void epochcolDestroy(EPOCHCOL_t *col);
+
+//! Add epoch to columnar batch
+/*!
+    \param[in,out]  col    batch handle
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+
+    \returns true if the epoch was added, false if the batch is full (use epochcolFlush() and add again)
+*/
+bool epochcolAdd(EPOCHCOL_t *col, EPOCH_t *epoch);
+
+//! Get columnar block and clear batch
+/*!
+    \param[in,out]  col   batch handle
+    \param[out]     size  size of the block [bytes]
+
+    \returns the block (valid until the next call to any epochcol...() function), NULL if the batch is empty
+*/
+const uint8_t *epochcolFlush(EPOCHCOL_t *col, int *size);
+
+/* ****************************************************************************************************************** */
+#ifdef __cplusplus
+}
+#endif
+#endif // __FF_EPOCHFMT_H__
@@ -0,0 +1,365 @@
+// clang-format off
+// flipflip's navigation epoch history
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "ff_debug.h"
+#include "ff_stuff.h"
+#include "ff_trafo.h"
+
+#include "ff_epochhist.h"
+
+/* ****************************************************************************************************************** */
+
+typedef enum REC_FLAGS_e
+{
+    REC_FIXOK    = 0x01, // fixOk
+    REC_RTKFLOAT = 0x02, // fixOk and RTK float fix
+    REC_RTKFIXED = 0x04, // fixOk and RTK fixed fix
+    REC_HACC     = 0x08, // horizAcc valid
+    REC_POS      = 0x10, // east and north valid
+    REC_HIST     = 0x20, // cnoTrk and cnoNav valid
+} REC_FLAGS_t;
+
+// Compact epoch record
+typedef struct EPOCHHIST_REC_s
+{
+    uint64_t ts;
+    double   east;
+    double   north;
+    double   horizAcc;
+    uint8_t  flags;
+    uint16_t cnoTrk[EPOCH_SIGCNOHIST_NUM];
+    uint16_t cnoNav[EPOCH_SIGCNOHIST_NUM];
+} EPOCHHIST_REC_t;
+
+// Running mean and variance (Welford's algorithm, with removal)
+typedef struct WELFORD_s
+{
+    int    n;
+    double mean;
+    double m2;
+} WELFORD_t;
+
+typedef struct EPOCHHIST_s
+{
+    int               size;
+    uint32_t          window;
+    EPOCHHIST_REC_t  *recs;     // Ring of records, the oldest at head
+    int               head;
+    int               num;
+    int              *maxq;     // Monotonic queue of record indices with decreasing horizAcc, for the max.
+    int               maxqHead;
+    int               maxqNum;
+    bool              haveRef;  // Reference position for east and north
+    double            xyzRef[3];
+    double            llhRef[3];
+    int               numFixOk;
+    int               numRtkFloat;
+    int               numRtkFixed;
+    int               numHist;
+    WELFORD_t         horizAcc;
+    WELFORD_t         east;
+    WELFORD_t         north;
+    int               cnoTrk[EPOCH_SIGCNOHIST_NUM];
+    int               cnoNav[EPOCH_SIGCNOHIST_NUM];
+} EPOCHHIST_t;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static void _welfordAdd(WELFORD_t *w, const double x)
+{
+    w->n++;
+    const double d = x - w->mean;
+    w->mean += d / (double)w->n;
+    w->m2 += d * (x - w->mean);
+}
+
+static void _welfordRemove(WELFORD_t *w, const double x)
+{
+    if (w->n <= 1)
+    {
+        memset(w, 0, sizeof(*w));
+        return;
+    }
+    const double mean = w->mean;
+    w->n--;
+    w->mean = ((mean * (double)(w->n + 1)) - x) / (double)w->n;
+    w->m2 -= (x - mean) * (x - w->mean);
+    if ( (w->m2 < 0.0) || (w->n == 1) ) // Rounding
+    {
+        w->m2 = 0.0;
+    }
+}
+
+static double _welfordStd(const WELFORD_t *w)
+{
+    return w->n > 0 ? sqrt(w->m2 / (double)w->n) : 0.0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+EPOCHHIST_t *epochhistCreate(const int size, const uint32_t window)
+{
+    EPOCHHIST_t *hist = malloc(sizeof(EPOCHHIST_t));
+    if (hist == NULL)
+    {
+        WARNING("epochhist: malloc fail!");
+        return NULL;
+    }
+    memset(hist, 0, sizeof(*hist));
+    hist->size   = size > 0 ? size : EPOCHHIST_DEF_SIZE;
+    hist->window = window;
+    hist->recs   = malloc(hist->size * sizeof(*hist->recs));
+    hist->maxq   = malloc(hist->size * sizeof(*hist->maxq));
+    if ( (hist->recs == NULL) || (hist->maxq == NULL) )
+    {
+        WARNING("epochhist: malloc fail!");
+        epochhistDestroy(hist);
+        return NULL;
+    }
+    return hist;
+}
+
+void epochhistDestroy(EPOCHHIST_t *hist)
+{
+    if (hist != NULL)
+    {
+        free(hist->recs);
+        free(hist->maxq);
+        free(hist);
+    }
+}
+
+void epochhistClear(EPOCHHIST_t *hist)
+{
+    if (hist == NULL)
+    {
+        return;
+    }
+    EPOCHHIST_REC_t *recs = hist->recs;
+    int *maxq = hist->maxq;
+    const int size = hist->size;
+    const uint32_t window = hist->window;
+    memset(hist, 0, sizeof(*hist));
+    hist->recs   = recs;
+    hist->maxq   = maxq;
+    hist->size   = size;
+    hist->window = window;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// Remove oldest record from the window
+static void _epochhistRemove(EPOCHHIST_t *hist)
+{
+    const int ix = hist->head;
+    const EPOCHHIST_REC_t *rec = &hist->recs[ix];
+
+    if ((rec->flags & REC_FIXOK) != 0)
+    {
+        hist->numFixOk--;
+    }
+    if ((rec->flags & REC_RTKFLOAT) != 0)
+    {
+        hist->numRtkFloat--;
+    }
+    if ((rec->flags & REC_RTKFIXED) != 0)
+    {
+        hist->numRtkFixed--;
+    }
+    if ((rec->flags & REC_HACC) != 0)
+    {
+        _welfordRemove(&hist->horizAcc, rec->horizAcc);
+        if ( (hist->maxqNum > 0) && (hist->maxq[hist->maxqHead] == ix) )
+        {
+            hist->maxqHead = (hist->maxqHead + 1) % hist->size;
+            hist->maxqNum--;
+        }
+    }
+    if ((rec->flags & REC_POS) != 0)
+    {
+        _welfordRemove(&hist->east, rec->east);
+        _welfordRemove(&hist->north, rec->north);
+        if (hist->east.n == 0)
+        {
+            hist->haveRef = false;
+        }
+    }
+    if ((rec->flags & REC_HIST) != 0)
+    {
+        hist->numHist--;
+        for (int bin = 0; bin < EPOCH_SIGCNOHIST_NUM; bin++)
+        {
+            hist->cnoTrk[bin] -= rec->cnoTrk[bin];
+            hist->cnoNav[bin] -= rec->cnoNav[bin];
+        }
+    }
+
+    hist->head = (hist->head + 1) % hist->size;
+    hist->num--;
+}
+
+// Remove records older than the window
+static void _epochhistExpire(EPOCHHIST_t *hist, const uint64_t now)
+{
+    if (hist->window == 0)
+    {
+        return;
+    }
+    while ( (hist->num > 0) && ((now - hist->recs[hist->head].ts) > hist->window) )
+    {
+        _epochhistRemove(hist);
+    }
+}
+
+void epochhistAdd(EPOCHHIST_t *hist, EPOCH_t *epoch)
+{
+    if ( (hist == NULL) || (epoch == NULL) )
+    {
+        return;
+    }
+
+    if (hist->num >= hist->size)
+    {
+        _epochhistRemove(hist);
+    }
+    _epochhistExpire(hist, epoch->ts);
+
+    const int ix = (hist->head + hist->num) % hist->size;
+    EPOCHHIST_REC_t *rec = &hist->recs[ix];
+    memset(rec, 0, sizeof(*rec));
+    rec->ts = epoch->ts;
+
+    if (epoch->haveFix && epoch->fixOk)
+    {
+        rec->flags |= REC_FIXOK;
+        hist->numFixOk++;
+        switch (epoch->fix)
+        {
+            case EPOCH_FIX_RTK_FLOAT:
+            case EPOCH_FIX_RTK_FLOAT_DR:
+                rec->flags |= REC_RTKFLOAT;
+                hist->numRtkFloat++;
+                break;
+            case EPOCH_FIX_RTK_FIXED:
+            case EPOCH_FIX_RTK_FIXED_DR:
+                rec->flags |= REC_RTKFIXED;
+                hist->numRtkFixed++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (epoch->havePos)
+    {
+        rec->flags |= REC_HACC;
+        rec->horizAcc = epoch->horizAcc;
+        _welfordAdd(&hist->horizAcc, rec->horizAcc);
+        // Drop smaller values from the back of the max. queue, they can never be the max. again
+        while (hist->maxqNum > 0)
+        {
+            const int back = (hist->maxqHead + hist->maxqNum - 1) % hist->size;
+            if (hist->recs[hist->maxq[back]].horizAcc > rec->horizAcc)
+            {
+                break;
+            }
+            hist->maxqNum--;
+        }
+        hist->maxq[(hist->maxqHead + hist->maxqNum) % hist->size] = ix;
+        hist->maxqNum++;
+
+        if ((rec->flags & REC_FIXOK) != 0)
+        {
+            const double *xyz = epochXyz(epoch);
+            if (!hist->haveRef)
+            {
+                memcpy(hist->xyzRef, xyz, sizeof(hist->xyzRef));
+                xyz2llh_vec(hist->xyzRef, hist->llhRef);
+                hist->haveRef = true;
+            }
+            double enu[3];
+            xyz2enu_vec(xyz, hist->xyzRef, hist->llhRef, enu);
+            rec->flags |= REC_POS;
+            rec->east  = enu[0];
+            rec->north = enu[1];
+            _welfordAdd(&hist->east, rec->east);
+            _welfordAdd(&hist->north, rec->north);
+        }
+    }
+
+    if (epoch->haveSigCnoHist)
+    {
+        rec->flags |= REC_HIST;
+        hist->numHist++;
+        for (int bin = 0; bin < EPOCH_SIGCNOHIST_NUM; bin++)
+        {
+            rec->cnoTrk[bin] = CLIP(epoch->sigCnoHistTrk[bin], 0, UINT16_MAX);
+            rec->cnoNav[bin] = CLIP(epoch->sigCnoHistNav[bin], 0, UINT16_MAX);
+            hist->cnoTrk[bin] += rec->cnoTrk[bin];
+            hist->cnoNav[bin] += rec->cnoNav[bin];
+        }
+    }
+
+    hist->num++;
+}
+
+void epochhistStats(EPOCHHIST_t *hist, EPOCHHIST_STATS_t *stats)
+{
+    if ( (hist == NULL) || (stats == NULL) )
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (hist->num <= 0)
+    {
+        return;
+    }
+    const int last = (hist->head + hist->num - 1) % hist->size;
+    _epochhistExpire(hist, hist->recs[last].ts);
+    stats->numEpochs = hist->num;
+    stats->span = hist->recs[last].ts - hist->recs[hist->head].ts;
+
+    const double num = (double)hist->num;
+    stats->numFixOk     = hist->numFixOk;
+    stats->numRtkFloat  = hist->numRtkFloat;
+    stats->numRtkFixed  = hist->numRtkFixed;
+    stats->fixRate      = (double)hist->numFixOk / num;
+    stats->rtkFloatRate = (double)hist->numRtkFloat / num;
+    stats->rtkFixedRate = (double)hist->numRtkFixed / num;
+
+    stats->numHorizAcc  = hist->horizAcc.n;
+    stats->horizAccMean = hist->horizAcc.mean;
+    stats->horizAccStd  = _welfordStd(&hist->horizAcc);
+    stats->horizAccMax  = hist->maxqNum > 0 ? hist->recs[hist->maxq[hist->maxqHead]].horizAcc : 0.0;
+
+    stats->numPos       = hist->east.n;
+    stats->posStdEast   = _welfordStd(&hist->east);
+    stats->posStdNorth  = _welfordStd(&hist->north);
+    stats->cep          = 0.59 * (stats->posStdEast + stats->posStdNorth);
+    stats->drms2        = 2.0 * sqrt((stats->posStdEast * stats->posStdEast) + (stats->posStdNorth * stats->posStdNorth));
+
+    stats->numSigCnoHist = hist->numHist;
+    memcpy(stats->sigCnoHistTrk, hist->cnoTrk, sizeof(stats->sigCnoHistTrk));
+    memcpy(stats->sigCnoHistNav, hist->cnoNav, sizeof(stats->sigCnoHistNav));
+}
+
+/* ****************************************************************************************************************** */
+// eof
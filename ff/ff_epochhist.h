@@ -0,0 +1,122 @@
+// clang-format off
+// flipflip's navigation epoch history
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef __FF_EPOCHHIST_H__
+#define __FF_EPOCHHIST_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ff_epoch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ****************************************************************************************************************** */
+
+// Epoch history: statistics over a sliding window of epochs
+//
+// - The history keeps a compact record (not the EPOCH_t) of the last epochs in a ring of fixed size. The window is
+//   limited by the ring size and optionally by time (the epochs' ts, relative to the latest epoch).
+// - The statistics are updated incrementally as epochs enter and leave the window, so that adding an epoch and
+//   querying the statistics are O(1) (amortised), regardless of the window size.
+// - Means and standard deviations use Welford's algorithm (with removal), the maximum uses a monotonic queue, and
+//   the C/N0 histograms are running sums of the epochs' sigCnoHistTrk and sigCnoHistNav.
+// - The position spread is calculated from the east/north position of fixOk epochs relative to the first position
+//   in the window. CEP is approximated as 0.59 * (std. east + std. north), and 2DRMS is 2 * sqrt(var. east + var.
+//   north).
+
+//! Epoch history handle
+typedef struct EPOCHHIST_s EPOCHHIST_t;
+
+//! Statistics of the epochs in the window
+typedef struct EPOCHHIST_STATS_s
+{
+    int      numEpochs;                           //!< Number of epochs in the window
+    uint32_t span;                                //!< Time between the first and last epoch in the window [ms]
+
+    int      numFixOk;                            //!< Number of epochs with a fix (fixOk)
+    int      numRtkFloat;                         //!< Number of epochs with an RTK float fix (fixOk, incl. DR)
+    int      numRtkFixed;                         //!< Number of epochs with an RTK fixed fix (fixOk, incl. DR)
+    double   fixRate;                             //!< Ratio of epochs with a fix [0..1]
+    double   rtkFloatRate;                        //!< Ratio of epochs with RTK float fix [0..1]
+    double   rtkFixedRate;                        //!< Ratio of epochs with RTK fixed fix [0..1]
+
+    int      numHorizAcc;                         //!< Number of epochs with horizontal accuracy estimate
+    double   horizAccMean;                        //!< Mean horizontal accuracy estimate [m]
+    double   horizAccStd;                         //!< Standard deviation of the horizontal accuracy estimate [m]
+    double   horizAccMax;                         //!< Maximum horizontal accuracy estimate [m]
+
+    int      numPos;                              //!< Number of fixOk epochs with position
+    double   posStdEast;                          //!< Standard deviation of the east position [m]
+    double   posStdNorth;                         //!< Standard deviation of the north position [m]
+    double   cep;                                 //!< Circular error probable (approximated) [m]
+    double   drms2;                               //!< Twice the distance root mean square [m]
+
+    int      numSigCnoHist;                       //!< Number of epochs with signal C/N0 histograms
+    int      sigCnoHistTrk[EPOCH_SIGCNOHIST_NUM]; //!< Sum of the epochs' sigCnoHistTrk
+    int      sigCnoHistNav[EPOCH_SIGCNOHIST_NUM]; //!< Sum of the epochs' sigCnoHistNav
+} EPOCHHIST_STATS_t;
+
+#define EPOCHHIST_DEF_SIZE 3000 //!< Default history size [epochs] (5 minutes at 10 Hz)
+
+//! Create epoch history
+/*!
+    \param[in]  size    max. number of epochs in the window, 0 for EPOCHHIST_DEF_SIZE
+    \param[in]  window  max. age of epochs in the window [ms], 0 for no limit
+
+    \returns the history handle, or NULL on failure (out of memory)
+*/
+EPOCHHIST_t *epochhistCreate(const int size, const uint32_t window);
+
+//! Destroy epoch history
+/*!
+    \param[in]  hist  history handle, can be NULL
+*/
+void epochhistDestroy(EPOCHHIST_t *hist);
+
+//! Clear epoch history
+/*!
+    \param[in,out]  hist  history handle
+*/
+void epochhistClear(EPOCHHIST_t *hist);
+
+//! Add epoch to the history
+/*!
+    \param[in,out]  hist   history handle
+    \param[in,out]  epoch  epoch (as returned by epochCollect())
+
+    \note The epoch is only non-const as this may calculate epochXyz().
+*/
+void epochhistAdd(EPOCHHIST_t *hist, EPOCH_t *epoch);
+
+//! Get statistics
+/*!
+    \param[in,out]  hist   history handle
+    \param[out]     stats  statistics of the epochs in the window
+
+    \note With a time limited window this first removes epochs older than the window (relative to the ts of the
+          latest epoch, i.e. the same time base as epochhistAdd() uses).
+*/
+void epochhistStats(EPOCHHIST_t *hist, EPOCHHIST_STATS_t *stats);
+
+/* ****************************************************************************************************************** */
+#ifdef __cplusplus
+}
+#endif
+#endif // __FF_EPOCHHIST_H__
@@ -0,0 +1,311 @@
+// clang-format off
+// flipflip's navigation epoch synchroniser
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "ff_debug.h"
+#include "ff_stuff.h"
+
+#include "ff_epochsync.h"
+
+/* ****************************************************************************************************************** */
+
+#define EPOCHSYNC_WEEK_SECS 604800.0
+
+typedef struct EPOCHSYNC_SRC_s
+{
+    EPOCH_t  *ring;     // Ring of epochs (ringSize slots), the oldest at head
+    double   *times;    // GPS time [s] of the epochs (weeks * EPOCHSYNC_WEEK_SECS + tow)
+    uint64_t *arrived;  // TIME() when the epochs were added
+    int       head;     // Index of the oldest epoch
+    int       num;      // Number of epochs in the ring
+    bool      haveLast; // Time of the last added epoch
+    double    last;
+} EPOCHSYNC_SRC_t;
+
+typedef struct EPOCHSYNC_s
+{
+    int               numSources;
+    int               ringSize;
+    double            tolerance;
+    uint32_t          wait;
+    uint32_t          presented; // Sources whose oldest epoch was output in the last set (released on next add/get)
+    bool              haveLastSet;
+    double            lastSet;   // Time of the last output set
+    EPOCHSYNC_STATS_t stats;
+    EPOCHSYNC_SRC_t   sources[EPOCHSYNC_MAX_SOURCES];
+    EPOCH_t          *epochs;    // All ring slots (numSources * ringSize)
+    double           *times;
+    uint64_t         *arrived;
+} EPOCHSYNC_t;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+EPOCHSYNC_t *epochsyncCreate(const int numSources, const int ringSize, const double tolerance, const uint32_t wait)
+{
+    if ( (numSources < 1) || (numSources > EPOCHSYNC_MAX_SOURCES) || (ringSize < 0) || (tolerance < 0.0) )
+    {
+        WARNING("epochsync: bad parameters");
+        return NULL;
+    }
+    EPOCHSYNC_t *sync = malloc(sizeof(EPOCHSYNC_t));
+    if (sync == NULL)
+    {
+        WARNING("epochsync: malloc fail!");
+        return NULL;
+    }
+    memset(sync, 0, sizeof(*sync));
+    sync->numSources = numSources;
+    sync->ringSize   = ringSize > 0 ? ringSize : EPOCHSYNC_DEF_RING_SIZE;
+    sync->tolerance  = tolerance > 0.0 ? tolerance : EPOCHSYNC_DEF_TOLERANCE;
+    sync->wait       = wait > 0 ? wait : EPOCHSYNC_DEF_WAIT;
+
+    const int numSlots = sync->numSources * sync->ringSize;
+    sync->epochs  = calloc(numSlots, sizeof(*sync->epochs));
+    sync->times   = calloc(numSlots, sizeof(*sync->times));
+    sync->arrived = calloc(numSlots, sizeof(*sync->arrived));
+    bool ok = (sync->epochs != NULL) && (sync->times != NULL) && (sync->arrived != NULL);
+    for (int ix = 0; ok && (ix < numSlots); ix++)
+    {
+        ok = epochInit(&sync->epochs[ix]);
+    }
+    if (!ok)
+    {
+        WARNING("epochsync: malloc fail!");
+        epochsyncDestroy(sync);
+        return NULL;
+    }
+
+    for (int ix = 0; ix < sync->numSources; ix++)
+    {
+        EPOCHSYNC_SRC_t *src = &sync->sources[ix];
+        src->ring    = &sync->epochs[ix * sync->ringSize];
+        src->times   = &sync->times[ix * sync->ringSize];
+        src->arrived = &sync->arrived[ix * sync->ringSize];
+    }
+
+    DEBUG("epochsync: create (%d sources, ring %d, tolerance %.3f, wait %u)",
+        sync->numSources, sync->ringSize, sync->tolerance, sync->wait);
+    return sync;
+}
+
+void epochsyncDestroy(EPOCHSYNC_t *sync)
+{
+    if (sync == NULL)
+    {
+        return;
+    }
+    if (sync->epochs != NULL)
+    {
+        const int numSlots = sync->numSources * sync->ringSize;
+        for (int ix = 0; ix < numSlots; ix++)
+        {
+            epochFree(&sync->epochs[ix]);
+        }
+    }
+    DEBUG("epochsync: destroy (%u sets, %u complete, %u incomplete)",
+        sync->stats.nSets, sync->stats.nComplete, sync->stats.nIncomplete);
+    free(sync->epochs);
+    free(sync->times);
+    free(sync->arrived);
+    free(sync);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// Remove the epochs output in the last set from the rings
+static void _epochsyncRelease(EPOCHSYNC_t *sync)
+{
+    for (int ix = 0; (sync->presented != 0) && (ix < sync->numSources); ix++)
+    {
+        const uint32_t bit = UINT32_C(1) << ix;
+        if ((sync->presented & bit) != 0)
+        {
+            EPOCHSYNC_SRC_t *src = &sync->sources[ix];
+            src->head = (src->head + 1) % sync->ringSize;
+            src->num--;
+            sync->presented &= ~bit;
+        }
+    }
+}
+
+bool epochsyncAdd(EPOCHSYNC_t *sync, const int source, EPOCH_t *epoch)
+{
+    if ( (sync == NULL) || (epoch == NULL) || (source < 0) || (source >= sync->numSources) )
+    {
+        return false;
+    }
+    _epochsyncRelease(sync);
+
+    EPOCHSYNC_SRC_t *src = &sync->sources[source];
+    EPOCHSYNC_SRCSTATS_t *stats = &sync->stats.sources[source];
+
+    if (!epoch->haveGpsWeek || !epoch->haveGpsTow)
+    {
+        stats->nNoTime++;
+        return false;
+    }
+
+    // Discard epochs for an already output time, and epochs out of order
+    const double t = ((double)epoch->gpsWeek * EPOCHSYNC_WEEK_SECS) + epoch->gpsTow;
+    if ( (sync->haveLastSet && (t <= (sync->lastSet + sync->tolerance))) ||
+         (src->haveLast && (t <= (src->last + sync->tolerance))) )
+    {
+        stats->nLate++;
+        return false;
+    }
+
+    // Ring full, drop oldest epoch
+    if (src->num >= sync->ringSize)
+    {
+        src->head = (src->head + 1) % sync->ringSize;
+        src->num--;
+        stats->nDropped++;
+    }
+
+    // Swap data with the free slot, like epochCollect() hands out epochs
+    const int slot = (src->head + src->num) % sync->ringSize;
+    const EPOCH_t tmp = src->ring[slot];
+    src->ring[slot] = *epoch;
+    *epoch = tmp;
+    epoch->valid = false;
+    src->times[slot] = t;
+    src->arrived[slot] = TIME();
+    src->num++;
+    src->haveLast = true;
+    src->last = t;
+    stats->nAdded++;
+    return true;
+}
+
+bool epochsyncGet(EPOCHSYNC_t *sync, EPOCHSYNC_SET_t *set, const bool flush)
+{
+    if ( (sync == NULL) || (set == NULL) )
+    {
+        return false;
+    }
+    _epochsyncRelease(sync);
+
+    // Time of the next set is the oldest buffered epoch
+    bool haveT = false;
+    double t = 0.0;
+    bool haveEmpty = false;
+    bool haveFull = false;
+    for (int ix = 0; ix < sync->numSources; ix++)
+    {
+        const EPOCHSYNC_SRC_t *src = &sync->sources[ix];
+        if (src->num <= 0)
+        {
+            haveEmpty = true;
+            continue;
+        }
+        if (src->num >= sync->ringSize)
+        {
+            haveFull = true;
+        }
+        const double srcT = src->times[src->head];
+        if (!haveT || (srcT < t))
+        {
+            t = srcT;
+            haveT = true;
+        }
+    }
+    if (!haveT)
+    {
+        return false;
+    }
+
+    // Sources with an epoch within tolerance are present, sources with a later epoch are missing, and sources with
+    // no epoch yet may still provide one
+    uint32_t present = 0;
+    bool haveArrived = false;
+    uint64_t firstArrived = 0;
+    for (int ix = 0; ix < sync->numSources; ix++)
+    {
+        const EPOCHSYNC_SRC_t *src = &sync->sources[ix];
+        if ( (src->num > 0) && ((src->times[src->head] - t) <= sync->tolerance) )
+        {
+            present |= UINT32_C(1) << ix;
+            const uint64_t arrived = src->arrived[src->head];
+            if (!haveArrived || (arrived < firstArrived))
+            {
+                firstArrived = arrived;
+                haveArrived = true;
+            }
+        }
+    }
+    if ( !flush && haveEmpty && !haveFull && ((TIME() - firstArrived) < sync->wait) )
+    {
+        return false;
+    }
+
+    // Output set
+    memset(set, 0, sizeof(*set));
+    set->numSources = sync->numSources;
+    for (int ix = 0; ix < sync->numSources; ix++)
+    {
+        const uint32_t bit = UINT32_C(1) << ix;
+        EPOCHSYNC_SRC_t *src = &sync->sources[ix];
+        if ((present & bit) != 0)
+        {
+            EPOCH_t *epoch = &src->ring[src->head];
+            if (set->numPresent == 0)
+            {
+                set->gpsWeek = epoch->gpsWeek;
+                set->gpsTow  = epoch->gpsTow;
+            }
+            set->epochs[ix] = epoch;
+            set->numPresent++;
+            sync->stats.sources[ix].nPresent++;
+        }
+        else
+        {
+            set->missing |= bit;
+            sync->stats.sources[ix].nMissing++;
+        }
+    }
+    set->present  = present;
+    set->complete = (set->numPresent == sync->numSources);
+    sync->stats.nSets++;
+    set->seq = sync->stats.nSets;
+    if (set->complete)
+    {
+        sync->stats.nComplete++;
+    }
+    else
+    {
+        sync->stats.nIncomplete++;
+    }
+
+    sync->presented   = present;
+    sync->haveLastSet = true;
+    sync->lastSet     = t;
+    return true;
+}
+
+void epochsyncStats(const EPOCHSYNC_t *sync, EPOCHSYNC_STATS_t *stats)
+{
+    if ( (sync == NULL) || (stats == NULL) )
+    {
+        return;
+    }
+    *stats = sync->stats;
+}
+
+/* ****************************************************************************************************************** */
+// eof
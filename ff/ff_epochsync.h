@@ -0,0 +1,162 @@
+// clang-format off
+// flipflip's navigation epoch synchroniser
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef __FF_EPOCHSYNC_H__
+#define __FF_EPOCHSYNC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ff_epoch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ****************************************************************************************************************** */
+
+// Epoch synchroniser: joins the epochs of several receivers (sources) by GPS time (gpsWeek and gpsTow)
+//
+// Example:
+//
+//     EPOCHSYNC_t *sync = epochsyncCreate(numRx, 0, 0.0, 0);
+//     ...
+//     if (epochCollect(&coll[ix], &msg, &epoch))
+//     {
+//         epochsyncAdd(sync, ix, &epoch);
+//     }
+//     EPOCHSYNC_SET_t set;
+//     while (epochsyncGet(sync, &set, false))
+//     {
+//         for (int ix = 0; ix < set.numSources; ix++)
+//         {
+//             if (set.epochs[ix] != NULL) { ... }
+//         }
+//     }
+//     ...
+//     while (epochsyncGet(sync, &set, true)) { ... }
+//     epochsyncDestroy(sync);
+//
+// - Each source has a ring of pre-allocated epochs. Epochs are not copied. Instead, like epochCollect() does,
+//   epochsyncAdd() swaps the user's epoch with a free ring slot.
+// - A set is output once all sources have provided an epoch for (or after) the set's time, or once the first epoch
+//   of the set has waited for the configured time, or once a ring is full. Sources without an epoch in the set are
+//   flagged as missing.
+// - Epochs for an already output time (or older) are late and are discarded. Epochs without GPS time are discarded.
+// - Memory use is constant (numSources * ringSize epochs), and the latency is bounded by the wait time.
+
+#define EPOCHSYNC_MAX_SOURCES   32   //!< Maximum number of sources
+#define EPOCHSYNC_DEF_RING_SIZE  8   //!< Default ring size (epochs per source)
+#define EPOCHSYNC_DEF_TOLERANCE  0.01 //!< Default time tolerance [s]
+#define EPOCHSYNC_DEF_WAIT     200   //!< Default wait time [ms]
+
+//! Epoch synchroniser handle
+typedef struct EPOCHSYNC_s EPOCHSYNC_t;
+
+//! Joined epoch set
+typedef struct EPOCHSYNC_SET_s
+{
+    int       gpsWeek;                           //!< GPS week of the set (from the first present epoch)
+    double    gpsTow;                            //!< GPS time of week of the set (from the first present epoch)
+    uint32_t  seq;                               //!< Set sequence number (1, 2, ...)
+    int       numSources;                        //!< Number of sources (size of epochs[])
+    int       numPresent;                        //!< Number of epochs present in the set
+    bool      complete;                          //!< All sources are present
+    uint32_t  present;                           //!< Present sources (bit 0 = source 0, etc.)
+    uint32_t  missing;                           //!< Missing sources (bit 0 = source 0, etc.)
+    EPOCH_t  *epochs[EPOCHSYNC_MAX_SOURCES];     //!< Epochs, NULL for missing sources
+} EPOCHSYNC_SET_t;
+
+//! Per-source statistics
+typedef struct EPOCHSYNC_SRCSTATS_s
+{
+    uint32_t  nAdded;   //!< Number of epochs added to the ring
+    uint32_t  nNoTime;  //!< Number of epochs discarded because they lack GPS time
+    uint32_t  nLate;    //!< Number of epochs discarded because they arrived late (or out of order)
+    uint32_t  nDropped; //!< Number of epochs dropped because the ring was full
+    uint32_t  nPresent; //!< Number of sets the source was present in
+    uint32_t  nMissing; //!< Number of sets the source was missing from
+} EPOCHSYNC_SRCSTATS_t;
+
+//! Statistics
+typedef struct EPOCHSYNC_STATS_s
+{
+    uint32_t              nSets;                          //!< Number of sets output
+    uint32_t              nComplete;                      //!< Number of complete sets
+    uint32_t              nIncomplete;                    //!< Number of incomplete sets
+    EPOCHSYNC_SRCSTATS_t  sources[EPOCHSYNC_MAX_SOURCES]; //!< Per-source statistics
+} EPOCHSYNC_STATS_t;
+
+//! Create epoch synchroniser
+/*!
+    \param[in]  numSources  number of sources (1..EPOCHSYNC_MAX_SOURCES)
+    \param[in]  ringSize    number of epochs buffered per source, 0 for EPOCHSYNC_DEF_RING_SIZE
+    \param[in]  tolerance   max. difference [s] of the GPS time of the epochs in a set, 0.0 for
+                            EPOCHSYNC_DEF_TOLERANCE, must be less than half the navigation period
+    \param[in]  wait        max. time [ms] (TIME()) to wait for the epochs of a set, 0 for EPOCHSYNC_DEF_WAIT
+
+    \returns the synchroniser handle, or NULL on failure (bad parameters, out of memory)
+*/
+EPOCHSYNC_t *epochsyncCreate(const int numSources, const int ringSize, const double tolerance, const uint32_t wait);
+
+//! Destroy epoch synchroniser
+/*!
+    \param[in]  sync  synchroniser handle, can be NULL
+*/
+void epochsyncDestroy(EPOCHSYNC_t *sync);
+
+//! Add epoch of a source
+/*!
+    \param[in,out]  sync    synchroniser handle
+    \param[in]      source  source index (0..numSources-1)
+    \param[in,out]  epoch   epoch (as returned by epochCollect())
+
+    \returns true if the epoch was added, false if it was discarded (no GPS time, late, bad source)
+
+    \note The data is not copied. The epoch swaps its data with a ring slot. Afterwards \c epoch is invalid (but still
+          initialised) and can be passed to epochCollect() again. The ring slots are initialised by epochInit(), so
+          \c epoch (and the collector) must be initialised with the default size, too.
+
+    \note This invalidates the epochs of the set previously returned by epochsyncGet().
+*/
+bool epochsyncAdd(EPOCHSYNC_t *sync, const int source, EPOCH_t *epoch);
+
+//! Get next joined epoch set
+/*!
+    \param[in,out]  sync   synchroniser handle
+    \param[out]     set    joined epoch set, only valid if the function returns true
+    \param[in]      flush  output sets without waiting for missing sources (e.g. at the end of input)
+
+    \returns true if a set is available, false otherwise
+
+    \note The epochs in the set belong to the synchroniser. They are valid until the next call to epochsyncAdd() or
+          epochsyncGet().
+*/
+bool epochsyncGet(EPOCHSYNC_t *sync, EPOCHSYNC_SET_t *set, const bool flush);
+
+//! Get statistics
+/*!
+    \param[in]   sync   synchroniser handle
+    \param[out]  stats  statistics
+*/
+void epochsyncStats(const EPOCHSYNC_t *sync, EPOCHSYNC_STATS_t *stats);
+
+/* ****************************************************************************************************************** */
+#ifdef __cplusplus
+}
+#endif
+#endif // __FF_EPOCHSYNC_H__
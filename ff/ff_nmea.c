@@ -20,6 +20,7 @@
 
 #include "ff_stuff.h"
 #include "ff_debug.h"
+#include "ff_prof.h"
 #include "ff_nmea.h"
 
 /* ****************************************************************************************************************** */
@@ -214,14 +215,37 @@ bool nmeaMessageInfo(char *info, const int size, const uint8_t *msg, const int m
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-static bool sNmeaDecodeTxt(NMEA_TXT_t *txt, char *payload, const char *talker);
-static bool sNmeaDecodeGga(NMEA_GGA_t *gga, char *payload, const char *talker);
-static bool sNmeaDecodeRmc(NMEA_RMC_t *gga, char *payload, const char *talker);
-static bool sNmeaDecodeGll(NMEA_GLL_t *gll, char *payload, const char *talker);
-static bool sNmeaDecodeGsv(NMEA_GSV_t *gsv, char *payload, const char *talker);
+// A field of the payload (not nul-terminated, points into the message)
+typedef struct FIELD_s
+{
+    const char *str;
+    int         len;
+} FIELD_t;
+
+// First character of a field, or '\0' for an empty field
+#define FIELD_CHAR(_field_) ( (_field_).len > 0 ? (_field_).str[0] : '\0' )
+
+static bool sNmeaDecodeTxt(NMEA_TXT_t *txt, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeGga(NMEA_GGA_t *gga, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeRmc(NMEA_RMC_t *gga, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeGll(NMEA_GLL_t *gll, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeGsv(NMEA_GSV_t *gsv, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeGsa(NMEA_GSA_t *gsa, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeGst(NMEA_GST_t *gst, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeVtg(NMEA_VTG_t *vtg, const char *payload, const int payloadLen, const char *talker);
+static bool sNmeaDecodeZda(NMEA_ZDA_t *zda, const char *payload, const int payloadLen, const char *talker);
 static const char *sNmeaFixStr(const NMEA_FIX_t fix);
+static bool sNmeaDecode(NMEA_MSG_t *nmea, const uint8_t *msg, const int msgSize);
 
 bool nmeaDecode(NMEA_MSG_t *nmea, const uint8_t *msg, const int msgSize)
+{
+    PROF_START(t0);
+    const bool res = sNmeaDecode(nmea, msg, msgSize);
+    PROF_STOP(t0, PROF_NMEA_DECODE);
+    return res;
+}
+
+static bool sNmeaDecode(NMEA_MSG_t *nmea, const uint8_t *msg, const int msgSize)
 {
     if ( (nmea == NULL) || (msg == 0) )
     {
@@ -242,59 +266,122 @@ bool nmeaDecode(NMEA_MSG_t *nmea, const uint8_t *msg, const int msgSize)
     // 012345678901234567890
     // $GNGGA,.......*xx\r\n
     //        ^=7   ^=13  --> 13 - 7 + 1 = 7
-    char payload[1000];
+    // The decoders work on the payload in the message, there's no need to copy it
+    const char *payload = (const char *)&msg[info.payloadIx0];
     const int payloadLen = info.payloadIx1 - info.payloadIx0 + 1;
-    if (payloadLen > ((int)sizeof(payload) - 1))
+    if (payloadLen < 0)
     {
         return false;
     }
-    memcpy(payload, &msg[info.payloadIx0], payloadLen);
-    payload[payloadLen] = '\0';
 
     bool res = false;
     if (strcmp(info.formatter, "GGA") == 0)
     {
         nmea->type = NMEA_TYPE_GGA;
-        res = sNmeaDecodeGga(&nmea->gga, payload, info.talker);
-        snprintf(nmea->info, sizeof(nmea->info), "%02d:%02d:%06.3f (%d) %s %+11.7f %+12.7f %+5.0f",
-            nmea->gga.time.hour, nmea->gga.time.minute, nmea->gga.time.second, nmea->gga.time.valid,
-            sNmeaFixStr(nmea->gga.fix), nmea->gga.lat, nmea->gga.lon, nmea->gga.height);
+        res = sNmeaDecodeGga(&nmea->gga, payload, payloadLen, info.talker);
     }
     else if (strcmp(info.formatter, "RMC") == 0)
     {
         nmea->type = NMEA_TYPE_RMC;
-        res = sNmeaDecodeRmc(&nmea->rmc, payload, info.talker);
-        snprintf(nmea->info, sizeof(nmea->info), "%04d-%02d-%02d (%d) %02d:%02d:%06.3f (%d) %s (%d) %+11.7f %+12.7f",
-            nmea->rmc.date.year, nmea->rmc.date.month, nmea->rmc.date.day, nmea->rmc.date.valid,
-            nmea->rmc.time.hour, nmea->rmc.time.minute, nmea->rmc.time.second, nmea->rmc.time.valid,
-            sNmeaFixStr(nmea->rmc.fix), nmea->rmc.valid, nmea->rmc.lat, nmea->rmc.lon);
+        res = sNmeaDecodeRmc(&nmea->rmc, payload, payloadLen, info.talker);
     }
     else if (strcmp(info.formatter, "GLL") == 0)
     {
         nmea->type = NMEA_TYPE_GLL;
-        res = sNmeaDecodeGll(&nmea->gll, payload, info.talker);
-        snprintf(nmea->info, sizeof(nmea->info), "%02d:%02d:%06.3f (%d) %s (%d) %+11.7f %+12.7f",
-            nmea->gll.time.hour, nmea->gll.time.minute, nmea->gll.time.second, nmea->gll.time.valid,
-            sNmeaFixStr(nmea->gll.fix), nmea->gll.valid, nmea->gll.lat, nmea->gll.lon);
+        res = sNmeaDecodeGll(&nmea->gll, payload, payloadLen, info.talker);
     }
     else if (strcmp(info.formatter, "GSV") == 0)
     {
         nmea->type = NMEA_TYPE_GSV;
-        res = sNmeaDecodeGsv(&nmea->gsv, payload, info.talker);
-        snprintf(nmea->info, sizeof(nmea->info), "%d/%d %d",
-            nmea->gsv.msgNum, nmea->gsv.numMsg, nmea->gsv.numSat);
+        res = sNmeaDecodeGsv(&nmea->gsv, payload, payloadLen, info.talker);
+    }
+    else if (strcmp(info.formatter, "GSA") == 0)
+    {
+        nmea->type = NMEA_TYPE_GSA;
+        res = sNmeaDecodeGsa(&nmea->gsa, payload, payloadLen, info.talker);
+    }
+    else if (strcmp(info.formatter, "GST") == 0)
+    {
+        nmea->type = NMEA_TYPE_GST;
+        res = sNmeaDecodeGst(&nmea->gst, payload, payloadLen, info.talker);
+    }
+    else if (strcmp(info.formatter, "VTG") == 0)
+    {
+        nmea->type = NMEA_TYPE_VTG;
+        res = sNmeaDecodeVtg(&nmea->vtg, payload, payloadLen, info.talker);
+    }
+    else if (strcmp(info.formatter, "ZDA") == 0)
+    {
+        nmea->type = NMEA_TYPE_ZDA;
+        res = sNmeaDecodeZda(&nmea->zda, payload, payloadLen, info.talker);
     }
     else if (strcmp(info.formatter, "TXT") == 0)
     {
         nmea->type = NMEA_TYPE_TXT;
-        res = sNmeaDecodeTxt(&nmea->txt, payload, info.talker);
-        snprintf(nmea->info, sizeof(nmea->info), "%s", nmea->txt.text);
+        res = sNmeaDecodeTxt(&nmea->txt, payload, payloadLen, info.talker);
     }
 
-    NMEA_DEBUG("decodeNmea: %d [%s] [%s] [%s]", res, nmea->talker, nmea->formatter, nmea->info);
+    NMEA_DEBUG("decodeNmea: %d [%s] [%s] %d", res, nmea->talker, nmea->formatter, nmea->type);
     return res;
 }
 
+bool nmeaDecodeInfo(char *info, const int size, const NMEA_MSG_t *nmea)
+{
+    if ( (info == NULL) || (size < 1) || (nmea == NULL) )
+    {
+        return false;
+    }
+    int len = 0;
+    switch (nmea->type)
+    {
+        case NMEA_TYPE_GGA:
+            len = snprintf(info, size, "%02d:%02d:%06.3f (%d) %s %+11.7f %+12.7f %+5.0f",
+                nmea->gga.time.hour, nmea->gga.time.minute, nmea->gga.time.second, nmea->gga.time.valid,
+                sNmeaFixStr(nmea->gga.fix), nmea->gga.lat, nmea->gga.lon, nmea->gga.height);
+            break;
+        case NMEA_TYPE_RMC:
+            len = snprintf(info, size, "%04d-%02d-%02d (%d) %02d:%02d:%06.3f (%d) %s (%d) %+11.7f %+12.7f",
+                nmea->rmc.date.year, nmea->rmc.date.month, nmea->rmc.date.day, nmea->rmc.date.valid,
+                nmea->rmc.time.hour, nmea->rmc.time.minute, nmea->rmc.time.second, nmea->rmc.time.valid,
+                sNmeaFixStr(nmea->rmc.fix), nmea->rmc.valid, nmea->rmc.lat, nmea->rmc.lon);
+            break;
+        case NMEA_TYPE_GLL:
+            len = snprintf(info, size, "%02d:%02d:%06.3f (%d) %s (%d) %+11.7f %+12.7f",
+                nmea->gll.time.hour, nmea->gll.time.minute, nmea->gll.time.second, nmea->gll.time.valid,
+                sNmeaFixStr(nmea->gll.fix), nmea->gll.valid, nmea->gll.lat, nmea->gll.lon);
+            break;
+        case NMEA_TYPE_GSV:
+            len = snprintf(info, size, "%d/%d %d",
+                nmea->gsv.msgNum, nmea->gsv.numMsg, nmea->gsv.numSat);
+            break;
+        case NMEA_TYPE_GSA:
+            len = snprintf(info, size, "%s %d %.2f %.2f %.2f",
+                sNmeaFixStr(nmea->gsa.fix), nmea->gsa.nSvs, nmea->gsa.pDOP, nmea->gsa.hDOP, nmea->gsa.vDOP);
+            break;
+        case NMEA_TYPE_GST:
+            len = snprintf(info, size, "%02d:%02d:%06.3f (%d) (%d) %.3f %.3f %.3f",
+                nmea->gst.time.hour, nmea->gst.time.minute, nmea->gst.time.second, nmea->gst.time.valid,
+                nmea->gst.valid, nmea->gst.stdLat, nmea->gst.stdLon, nmea->gst.stdAlt);
+            break;
+        case NMEA_TYPE_VTG:
+            len = snprintf(info, size, "%s (%d) %.3f %.1f",
+                sNmeaFixStr(nmea->vtg.fix), nmea->vtg.valid, nmea->vtg.sogk, nmea->vtg.cogt);
+            break;
+        case NMEA_TYPE_ZDA:
+            len = snprintf(info, size, "%04d-%02d-%02d (%d) %02d:%02d:%06.3f (%d)",
+                nmea->zda.date.year, nmea->zda.date.month, nmea->zda.date.day, nmea->zda.date.valid,
+                nmea->zda.time.hour, nmea->zda.time.minute, nmea->zda.time.second, nmea->zda.time.valid);
+            break;
+        case NMEA_TYPE_TXT:
+            len = snprintf(info, size, "%s", nmea->txt.text);
+            break;
+        case NMEA_TYPE_NONE:
+            info[0] = '\0';
+            break;
+    }
+    return len < size;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 
 static const char * const kNmeaFixStrs[] =
@@ -314,66 +401,148 @@ static const char *sNmeaFixStr(const NMEA_FIX_t fix)
     return (fix >= 0) && (fix < NUMOF(kNmeaFixStrs)) ? kNmeaFixStrs[fix] : kNmeaFixStrs[NMEA_FIX_UNKNOWN];
 }
 
-static int sGetFields(const char **fields, const int maxFields, char *payload)
+// Split payload into fields (at most maxFields, further fields are ignored)
+static int sGetFields(FIELD_t *fields, const int maxFields, const char *payload, const int payloadLen)
 {
-    int nTok = 0;
     int nFields = 0;
-    for (char *sep = strchr(payload, ','); sep != NULL; )
+    const char *end = &payload[payloadLen];
+    while (nFields < maxFields)
     {
-        nTok++;
-        *sep = '\0';
-        NMEA_DEBUG("tok %d [%s]", nTok, payload);
-        if (nFields < maxFields)
+        const char *sep = memchr(payload, ',', end - payload);
+        fields[nFields].str = payload;
+        fields[nFields].len = (sep != NULL ? sep : end) - payload;
+        NMEA_DEBUG("field %d [%.*s]", nFields, fields[nFields].len, fields[nFields].str);
+        nFields++;
+        if (sep == NULL)
         {
-            fields[nFields] = payload;
-            nFields++;
+            break;
         }
-
         payload = &sep[1];
-        sep = strchr(payload, ',');
     }
-    nTok++;
-    NMEA_DEBUG("tok %d [%s]", nTok, payload);
-    UNUSED(nTok);
-    if (nFields < maxFields)
+    return nFields;
+}
+
+// Powers of ten that are exactly representable as double
+static const double kPow10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+    1e19, 1e20, 1e21, 1e22
+};
+
+// Parse decimal digits, returns true if there is at least one digit and all characters are digits
+static bool sParseDigits(const char *str, const int len, int *val)
+{
+    if ( (len < 1) || (len > 9) )
     {
-        fields[nFields] = payload;
-        nFields++;
+        return false;
+    }
+    int res = 0;
+    for (int ix = 0; ix < len; ix++)
+    {
+        const int digit = str[ix] - '0';
+        if ( (digit < 0) || (digit > 9) )
+        {
+            return false;
+        }
+        res = (res * 10) + digit;
     }
+    *val = res;
+    return true;
+}
 
-    return nFields <= maxFields ? nFields : 0;
+// Parse "[+-]ddd", "[+-]ddd.ddd", "[+-].ddd" or "[+-]ddd." to double. The digits are accumulated into an integer,
+// which is then scaled by an exact power of ten. This gives the same (correctly rounded) result as strtod() as long as
+// the number of digits is small enough, which is always the case for NMEA.
+static bool sParseDecimal(const char *str, const int len, double *val)
+{
+    int ix = 0;
+    bool neg = false;
+    if ( (len > 0) && ((str[0] == '-') || (str[0] == '+')) )
+    {
+        neg = (str[0] == '-');
+        ix++;
+    }
+    uint64_t mant = 0;
+    int nDigits = 0;
+    int nFrac = 0;
+    bool haveDot = false;
+    for (; ix < len; ix++)
+    {
+        const char c = str[ix];
+        if ( (c >= '0') && (c <= '9') )
+        {
+            mant = (mant * 10) + (uint64_t)(c - '0');
+            if (mant > (UINT64_C(1) << 53)) // too many digits for exact calculation
+            {
+                return false;
+            }
+            nDigits++;
+            if (haveDot)
+            {
+                nFrac++;
+            }
+        }
+        else if ( (c == '.') && !haveDot )
+        {
+            haveDot = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if ( (nDigits < 1) || (nFrac >= (int)NUMOF(kPow10)) )
+    {
+        return false;
+    }
+    const double res = (double)mant / kPow10[nFrac];
+    *val = neg ? -res : res;
+    return true;
 }
 
-static bool sStrToTime(NMEA_TIME_t *time, const char *str)
+// Parse "dd", "dd.", or "dd.ddd" (exactly two integer digits, no sign), for seconds (hhmmss) and minutes (ddmm)
+static bool sParseTwoDigitDecimal(const char *str, const int len, double *val)
 {
-    int len = 0;
-    time->valid =
-        (sscanf(str, "%2d%2d%lf%n", &time->hour, &time->minute, &time->second, &len) == 3) && (len == (int)strlen(str));
+    return (len >= 2) && (str[0] >= '0') && (str[0] <= '9') && (str[1] >= '0') && (str[1] <= '9') &&
+        ((len == 2) || (str[2] == '.')) && sParseDecimal(str, len, val);
+}
+
+static bool sStrToTime(NMEA_TIME_t *time, const FIELD_t *field)
+{
+    // hhmmss, hhmmss.s, hhmmss.ss, ...
+    time->valid = (field->len > 4) &&
+        sParseDigits(&field->str[0], 2, &time->hour) &&
+        sParseDigits(&field->str[2], 2, &time->minute) &&
+        sParseTwoDigitDecimal(&field->str[4], field->len - 4, &time->second);
     // FIXME: validate data?
-    NMEA_DEBUG("sStrToTime [%s] -> %d %d %.3f (%d)", str, time->hour, time->minute, time->second, time->valid);
+    NMEA_DEBUG("sStrToTime [%.*s] -> %d %d %.3f (%d)", field->len, field->str, time->hour, time->minute, time->second, time->valid);
     return time->valid;
 }
 
-static bool sStrToDate(NMEA_DATE_t *date, const char *str)
+static bool sStrToDate(NMEA_DATE_t *date, const FIELD_t *field)
 {
-    int len = 0;
-    date->valid =
-        (sscanf(str, "%2d%2d%2d%n", &date->day, &date->month, &date->year, &len) == 3) && (len == (int)strlen(str));
+    // ddmmyy
+    date->valid = (field->len == 6) &&
+        sParseDigits(&field->str[0], 2, &date->day) &&
+        sParseDigits(&field->str[2], 2, &date->month) &&
+        sParseDigits(&field->str[4], 2, &date->year);
     date->year += 2000; // probably... :-/
     // FIXME: validate data?
-    NMEA_DEBUG("sStrToDate [%s] -> %d %d %d (%d)", str, date->day, date->month, date->year, date->valid);
+    NMEA_DEBUG("sStrToDate [%.*s] -> %d %d %d (%d)", field->len, field->str, date->day, date->month, date->year, date->valid);
     return date->valid;
 }
 
-static bool sStrToLat(double *lat, const char *str)
+static bool sStrToDegMin(double *degMin, const FIELD_t *field, const int nDegDigits)
 {
-    int len = 0;
+    // ddmm.mmm (latitude) or dddmm.mmm (longitude)
     int deg = 0;
     double min = 0.0;
-    if ( (sscanf(str, "%2d%lf%n", &deg, &min, &len) == 2) && (len == (int)strlen(str)) )
+    if ( (field->len > nDegDigits) &&
+        sParseDigits(field->str, nDegDigits, &deg) &&
+        sParseTwoDigitDecimal(&field->str[nDegDigits], field->len - nDegDigits, &min) )
     {
-        *lat = (double)deg + (min * (1.0/60.0));
-        NMEA_DEBUG("sStrToLat [%s] -> %d %g -> %g", str, deg, min, *lat);
+        *degMin = (double)deg + (min * (1.0/60.0));
+        NMEA_DEBUG("sStrToDegMin [%.*s] -> %d %g -> %g", field->len, field->str, deg, min, *degMin);
         return true;
     }
     else
@@ -382,31 +551,24 @@ static bool sStrToLat(double *lat, const char *str)
     }
 }
 
-static bool sStrToLon(double *lon, const char *str)
+static bool sStrToLat(double *lat, const FIELD_t *field)
 {
-    int len = 0;
-    int deg = 0;
-    double min = 0.0;
-    if ( (sscanf(str, "%3d%lf%n", &deg, &min, &len) == 2) && (len == (int)strlen(str)) )
-    {
-        *lon = (double)deg + (min * (1.0/60.0));
-        NMEA_DEBUG("sStrToLon [%s] -> %d %g -> %g", str, deg, min, *lon);
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return sStrToDegMin(lat, field, 2);
+}
+
+static bool sStrToLon(double *lon, const FIELD_t *field)
+{
+    return sStrToDegMin(lon, field, 3);
 }
 
-static bool sStrToFix(NMEA_FIX_t *fix, const char *str, const NMEA_TYPE_t type)
+static bool sStrToFix(NMEA_FIX_t *fix, const FIELD_t *field, const NMEA_TYPE_t type)
 {
     // FIXME: very confusing and the interface description isn't terribly helpful... to check actual receiver behaviour
     bool res = true;
     switch (type)
     {
         case NMEA_TYPE_GGA:
-            switch (str[0])
+            switch (FIELD_CHAR(*field))
             {
                 case '0': *fix = NMEA_FIX_NOFIX; break;
                 case '1':
@@ -419,7 +581,8 @@ static bool sStrToFix(NMEA_FIX_t *fix, const char *str, const NMEA_TYPE_t type)
             break;
         case NMEA_TYPE_RMC:
         case NMEA_TYPE_GLL:
-            switch (str[0])
+        case NMEA_TYPE_VTG:
+            switch (FIELD_CHAR(*field))
             {
                 case 'N': *fix = NMEA_FIX_NOFIX; break;
                 case 'A':
@@ -430,31 +593,46 @@ static bool sStrToFix(NMEA_FIX_t *fix, const char *str, const NMEA_TYPE_t type)
                 default:  *fix = NMEA_FIX_UNKNOWN; break;
             }
             break;
+        case NMEA_TYPE_GSA:
+            switch (FIELD_CHAR(*field))
+            {
+                case '1': *fix = NMEA_FIX_NOFIX; break;
+                case '2': *fix = NMEA_FIX_S2D; break;
+                case '3': *fix = NMEA_FIX_S3D; break;
+                default:  *fix = NMEA_FIX_UNKNOWN; break;
+            }
+            break;
         case NMEA_TYPE_TXT:
         case NMEA_TYPE_GSV:
+        case NMEA_TYPE_GST:
+        case NMEA_TYPE_ZDA:
         case NMEA_TYPE_NONE:
             res = false;
             break;
     }
-    NMEA_DEBUG("sStrToFix [%s] -> %d", str, *fix);
+    NMEA_DEBUG("sStrToFix [%.*s] -> %d", field->len, field->str, *fix);
     return res;
 }
 
-static bool sStrToInt(int *val, const char *str, const bool checkLo, const int lo, const bool checkHi, const int hi)
+static bool sStrToInt(int *val, const FIELD_t *field, const bool checkLo, const int lo, const bool checkHi, const int hi)
 {
-    int len = 0;
-    bool res = (sscanf(str, "%d%n", val, &len) == 1) && (len == (int)strlen(str)) &&
-         (!checkLo || (*val >= lo)) && (!checkHi || (*val <= hi));
-    NMEA_DEBUG("sStrToInt [%s] -> %d (%d, %d:%d - %d:%d)", str, *val, res, checkLo, lo, checkHi, hi);
+    const bool neg = (field->len > 0) && (field->str[0] == '-');
+    const int offs = (field->len > 0) && ((field->str[0] == '-') || (field->str[0] == '+')) ? 1 : 0;
+    bool res = sParseDigits(&field->str[offs], field->len - offs, val);
+    if (res && neg)
+    {
+        *val = -*val;
+    }
+    res = res && (!checkLo || (*val >= lo)) && (!checkHi || (*val <= hi));
+    NMEA_DEBUG("sStrToInt [%.*s] -> %d (%d, %d:%d - %d:%d)", field->len, field->str, *val, res, checkLo, lo, checkHi, hi);
     return res;
 }
 
-static bool sStrToDbl(double *val, const char *str, const bool checkLo, const double lo, const bool checkHi, const double hi)
+static bool sStrToDbl(double *val, const FIELD_t *field, const bool checkLo, const double lo, const bool checkHi, const double hi)
 {
-    int len = 0;
-    bool res = (sscanf(str, "%lf%n", val, &len) == 1) && (len == (int)strlen(str)) &&
+    bool res = sParseDecimal(field->str, field->len, val) &&
          (!checkLo || (*val >= lo)) && (!checkHi || (*val <= hi));
-    NMEA_DEBUG("sStrToDbl [%s] -> %g (%d, %d:%g - %d:%g)", str, *val, res, checkLo, lo, checkHi, hi);
+    NMEA_DEBUG("sStrToDbl [%.*s] -> %g (%d, %d:%g - %d:%g)", field->len, field->str, *val, res, checkLo, lo, checkHi, hi);
     return res;
 }
 
@@ -475,13 +653,13 @@ static bool sStrToDbl(double *val, const char *str, const bool checkLo, const do
 #define F_GGA_DIFFAGE (13 - 1)
 #define F_GGA_DIFFSTA (14 - 1)
 
-static bool sNmeaDecodeGga(NMEA_GGA_t *gga, char *payload, const char *talker)
+static bool sNmeaDecodeGga(NMEA_GGA_t *gga, const char *payload, const int payloadLen, const char *talker)
 {
-    NMEA_DEBUG("sNmeaDecodeGga [%s] [%s]", talker, payload);
+    NMEA_DEBUG("sNmeaDecodeGga [%s] [%.*s]", talker, payloadLen, payload);
     UNUSED(talker);
 
-    const char *fields[30];
-    const int nFields = sGetFields(fields, NUMOF(fields), payload);
+    FIELD_t fields[30];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
     if (nFields != 14)
     {
         return false;
@@ -489,24 +667,24 @@ static bool sNmeaDecodeGga(NMEA_GGA_t *gga, char *payload, const char *talker)
 
     bool res = true;
 
-    if (fields[F_GGA_TIME][0] != '\0')
+    if (fields[F_GGA_TIME].len > 0)
     {
-        res = sStrToTime(&gga->time, fields[F_GGA_TIME]);
+        res = sStrToTime(&gga->time, &fields[F_GGA_TIME]);
     }
 
-    if ( (fields[F_GGA_LAT][0] != '\0') && (fields[F_GGA_LON][0] != '\0') && (fields[F_GGA_QUALITY][0] != '\0') )
+    if ( (fields[F_GGA_LAT].len > 0) && (fields[F_GGA_LON].len > 0) && (fields[F_GGA_QUALITY].len > 0) )
     {
-        if (!sStrToLat( &gga->lat, fields[F_GGA_LAT]) ||
-            !sStrToLon( &gga->lon, fields[F_GGA_LON]) ||
-            !sStrToFix( &gga->fix, fields[F_GGA_QUALITY], NMEA_TYPE_GGA))
+        if (!sStrToLat( &gga->lat, &fields[F_GGA_LAT]) ||
+            !sStrToLon( &gga->lon, &fields[F_GGA_LON]) ||
+            !sStrToFix( &gga->fix, &fields[F_GGA_QUALITY], NMEA_TYPE_GGA))
         {
             res = false;
         }
-        if (fields[F_GGA_NS][0] == 'S')
+        if (FIELD_CHAR(fields[F_GGA_NS]) == 'S')
         {
             gga->lat *= -1.0;
         }
-        if (fields[F_GGA_EW][0] == 'W')
+        if (FIELD_CHAR(fields[F_GGA_EW]) == 'W')
         {
             gga->lon *= -1.0;
         }
@@ -516,34 +694,34 @@ static bool sNmeaDecodeGga(NMEA_GGA_t *gga, char *payload, const char *talker)
         gga->fix = NMEA_FIX_NOFIX;
     }
 
-    if ( (fields[F_GGA_NUMSV][0] != '\0') && !sStrToInt(&gga->numSv, fields[F_GGA_NUMSV], true, 0, false, 0) )
+    if ( (fields[F_GGA_NUMSV].len > 0) && !sStrToInt(&gga->numSv, &fields[F_GGA_NUMSV], true, 0, false, 0) )
     {
         res = false;
     }
 
-    if ( (fields[F_GGA_HDOP][0] != '\0') && !sStrToDbl(&gga->hDOP, fields[F_GGA_HDOP], true, 0.0, false, 0.0) )
+    if ( (fields[F_GGA_HDOP].len > 0) && !sStrToDbl(&gga->hDOP, &fields[F_GGA_HDOP], true, 0.0, false, 0.0) )
     {
         res = false;
     }
 
-    if ( (fields[F_GGA_ALT][0] != '\0') && !sStrToDbl(&gga->height, fields[F_GGA_ALT], false, 0.0, false, 0.0) )
+    if ( (fields[F_GGA_ALT].len > 0) && !sStrToDbl(&gga->height, &fields[F_GGA_ALT], false, 0.0, false, 0.0) )
     {
         res = false;
     }
 
-    if (fields[F_GGA_SEP][0] != '\0')
+    if (fields[F_GGA_SEP].len > 0)
     {
         double sep = 0.0;
-        if (!sStrToDbl(&sep, fields[F_GGA_SEP], false, 0.0, false, 0.0))
+        if (!sStrToDbl(&sep, &fields[F_GGA_SEP], false, 0.0, false, 0.0))
         {
             res = false;
         }
         gga->heightMsl = gga->height - sep;
     }
 
-    if (fields[F_GGA_DIFFAGE][0] != '\0')
+    if (fields[F_GGA_DIFFAGE].len > 0)
     {
-        if (!sStrToDbl(&gga->diffAge, fields[F_GGA_DIFFAGE], true, 0, false, 0))
+        if (!sStrToDbl(&gga->diffAge, &fields[F_GGA_DIFFAGE], true, 0, false, 0))
         {
             res = false;
         }
@@ -553,9 +731,9 @@ static bool sNmeaDecodeGga(NMEA_GGA_t *gga, char *payload, const char *talker)
         gga->diffAge = -1.0;
     }
 
-    if (fields[13][0] != '\0')
+    if (fields[13].len > 0)
     {
-        if (!sStrToInt(&gga->diffStation, fields[13], true, 0, false, 0))
+        if (!sStrToInt(&gga->diffStation, &fields[13], true, 0, false, 0))
         {
             res = false;
         }
@@ -584,13 +762,13 @@ static bool sNmeaDecodeGga(NMEA_GGA_t *gga, char *payload, const char *talker)
 #define F_RMC_POSMODE   (12 - 1)
 #define F_RMC_NAVSTATUS (13 - 1)
 
-static bool sNmeaDecodeRmc(NMEA_RMC_t *rmc, char *payload, const char *talker)
+static bool sNmeaDecodeRmc(NMEA_RMC_t *rmc, const char *payload, const int payloadLen, const char *talker)
 {
-    NMEA_DEBUG("sNmeaDecodeRmc [%s] [%s]", talker, payload);
+    NMEA_DEBUG("sNmeaDecodeRmc [%s] [%.*s]", talker, payloadLen, payload);
     UNUSED(talker);
 
-    const char *fields[30];
-    const int nFields = sGetFields(fields, NUMOF(fields), payload);
+    FIELD_t fields[30];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
     if (nFields < 13)
     {
         return false;
@@ -598,32 +776,32 @@ static bool sNmeaDecodeRmc(NMEA_RMC_t *rmc, char *payload, const char *talker)
 
     bool res = true;
 
-    if (fields[F_RMC_TIME][0] != '\0')
+    if (fields[F_RMC_TIME].len > 0)
     {
-        res = sStrToTime(&rmc->time, fields[F_RMC_TIME]);
+        res = sStrToTime(&rmc->time, &fields[F_RMC_TIME]);
     }
-    if (fields[F_RMC_DATE][0] != '\0')
+    if (fields[F_RMC_DATE].len > 0)
     {
-        res = sStrToDate(&rmc->date, fields[F_RMC_DATE]);
+        res = sStrToDate(&rmc->date, &fields[F_RMC_DATE]);
     }
 
-    if ( (fields[F_RMC_LAT][0] != '\0') && (fields[F_RMC_LON][0] != '\0') && (fields[F_RMC_POSMODE][0] != '\0') )
+    if ( (fields[F_RMC_LAT].len > 0) && (fields[F_RMC_LON].len > 0) && (fields[F_RMC_POSMODE].len > 0) )
     {
-        if (!sStrToLat( &rmc->lat, fields[F_RMC_LAT]) ||
-            !sStrToLon( &rmc->lon, fields[F_RMC_LON]) ||
-            !sStrToFix( &rmc->fix, fields[F_RMC_POSMODE], NMEA_TYPE_RMC))
+        if (!sStrToLat( &rmc->lat, &fields[F_RMC_LAT]) ||
+            !sStrToLon( &rmc->lon, &fields[F_RMC_LON]) ||
+            !sStrToFix( &rmc->fix, &fields[F_RMC_POSMODE], NMEA_TYPE_RMC))
         {
             res = false;
         }
-        if (fields[F_RMC_NS][0] != 'N')
+        if (FIELD_CHAR(fields[F_RMC_NS]) != 'N')
         {
             rmc->lat *= -1.0;
         }
-        if (fields[F_RMC_EW][0] != 'E')
+        if (FIELD_CHAR(fields[F_RMC_EW]) != 'E')
         {
             rmc->lon *= -1.0;
         }
-        if ( (nFields > F_RMC_NAVSTATUS) && (fields[F_RMC_NAVSTATUS][0] != 'V') )
+        if ( (nFields > F_RMC_NAVSTATUS) && (FIELD_CHAR(fields[F_RMC_NAVSTATUS]) != 'V') )
         {
             rmc->fix = NMEA_FIX_NOFIX; // FIXME: or what does != 'V' mean?
         }
@@ -633,32 +811,32 @@ static bool sNmeaDecodeRmc(NMEA_RMC_t *rmc, char *payload, const char *talker)
         rmc->fix = NMEA_FIX_NOFIX;
     }
 
-    rmc->valid = (fields[F_RMC_STATUS][0] == 'A');
+    rmc->valid = (FIELD_CHAR(fields[F_RMC_STATUS]) == 'A');
 
-    if (fields[F_RMC_SPEED][0] != '\0')
+    if (fields[F_RMC_SPEED].len > 0)
     {
-        if (!sStrToDbl(&rmc->spd, fields[F_RMC_SPEED], false, 0.0, false, 0.0))
+        if (!sStrToDbl(&rmc->spd, &fields[F_RMC_SPEED], false, 0.0, false, 0.0))
         {
             res = false;
         }
     }
 
-    if (fields[F_RMC_COG][0] != '\0')
+    if (fields[F_RMC_COG].len > 0)
     {
-        if (!sStrToDbl(&rmc->cog, fields[F_RMC_COG], true, 0.0, true, 360.0))
+        if (!sStrToDbl(&rmc->cog, &fields[F_RMC_COG], true, 0.0, true, 360.0))
         {
             res = false;
         }
     }
 
-    if (fields[F_RMC_MV][0] != '\0')
+    if (fields[F_RMC_MV].len > 0)
     {
-        if (!sStrToDbl(&rmc->mv, fields[F_RMC_MV], true, -180.0, true, 180.0))
+        if (!sStrToDbl(&rmc->mv, &fields[F_RMC_MV], true, -180.0, true, 180.0))
         {
             res = false;
         }
     }
-    if (fields[F_RMC_MVEW][0] == 'W')
+    if (FIELD_CHAR(fields[F_RMC_MVEW]) == 'W')
     {
         rmc->mv *= -1.0;
     }
@@ -668,21 +846,23 @@ static bool sNmeaDecodeRmc(NMEA_RMC_t *rmc, char *payload, const char *talker)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-static bool sNmeaDecodeTxt(NMEA_TXT_t *txt, char *payload, const char *talker)
+static bool sNmeaDecodeTxt(NMEA_TXT_t *txt, const char *payload, const int payloadLen, const char *talker)
 {
     UNUSED(talker);
-    NMEA_DEBUG("sNmeaDecodeTxt [%s] [%s]", talker, payload);
+    NMEA_DEBUG("sNmeaDecodeTxt [%s] [%.*s]", talker, payloadLen, payload);
 
-    const char *fields[5];
-    const int nFields = sGetFields(fields, NUMOF(fields), payload);
+    FIELD_t fields[5];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
     if ((nFields != 4) ||
-        !sStrToInt(&txt->numMsg,  fields[0], true, 0, false, 0) ||
-        !sStrToInt(&txt->msgNum,  fields[1], true, 0, false, 0) ||
-        !sStrToInt(&txt->msgType, fields[2], true, 0, false, 0))
+        !sStrToInt(&txt->numMsg,  &fields[0], true, 0, false, 0) ||
+        !sStrToInt(&txt->msgNum,  &fields[1], true, 0, false, 0) ||
+        !sStrToInt(&txt->msgType, &fields[2], true, 0, false, 0))
     {
         return false;
     }
-    snprintf(txt->text, sizeof(txt->text), "%s", fields[3]);
+    const int len = MIN(fields[3].len, (int)sizeof(txt->text) - 1);
+    memcpy(txt->text, fields[3].str, len);
+    txt->text[len] = '\0';
     return true;
 }
 
@@ -696,13 +876,13 @@ static bool sNmeaDecodeTxt(NMEA_TXT_t *txt, char *payload, const char *talker)
 #define F_GLL_STATUS   (6 - 1)
 #define F_GLL_POSMODE  (7 - 1)
 
-static bool sNmeaDecodeGll(NMEA_GLL_t *gll, char *payload, const char *talker)
+static bool sNmeaDecodeGll(NMEA_GLL_t *gll, const char *payload, const int payloadLen, const char *talker)
 {
     UNUSED(talker);
-    NMEA_DEBUG("sNmeaDecodeGll [%s] [%s]", talker, payload);
+    NMEA_DEBUG("sNmeaDecodeGll [%s] [%.*s]", talker, payloadLen, payload);
 
-    const char *fields[15];
-    const int nFields = sGetFields(fields, NUMOF(fields), payload);
+    FIELD_t fields[15];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
     if (nFields != 7)
     {
         return false;
@@ -710,24 +890,24 @@ static bool sNmeaDecodeGll(NMEA_GLL_t *gll, char *payload, const char *talker)
 
     bool res = true;
 
-    if (fields[F_GLL_TIME][0] != '\0')
+    if (fields[F_GLL_TIME].len > 0)
     {
-        res = sStrToTime(&gll->time, fields[F_GLL_TIME]);
+        res = sStrToTime(&gll->time, &fields[F_GLL_TIME]);
     }
 
-    if ( (fields[F_GLL_LAT][0] != '\0') && (fields[F_GLL_LON][0] != '\0') && (fields[F_GLL_POSMODE][0] != '\0') )
+    if ( (fields[F_GLL_LAT].len > 0) && (fields[F_GLL_LON].len > 0) && (fields[F_GLL_POSMODE].len > 0) )
     {
-        if (!sStrToLat( &gll->lat, fields[F_GLL_LAT]) ||
-            !sStrToLon( &gll->lon, fields[F_GLL_LON]) ||
-            !sStrToFix( &gll->fix, fields[F_GLL_POSMODE], NMEA_TYPE_RMC))
+        if (!sStrToLat( &gll->lat, &fields[F_GLL_LAT]) ||
+            !sStrToLon( &gll->lon, &fields[F_GLL_LON]) ||
+            !sStrToFix( &gll->fix, &fields[F_GLL_POSMODE], NMEA_TYPE_RMC))
         {
             res = false;
         }
-        if (fields[F_GLL_NS][0] != 'N')
+        if (FIELD_CHAR(fields[F_GLL_NS]) != 'N')
         {
             gll->lat *= -1.0;
         }
-        if (fields[F_GLL_EW][0] != 'E')
+        if (FIELD_CHAR(fields[F_GLL_EW]) != 'E')
         {
             gll->lon *= -1.0;
         }
@@ -737,32 +917,32 @@ static bool sNmeaDecodeGll(NMEA_GLL_t *gll, char *payload, const char *talker)
         gll->fix = NMEA_FIX_NOFIX;
     }
 
-    gll->valid = (fields[F_GLL_STATUS][0] == 'A');
+    gll->valid = (FIELD_CHAR(fields[F_GLL_STATUS]) == 'A');
 
     return res;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-static bool sNmeaDecodeGsv(NMEA_GSV_t *gsv, char *payload, const char *talker)
+static bool sNmeaDecodeGsv(NMEA_GSV_t *gsv, const char *payload, const int payloadLen, const char *talker)
 {
-    NMEA_DEBUG("sNmeaDecodeGsv [%s] [%s]", talker, payload);
+    NMEA_DEBUG("sNmeaDecodeGsv [%s] [%.*s]", talker, payloadLen, payload);
 
-    const char *fields[30];
-    const int nFields = sGetFields(fields, NUMOF(fields), payload);
+    FIELD_t fields[30];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
     if (nFields < 3)
     {
         return false;
     }
-    if (!sStrToInt(&gsv->numMsg, fields[0], true, 1, false, 0) ||
-        !sStrToInt(&gsv->msgNum, fields[1], true, 1, true, gsv->numMsg) ||
-        !sStrToInt(&gsv->numSat, fields[2], true, 0, false, 0) )
+    if (!sStrToInt(&gsv->numMsg, &fields[0], true, 1, false, 0) ||
+        !sStrToInt(&gsv->msgNum, &fields[1], true, 1, true, gsv->numMsg) ||
+        !sStrToInt(&gsv->numSat, &fields[2], true, 0, false, 0) )
     {
         return false;
     }
     const int nSat = (nFields - 3) / 4;
     const int remFields = nFields - (nSat * 4) - 3;
-    const char nmeaSig = (remFields > 0 ? fields[3 + (nSat * 4)][0] : '?');
+    const char nmeaSig = (remFields > 0 ? FIELD_CHAR(fields[3 + (nSat * 4)]) : '?');
     NMEA_DEBUG("nFields=%d/%d nSat=%d remFields=%d nmeaSig=%c", nFields, NUMOF(fields), nSat, remFields, nmeaSig);
 
     NMEA_GNSS_t   gnss = NMEA_GNSS_UNKNOWN;
@@ -834,10 +1014,10 @@ static bool sNmeaDecodeGsv(NMEA_GSV_t *gsv, char *payload, const char *talker)
     for (int satIx = 0; (satIx < nSat) && (satIx < (int)NUMOF(gsv->svs)); satIx++)
     {
         const int offs = 3 + (satIx * 4);
-        if (!sStrToInt(&gsv->svs[satIx].svId, fields[offs    ], true, 1, false, 0) ||
-            !sStrToInt(&gsv->svs[satIx].elev, fields[offs + 1], true, -90, true, 90) ||
-            !sStrToInt(&gsv->svs[satIx].azim, fields[offs + 2], true, 0, false, 360) ||
-            !sStrToInt(&gsv->svs[satIx].cno,  fields[offs + 3], true, 0, false, 0) )
+        if (!sStrToInt(&gsv->svs[satIx].svId, &fields[offs    ], true, 1, false, 0) ||
+            !sStrToInt(&gsv->svs[satIx].elev, &fields[offs + 1], true, -90, true, 90) ||
+            !sStrToInt(&gsv->svs[satIx].azim, &fields[offs + 2], true, 0, false, 360) ||
+            !sStrToInt(&gsv->svs[satIx].cno,  &fields[offs + 3], true, 0, false, 0) )
         {
             return false;
         }
@@ -863,6 +1043,268 @@ static bool sNmeaDecodeGsv(NMEA_GSV_t *gsv, char *payload, const char *talker)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+#define F_GSA_OPMODE   ( 1 - 1)
+#define F_GSA_NAVMODE  ( 2 - 1)
+#define F_GSA_SVID1    ( 3 - 1)
+#define F_GSA_PDOP     (15 - 1)
+#define F_GSA_HDOP     (16 - 1)
+#define F_GSA_VDOP     (17 - 1)
+#define F_GSA_SYSTEMID (18 - 1)
+
+static bool sNmeaDecodeGsa(NMEA_GSA_t *gsa, const char *payload, const int payloadLen, const char *talker)
+{
+    NMEA_DEBUG("sNmeaDecodeGsa [%s] [%.*s]", talker, payloadLen, payload);
+    UNUSED(talker);
+
+    FIELD_t fields[30];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
+    if ( (nFields != 17) && (nFields != 18) ) // systemId since NMEA 4.10
+    {
+        return false;
+    }
+
+    bool res = true;
+
+    gsa->autoMode = (FIELD_CHAR(fields[F_GSA_OPMODE]) == 'A');
+    if (!sStrToFix(&gsa->fix, &fields[F_GSA_NAVMODE], NMEA_TYPE_GSA))
+    {
+        res = false;
+    }
+
+    for (int ix = F_GSA_SVID1; ix < F_GSA_PDOP; ix++)
+    {
+        if (fields[ix].len > 0)
+        {
+            if (sStrToInt(&gsa->svIds[gsa->nSvs], &fields[ix], true, 1, false, 0))
+            {
+                gsa->nSvs++;
+            }
+            else
+            {
+                res = false;
+            }
+        }
+    }
+
+    gsa->pDOP = -1.0;
+    gsa->hDOP = -1.0;
+    gsa->vDOP = -1.0;
+    if ( (fields[F_GSA_PDOP].len > 0) && !sStrToDbl(&gsa->pDOP, &fields[F_GSA_PDOP], true, 0.0, false, 0.0) )
+    {
+        res = false;
+    }
+    if ( (fields[F_GSA_HDOP].len > 0) && !sStrToDbl(&gsa->hDOP, &fields[F_GSA_HDOP], true, 0.0, false, 0.0) )
+    {
+        res = false;
+    }
+    if ( (fields[F_GSA_VDOP].len > 0) && !sStrToDbl(&gsa->vDOP, &fields[F_GSA_VDOP], true, 0.0, false, 0.0) )
+    {
+        res = false;
+    }
+
+    if (nFields > F_GSA_SYSTEMID)
+    {
+        switch (FIELD_CHAR(fields[F_GSA_SYSTEMID]))
+        {
+            case '1': gsa->gnss = NMEA_GNSS_GPS;   break;
+            case '2': gsa->gnss = NMEA_GNSS_GLO;   break;
+            case '3': gsa->gnss = NMEA_GNSS_GAL;   break;
+            case '4': gsa->gnss = NMEA_GNSS_BDS;   break;
+            case '5': gsa->gnss = NMEA_GNSS_QZSS;  break;
+            case '6': gsa->gnss = NMEA_GNSS_NAVIC; break;
+        }
+    }
+
+    return res;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+#define F_GST_TIME     (1 - 1)
+#define F_GST_RANGERMS (2 - 1)
+#define F_GST_STDMAJOR (3 - 1)
+#define F_GST_STDMINOR (4 - 1)
+#define F_GST_ORIENT   (5 - 1)
+#define F_GST_STDLAT   (6 - 1)
+#define F_GST_STDLON   (7 - 1)
+#define F_GST_STDALT   (8 - 1)
+
+static bool sNmeaDecodeGst(NMEA_GST_t *gst, const char *payload, const int payloadLen, const char *talker)
+{
+    NMEA_DEBUG("sNmeaDecodeGst [%s] [%.*s]", talker, payloadLen, payload);
+    UNUSED(talker);
+
+    FIELD_t fields[15];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
+    if (nFields != 8)
+    {
+        return false;
+    }
+
+    bool res = true;
+
+    if (fields[F_GST_TIME].len > 0)
+    {
+        res = sStrToTime(&gst->time, &fields[F_GST_TIME]);
+    }
+
+    gst->rangeRms = -1.0;
+    gst->stdMajor = -1.0;
+    gst->stdMinor = -1.0;
+    if ( (fields[F_GST_RANGERMS].len > 0) && !sStrToDbl(&gst->rangeRms, &fields[F_GST_RANGERMS], true, 0.0, false, 0.0) )
+    {
+        res = false;
+    }
+    if ( (fields[F_GST_STDMAJOR].len > 0) && !sStrToDbl(&gst->stdMajor, &fields[F_GST_STDMAJOR], true, 0.0, false, 0.0) )
+    {
+        res = false;
+    }
+    if ( (fields[F_GST_STDMINOR].len > 0) && !sStrToDbl(&gst->stdMinor, &fields[F_GST_STDMINOR], true, 0.0, false, 0.0) )
+    {
+        res = false;
+    }
+    if ( (fields[F_GST_ORIENT].len > 0) && !sStrToDbl(&gst->orient, &fields[F_GST_ORIENT], true, 0.0, true, 360.0) )
+    {
+        res = false;
+    }
+
+    if ( (fields[F_GST_STDLAT].len > 0) && (fields[F_GST_STDLON].len > 0) && (fields[F_GST_STDALT].len > 0) )
+    {
+        gst->valid =
+            sStrToDbl(&gst->stdLat, &fields[F_GST_STDLAT], true, 0.0, false, 0.0) &&
+            sStrToDbl(&gst->stdLon, &fields[F_GST_STDLON], true, 0.0, false, 0.0) &&
+            sStrToDbl(&gst->stdAlt, &fields[F_GST_STDALT], true, 0.0, false, 0.0);
+        if (!gst->valid)
+        {
+            res = false;
+        }
+    }
+
+    return res;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+#define F_VTG_COGT     (1 - 1)
+#define F_VTG_COGTUNIT (2 - 1)
+#define F_VTG_COGM     (3 - 1)
+#define F_VTG_COGMUNIT (4 - 1)
+#define F_VTG_SOGN     (5 - 1)
+#define F_VTG_SOGNUNIT (6 - 1)
+#define F_VTG_SOGK     (7 - 1)
+#define F_VTG_SOGKUNIT (8 - 1)
+#define F_VTG_POSMODE  (9 - 1)
+
+static bool sNmeaDecodeVtg(NMEA_VTG_t *vtg, const char *payload, const int payloadLen, const char *talker)
+{
+    NMEA_DEBUG("sNmeaDecodeVtg [%s] [%.*s]", talker, payloadLen, payload);
+    UNUSED(talker);
+
+    FIELD_t fields[15];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
+    if ( (nFields != 8) && (nFields != 9) ) // posMode since NMEA 2.3
+    {
+        return false;
+    }
+
+    bool res = true;
+
+    if ( (nFields > F_VTG_POSMODE) && (fields[F_VTG_POSMODE].len > 0) &&
+         !sStrToFix(&vtg->fix, &fields[F_VTG_POSMODE], NMEA_TYPE_VTG) )
+    {
+        res = false;
+    }
+
+    vtg->cogm = -1.0;
+    if ( (fields[F_VTG_COGM].len > 0) && !sStrToDbl(&vtg->cogm, &fields[F_VTG_COGM], true, 0.0, true, 360.0) )
+    {
+        res = false;
+    }
+
+    // Speed in knots and km/h should both be there, but one is enough
+    if ( (fields[F_VTG_COGT].len > 0) && ((fields[F_VTG_SOGN].len > 0) || (fields[F_VTG_SOGK].len > 0)) )
+    {
+        vtg->valid = sStrToDbl(&vtg->cogt, &fields[F_VTG_COGT], true, 0.0, true, 360.0);
+        if (fields[F_VTG_SOGN].len > 0)
+        {
+            vtg->valid = vtg->valid && sStrToDbl(&vtg->sogn, &fields[F_VTG_SOGN], true, 0.0, false, 0.0);
+        }
+        if (fields[F_VTG_SOGK].len > 0)
+        {
+            vtg->valid = vtg->valid && sStrToDbl(&vtg->sogk, &fields[F_VTG_SOGK], true, 0.0, false, 0.0);
+        }
+        else
+        {
+            vtg->sogk = vtg->sogn * (1852.0 / 1000.0);
+        }
+        if (fields[F_VTG_SOGN].len == 0)
+        {
+            vtg->sogn = vtg->sogk * (1000.0 / 1852.0);
+        }
+        if (!vtg->valid)
+        {
+            res = false;
+        }
+    }
+
+    return res;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+#define F_ZDA_TIME  (1 - 1)
+#define F_ZDA_DAY   (2 - 1)
+#define F_ZDA_MONTH (3 - 1)
+#define F_ZDA_YEAR  (4 - 1)
+#define F_ZDA_LTZH  (5 - 1)
+#define F_ZDA_LTZN  (6 - 1)
+
+static bool sNmeaDecodeZda(NMEA_ZDA_t *zda, const char *payload, const int payloadLen, const char *talker)
+{
+    NMEA_DEBUG("sNmeaDecodeZda [%s] [%.*s]", talker, payloadLen, payload);
+    UNUSED(talker);
+
+    FIELD_t fields[15];
+    const int nFields = sGetFields(fields, NUMOF(fields), payload, payloadLen);
+    if (nFields != 6)
+    {
+        return false;
+    }
+
+    bool res = true;
+
+    if (fields[F_ZDA_TIME].len > 0)
+    {
+        res = sStrToTime(&zda->time, &fields[F_ZDA_TIME]);
+    }
+
+    // dd,mm,yyyy (unlike RMC with the full year)
+    if ( (fields[F_ZDA_DAY].len > 0) || (fields[F_ZDA_MONTH].len > 0) || (fields[F_ZDA_YEAR].len > 0) )
+    {
+        zda->date.valid = (fields[F_ZDA_DAY].len == 2) && (fields[F_ZDA_MONTH].len == 2) && (fields[F_ZDA_YEAR].len == 4) &&
+            sStrToInt(&zda->date.day,   &fields[F_ZDA_DAY],   true, 1, true, 31) &&
+            sStrToInt(&zda->date.month, &fields[F_ZDA_MONTH], true, 1, true, 12) &&
+            sStrToInt(&zda->date.year,  &fields[F_ZDA_YEAR],  true, 1980, false, 0);
+        if (!zda->date.valid)
+        {
+            res = false;
+        }
+    }
+
+    if ( (fields[F_ZDA_LTZH].len > 0) && !sStrToInt(&zda->ltzh, &fields[F_ZDA_LTZH], true, -13, true, 13) )
+    {
+        res = false;
+    }
+    if ( (fields[F_ZDA_LTZN].len > 0) && !sStrToInt(&zda->ltzn, &fields[F_ZDA_LTZN], true, 0, true, 59) )
+    {
+        res = false;
+    }
+
+    return res;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 bool nmeaMessageClsId(const char *name, uint8_t *clsId, uint8_t *msgId)
 {
     if ( (name == NULL) || (name[0] == '\0') )
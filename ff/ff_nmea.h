@@ -150,6 +150,49 @@ typedef struct NMEA_GSV_s
     int nSvs;
 } NMEA_GSV_t;
 
+typedef struct NMEA_GSA_s
+{
+    bool        autoMode;    // true = automatic 2D/3D, false = manual
+    NMEA_FIX_t  fix;         // From navMode: NMEA_FIX_NOFIX, NMEA_FIX_S2D or NMEA_FIX_S3D
+    int         svIds[12];   // Satellites used in the solution
+    int         nSvs;
+    double      pDOP;        // < 0 = n/a
+    double      hDOP;        // < 0 = n/a
+    double      vDOP;        // < 0 = n/a
+    NMEA_GNSS_t gnss;        // From system ID (NMEA >= 4.10), NMEA_GNSS_UNKNOWN if n/a
+} NMEA_GSA_t;
+
+typedef struct NMEA_GST_s
+{
+    NMEA_TIME_t time;
+    bool        valid;       // Standard deviations of lat/lon/alt are available
+    double      rangeRms;    // < 0 = n/a
+    double      stdMajor;    // < 0 = n/a
+    double      stdMinor;    // < 0 = n/a
+    double      orient;
+    double      stdLat;
+    double      stdLon;
+    double      stdAlt;
+} NMEA_GST_t;
+
+typedef struct NMEA_VTG_s
+{
+    NMEA_FIX_t  fix;         // NMEA_FIX_UNKNOWN if n/a (NMEA < 2.3)
+    bool        valid;       // Course and speed are available
+    double      cogt;        // Course over ground (true) [deg]
+    double      cogm;        // Course over ground (magnetic) [deg], < 0 = n/a
+    double      sogn;        // Speed over ground [knots]
+    double      sogk;        // Speed over ground [km/h]
+} NMEA_VTG_t;
+
+typedef struct NMEA_ZDA_s
+{
+    NMEA_TIME_t time;
+    NMEA_DATE_t date;
+    int         ltzh;        // Local time zone hours
+    int         ltzn;        // Local time zone minutes
+} NMEA_ZDA_t;
+
 typedef struct NMEA_TXT_s
 {
     int         numMsg;
@@ -166,13 +209,16 @@ typedef enum NMEA_TYPE_e
     NMEA_TYPE_RMC,
     NMEA_TYPE_GLL,
     NMEA_TYPE_GSV,
+    NMEA_TYPE_GSA,
+    NMEA_TYPE_GST,
+    NMEA_TYPE_VTG,
+    NMEA_TYPE_ZDA,
 } NMEA_TYPE_t;
 
 typedef struct NMEA_MSG_s
 {
     char talker[3];      //!< Talker ID ("GP", "GN", "P", ...)
     char formatter[8];   //!< Formatter ("GGA", "RMC", "UBX", ...)
-    char info[200];
     int  payloadIx0;
     int  payloadIx1;
     NMEA_TYPE_t type;
@@ -183,6 +229,10 @@ typedef struct NMEA_MSG_s
         NMEA_RMC_t rmc;
         NMEA_GLL_t gll;
         NMEA_GSV_t gsv;
+        NMEA_GSA_t gsa;
+        NMEA_GST_t gst;
+        NMEA_VTG_t vtg;
+        NMEA_ZDA_t zda;
     };
 
 } NMEA_MSG_t;
@@ -195,6 +245,16 @@ bool nmeaMessageInfo(char *info, const int size, const uint8_t *msg, const int m
 
 bool nmeaDecode(NMEA_MSG_t *nmea, const uint8_t *msg, const int msgSize);
 
+//! Stringify decoded NMEA message
+/*!
+    \param[out]  info  String buffer
+    \param[in]   size  Size of the string buffer
+    \param[in]   nmea  Decoded message (from nmeaDecode())
+
+    \returns true if the string was formatted (and fit into the buffer)
+*/
+bool nmeaDecodeInfo(char *info, const int size, const NMEA_MSG_t *nmea);
+
 //! Get NMEA message IDs ("fake" UBX class and message IDs)
 /*!
     \param[in]   name   Message name (e.g. "NMEA-STANDARD-GGA", "NMEA-PUBX-POSITION")
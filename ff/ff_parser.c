@@ -26,6 +26,7 @@
 #include "ff_nmea.h"
 #include "ff_novatel.h"
 #include "ff_crc.h"
+#include "ff_prof.h"
 
 #include "ff_parser.h"
 
@@ -53,20 +54,89 @@ void parserInit(PARSER_t *parser)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void parserSetTs(PARSER_t *parser, const PARSER_TS_t mode, uint64_t (*func)(void *), void *arg)
+{
+    parser->tsMode = ( (mode == PARSER_TS_FUNC) && (func == NULL) ) ? PARSER_TS_NONE : mode;
+    parser->tsFunc = func;
+    parser->tsArg  = arg;
+    parser->chunksHead = 0;
+    parser->chunksNum  = 0;
+}
+
+void parserSetNames(PARSER_t *parser, const bool names)
+{
+    parser->noNames = !names;
+}
+
+bool parserAddTs(PARSER_t *parser, const uint8_t *data, const int size, const uint64_t ts)
+{
+    if (!parserAdd(parser, data, size))
+    {
+        return false;
+    }
+    // Remember chunk, if there are too many, drop the oldest one
+    const int ix = (parser->chunksHead + parser->chunksNum) % PARSER_NUM_CHUNKS;
+    if (parser->chunksNum < PARSER_NUM_CHUNKS)
+    {
+        parser->chunksNum++;
+    }
+    else
+    {
+        parser->chunksHead = (parser->chunksHead + 1) % PARSER_NUM_CHUNKS;
+    }
+    parser->chunks[ix].end = parser->totIn;
+    parser->chunks[ix].ts  = ts;
+    return true;
+}
+
+// Get timestamp for the message (or garbage) of the given size, which is about to be emitted
+static uint64_t _parserTs(PARSER_t *parser, const int size)
+{
+    const uint64_t end = parser->totOut + size;
+    parser->totOut = end;
+    switch (parser->tsMode)
+    {
+        case PARSER_TS_TIME:
+            return TIME();
+        case PARSER_TS_NONE:
+            break;
+        case PARSER_TS_FUNC:
+            return parser->tsFunc(parser->tsArg);
+        case PARSER_TS_CHUNK:
+            // Drop chunks that are completely emitted
+            while ( (parser->chunksNum > 1) && (parser->chunks[parser->chunksHead].end < end) )
+            {
+                parser->chunksHead = (parser->chunksHead + 1) % PARSER_NUM_CHUNKS;
+                parser->chunksNum--;
+            }
+            return parser->chunksNum > 0 ? parser->chunks[parser->chunksHead].ts : 0;
+    }
+    return 0;
+}
+
 bool parserAdd(PARSER_t *parser, const uint8_t *data, const int size)
 {
-    // Overflow, discard all
-    if ((parser->offs + parser->size + size) > (int)sizeof(parser->buf))
+    // Overflow, discard all. The data is not moved here, as the last message returned by parserProcess() must stay
+    // valid. The buffer is compacted by parserProcess() once it has consumed all complete messages.
+    if ((parser->start + parser->offs + parser->size + size) > (int)sizeof(parser->buf))
     {
         return false;
     }
+    PROF_START(t0);
     // Add to buffer
-    memcpy(&parser->buf[parser->offs + parser->size], data, size);
+    memcpy(&parser->buf[parser->start + parser->offs + parser->size], data, size);
     parser->size += size;
+    parser->totIn += size;
     PARSER_XTRA_TRACE("add: size=%d ", size);
+    PROF_STOP(t0, PROF_PARSER_ADD);
     return true;
 }
 
+int parserSpace(const PARSER_t *parser)
+{
+    return (int)sizeof(parser->buf) - parser->start - parser->offs - parser->size;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 
 const char *parserMsgtypeName(const PARSER_MSGTYPE_t type)
@@ -91,6 +161,7 @@ static int _isRtcm3Message(const uint8_t *buf, const int size);
 static int _isSpartnMessage(const uint8_t *buf, const int size);
 static int _isNovatelMessage(const uint8_t *buf, const int size);
 static void _emitGarbage(PARSER_t *parser, PARSER_MSG_t *msg);
+static void _compact(PARSER_t *parser);
 static void _emitMessage(PARSER_t *parser, PARSER_MSG_t *msg, const int msgSize, const PARSER_MSGTYPE_t msgType, const bool info);
 
 typedef struct PARSER_FUNC_s
@@ -98,19 +169,27 @@ typedef struct PARSER_FUNC_s
     int            (*func)(const uint8_t *, const int);
     PARSER_MSGTYPE_t type;
     const char      *name;
+    PROF_STAGE_t     prof;
 } PARSER_FUNC_t;
 
 static const PARSER_FUNC_t kParserFuncs[] =
 {
-    { .func = _isUbxMessage,     .type = PARSER_MSGTYPE_UBX,     .name = "UBX"     },
-    { .func = _isNmeaMessage,    .type = PARSER_MSGTYPE_NMEA,    .name = "NMEA"    },
-    { .func = _isRtcm3Message,   .type = PARSER_MSGTYPE_RTCM3,   .name = "RTCM3"   },
-    { .func = _isSpartnMessage,  .type = PARSER_MSGTYPE_SPARTN,  .name = "SPARTN"  },
-    { .func = _isNovatelMessage, .type = PARSER_MSGTYPE_NOVATEL, .name = "NOVATEL" },
+    { .func = _isUbxMessage,     .type = PARSER_MSGTYPE_UBX,     .name = "UBX"    , .prof = PROF_DET_UBX     },
+    { .func = _isNmeaMessage,    .type = PARSER_MSGTYPE_NMEA,    .name = "NMEA"   , .prof = PROF_DET_NMEA    },
+    { .func = _isRtcm3Message,   .type = PARSER_MSGTYPE_RTCM3,   .name = "RTCM3"  , .prof = PROF_DET_RTCM3   },
+    { .func = _isSpartnMessage,  .type = PARSER_MSGTYPE_SPARTN,  .name = "SPARTN" , .prof = PROF_DET_SPARTN  },
+    { .func = _isNovatelMessage, .type = PARSER_MSGTYPE_NOVATEL, .name = "NOVATEL", .prof = PROF_DET_NOVATEL },
 };
 
 bool parserProcess(PARSER_t *parser, PARSER_MSG_t *msg, const bool info)
 {
+    // The previous message is no longer in use, make space if the remaining data is far back in the buffer (for
+    // callers that add data before all messages are processed)
+    if (parser->start >= (PARSER_BUF_SIZE / 2))
+    {
+        _compact(parser);
+    }
+
     while (parser->size > 0)
     {
         // Run parser functions
@@ -118,7 +197,9 @@ bool parserProcess(PARSER_t *parser, PARSER_MSG_t *msg, const bool info)
         PARSER_MSGTYPE_t msgType = PARSER_MSGTYPE_GARBAGE;
         for (int ix = 0; ix < NUMOF(kParserFuncs); ix++)
         {
-            msgSize = kParserFuncs[ix].func(&parser->buf[parser->offs], parser->size);
+            PROF_START(t0);
+            msgSize = kParserFuncs[ix].func(&parser->buf[parser->start + parser->offs], parser->size);
+            PROF_STOP(t0, kParserFuncs[ix].prof);
             PARSER_XTRA_TRACE("process: try %s, msgSize=%d ", kParserFuncs[ix].name, msgSize);
 
             // Parser said: Wait, need more data
@@ -139,6 +220,7 @@ bool parserProcess(PARSER_t *parser, PARSER_MSG_t *msg, const bool info)
         if (msgSize < 0)
         {
             PARSER_XTRA_TRACE("process: need more data");
+            _compact(parser);
             return false;
         }
 
@@ -183,6 +265,7 @@ bool parserProcess(PARSER_t *parser, PARSER_MSG_t *msg, const bool info)
         return true;
     }
 
+    _compact(parser);
     return false;
 }
 
@@ -192,8 +275,8 @@ bool parserFlush(PARSER_t *parser, PARSER_MSG_t *msg)
     if (rem > 0)
     {
         parser->offs += parser->size;
-        _emitGarbage(parser, msg);
         parser->size = 0;
+        _emitGarbage(parser, msg);
         return true;
     }
     else
@@ -204,19 +287,28 @@ bool parserFlush(PARSER_t *parser, PARSER_MSG_t *msg)
 
 /* ****************************************************************************************************************** */
 
+static void _compact(PARSER_t *parser)
+{
+    // Move remaining (incomplete) data to beginning of buffer, no message is in use by the caller now
+    //     buf: ..........GGG???????........ (p->start > 0, p->offs >= 0, p->size >= 0)
+    // --> buf: GGG???????.................. (p->start = 0)
+    if (parser->start > 0)
+    {
+        memmove(&parser->buf[0], &parser->buf[parser->start], parser->offs + parser->size);
+        parser->start = 0;
+    }
+}
+
 static void _emitGarbage(PARSER_t *parser, PARSER_MSG_t *msg)
 {
-    uint64_t now = TIME();
-    // Copy garbage to msg buf and move data in parser buf
-    //     buf: GGGGGGGGGGGGG???????????????........ (p->offs > 0, p->size >= 0)
-    //          ---p->offs--><-- p->size -->
-    // --> tmp: GGGGGGGGGGGG......
-    // --> buf  ???????????????..................... (p->offs = 0, p->size >= 0)
+    // Garbage is emitted from the buffer, the next message starts after it
+    //     buf: ....GGGGGGGGGGGGG???????????????........ (p->offs > 0, p->size >= 0)
+    //              ---p->offs--><-- p->size -->
+    // --> buf  .................???????????????........ (p->offs = 0, p->size >= 0)
     const int size = parser->offs;
-    //PARSER_XTRA_TRACE("garb copy tmp %d ", size);
-    memcpy(parser->tmp, parser->buf, size);
-    //PARSER_XTRA_TRACE("garb move 0 <- %d (%d) ", size, parser->size);
-    memmove(&parser->buf[0], &parser->buf[size], parser->size);
+    const uint64_t ts = _parserTs(parser, size);
+    const uint8_t *data = &parser->buf[parser->start];
+    parser->start = parser->size > 0 ? parser->start + size : 0;
     parser->offs = 0;
     parser->nMsgs++;
     parser->sMsgs += size;
@@ -226,9 +318,9 @@ static void _emitGarbage(PARSER_t *parser, PARSER_MSG_t *msg)
     // Make message
     msg->type = PARSER_MSGTYPE_GARBAGE;
     msg->size = size;
-    msg->data = parser->tmp;
+    msg->data = data;
     msg->seq  = parser->nMsgs;
-    msg->ts   = now;
+    msg->ts   = ts;
     msg->src  = PARSER_MSGSRC_UNKN;
     msg->name = "GARBAGE";
     msg->info = NULL;
@@ -238,89 +330,104 @@ static void _emitGarbage(PARSER_t *parser, PARSER_MSG_t *msg)
 
 static void _emitMessage(PARSER_t *parser, PARSER_MSG_t *msg, const int msgSize, const PARSER_MSGTYPE_t msgType, const bool info)
 {
-    uint64_t now = TIME();
-
-    // Copy message to tmp, move remaining data to beginning of buf
-    //     buf: MMMMMMMMMMMMMMM????????............. (p->offs = 0)
-    //          <-- msgSize -->
-    //          <----- p->size ------->
-    // --> tmp: MMMMMMMMMMMMMMM.....
-    // --> buf: ????????............................ (p->offs = 0, p->size >= 0)
-
-    //PARSER_XTRA_TRACE("msg copy tmp %d "_TRACE_FMT, msgSize, _TRACE_ARG);
-    memcpy(parser->tmp, parser->buf, msgSize);
-    //PARSER_XTRA_TRACE("msg move 0 <- %d (%d) "_TRACE_FMT, parser->size - msgSize, parser->size, _TRACE_ARG);
+    PROF_START(t0);
+    const uint64_t ts = _parserTs(parser, msgSize);
+
+    // Message is emitted from the buffer, the remaining data follows it
+    //     buf: ....MMMMMMMMMMMMMMM????????............. (p->offs = 0)
+    //              <-- msgSize -->
+    //              <----- p->size ------->
+    // --> buf: ...................????????............. (p->offs = 0, p->size >= 0)
+    const uint8_t *data = &parser->buf[parser->start];
     parser->size -= msgSize;
-    if (parser->size > 0)
-    {
-        memmove(&parser->buf[0], &parser->buf[msgSize], parser->size);
-    }
+    parser->start = parser->size > 0 ? parser->start + msgSize : 0;
     parser->sMsgs += msgSize;
     parser->nMsgs++;
     // Make message
     msg->type = msgType;
     msg->size = msgSize;
-    msg->data = parser->tmp;
+    msg->data = data;
     msg->seq  = parser->nMsgs;
-    msg->ts   = now;
+    msg->ts   = ts;
     msg->src  = PARSER_MSGSRC_UNKN;
     parser->name[0] = '\0';
     parser->info[0] = '\0';
+    const bool names = !parser->noNames;
+    if (!names)
+    {
+        msg->name = parserMsgtypeName(msgType);
+        msg->info = NULL;
+    }
     switch (msgType)
     {
         case PARSER_MSGTYPE_UBX:
             parser->nUbx++;
             parser->sUbx += msgSize;
-            msg->name = (ubxMessageName(parser->name, sizeof(parser->name), parser->tmp, msgSize) ?
-                parser->name : "UBX-?-?");
-            if (info)
+            if (names)
             {
-                msg->info = (ubxMessageInfo(parser->info, sizeof(parser->info), parser->tmp, msgSize) ?
-                    parser->info : NULL);
+                msg->name = (ubxMessageName(parser->name, sizeof(parser->name), data, msgSize) ?
+                    parser->name : "UBX-?-?");
+                if (info)
+                {
+                    msg->info = (ubxMessageInfo(parser->info, sizeof(parser->info), data, msgSize) ?
+                        parser->info : NULL);
+                }
             }
             break;
         case PARSER_MSGTYPE_NMEA:
             parser->nNmea++;
             parser->sNmea += msgSize;
-            msg->name = (nmeaMessageName(parser->name, sizeof(parser->name), parser->tmp, msgSize) ?
-                parser->name : "NMEA-?-?");
-            if (info)
+            if (names)
             {
-                msg->info = (nmeaMessageInfo(parser->info, sizeof(parser->info), parser->tmp, msgSize) ?
-                    parser->info : NULL);
+                msg->name = (nmeaMessageName(parser->name, sizeof(parser->name), data, msgSize) ?
+                    parser->name : "NMEA-?-?");
+                if (info)
+                {
+                    msg->info = (nmeaMessageInfo(parser->info, sizeof(parser->info), data, msgSize) ?
+                        parser->info : NULL);
+                }
             }
             break;
         case PARSER_MSGTYPE_RTCM3:
             parser->nRtcm3++;
             parser->sRtcm3 += msgSize;
-            msg->name = (rtcm3MessageName(parser->name, sizeof(parser->name), parser->tmp, msgSize) ?
-                parser->name : "RTCM3-?");
-            if (info)
+            if (names)
             {
-                msg->info = (rtcm3MessageInfo(parser->info, sizeof(parser->info), parser->tmp, msgSize) ?
-                    parser->info : NULL);
+                msg->name = (rtcm3MessageName(parser->name, sizeof(parser->name), data, msgSize) ?
+                    parser->name : "RTCM3-?");
+                if (info)
+                {
+                    msg->info = (rtcm3MessageInfo(parser->info, sizeof(parser->info), data, msgSize) ?
+                        parser->info : NULL);
+                }
             }
             break;
         case PARSER_MSGTYPE_SPARTN:
             parser->nSpartn++;
             parser->sSpartn += msgSize;
-            msg->name = (spartnMessageName(parser->name, sizeof(parser->name), parser->tmp, msgSize) ?
-                parser->name : "SPARTN-?");
-            if (info)
+            if (names)
             {
-                msg->info = (spartnMessageInfo(parser->info, sizeof(parser->info), parser->tmp, msgSize) ?
-                    parser->info : NULL);
+                msg->name = (spartnMessageName(parser->name, sizeof(parser->name), data, msgSize) ?
+                    parser->name : "SPARTN-?");
+                if (info)
+                {
+                    msg->info = (spartnMessageInfo(parser->info, sizeof(parser->info), data, msgSize) ?
+                        parser->info : NULL);
+                }
             }
             break;
         case PARSER_MSGTYPE_NOVATEL:
             parser->nNovatel++;
             parser->sNovatel += msgSize;
-            msg->name = (novatelMessageName(parser->name, sizeof(parser->name), parser->tmp, msgSize) ?
-                parser->name : "NOVATEL-?");
-            if (info)
+            if (names)
             {
-                msg->info = (novatelMessageInfo(parser->info, sizeof(parser->info), parser->tmp, msgSize) ?
-                    parser->info : NULL);
+                msg->name = (novatelMessageName(parser->name, sizeof(parser->name), data, msgSize) ?
+                    parser->name : "NOVATEL-?");
+                if (info)
+                {
+                    msg->info = (novatelMessageInfo(parser->info, sizeof(parser->info), data, msgSize) ?
+                        parser->info : NULL);
+                }
             }
             break;
         default:
@@ -329,6 +436,7 @@ static void _emitMessage(PARSER_t *parser, PARSER_MSG_t *msg, const int msgSize,
             break;
     }
     PARSER_XTRA_TRACE("process: emit %s, size %d, type %d ", msg->name, msgSize, msgType);
+    PROF_STOP(t0, PROF_PARSER_EMIT);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -43,13 +43,40 @@ extern "C" {
 #define PARSER_MAX_NAME_SIZE     100
 #define PARSER_MAX_INFO_SIZE    1000
 
+#define PARSER_NUM_CHUNKS         32 // number of input chunks to track for PARSER_TS_CHUNK
+
+// Source of message timestamps (PARSER_MSG_t.ts)
+typedef enum PARSER_TS_e
+{
+    PARSER_TS_TIME = 0,  // TIME() when the message is emitted (default)
+    PARSER_TS_NONE,      // No timestamps (always 0), for example for offline processing
+    PARSER_TS_CHUNK,     // Timestamp of the input chunk (see parserAddTs()) that completed the message
+    PARSER_TS_FUNC,      // User function (see parserSetTs())
+} PARSER_TS_t;
+
+typedef struct PARSER_CHUNK_s
+{
+    uint64_t  end;     // total number of bytes added up to and including this chunk
+    uint64_t  ts;      // timestamp
+} PARSER_CHUNK_t;
+
 typedef struct PARSER_s
 {
     // Parser state, don't mess with this
     uint8_t   buf[PARSER_BUF_SIZE];
+    int       start;
     int       size;
     int       offs;
-    uint8_t   tmp[PARSER_MAX_ANY_SIZE];
+    // Timestamps
+    PARSER_TS_t    tsMode;
+    uint64_t     (*tsFunc)(void *);
+    void          *tsArg;
+    uint64_t       totIn;   // total number of bytes added
+    uint64_t       totOut;  // total number of bytes emitted
+    PARSER_CHUNK_t chunks[PARSER_NUM_CHUNKS];
+    int            chunksHead;
+    int            chunksNum;
+    bool      noNames;
     char      name[PARSER_MAX_NAME_SIZE];
     char      info[PARSER_MAX_INFO_SIZE];
     // Statistics (number and size of all messages reps. of protocol)
@@ -93,7 +120,7 @@ typedef enum PARSER_MSGSRC_e
 typedef struct PARSER_MSG_s
 {
     PARSER_MSGTYPE_t type;
-    const uint8_t   *data;
+    const uint8_t   *data; // valid until the next parserProcess() or parserFlush()
     int              size;
     uint32_t         seq;
     uint64_t         ts;
@@ -103,7 +130,17 @@ typedef struct PARSER_MSG_s
 } PARSER_MSG_t;
 
 void parserInit(PARSER_t *parser);
+void parserSetTs(PARSER_t *parser, const PARSER_TS_t mode, uint64_t (*func)(void *), void *arg);
+// Generate message names (default), or only set PARSER_MSG_t.name to the protocol name (see parserMsgtypeName()) and
+// don't generate any info, for example when only the frames are needed
+void parserSetNames(PARSER_t *parser, const bool names);
+// Add data, returns false if it doesn't fit (see parserSpace()). Adding data does not move data in the buffer, so
+// the last message returned by parserProcess() stays valid. The full buffer is available once parserProcess()
+// returned false.
 bool parserAdd(PARSER_t *parser, const uint8_t *data, const int size);
+bool parserAddTs(PARSER_t *parser, const uint8_t *data, const int size, const uint64_t ts);
+// Number of bytes that parserAdd() can take now
+int parserSpace(const PARSER_t *parser);
 bool parserProcess(PARSER_t *parser, PARSER_MSG_t *msg, const bool info);
 bool parserFlush(PARSER_t *parser, PARSER_MSG_t *msg);
 
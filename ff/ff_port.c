@@ -45,6 +45,7 @@
 
 #include "ff_debug.h"
 #include "ff_stuff.h"
+#include "ff_prof.h"
 #include "ff_port.h"
 
 /* ****************************************************************************************************************** */
@@ -345,6 +346,7 @@ static bool _portReadTelnet(PORT_t *port, uint8_t *data, const int size, int *nR
 
 bool portRead(PORT_t *port, uint8_t *data, const int size, int *nRead)
 {
+    PROF_START(t0);
     bool res = false;
     *nRead = 0;
     if ( (port != NULL) && (nRead != NULL) && port->portOk && (size > 0) )
@@ -370,6 +372,7 @@ bool portRead(PORT_t *port, uint8_t *data, const int size, int *nRead)
     {
         port->numRx += *nRead;
     }
+    PROF_STOP(t0, PROF_PORT_READ);
     return res;
 }
 
@@ -0,0 +1,172 @@
+// clang-format off
+// flipflip's hot path profiling
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "ff_debug.h"
+#include "ff_stuff.h"
+
+#include "ff_prof.h"
+
+/* ****************************************************************************************************************** */
+
+#define PROF_HIST_SIZE 32 // Histogram bins: [0, 2), [2, 4), [4, 8), ..., [2^31, inf) ticks
+
+typedef struct PROF_DATA_s
+{
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t hist[PROF_HIST_SIZE];
+} PROF_DATA_t;
+
+static PROF_DATA_t gProfData[_PROF_NUM_STAGES];
+static uint64_t    gProfTicks0; // Ticks and time [ns] at start, to calibrate ticks to ns
+static uint64_t    gProfTime0;
+static bool        gProfInit;
+
+static const char * const kProfStageNames[_PROF_NUM_STAGES] =
+{
+    [PROF_PORT_READ]      = "PORT_READ",
+    [PROF_PARSER_ADD]     = "PARSER_ADD",
+    [PROF_DET_UBX]        = "DET_UBX",
+    [PROF_DET_NMEA]       = "DET_NMEA",
+    [PROF_DET_RTCM3]      = "DET_RTCM3",
+    [PROF_DET_SPARTN]     = "DET_SPARTN",
+    [PROF_DET_NOVATEL]    = "DET_NOVATEL",
+    [PROF_PARSER_EMIT]    = "PARSER_EMIT",
+    [PROF_NMEA_DECODE]    = "NMEA_DECODE",
+    [PROF_EPOCH_COLLECT]  = "EPOCH_COLLECT",
+    [PROF_EPOCH_COMPLETE] = "EPOCH_COMPLETE",
+};
+
+// Deliberately not TIME() or timeMonoNs(), which may use a virtual clock
+static uint64_t _profTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+void profReset(void)
+{
+    memset(gProfData, 0, sizeof(gProfData));
+    gProfTicks0 = profTicks();
+    gProfTime0  = _profTimeNs();
+    gProfInit   = true;
+}
+
+bool profEnabled(void)
+{
+    return FF_PROF ? true : false;
+}
+
+void profAdd(const PROF_STAGE_t stage, const uint64_t ticks)
+{
+    if (!gProfInit)
+    {
+        profReset();
+    }
+    if ((int)stage >= _PROF_NUM_STAGES)
+    {
+        return;
+    }
+    PROF_DATA_t *data = &gProfData[stage];
+    if ( (data->count == 0) || (ticks < data->min) )
+    {
+        data->min = ticks;
+    }
+    if (ticks > data->max)
+    {
+        data->max = ticks;
+    }
+    data->count++;
+    data->total += ticks;
+    const int bin = ticks > 0 ? (63 - __builtin_clzll(ticks)) : 0;
+    data->hist[bin < PROF_HIST_SIZE ? bin : (PROF_HIST_SIZE - 1)]++;
+}
+
+void profDump(void)
+{
+    if (!FF_PROF)
+    {
+        PRINT("prof: profiling not compiled in");
+        return;
+    }
+    if (!gProfInit)
+    {
+        profReset();
+    }
+
+    // Calibrate ticks to ns
+    const uint64_t dTicks = profTicks() - gProfTicks0;
+    const uint64_t dTime  = _profTimeNs() - gProfTime0;
+    const double nsPerTick = (dTicks > 0) && (dTime > 0) ? (double)dTime / (double)dTicks : 1.0;
+
+    PRINT("prof: %.3f s, %.3f ns/tick", (double)dTime * 1e-9, nsPerTick);
+    PRINT("prof: stage                count        min [ns]     mean [ns]      max [ns]     total [ms]");
+    for (int stage = 0; stage < _PROF_NUM_STAGES; stage++)
+    {
+        const PROF_DATA_t *data = &gProfData[stage];
+        if (data->count == 0)
+        {
+            PRINT("prof: %-15s %10u", kProfStageNames[stage], 0);
+            continue;
+        }
+        PRINT("prof: %-15s %10"PRIu64"  %12.1f  %12.1f  %12.1f  %12.3f", kProfStageNames[stage],
+            data->count, (double)data->min * nsPerTick,
+            (double)data->total * nsPerTick / (double)data->count, (double)data->max * nsPerTick,
+            (double)data->total * nsPerTick * 1e-6);
+    }
+
+    // Histograms, listing the non-empty bins as "<upper bound>:<percent>"
+    for (int stage = 0; stage < _PROF_NUM_STAGES; stage++)
+    {
+        const PROF_DATA_t *data = &gProfData[stage];
+        if (data->count == 0)
+        {
+            continue;
+        }
+        char str[1000];
+        int len = 0;
+        for (int bin = 0; (bin < PROF_HIST_SIZE) && (len < ((int)sizeof(str) - 50)); bin++)
+        {
+            if (data->hist[bin] == 0)
+            {
+                continue;
+            }
+            const double perc = (double)data->hist[bin] / (double)data->count * 1e2;
+            if (bin < (PROF_HIST_SIZE - 1))
+            {
+                const double upper = (double)(UINT64_C(2) << bin) * nsPerTick;
+                len += snprintf(&str[len], sizeof(str) - len, " <%.0f:%.1f%%", upper, perc);
+            }
+            else
+            {
+                len += snprintf(&str[len], sizeof(str) - len, " more:%.1f%%", perc);
+            }
+        }
+        PRINT("prof: %-15s [ns]%s", kProfStageNames[stage], str);
+    }
+}
+
+/* ****************************************************************************************************************** */
+// eof
@@ -0,0 +1,102 @@
+// clang-format off
+// flipflip's hot path profiling
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef __FF_PROF_H__
+#define __FF_PROF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Profiling is enabled at compile time (cmake -DFF_PROF=ON, or make FF_PROF=1). When disabled the PROF_START() and
+// PROF_STOP() macros expand to nothing.
+#ifndef FF_PROF
+#  define FF_PROF 0
+#endif
+
+#if FF_PROF
+#  if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#  else
+#    include <time.h>
+#  endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ****************************************************************************************************************** */
+
+// Instrumented stages. Note that some stages are nested (e.g. the detectors are called from parserProcess(), which
+// is called from rxGetNextMessage(), which calls portRead()).
+typedef enum PROF_STAGE_e
+{
+    PROF_PORT_READ = 0,   // portRead()
+    PROF_PARSER_ADD,      // parserAdd()
+    PROF_DET_UBX,         // UBX detector in parserProcess()
+    PROF_DET_NMEA,        // NMEA detector in parserProcess()
+    PROF_DET_RTCM3,       // RTCM3 detector in parserProcess()
+    PROF_DET_SPARTN,      // SPARTN detector in parserProcess()
+    PROF_DET_NOVATEL,     // NOVATEL detector in parserProcess()
+    PROF_PARSER_EMIT,     // Emit message in parserProcess() (incl. name and info strings)
+    PROF_NMEA_DECODE,     // nmeaDecode()
+    PROF_EPOCH_COLLECT,   // epochCollect() of relevant messages (incl. nmeaDecode() and epoch complete)
+    PROF_EPOCH_COMPLETE,  // Epoch complete in epochCollect()
+    _PROF_NUM_STAGES
+} PROF_STAGE_t;
+
+#if FF_PROF
+#  define PROF_START(_t0_)           const uint64_t _t0_ = profTicks()
+#  define PROF_STOP(_t0_, _stage_)   profAdd((_stage_), profTicks() - (_t0_))
+#else
+#  define PROF_START(_t0_)           /* nothing */
+#  define PROF_STOP(_t0_, _stage_)   /* nothing */
+#endif
+
+// Current tick counter (TSC on x86, monotonic clock [ns] elsewhere)
+static inline uint64_t profTicks(void)
+{
+#if FF_PROF
+#  if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#  else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+#  endif
+#else
+    return 0;
+#endif
+}
+
+// Add a measurement (not thread-safe, numbers may be slightly off with multiple threads)
+void profAdd(const PROF_STAGE_t stage, const uint64_t ticks);
+
+// Is profiling compiled in?
+bool profEnabled(void);
+
+// Clear all counters
+void profReset(void);
+
+// Print summary (count, min, mean, max, histogram) of all stages (using PRINT())
+void profDump(void);
+
+/* ****************************************************************************************************************** */
+#ifdef __cplusplus
+}
+#endif
+#endif // __FF_PROF_H__
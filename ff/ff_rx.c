@@ -218,7 +218,7 @@ static bool _rxOpenDetect(RX_t *rx)
 
 static void _rxCallbackData(RX_t *rx, const PARSER_MSGSRC_t src, const uint8_t *buf, const int size)
 {
-    if (rx->opts.msgcb != NULL)
+    if ( (rx->opts.msgcb != NULL) || (rx->opts.log != NULL) )
     {
         PARSER_t p;
         parserInit(&p);
@@ -227,13 +227,29 @@ static void _rxCallbackData(RX_t *rx, const PARSER_MSGSRC_t src, const uint8_t *
             RX_WARNING("Parser overflow!");
             parserInit(&p);
         }
+        // Usually this is exactly one message, but it could be more (or less, i.e. GARBAGE)
         PARSER_MSG_t msg;
-        if (parserProcess(&p, &msg, true))
+        bool more = true;
+        while (more)
         {
+            more = parserProcess(&p, &msg, true);
+            if (!more)
+            {
+                if (!parserFlush(&p, &msg))
+                {
+                    break;
+                }
+            }
             msg.src = src;
-            rx->opts.msgcb(&msg, rx->opts.cbarg);
+            if (rx->opts.log != NULL)
+            {
+                rxlogWriteMsg(rx->opts.log, &msg);
+            }
+            if (rx->opts.msgcb != NULL)
+            {
+                rx->opts.msgcb(&msg, rx->opts.cbarg);
+            }
         }
-        //else // should not happen, parserProcess() should always return at least GARBAGE
     }
 }
 
@@ -306,16 +322,45 @@ PARSER_MSG_t *rxGetNextMessage(RX_t *rx)
     PARSER_MSG_t *msg = NULL;
     if (rx != NULL)
     {
-        int readSize;
-        while ( !rx->abort && portRead(&rx->port, rx->readBuf, sizeof(rx->readBuf), &readSize) && (readSize > 0) )
+        // Return messages already in the parser first, and read only as much data as the parser can take (so that
+        // nothing is lost if the data arrives faster than it's processed)
+        bool haveMsg = parserProcess(&rx->parser, &rx->msg, true);
+        while (!haveMsg && !rx->abort)
         {
+            const int space = MIN((int)sizeof(rx->readBuf), parserSpace(&rx->parser));
+            int readSize = 0;
+            if ( (space <= 0) || !portRead(&rx->port, rx->readBuf, space, &readSize) || (readSize <= 0) )
+            {
+                break;
+            }
             parserAdd(&rx->parser, rx->readBuf, readSize);
+            haveMsg = parserProcess(&rx->parser, &rx->msg, true);
         }
 
-        if (parserProcess(&rx->parser, &rx->msg, true))
+        if (haveMsg)
         {
             msg = &rx->msg;
             msg->src = PARSER_MSGSRC_FROM_RX;
+            if (rx->opts.log != NULL)
+            {
+                rxlogWriteMsg(rx->opts.log, msg);
+            }
+        }
+    }
+    return msg;
+}
+
+PARSER_MSG_t *rxFlushMessage(RX_t *rx)
+{
+    PARSER_MSG_t *msg = NULL;
+    // Messages already in the parser first, and only then the remaining (incomplete) data
+    if ( (rx != NULL) && (parserProcess(&rx->parser, &rx->msg, true) || parserFlush(&rx->parser, &rx->msg)) )
+    {
+        msg = &rx->msg;
+        msg->src = PARSER_MSGSRC_FROM_RX;
+        if (rx->opts.log != NULL)
+        {
+            rxlogWriteMsg(rx->opts.log, msg);
         }
     }
     return msg;
@@ -23,6 +23,7 @@
 
 #include "ubloxcfg/ubloxcfg.h"
 #include "ff_parser.h"
+#include "ff_rxlog.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,9 +52,10 @@ typedef struct RX_OPTS_s
     char    *name;     //!< Name of the receiver (automatic if NULL)
     void   (*msgcb)(PARSER_MSG_t *, void *arg); //!< Optional callback for every message received
     void    *cbarg;    //!< Optional user argument for callback
+    RXLOG_t *log;      //!< Optional log for all messages received and sent (see rxlogCreate())
 } RX_OPTS_t;
 
-#define RX_OPTS_DEFAULT() { .detect = RX_DET_UBX, .autobaud = true, .baudrate = 0, .verbose = true, .name = NULL, .msgcb = NULL, .cbarg = NULL }
+#define RX_OPTS_DEFAULT() { .detect = RX_DET_UBX, .autobaud = true, .baudrate = 0, .verbose = true, .name = NULL, .msgcb = NULL, .cbarg = NULL, .log = NULL }
 
 RX_t *rxInit(const char *port, const RX_OPTS_t *opts);
 
@@ -62,6 +64,7 @@ void rxClose(RX_t *rx);
 
 PARSER_MSG_t *rxGetNextMessage(RX_t *rx);
 PARSER_MSG_t *rxGetNextMessageTimeout(RX_t *rx, const uint32_t timeout);
+PARSER_MSG_t *rxFlushMessage(RX_t *rx); // Remaining messages in parser, then remaining data (as GARBAGE), or NULL
 
 bool rxSend(RX_t *rx, const uint8_t *data, const int size);
 
@@ -0,0 +1,745 @@
+// clang-format off
+// flipflip's u-blox positioning receiver control library
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#  include <io.h>
+#endif
+
+#include "ff_debug.h"
+#include "ff_stuff.h"
+#include "ff_crc.h"
+#include "ff_parser.h"
+#include "ff_rxlog.h"
+
+/* ****************************************************************************************************************** */
+
+#define RXLOG_MAGIC           "FFRXLOG\n"
+#define RXLOG_WRITE_BUF_SIZE  (256 * 1024)
+#define RXLOG_READ_CHUNK_SIZE (64 * 1024)
+#define RXLOG_REC_MAX_SIZE    (RXLOG_REC_HEAD_SIZE + RXLOG_MAX_SIZE)
+#define RXLOG_READ_BUF_SIZE   (RXLOG_REC_MAX_SIZE + RXLOG_READ_CHUNK_SIZE)
+#define RXLOG_TAIL_SIZE       (4 * RXLOG_REC_MAX_SIZE)
+#define RXLOG_CHECK_SIZE      8
+
+typedef struct RXLOG_s
+{
+    FILE        *file;
+    char        *path;
+    bool         write;
+    bool         error;
+    RXLOG_INFO_t info;
+    // Block check (writer and reader)
+    uint32_t     chainCrc;
+    uint32_t     chainNum;
+    bool         chainValid;
+    // Writer
+    uint64_t     nextCheck;
+    uint64_t     lastTs;
+    char        *wbuf;
+    // Reader
+    uint8_t     *rbuf;
+    int          rsize;
+    int          rpos;
+    uint64_t     roffs;
+    bool         rsync;
+} RXLOG_t;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static inline void _put16(uint8_t *p, const uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static inline void _put32(uint8_t *p, const uint32_t v)
+{
+    _put16(&p[0], v & 0xffff);
+    _put16(&p[2], (v >> 16) & 0xffff);
+}
+
+static inline void _put64(uint8_t *p, const uint64_t v)
+{
+    _put32(&p[0], v & 0xffffffff);
+    _put32(&p[4], (v >> 32) & 0xffffffff);
+}
+
+static inline uint16_t _get16(const uint8_t *p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline uint32_t _get32(const uint8_t *p)
+{
+    return (uint32_t)_get16(&p[0]) | ((uint32_t)_get16(&p[2]) << 16);
+}
+
+static inline uint64_t _get64(const uint8_t *p)
+{
+    return (uint64_t)_get32(&p[0]) | ((uint64_t)_get32(&p[4]) << 32);
+}
+
+// Check of record header (all but the check itself)
+static uint16_t _recHeadCheck(const uint8_t *head)
+{
+    uint8_t tmp[RXLOG_REC_HEAD_SIZE - 2];
+    memcpy(&tmp[0], &head[0], 6);
+    memcpy(&tmp[6], &head[8], 8);
+    return crcSpartn16(tmp, sizeof(tmp));
+}
+
+// Valid record header? (caller must make sure there are at least RXLOG_REC_HEAD_SIZE bytes)
+static bool _recHeadValid(const uint8_t *head)
+{
+    return (head[0] == RXLOG_SYNC_1) && (head[1] == RXLOG_SYNC_2) && (_get16(&head[6]) == _recHeadCheck(head));
+}
+
+static void _chainUpdate(RXLOG_t *log, const uint8_t *head, const uint8_t *data, const int size)
+{
+    uint8_t tmp[4 + RXLOG_REC_HEAD_SIZE + 4];
+    _put32(&tmp[0], log->chainCrc);
+    memcpy(&tmp[4], head, RXLOG_REC_HEAD_SIZE);
+    _put32(&tmp[4 + RXLOG_REC_HEAD_SIZE], crcNovatel32(data, size));
+    log->chainCrc = crcNovatel32(tmp, sizeof(tmp));
+    log->chainNum++;
+}
+
+static void _chainReset(RXLOG_t *log)
+{
+    log->chainCrc = 0;
+    log->chainNum = 0;
+    log->chainValid = true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static RXLOG_t *_rxlogAlloc(const char *path, const bool write)
+{
+    RXLOG_t *log = malloc(sizeof(RXLOG_t));
+    if (log == NULL)
+    {
+        WARNING("rxlog: malloc fail!");
+        return NULL;
+    }
+    memset(log, 0, sizeof(*log));
+    log->write = write;
+    log->path  = strdup(path);
+    if (write)
+    {
+        log->wbuf = malloc(RXLOG_WRITE_BUF_SIZE);
+    }
+    else
+    {
+        log->rbuf = malloc(RXLOG_READ_BUF_SIZE);
+    }
+    if ( (log->path == NULL) || (write ? (log->wbuf == NULL) : (log->rbuf == NULL)) )
+    {
+        WARNING("rxlog: malloc fail!");
+        free(log->path);
+        free(log->wbuf);
+        free(log->rbuf);
+        free(log);
+        return NULL;
+    }
+    _chainReset(log);
+    return log;
+}
+
+static void _rxlogFree(RXLOG_t *log)
+{
+    if (log->file != NULL)
+    {
+        fclose(log->file);
+    }
+    free(log->path);
+    free(log->wbuf);
+    free(log->rbuf);
+    free(log);
+}
+
+static bool _readHead(RXLOG_t *log, const uint8_t *head)
+{
+    if (!rxlogIsLog(head, RXLOG_HEAD_SIZE))
+    {
+        WARNING("rxlog: %s: not a log (or unsupported version)!", log->path);
+        return false;
+    }
+    log->info.version       = _get16(&head[8]);
+    log->info.checkInterval = _get32(&head[12]);
+    log->info.timeReal      = _get64(&head[16]);
+    log->info.timeMono      = _get64(&head[24]);
+    log->info.flags         = _get32(&head[32]);
+    return true;
+}
+
+bool rxlogIsLog(const uint8_t *data, const int size)
+{
+    return (data != NULL) && (size >= RXLOG_HEAD_SIZE) && (memcmp(data, RXLOG_MAGIC, 8) == 0) &&
+        (_get16(&data[8]) == RXLOG_VERSION) && (_get16(&data[10]) == RXLOG_HEAD_SIZE);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static bool _writeRec(RXLOG_t *log, const uint64_t ts, const uint8_t src, const uint8_t type,
+    const uint8_t *data, const int size)
+{
+    uint8_t head[RXLOG_REC_HEAD_SIZE];
+    head[0] = RXLOG_SYNC_1;
+    head[1] = RXLOG_SYNC_2;
+    head[2] = src;
+    head[3] = type;
+    _put16(&head[4], size);
+    _put64(&head[8], ts);
+    _put16(&head[6], _recHeadCheck(head));
+
+    if ( (fwrite(head, sizeof(head), 1, log->file) != 1) ||
+         ( (size > 0) && (fwrite(data, size, 1, log->file) != 1) ) )
+    {
+        WARNING("rxlog: %s: write fail: %s", log->path, strerror(errno));
+        log->error = true;
+        return false;
+    }
+    log->info.size += sizeof(head) + size;
+
+    if ( (log->info.checkInterval > 0) && (type != RXLOG_TYPE_CHECK) )
+    {
+        _chainUpdate(log, head, data, size);
+    }
+    return true;
+}
+
+static bool _writeCheck(RXLOG_t *log, const bool restart)
+{
+    uint8_t payload[RXLOG_CHECK_SIZE];
+    _put32(&payload[0], restart ? 0 : log->chainCrc);
+    _put32(&payload[4], restart ? 0 : log->chainNum);
+    _chainReset(log);
+    log->nextCheck = log->info.size + log->info.checkInterval;
+    log->info.numChecks++;
+    return _writeRec(log, log->lastTs, PARSER_MSGSRC_LOG, RXLOG_TYPE_CHECK, payload, sizeof(payload));
+}
+
+// Find end of last complete record in the log, and the timestamp of that record
+static bool _findEnd(RXLOG_t *log, const uint64_t fileSize, uint64_t *end, uint64_t *lastTs)
+{
+    const uint64_t tailOffs = fileSize > (RXLOG_HEAD_SIZE + RXLOG_TAIL_SIZE) ? fileSize - RXLOG_TAIL_SIZE : RXLOG_HEAD_SIZE;
+    const int tailSize = fileSize - tailOffs;
+    *end = fileSize;
+    *lastTs = 0;
+    if (tailSize == 0)
+    {
+        return true;
+    }
+
+    uint8_t *tail = malloc(tailSize);
+    if ( (tail == NULL) || (fseeko(log->file, tailOffs, SEEK_SET) != 0) || (fread(tail, tailSize, 1, log->file) != 1) )
+    {
+        WARNING("rxlog: %s: read fail: %s", log->path, strerror(errno));
+        free(tail);
+        return false;
+    }
+
+    // Find the first record from which we can walk the chain of records to (or beyond) the end of the file
+    bool found = false;
+    for (int cand = 0; !found && (cand <= (tailSize - RXLOG_REC_HEAD_SIZE)); cand++)
+    {
+        int pos = cand;
+        int last = -1;
+        while ( (pos <= (tailSize - RXLOG_REC_HEAD_SIZE)) && _recHeadValid(&tail[pos]) )
+        {
+            const int next = pos + RXLOG_REC_HEAD_SIZE + _get16(&tail[pos + 4]);
+            if (next > tailSize)
+            {
+                break;
+            }
+            last = pos;
+            pos = next;
+        }
+        // Record chain ends with a complete record at the end of the file, or with a truncated record
+        if ( (pos == tailSize) || ( (pos <= (tailSize - RXLOG_REC_HEAD_SIZE)) && _recHeadValid(&tail[pos]) ) ||
+             ( (pos > cand) && ((tailSize - pos) < RXLOG_REC_HEAD_SIZE) && (tail[pos] == RXLOG_SYNC_1) ) )
+        {
+            *end = tailOffs + pos;
+            *lastTs = last >= 0 ? _get64(&tail[last + 8]) : 0;
+            found = true;
+        }
+    }
+    free(tail);
+
+    if (!found)
+    {
+        WARNING("rxlog: %s: cannot find end of last record", log->path);
+    }
+    return true;
+}
+
+RXLOG_t *rxlogCreate(const char *path, const bool append, const uint32_t checkInterval)
+{
+    if (path == NULL)
+    {
+        return NULL;
+    }
+    RXLOG_t *log = _rxlogAlloc(path, true);
+    if (log == NULL)
+    {
+        return NULL;
+    }
+
+    bool ok = true;
+    log->file = append ? fopen(path, "r+b") : NULL;
+
+    // Append to existing log
+    if (log->file != NULL)
+    {
+        uint8_t head[RXLOG_HEAD_SIZE];
+        uint64_t fileSize = 0;
+        uint64_t end = 0;
+        if ( (fread(head, sizeof(head), 1, log->file) != 1) || !_readHead(log, head) ||
+             (fseeko(log->file, 0, SEEK_END) != 0) || ((fileSize = ftello(log->file)) < RXLOG_HEAD_SIZE) ||
+             !_findEnd(log, fileSize, &end, &log->lastTs) )
+        {
+            WARNING("rxlog: %s: cannot append to log", path);
+            ok = false;
+        }
+        else
+        {
+            if (end < fileSize)
+            {
+                WARNING("rxlog: %s: removing truncated record at end of log (%" PRIu64 " bytes)", path, fileSize - end);
+                fflush(log->file);
+                if (ftruncate(fileno(log->file), end) != 0)
+                {
+                    WARNING("rxlog: %s: truncate fail: %s", path, strerror(errno));
+                    ok = false;
+                }
+            }
+            if (ok && (fseeko(log->file, end, SEEK_SET) != 0))
+            {
+                WARNING("rxlog: %s: seek fail: %s", path, strerror(errno));
+                ok = false;
+            }
+            log->info.size = end;
+        }
+        if (ok)
+        {
+            setvbuf(log->file, log->wbuf, _IOFBF, RXLOG_WRITE_BUF_SIZE);
+            DEBUG("rxlog: %s: append (size %" PRIu64 ", check interval %" PRIu32 ")",
+                path, log->info.size, log->info.checkInterval);
+            if (log->info.checkInterval > 0)
+            {
+                ok = _writeCheck(log, true);
+            }
+        }
+    }
+    // Create new log
+    else
+    {
+        log->file = fopen(path, "wb");
+        if (log->file == NULL)
+        {
+            WARNING("rxlog: %s: cannot create: %s", path, strerror(errno));
+            ok = false;
+        }
+        else
+        {
+            setvbuf(log->file, log->wbuf, _IOFBF, RXLOG_WRITE_BUF_SIZE);
+            log->info.version       = RXLOG_VERSION;
+            log->info.checkInterval = checkInterval;
+            log->info.timeReal      = timeRealNs();
+            log->info.timeMono      = timeMonoNs();
+            uint8_t head[RXLOG_HEAD_SIZE];
+            memcpy(&head[0], RXLOG_MAGIC, 8);
+            _put16(&head[8], RXLOG_VERSION);
+            _put16(&head[10], RXLOG_HEAD_SIZE);
+            _put32(&head[12], checkInterval);
+            _put64(&head[16], log->info.timeReal);
+            _put64(&head[24], log->info.timeMono);
+            _put32(&head[32], 0);
+            _put32(&head[36], 0);
+            if (fwrite(head, sizeof(head), 1, log->file) != 1)
+            {
+                WARNING("rxlog: %s: write fail: %s", path, strerror(errno));
+                ok = false;
+            }
+            log->info.size = sizeof(head);
+            log->nextCheck = log->info.size + checkInterval;
+            DEBUG("rxlog: %s: create (check interval %" PRIu32 ")", path, checkInterval);
+        }
+    }
+
+    if (!ok)
+    {
+        _rxlogFree(log);
+        return NULL;
+    }
+    return log;
+}
+
+// Update flags in the file header
+static bool _writeFlags(RXLOG_t *log, const uint32_t flags)
+{
+    uint8_t buf[4];
+    _put32(buf, flags);
+    if ( (fflush(log->file) != 0) || (fseeko(log->file, 32, SEEK_SET) != 0) ||
+         (fwrite(buf, sizeof(buf), 1, log->file) != 1) || (fseeko(log->file, log->info.size, SEEK_SET) != 0) )
+    {
+        WARNING("rxlog: %s: write fail: %s", log->path, strerror(errno));
+        log->error = true;
+        return false;
+    }
+    log->info.flags = flags;
+    return true;
+}
+
+bool rxlogWrite(RXLOG_t *log, const uint64_t ts, const PARSER_MSGSRC_t src, const PARSER_MSGTYPE_t type,
+    const uint8_t *data, const int size)
+{
+    if ( (log == NULL) || !log->write || log->error || (size < 0) || (size > RXLOG_MAX_SIZE) )
+    {
+        return false;
+    }
+    // Timestamp going backwards (e.g. appending to a log after a reboot), readers can no longer binary search
+    if ( (ts < log->lastTs) && ((log->info.flags & RXLOG_FLAG_NONMONO) == 0) )
+    {
+        DEBUG("rxlog: %s: timestamps not monotonic", log->path);
+        if (!_writeFlags(log, log->info.flags | RXLOG_FLAG_NONMONO))
+        {
+            return false;
+        }
+    }
+    log->lastTs = ts;
+    if (!_writeRec(log, ts, src, type, data, size))
+    {
+        return false;
+    }
+    log->info.numRecs++;
+    if ( (log->info.checkInterval > 0) && (log->info.size >= log->nextCheck) )
+    {
+        return _writeCheck(log, false);
+    }
+    return true;
+}
+
+bool rxlogWriteMsg(RXLOG_t *log, const PARSER_MSG_t *msg)
+{
+    return rxlogWrite(log, timeMonoNs(), msg->src, msg->type, msg->data, msg->size);
+}
+
+bool rxlogFlush(RXLOG_t *log)
+{
+    if ( (log == NULL) || !log->write || log->error )
+    {
+        return false;
+    }
+    if (fflush(log->file) != 0)
+    {
+        WARNING("rxlog: %s: write fail: %s", log->path, strerror(errno));
+        log->error = true;
+        return false;
+    }
+    return true;
+}
+
+bool rxlogSync(RXLOG_t *log)
+{
+    if (!rxlogFlush(log))
+    {
+        return false;
+    }
+#ifdef _WIN32
+    if (_commit(fileno(log->file)) != 0)
+#else
+    if (fsync(fileno(log->file)) != 0)
+#endif
+    {
+        WARNING("rxlog: %s: sync fail: %s", log->path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool rxlogClose(RXLOG_t *log)
+{
+    if (log == NULL)
+    {
+        return false;
+    }
+    bool ok = true;
+    if (log->write)
+    {
+        if ( (log->info.checkInterval > 0) && (log->chainNum > 0) && !log->error )
+        {
+            ok = _writeCheck(log, false);
+        }
+        if (ok)
+        {
+            ok = rxlogFlush(log);
+        }
+        if (fclose(log->file) != 0)
+        {
+            WARNING("rxlog: %s: close fail: %s", log->path, strerror(errno));
+            ok = false;
+        }
+        log->file = NULL;
+        DEBUG("rxlog: %s: close (size %" PRIu64 ", %" PRIu64 " records, %" PRIu64 " checks)", log->path,
+            log->info.size, log->info.numRecs, log->info.numChecks);
+        ok = ok && !log->error;
+    }
+    _rxlogFree(log);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+RXLOG_t *rxlogOpen(const char *path)
+{
+    if (path == NULL)
+    {
+        return NULL;
+    }
+    RXLOG_t *log = _rxlogAlloc(path, false);
+    if (log == NULL)
+    {
+        return NULL;
+    }
+
+    log->file = fopen(path, "rb");
+    if (log->file == NULL)
+    {
+        WARNING("rxlog: %s: cannot open: %s", path, strerror(errno));
+        _rxlogFree(log);
+        return NULL;
+    }
+
+    uint8_t head[RXLOG_HEAD_SIZE];
+    if ( (fread(head, sizeof(head), 1, log->file) != 1) || !_readHead(log, head) ||
+         (fseeko(log->file, 0, SEEK_END) != 0) )
+    {
+        _rxlogFree(log);
+        return NULL;
+    }
+    log->info.size = ftello(log->file);
+    if (!rxlogSeek(log, RXLOG_HEAD_SIZE))
+    {
+        // Empty log, this is okay
+        log->rsync = false;
+    }
+    _chainReset(log);
+    DEBUG("rxlog: %s: open (size %" PRIu64 ", check interval %" PRIu32 ")", path, log->info.size, log->info.checkInterval);
+    return log;
+}
+
+// Make sure there are at least "size" bytes in the read buffer, returns available bytes
+static int _readFill(RXLOG_t *log, const int size)
+{
+    int avail = log->rsize - log->rpos;
+    if (avail < size)
+    {
+        if ( (avail > 0) && (log->rpos > 0) )
+        {
+            memmove(&log->rbuf[0], &log->rbuf[log->rpos], avail);
+        }
+        log->roffs += log->rpos;
+        log->rpos = 0;
+        log->rsize = avail;
+        while (log->rsize < size)
+        {
+            const size_t n = fread(&log->rbuf[log->rsize], 1, RXLOG_READ_BUF_SIZE - log->rsize, log->file);
+            if (n == 0)
+            {
+                break;
+            }
+            log->rsize += n;
+        }
+        avail = log->rsize;
+    }
+    return avail;
+}
+
+// Advance to next valid and complete record, returns false at end of log
+static bool _readSync(RXLOG_t *log)
+{
+    bool skipped = false;
+    while (true)
+    {
+        if (_readFill(log, RXLOG_REC_HEAD_SIZE) < RXLOG_REC_HEAD_SIZE)
+        {
+            break;
+        }
+        const uint8_t *head = &log->rbuf[log->rpos];
+        if (_recHeadValid(head))
+        {
+            const int recSize = RXLOG_REC_HEAD_SIZE + _get16(&head[4]);
+            if (_readFill(log, recSize) >= recSize)
+            {
+                if (skipped && log->rsync)
+                {
+                    WARNING("rxlog: %s: bad data at offset %" PRIu64 " (resync)", log->path, log->roffs + log->rpos);
+                    log->info.numErrors++;
+                }
+                if (skipped)
+                {
+                    log->chainValid = false;
+                }
+                log->rsync = true;
+                return true;
+            }
+            // Truncated record at end of the log
+            WARNING("rxlog: %s: truncated record at offset %" PRIu64, log->path, log->roffs + log->rpos);
+            log->info.numErrors++;
+            log->rpos = log->rsize;
+            break;
+        }
+        log->rpos++;
+        skipped = true;
+    }
+    return false;
+}
+
+bool rxlogRead(RXLOG_t *log, RXLOG_REC_t *rec)
+{
+    if ( (log == NULL) || log->write || (rec == NULL) )
+    {
+        return false;
+    }
+
+    while (_readSync(log))
+    {
+        const uint8_t *head = &log->rbuf[log->rpos];
+        const uint8_t *data = &head[RXLOG_REC_HEAD_SIZE];
+        const int size = _get16(&head[4]);
+        const uint64_t offs = log->roffs + log->rpos;
+        log->rpos += RXLOG_REC_HEAD_SIZE + size;
+
+        // Check record
+        if (head[3] == RXLOG_TYPE_CHECK)
+        {
+            const uint32_t num = size == RXLOG_CHECK_SIZE ? _get32(&data[4]) : 0;
+            if ( log->chainValid && (num > 0) )
+            {
+                if ( (_get32(&data[0]) != log->chainCrc) || (num != log->chainNum) )
+                {
+                    WARNING("rxlog: %s: check fail at offset %" PRIu64 " (%" PRIu32 "/%" PRIu32 " records)",
+                        log->path, offs, log->chainNum, num);
+                    log->info.numErrors++;
+                }
+                log->info.numChecks++;
+            }
+            _chainReset(log);
+            continue;
+        }
+
+        if (log->info.checkInterval > 0)
+        {
+            _chainUpdate(log, head, data, size);
+        }
+        rec->ts   = _get64(&head[8]);
+        rec->src  = (PARSER_MSGSRC_t)head[2];
+        rec->type = (PARSER_MSGTYPE_t)head[3];
+        rec->data = data;
+        rec->size = size;
+        rec->offs = offs;
+        log->info.numRecs++;
+        return true;
+    }
+    return false;
+}
+
+bool rxlogSeek(RXLOG_t *log, const uint64_t offs)
+{
+    if ( (log == NULL) || log->write )
+    {
+        return false;
+    }
+    const uint64_t o = offs < RXLOG_HEAD_SIZE ? RXLOG_HEAD_SIZE : offs;
+    if (fseeko(log->file, o, SEEK_SET) != 0)
+    {
+        WARNING("rxlog: %s: seek fail: %s", log->path, strerror(errno));
+        return false;
+    }
+    log->roffs = o;
+    log->rpos = 0;
+    log->rsize = 0;
+    log->rsync = false; // don't complain about skipped data
+    log->chainValid = false;
+    return _readSync(log);
+}
+
+bool rxlogSeekTs(RXLOG_t *log, const uint64_t ts)
+{
+    if ( (log == NULL) || log->write )
+    {
+        return false;
+    }
+
+    // Binary search for a record before the wanted timestamp, if the timestamps are monotonic
+    uint64_t lo = RXLOG_HEAD_SIZE;
+    uint64_t hi = (log->info.flags & RXLOG_FLAG_NONMONO) != 0 ? lo : log->info.size;
+    while ((hi - lo) > RXLOG_READ_CHUNK_SIZE)
+    {
+        const uint64_t mid = lo + ((hi - lo) / 2);
+        if (rxlogSeek(log, mid) && (_get64(&log->rbuf[log->rpos + 8]) < ts))
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    // Linear search for the exact record (or for the first one in the log, if timestamps are not monotonic)
+    if (!rxlogSeek(log, lo))
+    {
+        return false;
+    }
+    while (_readSync(log))
+    {
+        const uint8_t *head = &log->rbuf[log->rpos];
+        if ( (head[3] != RXLOG_TYPE_CHECK) && (_get64(&head[8]) >= ts) )
+        {
+            log->chainValid = false;
+            return true;
+        }
+        log->rpos += RXLOG_REC_HEAD_SIZE + _get16(&head[4]);
+    }
+    return false;
+}
+
+void rxlogGetInfo(RXLOG_t *log, RXLOG_INFO_t *info)
+{
+    if ( (log != NULL) && (info != NULL) )
+    {
+        *info = log->info;
+    }
+}
+
+bool rxlogToParser(PARSER_t *parser, const RXLOG_REC_t *rec)
+{
+    return parserAddTs(parser, rec->data, rec->size, rec->ts);
+}
+
+/* ****************************************************************************************************************** */
+// eof
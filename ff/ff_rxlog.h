@@ -0,0 +1,243 @@
+// clang-format off
+// flipflip's u-blox positioning receiver control library
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef __FF_RXLOG_H__
+#define __FF_RXLOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ff_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ****************************************************************************************************************** */
+
+// Timestamped receiver log
+//
+// File layout (all values little-endian):
+//
+//   File header (RXLOG_HEAD_SIZE bytes):
+//     0  char[8]   magic "FFRXLOG\n"
+//     8  uint16_t  version (RXLOG_VERSION)
+//    10  uint16_t  header size (RXLOG_HEAD_SIZE)
+//    12  uint32_t  check interval [bytes] (0 = no check records)
+//    16  uint64_t  creation time, wall clock [ns] since 1970-01-01 00:00:00 UTC
+//    24  uint64_t  creation time, monotonic clock [ns] (same clock as the record timestamps)
+//    32  uint32_t  flags (RXLOG_FLAG_...)
+//    36  uint32_t  reserved (0)
+//
+//   Records (RXLOG_REC_HEAD_SIZE bytes header + payload):
+//     0  uint8_t   sync 1 (RXLOG_SYNC_1)
+//     1  uint8_t   sync 2 (RXLOG_SYNC_2)
+//     2  uint8_t   source (PARSER_MSGSRC_t)
+//     3  uint8_t   type (PARSER_MSGTYPE_t, or RXLOG_TYPE_CHECK)
+//     4  uint16_t  payload size (0..RXLOG_MAX_SIZE)
+//     6  uint16_t  header check (crcSpartn16() of header bytes 0-5 and 8-15)
+//     8  uint64_t  timestamp, monotonic clock [ns]
+//    16  uint8_t[] payload (the message, or any chunk of data)
+//
+//   Optional check records (type RXLOG_TYPE_CHECK, source PARSER_MSGSRC_LOG), written every check interval bytes and
+//   when closing the log, with payload:
+//     0  uint32_t  chained CRC of all records since the previous check record (or the file header)
+//     4  uint32_t  number of records covered (0 = no check, restart, written when appending to a log)
+//
+//   The chained CRC is updated for each record as crc = crcNovatel32([ crc, header, crcNovatel32(payload) ]).
+//
+// Each record header can be validated on its own. Readers can therefore start at any offset and resynchronise to the
+// next valid record header, which makes the log seekable and robust against truncated writes (e.g. from a crashed
+// logger). Appending to an existing log first removes a truncated record at the end of the file, if any.
+//
+// The monotonic clock restarts at 0 when the system reboots. A log that is appended to after a reboot therefore has
+// timestamps that go backwards. The writer detects this (a timestamp before the previous one) and sets
+// RXLOG_FLAG_NONMONO in the file header.
+
+#define RXLOG_VERSION          1      //!< File format version
+#define RXLOG_HEAD_SIZE       40      //!< File header size [bytes]
+#define RXLOG_REC_HEAD_SIZE   16      //!< Record header size [bytes]
+#define RXLOG_SYNC_1        0xf5      //!< Record sync byte 1
+#define RXLOG_SYNC_2        0x4c      //!< Record sync byte 2 ('L')
+#define RXLOG_MAX_SIZE     65535      //!< Max. record payload size [bytes]
+#define RXLOG_TYPE_CHECK    0xff      //!< Record type of check records
+
+#define RXLOG_FLAG_NONMONO  0x00000001  //!< Timestamps are not monotonic (e.g. appended after a reboot)
+
+//! Log handle
+typedef struct RXLOG_s RXLOG_t;
+
+//! Log record
+typedef struct RXLOG_REC_s
+{
+    uint64_t         ts;    //!< Timestamp [ns] (monotonic clock)
+    PARSER_MSGSRC_t  src;   //!< Source
+    PARSER_MSGTYPE_t type;  //!< Type of payload
+    const uint8_t   *data;  //!< Payload (valid until the next rxlogRead() or rxlogClose())
+    int              size;  //!< Size of payload
+    uint64_t         offs;  //!< Offset of the record in the file
+} RXLOG_REC_t;
+
+//! Log information
+typedef struct RXLOG_INFO_s
+{
+    uint32_t version;       //!< Format version
+    uint32_t checkInterval; //!< Check interval [bytes]
+    uint64_t timeReal;      //!< Creation time, wall clock [ns]
+    uint64_t timeMono;      //!< Creation time, monotonic clock [ns]
+    uint32_t flags;         //!< Flags (RXLOG_FLAG_...)
+    uint64_t size;          //!< Current file size (writer: including buffered data)
+    uint64_t numRecs;       //!< Number of records written or read (not counting check records)
+    uint64_t numChecks;     //!< Number of check records written or verified
+    uint64_t numErrors;     //!< Number of failed checks and resyncs (reader only)
+} RXLOG_INFO_t;
+
+//! Create a new log, or append to an existing log
+/*!
+    \param[in]  path           path of the log file
+    \param[in]  append         append to existing log (file must be a log), create new log if it doesn't exist
+    \param[in]  checkInterval  write a check record every so many bytes (0 = no check records), for new logs only,
+                               existing logs continue with the check interval they were created with
+
+    \returns the log handle, NULL on error
+*/
+RXLOG_t *rxlogCreate(const char *path, const bool append, const uint32_t checkInterval);
+
+//! Open log for reading
+/*!
+    \param[in]  path  path of the log file
+
+    \returns the log handle, NULL on error (e.g. file is not a log)
+*/
+RXLOG_t *rxlogOpen(const char *path);
+
+//! Close log
+/*!
+    Writes buffered data and the final check record, if any.
+
+    \param[in]  log  log handle
+
+    \returns true if all data was successfully written (writer), true (reader)
+*/
+bool rxlogClose(RXLOG_t *log);
+
+//! Write record
+/*!
+    \param[in]  log   log handle
+    \param[in]  ts    timestamp [ns] (monotonic clock, see timeMonoNs())
+    \param[in]  src   source of the data
+    \param[in]  type  type of the data
+    \param[in]  data  the data
+    \param[in]  size  size of the data (max. RXLOG_MAX_SIZE)
+
+    \returns true on success, false otherwise (the log is in error state and all further writes fail)
+*/
+bool rxlogWrite(RXLOG_t *log, const uint64_t ts, const PARSER_MSGSRC_t src, const PARSER_MSGTYPE_t type,
+    const uint8_t *data, const int size);
+
+//! Write message (with current timeMonoNs() timestamp)
+/*!
+    \param[in]  log  log handle
+    \param[in]  msg  the message
+
+    \returns true on success, false otherwise
+*/
+bool rxlogWriteMsg(RXLOG_t *log, const PARSER_MSG_t *msg);
+
+//! Flush buffered data to the file
+/*!
+    \param[in]  log  log handle
+
+    \returns true on success, false otherwise
+*/
+bool rxlogFlush(RXLOG_t *log);
+
+//! Flush buffered data and commit it to the storage device (fsync())
+/*!
+    \param[in]  log  log handle
+
+    \returns true on success, false otherwise
+*/
+bool rxlogSync(RXLOG_t *log);
+
+//! Read next record
+/*!
+    Invalid data (e.g. records with a bad header) is skipped. Check records are verified and skipped. Failed checks
+    are reported (WARNING()) and counted (RXLOG_INFO_t.numErrors).
+
+    \param[in]   log  log handle
+    \param[out]  rec  the record
+
+    \returns true if a record was read, false at the end of the log (or on error)
+*/
+bool rxlogRead(RXLOG_t *log, RXLOG_REC_t *rec);
+
+//! Seek to record at or after given offset
+/*!
+    \param[in]  log   log handle
+    \param[in]  offs  file offset
+
+    \returns true if a record was found at or after the offset, false otherwise
+*/
+bool rxlogSeek(RXLOG_t *log, const uint64_t offs);
+
+//! Seek to first record with timestamp at or after given timestamp
+/*!
+    Uses a binary search if the timestamps in the log are monotonic. Otherwise (RXLOG_FLAG_NONMONO) the log is
+    scanned from the beginning, and the first record (in file order) with a timestamp at or after the given timestamp
+    is found.
+
+    \param[in]  log  log handle
+    \param[in]  ts   timestamp [ns]
+
+    \returns true if such a record was found, false otherwise
+*/
+bool rxlogSeekTs(RXLOG_t *log, const uint64_t ts);
+
+//! Get log information
+/*!
+    \param[in]   log   log handle
+    \param[out]  info  information
+*/
+void rxlogGetInfo(RXLOG_t *log, RXLOG_INFO_t *info);
+
+//! Check if data looks like the start of a log
+/*!
+    \param[in]  data  data (e.g. the beginning of a file)
+    \param[in]  size  size of data
+
+    \returns true if data starts with a valid log file header
+*/
+bool rxlogIsLog(const uint8_t *data, const int size);
+
+//! Feed record to parser
+/*!
+    Adds the record payload to the parser using the record timestamp (see parserAddTs()), so that with the parser in
+    PARSER_TS_CHUNK mode the messages carry the timestamp of the record.
+
+    \param[in,out]  parser  parser
+    \param[in]      rec     record
+
+    \returns true on success, false if the parser overflowed
+*/
+bool rxlogToParser(PARSER_t *parser, const RXLOG_REC_t *rec);
+
+/* ****************************************************************************************************************** */
+#ifdef __cplusplus
+}
+#endif
+#endif // __FF_RXLOG_H__
@@ -17,6 +17,7 @@
 
 #include <unistd.h>
 #include <time.h>
+#include <errno.h>
 #ifdef _WIN32
 #  define NOGDI
 #  include <windows.h>
@@ -26,28 +27,43 @@
 
 /* ****************************************************************************************************************** */
 
+static uint64_t _timeSysNow(void *arg);
+static bool _timeSysSleepUntil(void *arg, const uint64_t ts);
+static TIME_CLOCK_t gClock = { .now = _timeSysNow, .sleepUntil = _timeSysSleepUntil, .arg = NULL };
+static bool gHaveTime0 = false;
+static uint64_t gTime0 = 0;
+
+void timeSetClock(const TIME_CLOCK_t *clock)
+{
+    if (clock != NULL)
+    {
+        gClock = *clock;
+    }
+    else
+    {
+        gClock.now = _timeSysNow;
+        gClock.sleepUntil = _timeSysSleepUntil;
+        gClock.arg = NULL;
+    }
+    gHaveTime0 = false;
+}
+
 uint64_t TIME(void)
 {
-    static uint64_t t0 = 0;
-    struct timespec tp;
-    clock_gettime(CLOCK_MONOTONIC, &tp);
-    uint64_t t = (tp.tv_sec * 1000) + (tp.tv_nsec / 1000000);
-    if (t0 == 0)
+    const uint64_t t = gClock.now(gClock.arg) / 1000000;
+    if (!gHaveTime0)
     {
-        t0 = t;
+        gTime0 = t;
+        gHaveTime0 = true;
         return 0;
     }
 
-    return t - t0;
+    return t - gTime0;
 }
 
 void SLEEP(uint32_t dur)
 {
-#ifdef _WIN32
-    Sleep(dur);
-#else
-    usleep(dur * 1000);
-#endif
+    gClock.sleepUntil(gClock.arg, gClock.now(gClock.arg) + ((uint64_t)dur * 1000000));
 }
 
 uint64_t timeOfDay(void)
@@ -60,5 +76,85 @@ uint64_t timeOfDay(void)
     return t;
 }
 
+uint64_t timeMonoNs(void)
+{
+    return gClock.now(gClock.arg);
+}
+
+uint64_t timeRealNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+bool sleepUntilMonoNs(const uint64_t ts)
+{
+    return gClock.sleepUntil(gClock.arg, ts);
+}
+
+static uint64_t _timeSysNow(void *arg)
+{
+    UNUSED(arg);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+static bool _timeSysSleepUntil(void *arg, const uint64_t ts)
+{
+    UNUSED(arg);
+#ifdef _WIN32
+    const uint64_t now = _timeSysNow(NULL);
+    if (ts > now)
+    {
+        Sleep((ts - now + 999999) / 1000000);
+    }
+    return true;
+#else
+    // Absolute deadline, so that (unlike with relative sleeps) errors don't accumulate
+    const struct timespec tp = { .tv_sec = ts / 1000000000, .tv_nsec = ts % 1000000000 };
+    const int res = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tp, NULL);
+    return res != EINTR;
+#endif
+}
+
+/* ****************************************************************************************************************** */
+
+static uint64_t _timeVclockNow(void *arg)
+{
+    const TIME_VCLOCK_t *vclock = (const TIME_VCLOCK_t *)arg;
+    return vclock->now;
+}
+
+static bool _timeVclockSleepUntil(void *arg, const uint64_t ts)
+{
+    TIME_VCLOCK_t *vclock = (TIME_VCLOCK_t *)arg;
+    vclock->nSleeps++;
+    if (ts > vclock->now)
+    {
+        if (vclock->advance != NULL)
+        {
+            vclock->advance(vclock->arg, vclock->now, ts);
+        }
+        vclock->slept += ts - vclock->now;
+        vclock->now = ts;
+    }
+    return true;
+}
+
+void timeSetVirtualClock(TIME_VCLOCK_t *vclock)
+{
+    if (vclock != NULL)
+    {
+        const TIME_CLOCK_t clock = { .now = _timeVclockNow, .sleepUntil = _timeVclockSleepUntil, .arg = vclock };
+        timeSetClock(&clock);
+    }
+    else
+    {
+        timeSetClock(NULL);
+    }
+}
+
 /* ****************************************************************************************************************** */
 // eof
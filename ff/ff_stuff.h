@@ -32,6 +32,43 @@ void SLEEP(uint32_t dur);
 
 uint64_t timeOfDay(void);
 
+uint64_t timeMonoNs(void); // Monotonic time [ns] (arbitrary epoch)
+uint64_t timeRealNs(void); // Wall clock time [ns] since 1970-01-01 00:00:00 UTC
+bool sleepUntilMonoNs(const uint64_t ts); // Sleep until timeMonoNs() >= ts, false if interrupted (signal)
+
+// TIME(), SLEEP(), timeMonoNs() and sleepUntilMonoNs() use this clock. The default is the system's monotonic clock.
+typedef struct TIME_CLOCK_s
+{
+    uint64_t (*now)(void *arg);                        // Monotonic time [ns]
+    bool     (*sleepUntil)(void *arg, const uint64_t ts); // Sleep until now() >= ts, false if interrupted
+    void      *arg;                                    // User argument for the functions
+} TIME_CLOCK_t;
+
+// Use a different clock (NULL to use the system clock again). Should be set before anything else uses the clock, as
+// TIME() restarts at 0. Not thread-safe: the clock must only be changed while no other thread uses it (i.e. before
+// starting and after stopping any threads), and the functions of a user clock must be thread-safe if several threads
+// use the clock.
+void timeSetClock(const TIME_CLOCK_t *clock);
+
+// Virtual clock: the time only advances when sleeping, and it does so instantly. The optional advance() callback is
+// called before the time advances, so that simulated actors (e.g. a receiver) can do what they would have done in
+// the meantime (e.g. provide data). It must not sleep itself.
+// This is for tests and simulations only. It is not thread-safe, so only one thread must use it (e.g. not with
+// cfgtool record, whose writer thread uses the clock, too). And it must only be used with peers that are simulated by
+// the advance() callback. With a real peer (e.g. a receiver on a serial port) each sleep, and therefore each timeout,
+// would expire before the peer had a chance to respond. See test/test_rx.c for an example.
+typedef struct TIME_VCLOCK_s
+{
+    uint64_t   now;                                                      // Current time [ns]
+    void     (*advance)(void *arg, const uint64_t from, const uint64_t to); // Optional callback
+    void      *arg;                                                      // User argument for advance()
+    uint64_t   nSleeps;                                                  // Number of sleeps
+    uint64_t   slept;                                                    // Total time slept [ns]
+} TIME_VCLOCK_t;
+
+// Use virtual clock (NULL to use the system clock again)
+void timeSetVirtualClock(TIME_VCLOCK_t *vclock);
+
 //! Number of elements in array \hideinitializer
 #define NUMOF(x) (int)(sizeof(x)/sizeof(*(x)))
 
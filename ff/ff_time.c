@@ -86,7 +86,21 @@ double ts2posix(const double ts, const int leapSec, const bool leapSecValid)
         return ts + (double)(GPS_POSIX_OFFS - sLeapSecAtTs(ts));
     }
 }
+// ---------------------------------------------------------------------------------------------------------------------
 
+double posix2ts(const double posix, const int leapSec, const bool leapSecValid)
+{
+    if (leapSecValid)
+    {
+        return posix - (double)(GPS_POSIX_OFFS - leapSec);
+    }
+    else
+    {
+        // Leap seconds at the (approximate, off by the leap seconds) GPS time
+        const double ts = posix - (double)GPS_POSIX_OFFS;
+        return ts + (double)sLeapSecAtTs(ts + (double)sLeapSecAtTs(ts));
+    }
+}
 
 // ---------------------------------------------------------------------------------------------------------------------
 
@@ -31,6 +31,8 @@ double wnoTow2ts(const int wno, const double tow);
 
 double ts2posix(const double ts, const int leapSec, const bool leapSecValid);
 
+double posix2ts(const double posix, const int leapSec, const bool leapSecValid);
+
 double posixNow();
 
 /* ****************************************************************************************************************** */
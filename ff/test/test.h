@@ -0,0 +1,69 @@
+// clang-format off
+// flipflip's library tests
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef __FF_TEST_H__
+#define __FF_TEST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ****************************************************************************************************************** */
+
+// Minimal test framework (like ubloxcfg/test/test_ubloxcfg.c), use like this:
+//
+//     int main(int argc, char **argv)
+//     {
+//         TEST_INIT(argc, argv);
+//         TEST("what is tested", predicate);
+//         ...
+//         return TEST_DONE("test_foo");
+//     }
+
+static int gVerbosity = 0;
+static int gNumTests = 0;
+static int gNumPass = 0;
+static int gNumFail = 0;
+
+#define TEST_INIT(argc, argv) do { \
+        for (int _ix = 0; _ix < (argc); _ix++) \
+        { \
+            if (strcmp((argv)[_ix], "-v") == 0) { gVerbosity++; } \
+        } \
+    } while (0)
+
+// Assertion with result printing
+#define TEST(descr, predicate) do { gNumTests++; \
+        if (predicate) \
+        { \
+            gNumPass++; \
+            if (gVerbosity > 0) { printf("%03d PASS %s: %s [%s:%d]\n", gNumTests, descr, # predicate, __FILE__, __LINE__); } \
+        } \
+        else \
+        { \
+            gNumFail++; \
+            printf("%03d FAIL %s: %s [%s:%d]\n", gNumTests, descr, # predicate, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+// Analyse results
+#define TEST_DONE(name) ( \
+        printf("%s: %d tests: %d passed, %d failed\n", name, gNumTests, gNumPass, gNumFail), \
+        (gNumFail != 0) || (gNumTests == 0) ? EXIT_FAILURE : EXIT_SUCCESS )
+
+/* ****************************************************************************************************************** */
+#endif // __FF_TEST_H__
@@ -0,0 +1,390 @@
+// clang-format off
+// flipflip's library tests: navigation epoch signals and satellites order, epoch detection, NMEA time and date
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_ubx.h"
+#include "ff_nmea.h"
+#include "ff_parser.h"
+#include "ff_epoch.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// Random UBX-NAV-SIG and UBX-NAV-SAT messages are collected into epochs. Each signal and satellite carries its index
+// in the message (in prRes resp. azim), so that the order in the epoch can be compared to the expected order, which
+// is a stable sort by gnss, sv and signal, done here with qsort().
+
+static uint32_t gRand = 42;
+
+static uint32_t _rand(void)
+{
+    gRand = (gRand * 1103515245) + 12345;
+    return (gRand >> 8) & 0xffffff;
+}
+
+static const uint8_t kGnssIds[] = { 0, 1, 2, 3, 5, 6, 7 };
+static const uint8_t kSigIds[]  = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+typedef struct ENTRY_s
+{
+    uint64_t key;
+    int      id;
+} ENTRY_t;
+
+static int _entryCmp(const void *a, const void *b)
+{
+    const ENTRY_t *eA = (const ENTRY_t *)a;
+    const ENTRY_t *eB = (const ENTRY_t *)b;
+    if (eA->key != eB->key)
+    {
+        return eA->key < eB->key ? -1 : 1;
+    }
+    return eA->id - eB->id; // stable
+}
+
+static bool _collect(PARSER_t *parser, EPOCH_t *coll, EPOCH_t *epoch, const uint8_t *msg, const int size)
+{
+    parserAdd(parser, msg, size);
+    PARSER_MSG_t pmsg;
+    bool res = false;
+    while (parserProcess(parser, &pmsg, false))
+    {
+        if (epochCollect(coll, &pmsg, epoch))
+        {
+            res = true;
+        }
+    }
+    return res;
+}
+
+// Make an epoch with the given number of signals and satellites, and check the order
+static bool _testEpoch(const uint32_t iTow, const int nSig, const int nSat, const int maxSv)
+{
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    uint8_t *msg = malloc(UBX_FRAME_SIZE + 10000);
+    uint8_t *payload = malloc(10000);
+    if ( !epochInit(&coll) || !epochInit(&epoch) || (parser == NULL) || (msg == NULL) || (payload == NULL) )
+    {
+        epochFree(&coll);
+        epochFree(&epoch);
+        free(parser);
+        free(msg);
+        free(payload);
+        return false;
+    }
+    parserInit(parser);
+    parserSetNames(parser, false);
+
+    // UBX-NAV-SIG, random signals (with duplicates)
+    UBX_NAV_SIG_V0_GROUP0_t sigHead = { .iTOW = iTow, .version = UBX_NAV_SIG_V0_VERSION, .numSigs = nSig };
+    memcpy(payload, &sigHead, sizeof(sigHead));
+    for (int ix = 0; ix < nSig; ix++)
+    {
+        UBX_NAV_SIG_V0_GROUP1_t sig = { .gnssId = kGnssIds[_rand() % NUMOF(kGnssIds)], .svId = 1 + (_rand() % maxSv),
+            .sigId = kSigIds[_rand() % NUMOF(kSigIds)], .prRes = ix, .cno = _rand() % 60 };
+        memcpy(&payload[sizeof(sigHead) + (ix * sizeof(sig))], &sig, sizeof(sig));
+    }
+    int size = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_SIG_MSGID, payload,
+        sizeof(sigHead) + (nSig * sizeof(UBX_NAV_SIG_V0_GROUP1_t)), msg);
+    _collect(parser, &coll, &epoch, msg, size);
+    // Remember what we sent
+    UBX_NAV_SIG_V0_GROUP1_t sigs[255];
+    memcpy(sigs, &payload[sizeof(sigHead)], nSig * sizeof(*sigs));
+
+    // UBX-NAV-SAT, random satellites (no duplicates, as the receiver would do)
+    UBX_NAV_SAT_V1_GROUP0_t satHead = { .iTOW = iTow, .version = UBX_NAV_SAT_V1_VERSION, .numSvs = nSat };
+    memcpy(payload, &satHead, sizeof(satHead));
+    uint16_t svs[NUMOF(kGnssIds) * 256];
+    const int nSvs = NUMOF(kGnssIds) * maxSv;
+    for (int ix = 0; ix < nSvs; ix++)
+    {
+        svs[ix] = ix;
+    }
+    for (int ix = 0; ix < nSat; ix++)
+    {
+        const int swapIx = ix + (_rand() % (nSvs - ix));
+        const uint16_t sv = svs[swapIx];
+        svs[swapIx] = svs[ix];
+        UBX_NAV_SAT_V1_GROUP1_t sat = { .gnssId = kGnssIds[sv % NUMOF(kGnssIds)], .svId = 1 + (sv / NUMOF(kGnssIds)),
+            .azim = ix, .elev = _rand() % 90 };
+        memcpy(&payload[sizeof(satHead) + (ix * sizeof(sat))], &sat, sizeof(sat));
+    }
+    size = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_SAT_MSGID, payload,
+        sizeof(satHead) + (nSat * sizeof(UBX_NAV_SAT_V1_GROUP1_t)), msg);
+    _collect(parser, &coll, &epoch, msg, size);
+
+    // UBX-NAV-EOE, completes the epoch
+    const UBX_NAV_EOE_V0_GROUP0_t eoe = { .iTOW = iTow };
+    size = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_EOE_MSGID, (const uint8_t *)&eoe, sizeof(eoe), msg);
+    bool ok = _collect(parser, &coll, &epoch, msg, size);
+
+    // Check signals
+    const EPOCH_SIGNALS_t *eSig = &epoch.signals;
+    ok = ok && (eSig->num == nSig);
+    ENTRY_t entries[255];
+    int gnssOfId[255];
+    for (int ix = 0; ok && (ix < nSig); ix++)
+    {
+        const int id = (int)lroundf(eSig->prRes[ix] / (float)UBX_NAV_SIG_V0_PRRES_SCALE);
+        ok = (id >= 0) && (id < nSig) && (eSig->sv[ix] == sigs[id].svId) && (eSig->cno[ix] == sigs[id].cno);
+        if (ok)
+        {
+            entries[ix].key = ((uint64_t)eSig->gnss[ix] << 16) | ((uint64_t)eSig->sv[ix] << 8) | (uint64_t)eSig->signal[ix];
+            entries[ix].id = id;
+            gnssOfId[id] = eSig->gnss[ix];
+        }
+    }
+    // Same UBX gnssId must map to the same gnss
+    for (int ix = 0; ok && (ix < nSig); ix++)
+    {
+        for (int ix2 = 0; ok && (ix2 < nSig); ix2++)
+        {
+            ok = (sigs[ix].gnssId != sigs[ix2].gnssId) || (gnssOfId[ix] == gnssOfId[ix2]);
+        }
+    }
+    // Order must be the one of a stable sort
+    if (ok)
+    {
+        ENTRY_t sorted[255];
+        memcpy(sorted, entries, nSig * sizeof(*sorted));
+        qsort(sorted, nSig, sizeof(*sorted), _entryCmp);
+        for (int ix = 0; ok && (ix < nSig); ix++)
+        {
+            ok = (sorted[ix].id == entries[ix].id);
+        }
+    }
+
+    // Check satellites
+    const EPOCH_SATELLITES_t *eSat = &epoch.satellites;
+    ok = ok && (eSat->num == nSat);
+    for (int ix = 1; ok && (ix < nSat); ix++)
+    {
+        ok = (eSat->gnss[ix - 1] < eSat->gnss[ix]) ||
+            ( (eSat->gnss[ix - 1] == eSat->gnss[ix]) && (eSat->sv[ix - 1] < eSat->sv[ix]) );
+    }
+    for (int ix = 0; ok && (ix < nSat); ix++)
+    {
+        UBX_NAV_SAT_V1_GROUP1_t sat;
+        ok = (eSat->azim[ix] >= 0) && (eSat->azim[ix] < nSat);
+        if (ok)
+        {
+            memcpy(&sat, &payload[sizeof(satHead) + (eSat->azim[ix] * sizeof(sat))], sizeof(sat));
+            ok = (eSat->sv[ix] == sat.svId) && (eSat->elev[ix] == sat.elev);
+        }
+    }
+
+    // Signal to satellite index
+    for (int ix = 0; ok && (ix < nSig); ix++)
+    {
+        const int satIx = eSig->satIx[ix];
+        ok = (satIx < nSat) && ( (satIx < 0) || ((eSat->gnss[satIx] == eSig->gnss[ix]) && (eSat->sv[satIx] == eSig->sv[ix])) );
+    }
+
+    if (!ok && (gVerbosity > 0))
+    {
+        printf("iTow=%u nSig=%d/%d nSat=%d/%d\n", iTow, eSig->num, nSig, eSat->num, nSat);
+    }
+
+    epochFree(&coll);
+    epochFree(&epoch);
+    free(parser);
+    free(msg);
+    free(payload);
+    return ok;
+}
+
+// UBX-NAV-SAT with the given number of satellites, returns true if an epoch was output, and how many satellites it had
+static bool _sendSat(PARSER_t *parser, EPOCH_t *coll, EPOCH_t *epoch, const uint32_t iTow, const int nSat, int *epochNumSat)
+{
+    uint8_t payload[sizeof(UBX_NAV_SAT_V1_GROUP0_t) + (10 * sizeof(UBX_NAV_SAT_V1_GROUP1_t))];
+    const UBX_NAV_SAT_V1_GROUP0_t satHead = { .iTOW = iTow, .version = UBX_NAV_SAT_V1_VERSION, .numSvs = nSat };
+    memcpy(payload, &satHead, sizeof(satHead));
+    for (int ix = 0; ix < nSat; ix++)
+    {
+        const UBX_NAV_SAT_V1_GROUP1_t sat = { .gnssId = UBX_GNSSID_GPS, .svId = 1 + ix, .elev = 45 };
+        memcpy(&payload[sizeof(satHead) + (ix * sizeof(sat))], &sat, sizeof(sat));
+    }
+    uint8_t msg[UBX_FRAME_SIZE + sizeof(payload)];
+    const int size = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_SAT_MSGID, payload,
+        sizeof(satHead) + (nSat * sizeof(UBX_NAV_SAT_V1_GROUP1_t)), msg);
+    const bool res = _collect(parser, coll, epoch, msg, size);
+    *epochNumSat = res ? epoch->satellites.num : -1;
+    return res;
+}
+
+static bool _sendEoe(PARSER_t *parser, EPOCH_t *coll, EPOCH_t *epoch, const uint32_t iTow, int *epochNumSat)
+{
+    const UBX_NAV_EOE_V0_GROUP0_t eoe = { .iTOW = iTow };
+    uint8_t msg[UBX_FRAME_SIZE + sizeof(eoe)];
+    const int size = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_EOE_MSGID, (const uint8_t *)&eoe, sizeof(eoe), msg);
+    const bool res = _collect(parser, coll, epoch, msg, size);
+    *epochNumSat = res ? epoch->satellites.num : -1;
+    return res;
+}
+
+// Late UBX-NAV messages (with the iTOW of an epoch already output)
+static void _testLate(void)
+{
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    if ( !epochInit(&coll) || !epochInit(&epoch) || (parser == NULL) )
+    {
+        TEST("late: init", false);
+        epochFree(&coll);
+        epochFree(&epoch);
+        free(parser);
+        return;
+    }
+    parserInit(parser);
+    parserSetNames(parser, false);
+    int n = 0;
+
+    // Without expected messages a late message starts a new epoch (after UBX-NAV-EOE)
+    TEST("late: no expected, eoe", !_sendSat(parser, &coll, &epoch, 1000, 1, &n) &&
+        _sendEoe(parser, &coll, &epoch, 1000, &n) && (n == 1));
+    TEST("late: no expected, after eoe", !_sendSat(parser, &coll, &epoch, 1000, 2, &n) &&
+        _sendEoe(parser, &coll, &epoch, 1000, &n) && (n == 2));
+
+    // Without expected messages a late message starts a new epoch (after iTOW change)
+    TEST("late: no expected, itow change", !_sendSat(parser, &coll, &epoch, 2000, 1, &n) &&
+        _sendSat(parser, &coll, &epoch, 3000, 2, &n) && (n == 1));
+    TEST("late: no expected, after itow change", _sendSat(parser, &coll, &epoch, 2000, 3, &n) && (n == 2) &&
+        _sendEoe(parser, &coll, &epoch, 2000, &n) && (n == 3));
+
+    // With expected messages the epoch is output right away, late messages are skipped
+    epochSetExpected(&coll, EPOCH_EXPECT_UBX_NAV_SAT);
+    TEST("late: expected", _sendSat(parser, &coll, &epoch, 4000, 4, &n) && (n == 4));
+    TEST("late: expected, skip", !_sendSat(parser, &coll, &epoch, 4000, 5, &n) &&
+        !_sendEoe(parser, &coll, &epoch, 4000, &n));
+    TEST("late: expected, next", _sendSat(parser, &coll, &epoch, 5000, 6, &n) && (n == 6));
+
+    epochFree(&coll);
+    epochFree(&epoch);
+    free(parser);
+}
+
+// NMEA messages with empty time or date fields must not take the place of the ones with a time or date
+typedef struct NMEA_s
+{
+    const char *formatter;
+    const char *payload;
+} NMEA_t;
+
+static bool _testNmeaTime(const NMEA_t *msgs, const int numMsgs)
+{
+    EPOCH_t coll = { 0 };
+    EPOCH_t epoch = { 0 };
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    bool ok = epochInit(&coll) && epochInit(&epoch) && (parser != NULL);
+    if (ok)
+    {
+        parserInit(parser);
+        parserSetNames(parser, false);
+        int numEpochs = 0;
+        for (int ix = 0; ix < numMsgs; ix++)
+        {
+            char msg[NMEA_FRAME_SIZE + 100];
+            const int size = nmeaMakeMessage("GN", msgs[ix].formatter, msgs[ix].payload, msg);
+            if (_collect(parser, &coll, &epoch, (const uint8_t *)msg, size))
+            {
+                numEpochs++;
+            }
+        }
+        ok = (numEpochs == 1) && epoch.haveTime && (epoch.hour == 12) && (epoch.minute == 34) &&
+            (fabs(epoch.second - 56.0) < 1e-6) && epoch.haveDate && (epoch.year == 2026) && (epoch.month == 7) &&
+            (epoch.day == 19);
+        if (!ok && (gVerbosity > 0))
+        {
+            printf("numEpochs=%d time=%d %02d:%02d:%06.3f date=%d %04d-%02d-%02d\n", numEpochs, epoch.haveTime,
+                epoch.hour, epoch.minute, epoch.second, epoch.haveDate, epoch.year, epoch.month, epoch.day);
+        }
+    }
+    epochFree(&coll);
+    epochFree(&epoch);
+    free(parser);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 1 ? DEBUG_LEVEL_TRACE : DEBUG_LEVEL_WARNING;
+    debugSetup(&debugCfg);
+
+    TEST("no signals", _testEpoch(1000, 0, 0, 32));
+    TEST("one signal", _testEpoch(2000, 1, 1, 32));
+    TEST("two signals", _testEpoch(3000, 2, 2, 32));
+    TEST("max signals", _testEpoch(4000, 255, 100, 32));
+    TEST("all the same", _testEpoch(5000, 50, 1, 1) && _testEpoch(5000, 255, 1, 1));
+    TEST("large sv", _testEpoch(6000, 200, 150, 255));
+
+    int nFail = 0;
+    for (int ix = 0; ix < 200; ix++)
+    {
+        const int nSig = _rand() % 256;
+        const int maxSv = 1 + (_rand() % 64);
+        const int nSat = _rand() % 100;
+        const int nSatMax = maxSv * NUMOF(kGnssIds); // satellites must be unique
+        if (!_testEpoch(10000 + (ix * 1000), nSig, MIN(nSat, nSatMax), maxSv))
+        {
+            nFail++;
+        }
+    }
+    TEST("random epochs", nFail == 0);
+
+    _testLate();
+
+    // Time from GGA, date from RMC, the next GGA completes the epoch
+    {
+        const NMEA_t msgs[] =
+        {
+            { "GST", ",1.0,,,,0.5,0.5,1.0" },
+            { "ZDA", "123456.00,,,,00,00" },
+            { "GGA", "123456.00,4723.86200,N,00832.73000,E,1,12,0.80,402.0,M,48.0,M,," },
+            { "RMC", "123456.00,A,4723.86200,N,00832.73000,E,0.010,,190726,,,A,V" },
+            { "GGA", "123457.00,4723.86200,N,00832.73000,E,1,12,0.80,402.0,M,48.0,M,," },
+        };
+        TEST("NMEA empty GST time and ZDA date", _testNmeaTime(msgs, NUMOF(msgs)));
+    }
+    // Time and date from ZDA
+    {
+        const NMEA_t msgs[] =
+        {
+            { "GGA", ",4723.86200,N,00832.73000,E,1,12,0.80,402.0,M,48.0,M,," },
+            { "RMC", ",A,4723.86200,N,00832.73000,E,0.010,,,,,A,V" },
+            { "ZDA", "123456.00,19,07,2026,00,00" },
+            { "GGA", "123457.00,4723.86200,N,00832.73000,E,1,12,0.80,402.0,M,48.0,M,," },
+        };
+        TEST("NMEA empty GGA and RMC time", _testNmeaTime(msgs, NUMOF(msgs)));
+    }
+
+    return TEST_DONE("test_epoch");
+}
+
+/* ****************************************************************************************************************** */
+// eof
@@ -0,0 +1,364 @@
+// clang-format off
+// flipflip's library tests: epoch serialisation
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_epoch.h"
+#include "ff_epochfmt.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// The expected layouts are spelled out here (see ff_epochfmt.h) rather than derived like the implementation does
+
+#define NUM_FIELDS    44
+#define NUM_SIGCOLS   13
+
+// Binary record field offsets
+#define OFFS_TS          16
+#define OFFS_GPSTOW      24
+#define OFFS_LAT         40
+#define OFFS_UPTIME     120
+#define OFFS_PDOP       128
+#define OFFS_GPSTOWACC  132
+#define OFFS_DIFFAGE    184
+#define OFFS_SEQ        188
+#define OFFS_NUMSV      192
+#define OFFS_GPSWEEK    194
+#define OFFS_NUMSATS    204
+#define OFFS_FIX        206
+#define OFFS_FIXOK      207
+#define OFFS_LEAPS      212
+
+static uint16_t _get16(const uint8_t *p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static uint32_t _get32(const uint8_t *p)
+{
+    return (uint32_t)_get16(&p[0]) | ((uint32_t)_get16(&p[2]) << 16);
+}
+
+static uint64_t _get64(const uint8_t *p)
+{
+    return (uint64_t)_get32(&p[0]) | ((uint64_t)_get32(&p[4]) << 32);
+}
+
+static float _getF32(const uint8_t *p)
+{
+    const uint32_t u = _get32(p);
+    float v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+static double _getF64(const uint8_t *p)
+{
+    const uint64_t u = _get64(p);
+    double v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+static bool _allZero(const uint8_t *p, const int size)
+{
+    for (int ix = 0; ix < size; ix++)
+    {
+        if (p[ix] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Get n-th field of a CSV line
+static const char *_csvField(const char *line, const int n)
+{
+    static char field[100];
+    const char *p = line;
+    for (int ix = 0; (ix < n) && (p != NULL); ix++)
+    {
+        p = strchr(p, ',');
+        p = (p != NULL) ? &p[1] : NULL;
+    }
+    if (p == NULL)
+    {
+        return "<missing>";
+    }
+    const int len = strcspn(p, ",\n");
+    snprintf(field, sizeof(field), "%.*s", len, p);
+    return field;
+}
+
+static bool _csvCheck(const char *line, const int n, const char *expected)
+{
+    const char *field = _csvField(line, n);
+    const bool ok = strcmp(field, expected) == 0;
+    if (!ok && (gVerbosity > 0))
+    {
+        printf("field %d: have '%s', expected '%s'\n", n, field, expected);
+    }
+    return ok;
+}
+
+// Epoch with some fields
+static void _makeEpoch(EPOCH_t *epoch)
+{
+    epoch->valid       = true;
+    epoch->ts          = 123456789;
+    epoch->seq         = 42;
+    epoch->haveFix     = true;
+    epoch->fix         = EPOCH_FIX_S3D;
+    epoch->fixOk       = true;
+    epoch->haveGpsWeek = true;
+    epoch->gpsWeek     = 2295;
+    epoch->haveGpsTow  = true;
+    epoch->gpsTow      = 345600.1234;
+    epoch->gpsTowAcc   = 0.9999995;
+    epoch->haveVel     = true;
+    epoch->velNed[0]   = -1.5;
+    epoch->velNed[1]   = 0.00004;
+    epoch->velNed[2]   = -0.00006;
+    epoch->vel2d       = -0.99996;
+    epoch->velAcc      = INFINITY;
+    epoch->haveClock   = true;
+    epoch->clockBias   = 1.0e7;
+    epoch->clockDrift  = NAN;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 0 ? DEBUG_LEVEL_DEBUG : DEBUG_LEVEL_ERROR;
+    debugSetup(&debugCfg);
+
+    EPOCH_t epoch;
+    if (!epochInit(&epoch))
+    {
+        TEST("epochInit", false);
+        return TEST_DONE("test_epochfmt");
+    }
+    _makeEpoch(&epoch);
+
+    // Format names
+    {
+        EPOCHFMT_t fmt = EPOCHFMT_STR;
+        TEST("name csv", epochfmtFromName("csv", &fmt) && (fmt == EPOCHFMT_CSV));
+        TEST("name col", epochfmtFromName("col", &fmt) && (fmt == EPOCHFMT_COL));
+        TEST("bad name", !epochfmtFromName("xml", &fmt) && !epochfmtFromName(NULL, &fmt) && (fmt == EPOCHFMT_COL));
+    }
+
+    // Binary record
+    {
+        uint8_t rec[EPOCHFMT_BIN_SIZE + 10];
+        memset(rec, 0xaa, sizeof(rec));
+        TEST("bin: small buffer", epochfmtBin(rec, EPOCHFMT_BIN_SIZE - 1, &epoch) == 0);
+        TEST("bin: size", epochfmtBin(rec, sizeof(rec), &epoch) == EPOCHFMT_BIN_SIZE);
+        TEST("bin: header", (rec[0] == EPOCHFMT_BIN_SYNC_1) && (rec[1] == EPOCHFMT_BIN_SYNC_2) &&
+            (_get16(&rec[2]) == EPOCHFMT_BIN_SIZE) && (_get16(&rec[4]) == EPOCHFMT_VERSION) && (_get16(&rec[6]) == 0));
+        TEST("bin: no overrun", rec[EPOCHFMT_BIN_SIZE] == 0xaa);
+        // Valid: ts, seq, fix, fixOk, gpsWeek, gpsTow, gpsTowAcc, vel*, clock*, numSignals, numSatellites
+        const uint64_t valid = (UINT64_C(1) << 0) | (UINT64_C(1) << 1) | (UINT64_C(1) << 2) | (UINT64_C(1) << 3) |
+            (UINT64_C(1) << 6) | (UINT64_C(1) << 7) | (UINT64_C(1) << 8) | (UINT64_C(0x1f) << 24) |
+            (UINT64_C(1) << 28) | (UINT64_C(3) << 36) | (UINT64_C(3) << 42);
+        TEST("bin: valid", _get64(&rec[8]) == valid);
+        TEST("bin: ts", _get64(&rec[OFFS_TS]) == 123456789);
+        TEST("bin: gpsTow", _getF64(&rec[OFFS_GPSTOW]) == 345600.1234);
+        TEST("bin: gpsTowAcc", _getF32(&rec[OFFS_GPSTOWACC]) == 0.9999995f);
+        TEST("bin: seq", _get32(&rec[OFFS_SEQ]) == 42);
+        TEST("bin: gpsWeek", _get16(&rec[OFFS_GPSWEEK]) == 2295);
+        TEST("bin: fix", (rec[OFFS_FIX] == EPOCH_FIX_S3D) && (rec[OFFS_FIXOK] == 1));
+        // Invalid fields are 0
+        TEST("bin: no lat", _allZero(&rec[OFFS_LAT], 8));
+        TEST("bin: no uptime", _allZero(&rec[OFFS_UPTIME], 8));
+        TEST("bin: no pDOP", _allZero(&rec[OFFS_PDOP], 4));
+        TEST("bin: no diffAge", _allZero(&rec[OFFS_DIFFAGE], 4));
+        TEST("bin: no numSv", _allZero(&rec[OFFS_NUMSV], 2));
+        TEST("bin: no leapSeconds", rec[OFFS_LEAPS] == 0);
+        TEST("bin: padding", _allZero(&rec[EPOCHFMT_BIN_SIZE - 3], 3));
+
+        // More fields
+        epoch.haveNumSv = true;
+        epoch.numSv = 0x1234;
+        epoch.haveLeapSeconds = true;
+        epoch.leapSeconds = -3;
+        epoch.haveUptime = true;
+        epoch.uptime = 1.25;
+        epoch.satellites.num = 7;
+        epochfmtBin(rec, sizeof(rec), &epoch);
+        TEST("bin: more valid", _get64(&rec[8]) == (valid | (UINT64_C(1) << 4) | (UINT64_C(1) << 16) |
+            (UINT64_C(1) << 39)));
+        TEST("bin: numSv", (rec[OFFS_NUMSV] == 0x34) && (rec[OFFS_NUMSV + 1] == 0x12));
+        TEST("bin: leapSeconds", (int8_t)rec[OFFS_LEAPS] == -3);
+        TEST("bin: uptime", _getF64(&rec[OFFS_UPTIME]) == 1.25);
+        TEST("bin: numSatellites", _get16(&rec[OFFS_NUMSATS]) == 7);
+        epoch.haveNumSv = false;
+        epoch.haveLeapSeconds = false;
+        epoch.haveUptime = false;
+        epoch.satellites.num = 0;
+    }
+
+    // CSV
+    {
+        char str[EPOCHFMT_STR_SIZE];
+        TEST("csv: small buffer", (epochfmtCsvHeader(str, EPOCHFMT_STR_SIZE - 1) == 0) &&
+            (epochfmtCsv(str, EPOCHFMT_STR_SIZE - 1, &epoch) == 0));
+        const int hLen = epochfmtCsvHeader(str, sizeof(str));
+        TEST("csv: header", (hLen == (int)strlen(str)) && (str[hLen - 1] == '\n') &&
+            _csvCheck(str, 0, "ts") && _csvCheck(str, 17, "lat") && _csvCheck(str, NUM_FIELDS - 1, "numSatellites") &&
+            _csvCheck(str, NUM_FIELDS, "<missing>"));
+        const int len = epochfmtCsv(str, sizeof(str), &epoch);
+        TEST("csv: line", (len == (int)strlen(str)) && (str[len - 1] == '\n'));
+        TEST("csv: ts", _csvCheck(str, 0, "123456789"));
+        TEST("csv: fix", _csvCheck(str, 2, "5") && _csvCheck(str, 3, "1"));
+        TEST("csv: gpsTow", _csvCheck(str, 7, "345600.123"));
+        TEST("csv: rounding carry", _csvCheck(str, 8, "1.000000"));
+        TEST("csv: negative", _csvCheck(str, 24, "-1.5000"));
+        TEST("csv: round to zero", _csvCheck(str, 25, "0.0000"));
+        TEST("csv: small negative", _csvCheck(str, 26, "-0.0001"));
+        TEST("csv: negative carry", _csvCheck(str, 27, "-1.0000"));
+        TEST("csv: infinity", _csvCheck(str, 28, ""));
+        TEST("csv: large", _csvCheck(str, 36, "1.000000000000e+07"));
+        TEST("csv: NaN", _csvCheck(str, 37, ""));
+        TEST("csv: empty", _csvCheck(str, 4, "") && _csvCheck(str, 17, "") && _csvCheck(str, 39, ""));
+        TEST("csv: always valid", _csvCheck(str, 42, "0") && _csvCheck(str, NUM_FIELDS - 1, "0"));
+        TEST("csv: no more", _csvCheck(str, NUM_FIELDS, "<missing>"));
+    }
+
+    // JSON
+    {
+        char str[EPOCHFMT_STR_SIZE];
+        TEST("json: small buffer", epochfmtJson(str, EPOCHFMT_STR_SIZE - 1, &epoch) == 0);
+        const int len = epochfmtJson(str, sizeof(str), &epoch);
+        TEST("json: line", (len == (int)strlen(str)) && (str[0] == '{') && (strcmp(&str[len - 2], "}\n") == 0) &&
+            (strchr(str, '\n') == &str[len - 1]));
+        TEST("json: first", strncmp(str, "{\"ts\":123456789,\"seq\":42,", 25) == 0);
+        TEST("json: values", (strstr(str, ",\"gpsTowAcc\":1.000000,") != NULL) &&
+            (strstr(str, ",\"velN\":-1.5000,") != NULL) && (strstr(str, ",\"clockBias\":1.000000000000e+07,") != NULL));
+        TEST("json: null", (strstr(str, ",\"numSv\":null,") != NULL) && (strstr(str, ",\"lat\":null,") != NULL));
+        TEST("json: NaN and infinity", (strstr(str, ",\"clockDrift\":null,") != NULL) &&
+            (strstr(str, ",\"velAcc\":null,") != NULL));
+        TEST("json: last", strstr(str, ",\"numSatellites\":0}") != NULL);
+    }
+
+    // Columnar block
+    {
+        EPOCHCOL_t *col = epochcolCreate(2, false);
+        TEST("col: create", col != NULL);
+        int size = 0;
+        TEST("col: empty", epochcolFlush(col, &size) == NULL);
+        TEST("col: add", epochcolAdd(col, &epoch) && epochcolAdd(col, &epoch));
+        TEST("col: full", !epochcolAdd(col, &epoch));
+        const uint8_t *block = epochcolFlush(col, &size);
+        TEST("col: flush", block != NULL);
+        TEST("col: header", (block != NULL) && (memcmp(block, "FFEPCOL\n", 8) == 0) &&
+            (_get16(&block[8]) == EPOCHFMT_VERSION) && (_get16(&block[10]) == (1 + NUM_FIELDS)) &&
+            (_get16(&block[12]) == 0) && (_get16(&block[14]) == 0) && (_get32(&block[16]) == 2) &&
+            (_get32(&block[20]) == 0) && (_get32(&block[24]) == (uint32_t)size) && (_get32(&block[28]) == 0));
+        if (block != NULL)
+        {
+            // Walk descriptors, the column data must add up to the block size
+            const int numCols = _get16(&block[10]);
+            const uint8_t *desc = &block[32];
+            int offs = 32 + (numCols * EPOCHFMT_COL_DESC_SIZE);
+            TEST("col: valid desc", (strcmp((const char *)&desc[0], "valid") == 0) && (desc[20] == EPOCHFMT_TYPE_U64) &&
+                (desc[21] == 8) && (_get16(&desc[22]) == 0));
+            TEST("col: valid data", _get64(&block[offs]) == _get64(&block[offs + 8]) &&
+                ((_get64(&block[offs]) & 0x3) == 0x3));
+            desc = &block[32 + EPOCHFMT_COL_DESC_SIZE];
+            TEST("col: ts desc", (strcmp((const char *)desc, "ts") == 0) && (desc[20] == EPOCHFMT_TYPE_U64) &&
+                (desc[21] == 8));
+            TEST("col: ts data", (_get64(&block[offs + 16]) == 123456789) && (_get64(&block[offs + 24]) == 123456789));
+            desc = &block[32 + (2 * EPOCHFMT_COL_DESC_SIZE)];
+            TEST("col: seq desc", (strcmp((const char *)desc, "seq") == 0) && (desc[20] == EPOCHFMT_TYPE_U32) &&
+                (desc[21] == 4));
+            TEST("col: seq data", (_get32(&block[offs + 32]) == 42) && (_get32(&block[offs + 36]) == 42));
+            desc = &block[32 + (numCols - 1) * EPOCHFMT_COL_DESC_SIZE];
+            TEST("col: last desc", (strcmp((const char *)desc, "numSatellites") == 0) &&
+                (desc[20] == EPOCHFMT_TYPE_U16) && (desc[21] == 2));
+            for (int ix = 0; ix < numCols; ix++)
+            {
+                offs += ((2 * block[32 + (ix * EPOCHFMT_COL_DESC_SIZE) + 21]) + 7) & ~7;
+            }
+            TEST("col: block size", offs == size);
+        }
+        TEST("col: flushed", (epochcolFlush(col, &size) == NULL) && epochcolAdd(col, &epoch));
+        epochcolDestroy(col);
+    }
+
+    // Columnar block with signals
+    {
+        EPOCHCOL_t *col = epochcolCreate(0, true);
+        epoch.signals.num = 2;
+        epoch.signals.gnss[1] = EPOCH_GNSS_GAL;
+        epoch.signals.sv[1] = 12;
+        epoch.signals.gloFcn[1] = -7;
+        epoch.signals.prUsed[1] = true;
+        epoch.signals.doUsed[1] = true;
+        epoch.signals.cno[1] = 42.5f;
+        TEST("colsig: add", epochcolAdd(col, &epoch));
+        epoch.signals.num = 1;
+        TEST("colsig: add more", epochcolAdd(col, &epoch));
+        epoch.signals.num = 0;
+        int size = 0;
+        const uint8_t *block = epochcolFlush(col, &size);
+        TEST("colsig: header", (block != NULL) && (_get16(&block[10]) == (1 + NUM_FIELDS)) &&
+            (_get16(&block[12]) == NUM_SIGCOLS) && (_get32(&block[16]) == 2) && (_get32(&block[20]) == 3) &&
+            (_get32(&block[24]) == (uint32_t)size));
+        if (block != NULL)
+        {
+            const int numCols = _get16(&block[10]) + _get16(&block[12]);
+            int offs = 32 + (numCols * EPOCHFMT_COL_DESC_SIZE);
+            const uint8_t *data[NUM_SIGCOLS];
+            for (int ix = 0; ix < numCols; ix++)
+            {
+                const uint8_t *desc = &block[32 + (ix * EPOCHFMT_COL_DESC_SIZE)];
+                const int sigIx = ix - (1 + NUM_FIELDS);
+                if (sigIx >= 0)
+                {
+                    data[sigIx] = &block[offs];
+                }
+                offs += (((sigIx >= 0 ? 3 : 2) * desc[21]) + 7) & ~7;
+            }
+            TEST("colsig: block size", offs == size);
+            const uint8_t *desc = &block[32 + ((1 + NUM_FIELDS) * EPOCHFMT_COL_DESC_SIZE)];
+            TEST("colsig: epoch desc", (strcmp((const char *)desc, "epoch") == 0) && (desc[20] == EPOCHFMT_TYPE_U32));
+            desc = &block[32 + ((numCols - 1) * EPOCHFMT_COL_DESC_SIZE)];
+            TEST("colsig: last desc", (strcmp((const char *)desc, "prRes") == 0) && (desc[20] == EPOCHFMT_TYPE_F32));
+            TEST("colsig: epoch", (_get32(&data[0][0]) == 0) && (_get32(&data[0][4]) == 0) && (_get32(&data[0][8]) == 1));
+            TEST("colsig: signal", (data[1][1] == EPOCH_GNSS_GAL) && (data[2][1] == 12) && ((int8_t)data[5][1] == -7) &&
+                (data[10][1] == 0x05) && (_getF32(&data[11][4]) == 42.5f));
+        }
+        epochcolDestroy(col);
+    }
+
+    epochFree(&epoch);
+
+    return TEST_DONE("test_epochfmt");
+}
+
+/* ****************************************************************************************************************** */
+// eof
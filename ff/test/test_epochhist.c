@@ -0,0 +1,306 @@
+// clang-format off
+// flipflip's library tests: navigation epoch history
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_trafo.h"
+#include "ff_epoch.h"
+#include "ff_epochhist.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// Random epochs are added to the history, and after each epoch the (incremental) statistics are compared to the
+// statistics calculated from scratch over the epochs in the window.
+
+#define NUM_EPOCHS 2000
+
+typedef struct REF_s
+{
+    uint64_t ts;
+    bool     fixOk;
+    EPOCH_FIX_t fix;
+    bool     havePos;
+    double   horizAcc;
+    double   east;
+    double   north;
+    bool     haveHist;
+    int      hist[EPOCH_SIGCNOHIST_NUM];
+} REF_t;
+
+static uint32_t gRand = 42;
+
+static uint32_t _rand(void)
+{
+    gRand = (gRand * 1103515245) + 12345;
+    return (gRand >> 8) & 0xffffff;
+}
+
+static const double kLlhRef[3] = { 0.8267, 0.1490, 450.0 }; // ~47.4N, ~8.5E
+static double gXyzRef[3];
+
+static void _makeRef(REF_t *ref, const uint64_t ts)
+{
+    memset(ref, 0, sizeof(*ref));
+    ref->ts       = ts;
+    ref->fix      = (EPOCH_FIX_t)(_rand() % (EPOCH_FIX_RTK_FIXED_DR + 1));
+    ref->fixOk    = (ref->fix > EPOCH_FIX_NOFIX) && ((_rand() % 10) != 0);
+    ref->havePos  = (ref->fix > EPOCH_FIX_NOFIX);
+    ref->horizAcc = (double)(_rand() % 100000) * 1e-3;
+    ref->east     = ((double)(_rand() % 10000) * 1e-3) - 5.0;
+    ref->north    = ((double)(_rand() % 10000) * 1e-3) - 5.0;
+    ref->haveHist = ((_rand() % 5) != 0);
+    for (int bin = 0; bin < EPOCH_SIGCNOHIST_NUM; bin++)
+    {
+        ref->hist[bin] = _rand() % 20;
+    }
+}
+
+static void _add(EPOCHHIST_t *hist, const REF_t *ref)
+{
+    EPOCH_t epoch = { .valid = true };
+    epoch.ts       = ref->ts;
+    epoch.haveFix  = true;
+    epoch.fix      = ref->fix;
+    epoch.fixOk    = ref->fixOk;
+    epoch.havePos  = ref->havePos;
+    epoch.horizAcc = ref->horizAcc;
+    const double enu[3] = { ref->east, ref->north, 0.0 };
+    enu2xyz_vec(enu, gXyzRef, kLlhRef, epoch.xyz);
+    epoch.haveSigCnoHist = ref->haveHist;
+    for (int bin = 0; bin < EPOCH_SIGCNOHIST_NUM; bin++)
+    {
+        epoch.sigCnoHistTrk[bin] = ref->hist[bin];
+        epoch.sigCnoHistNav[bin] = ref->hist[bin] / 2;
+    }
+    epochhistAdd(hist, &epoch);
+}
+
+static double _std(const double sum, const double sum2, const int n)
+{
+    if (n <= 0)
+    {
+        return 0.0;
+    }
+    const double mean = sum / (double)n;
+    const double var = (sum2 / (double)n) - (mean * mean);
+    return var > 0.0 ? sqrt(var) : 0.0;
+}
+
+static bool _near(const double a, const double b)
+{
+    return fabs(a - b) < 1e-6;
+}
+
+// Compare statistics to the statistics calculated from the refs[first..last]
+static bool _check(const EPOCHHIST_STATS_t *stats, const REF_t *refs, const int first, const int last)
+{
+    EPOCHHIST_STATS_t exp = { .numEpochs = last - first + 1 };
+    exp.span = refs[last].ts - refs[first].ts;
+    double haccSum = 0.0, haccSum2 = 0.0;
+    double eSum = 0.0, eSum2 = 0.0, nSum = 0.0, nSum2 = 0.0;
+    for (int ix = first; ix <= last; ix++)
+    {
+        const REF_t *ref = &refs[ix];
+        if (ref->fixOk)
+        {
+            exp.numFixOk++;
+            exp.numRtkFloat += ( (ref->fix == EPOCH_FIX_RTK_FLOAT) || (ref->fix == EPOCH_FIX_RTK_FLOAT_DR) ) ? 1 : 0;
+            exp.numRtkFixed += ( (ref->fix == EPOCH_FIX_RTK_FIXED) || (ref->fix == EPOCH_FIX_RTK_FIXED_DR) ) ? 1 : 0;
+        }
+        if (ref->havePos)
+        {
+            exp.numHorizAcc++;
+            haccSum += ref->horizAcc;
+            haccSum2 += ref->horizAcc * ref->horizAcc;
+            exp.horizAccMax = MAX(exp.horizAccMax, ref->horizAcc);
+            if (ref->fixOk)
+            {
+                exp.numPos++;
+                eSum += ref->east;
+                eSum2 += ref->east * ref->east;
+                nSum += ref->north;
+                nSum2 += ref->north * ref->north;
+            }
+        }
+        if (ref->haveHist)
+        {
+            exp.numSigCnoHist++;
+            for (int bin = 0; bin < EPOCH_SIGCNOHIST_NUM; bin++)
+            {
+                exp.sigCnoHistTrk[bin] += ref->hist[bin];
+                exp.sigCnoHistNav[bin] += ref->hist[bin] / 2;
+            }
+        }
+    }
+    exp.horizAccMean = exp.numHorizAcc > 0 ? haccSum / (double)exp.numHorizAcc : 0.0;
+    exp.horizAccStd  = _std(haccSum, haccSum2, exp.numHorizAcc);
+    exp.posStdEast   = _std(eSum, eSum2, exp.numPos);
+    exp.posStdNorth  = _std(nSum, nSum2, exp.numPos);
+
+    bool ok = (stats->numEpochs == exp.numEpochs) && (stats->span == exp.span) &&
+        (stats->numFixOk == exp.numFixOk) && (stats->numRtkFloat == exp.numRtkFloat) &&
+        (stats->numRtkFixed == exp.numRtkFixed) &&
+        _near(stats->fixRate, (double)exp.numFixOk / (double)exp.numEpochs) &&
+        (stats->numHorizAcc == exp.numHorizAcc) && _near(stats->horizAccMean, exp.horizAccMean) &&
+        _near(stats->horizAccStd, exp.horizAccStd) && (stats->horizAccMax == exp.horizAccMax) &&
+        (stats->numPos == exp.numPos) &&
+        (fabs(stats->posStdEast - exp.posStdEast) < 1e-4) && (fabs(stats->posStdNorth - exp.posStdNorth) < 1e-4) &&
+        (stats->numSigCnoHist == exp.numSigCnoHist) &&
+        (memcmp(stats->sigCnoHistTrk, exp.sigCnoHistTrk, sizeof(exp.sigCnoHistTrk)) == 0) &&
+        (memcmp(stats->sigCnoHistNav, exp.sigCnoHistNav, sizeof(exp.sigCnoHistNav)) == 0);
+    if (!ok && (gVerbosity > 0))
+    {
+        printf("window %d..%d: numEpochs=%d/%d numFixOk=%d/%d horizAcc=%d/%d %.6f/%.6f %.6f/%.6f %.3f/%.3f"
+            " pos=%d/%d %.6f/%.6f %.6f/%.6f\n", first, last, stats->numEpochs, exp.numEpochs,
+            stats->numFixOk, exp.numFixOk, stats->numHorizAcc, exp.numHorizAcc, stats->horizAccMean, exp.horizAccMean,
+            stats->horizAccStd, exp.horizAccStd, stats->horizAccMax, exp.horizAccMax, stats->numPos, exp.numPos,
+            stats->posStdEast, exp.posStdEast, stats->posStdNorth, exp.posStdNorth);
+    }
+    return ok;
+}
+
+// Add random epochs and check the statistics after each of them
+static bool _testRandom(const int size, const uint32_t window, const uint32_t dtMax)
+{
+    EPOCHHIST_t *hist = epochhistCreate(size, window);
+    REF_t *refs = malloc(NUM_EPOCHS * sizeof(REF_t));
+    bool ok = (hist != NULL) && (refs != NULL);
+    uint64_t ts = UINT64_C(1000000000);
+    int first = 0;
+    for (int ix = 0; ok && (ix < NUM_EPOCHS); ix++)
+    {
+        ts += 1 + (_rand() % dtMax);
+        _makeRef(&refs[ix], ts);
+        _add(hist, &refs[ix]);
+        while ( ((ix - first + 1) > size) || ((window > 0) && ((ts - refs[first].ts) > window)) )
+        {
+            first++;
+        }
+        EPOCHHIST_STATS_t stats;
+        epochhistStats(hist, &stats);
+        ok = _check(&stats, refs, first, ix);
+    }
+    epochhistDestroy(hist);
+    free(refs);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 1 ? DEBUG_LEVEL_TRACE : DEBUG_LEVEL_WARNING;
+    debugSetup(&debugCfg);
+
+    llh2xyz_vec(kLlhRef, gXyzRef);
+
+    // The statistics must not depend on the system time, only on the epochs' ts
+    TIME_VCLOCK_t vclock = { .now = 0 };
+    timeSetVirtualClock(&vclock);
+
+    // Empty history
+    {
+        EPOCHHIST_t *hist = epochhistCreate(0, 0);
+        EPOCHHIST_STATS_t stats;
+        memset(&stats, 0xff, sizeof(stats));
+        epochhistStats(hist, &stats);
+        TEST("empty", (hist != NULL) && (stats.numEpochs == 0) && (stats.span == 0) && (stats.fixRate == 0.0));
+        epochhistDestroy(hist);
+        epochhistDestroy(NULL);
+    }
+
+    // Window limited by size, by time, or both
+    TEST("size 1", _testRandom(1, 0, 100));
+    TEST("size 10", _testRandom(10, 0, 100));
+    TEST("size 500", _testRandom(500, 0, 100));
+    TEST("size > num", _testRandom(NUM_EPOCHS + 1, 0, 100));
+    TEST("window 1s", _testRandom(NUM_EPOCHS, 1000, 100));
+    TEST("window 10s", _testRandom(NUM_EPOCHS, 10000, 500));
+    TEST("window and size", _testRandom(50, 3000, 100));
+    TEST("window < dt", _testRandom(100, 50, 100));
+
+    // Window boundary, and stats later (system time far ahead of the epochs' ts)
+    {
+        EPOCHHIST_t *hist = epochhistCreate(100, 1000);
+        REF_t ref;
+        for (int ix = 0; ix <= 20; ix++)
+        {
+            _makeRef(&ref, UINT64_C(5000000) + (ix * 100));
+            _add(hist, &ref);
+        }
+        EPOCHHIST_STATS_t stats;
+        epochhistStats(hist, &stats);
+        TEST("window boundary", (stats.numEpochs == 11) && (stats.span == 1000));
+        SLEEP(60000);
+        epochhistStats(hist, &stats);
+        TEST("window stats later", (stats.numEpochs == 11) && (stats.span == 1000));
+        epochhistClear(hist);
+        epochhistStats(hist, &stats);
+        TEST("clear", stats.numEpochs == 0);
+        _makeRef(&ref, 100);
+        _add(hist, &ref);
+        epochhistStats(hist, &stats);
+        TEST("add after clear", (stats.numEpochs == 1) && (stats.span == 0));
+        epochhistDestroy(hist);
+    }
+
+    // Max. of a decreasing and increasing sequence
+    {
+        EPOCHHIST_t *hist = epochhistCreate(5, 0);
+        REF_t ref;
+        EPOCHHIST_STATS_t stats;
+        bool okDec = true;
+        bool okInc = true;
+        for (int ix = 0; ix < 20; ix++)
+        {
+            _makeRef(&ref, 1000 + ix);
+            ref.fix = EPOCH_FIX_S3D;
+            ref.havePos = true;
+            ref.horizAcc = 100.0 - ix;
+            _add(hist, &ref);
+            epochhistStats(hist, &stats);
+            okDec = okDec && (stats.horizAccMax == (100.0 - MAX(0, ix - 4)));
+        }
+        for (int ix = 0; ix < 20; ix++)
+        {
+            _makeRef(&ref, 2000 + ix);
+            ref.fix = EPOCH_FIX_S3D;
+            ref.havePos = true;
+            ref.horizAcc = ix;
+            _add(hist, &ref);
+            epochhistStats(hist, &stats);
+            okInc = okInc && (stats.horizAccMax == (ix < 4 ? 100.0 - 16 - ix : ix));
+        }
+        TEST("max decreasing", okDec);
+        TEST("max increasing", okInc);
+        epochhistDestroy(hist);
+    }
+
+    timeSetVirtualClock(NULL);
+
+    return TEST_DONE("test_epochhist");
+}
+
+/* ****************************************************************************************************************** */
+// eof
@@ -0,0 +1,228 @@
+// clang-format off
+// flipflip's library tests: epoch synchroniser
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_epoch.h"
+#include "ff_epochsync.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// The epochs are marked with the source and a number (in numSv), to check that the right epochs come out
+
+static EPOCH_t gEpoch;
+
+static bool _add(EPOCHSYNC_t *sync, const int source, const int week, const double tow, const int mark)
+{
+    gEpoch.valid       = true;
+    gEpoch.haveGpsWeek = (week >= 0);
+    gEpoch.gpsWeek     = week;
+    gEpoch.haveGpsTow  = true;
+    gEpoch.gpsTow      = tow;
+    gEpoch.haveNumSv   = true;
+    gEpoch.numSv       = (source * 1000) + mark;
+    return epochsyncAdd(sync, source, &gEpoch);
+}
+
+// Check that the set has the given epochs (mark, or -1 for missing)
+static bool _check(const EPOCHSYNC_SET_t *set, const int mark0, const int mark1, const int mark2)
+{
+    const int marks[3] = { mark0, mark1, mark2 };
+    bool ok = true;
+    for (int ix = 0; ok && (ix < set->numSources); ix++)
+    {
+        if (marks[ix] < 0)
+        {
+            ok = (set->epochs[ix] == NULL) && ((set->missing & (1 << ix)) != 0) && ((set->present & (1 << ix)) == 0);
+        }
+        else
+        {
+            ok = (set->epochs[ix] != NULL) && (set->epochs[ix]->numSv == ((ix * 1000) + marks[ix])) &&
+                ((set->present & (1 << ix)) != 0) && ((set->missing & (1 << ix)) == 0);
+        }
+    }
+    if (!ok && (gVerbosity > 0))
+    {
+        printf("set %u: present=%08x missing=%08x epochs=%d %d %d\n", set->seq, set->present, set->missing,
+            set->epochs[0] != NULL ? set->epochs[0]->numSv : -1, set->epochs[1] != NULL ? set->epochs[1]->numSv : -1,
+            set->epochs[2] != NULL ? set->epochs[2]->numSv : -1);
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 0 ? DEBUG_LEVEL_DEBUG : DEBUG_LEVEL_ERROR;
+    debugSetup(&debugCfg);
+
+    // The wait time is tested with the virtual clock
+    TIME_VCLOCK_t vclock = { .now = 0 };
+    timeSetVirtualClock(&vclock);
+
+    if (!epochInit(&gEpoch))
+    {
+        TEST("epochInit", false);
+        return TEST_DONE("test_epochsync");
+    }
+    EPOCHSYNC_SET_t set;
+    EPOCHSYNC_STATS_t stats;
+
+    // Bad parameters
+    {
+        TEST("no sources", epochsyncCreate(0, 0, 0.0, 0) == NULL);
+        TEST("too many sources", epochsyncCreate(EPOCHSYNC_MAX_SOURCES + 1, 0, 0.0, 0) == NULL);
+        TEST("bad ring size", epochsyncCreate(2, -1, 0.0, 0) == NULL);
+        TEST("bad tolerance", epochsyncCreate(2, 0, -1.0, 0) == NULL);
+        epochsyncDestroy(NULL);
+    }
+
+    // Complete sets
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(3, 0, 0.0, 0);
+        TEST("create", sync != NULL);
+        TEST("empty", !epochsyncGet(sync, &set, false) && !epochsyncGet(sync, &set, true));
+        TEST("add", _add(sync, 0, 2000, 100.0, 1) && _add(sync, 2, 2000, 100.002, 1));
+        TEST("add: epoch swapped", !gEpoch.valid && (gEpoch.signals.max == EPOCH_DEF_MAX_SIGNALS));
+        TEST("waiting", !epochsyncGet(sync, &set, false));
+        TEST("add last", _add(sync, 1, 2000, 99.995, 1));
+        TEST("complete", epochsyncGet(sync, &set, false) && set.complete && (set.numPresent == 3) && (set.seq == 1) &&
+            _check(&set, 1, 1, 1) && (set.gpsWeek == 2000));
+        TEST("only once", !epochsyncGet(sync, &set, false));
+        // Some epochs in advance
+        for (int ix = 2; ix < 6; ix++)
+        {
+            _add(sync, 0, 2000, 100.0 + (ix - 1), ix);
+            _add(sync, 1, 2000, 100.0 + (ix - 1), ix);
+        }
+        _add(sync, 2, 2000, 101.0, 2);
+        TEST("complete 2", epochsyncGet(sync, &set, false) && set.complete && _check(&set, 2, 2, 2));
+        TEST("waiting 3", !epochsyncGet(sync, &set, false));
+        _add(sync, 2, 2000, 102.0, 3);
+        _add(sync, 2, 2000, 103.0, 4);
+        TEST("complete 3", epochsyncGet(sync, &set, false) && _check(&set, 3, 3, 3));
+        TEST("complete 4", epochsyncGet(sync, &set, false) && _check(&set, 4, 4, 4));
+        TEST("waiting 5", !epochsyncGet(sync, &set, false));
+        TEST("flush 5", epochsyncGet(sync, &set, true) && !set.complete && _check(&set, 5, 5, -1));
+        TEST("flushed", !epochsyncGet(sync, &set, true));
+        epochsyncStats(sync, &stats);
+        TEST("stats", (stats.nSets == 5) && (stats.nComplete == 4) && (stats.nIncomplete == 1) &&
+            (stats.sources[0].nAdded == 5) && (stats.sources[2].nAdded == 4) && (stats.sources[2].nMissing == 1) &&
+            (stats.sources[2].nPresent == 4));
+        epochsyncDestroy(sync);
+    }
+
+    // Wait time
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(3, 0, 0.0, 500);
+        _add(sync, 0, 2000, 200.0, 1);
+        SLEEP(300);
+        _add(sync, 1, 2000, 200.0, 1);
+        TEST("wait", !epochsyncGet(sync, &set, false));
+        SLEEP(199);
+        TEST("wait more", !epochsyncGet(sync, &set, false));
+        SLEEP(1);
+        TEST("waited", epochsyncGet(sync, &set, false) && !set.complete && _check(&set, 1, 1, -1));
+        TEST("late", !_add(sync, 2, 2000, 200.0, 1) && !_add(sync, 2, 2000, 199.0, 1));
+        TEST("not late", _add(sync, 2, 2000, 201.0, 2));
+        TEST("missing", !epochsyncGet(sync, &set, false));
+        TEST("flush", epochsyncGet(sync, &set, true) && _check(&set, -1, -1, 2));
+        epochsyncStats(sync, &stats);
+        TEST("stats late", (stats.sources[2].nLate == 2) && (stats.sources[2].nAdded == 1));
+        epochsyncDestroy(sync);
+    }
+
+    // A source that is ahead makes the others missing
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(2, 0, 0.0, 0);
+        _add(sync, 0, 2000, 300.0, 1);
+        _add(sync, 1, 2000, 301.0, 2);
+        TEST("ahead", epochsyncGet(sync, &set, false) && _check(&set, 1, -1, 0) && (set.gpsTow == 300.0));
+        TEST("ahead waiting", !epochsyncGet(sync, &set, false));
+        _add(sync, 0, 2000, 301.0, 2);
+        TEST("ahead complete", epochsyncGet(sync, &set, false) && set.complete && _check(&set, 2, 2, 0));
+        epochsyncDestroy(sync);
+    }
+
+    // Tolerance
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(2, 0, 0.05, 0);
+        _add(sync, 0, 2000, 400.0, 1);
+        _add(sync, 1, 2000, 400.049, 1);
+        TEST("within tolerance", epochsyncGet(sync, &set, false) && set.complete && _check(&set, 1, 1, 0));
+        _add(sync, 0, 2000, 401.0, 2);
+        _add(sync, 1, 2000, 401.06, 2);
+        TEST("outside tolerance", epochsyncGet(sync, &set, false) && _check(&set, 2, -1, 0));
+        TEST("outside tolerance 2", epochsyncGet(sync, &set, true) && _check(&set, -1, 2, 0));
+        epochsyncDestroy(sync);
+    }
+
+    // Week rollover
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(2, 0, 0.0, 0);
+        _add(sync, 0, 2000, 604799.5, 1);
+        _add(sync, 0, 2001, 0.0, 2);
+        _add(sync, 1, 2000, 604799.5, 1);
+        _add(sync, 1, 2001, 0.0, 2);
+        TEST("week end", epochsyncGet(sync, &set, false) && _check(&set, 1, 1, 0) && (set.gpsWeek == 2000));
+        TEST("week start", epochsyncGet(sync, &set, false) && _check(&set, 2, 2, 0) && (set.gpsWeek == 2001) &&
+            (set.gpsTow == 0.0));
+        epochsyncDestroy(sync);
+    }
+
+    // No time, bad source
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(2, 0, 0.0, 0);
+        TEST("no time", !_add(sync, 0, -1, 100.0, 1));
+        TEST("bad source", !_add(sync, 2, 2000, 100.0, 1) && !_add(sync, -1, 2000, 100.0, 1));
+        TEST("no epoch", !epochsyncGet(sync, &set, true));
+        epochsyncStats(sync, &stats);
+        TEST("stats no time", (stats.sources[0].nNoTime == 1) && (stats.sources[0].nAdded == 0));
+        epochsyncDestroy(sync);
+    }
+
+    // Ring full
+    {
+        EPOCHSYNC_t *sync = epochsyncCreate(2, 4, 0.0, 0);
+        for (int ix = 1; ix <= 6; ix++)
+        {
+            _add(sync, 0, 2000, 500.0 + ix, ix);
+        }
+        epochsyncStats(sync, &stats);
+        TEST("ring full: dropped", (stats.sources[0].nDropped == 2) && (stats.sources[0].nAdded == 6));
+        TEST("ring full: output", epochsyncGet(sync, &set, false) && _check(&set, 3, -1, 0));
+        TEST("ring full: not full", !epochsyncGet(sync, &set, false));
+        _add(sync, 0, 2000, 507.0, 7);
+        TEST("ring full again", epochsyncGet(sync, &set, false) && _check(&set, 4, -1, 0));
+        epochsyncDestroy(sync);
+    }
+
+    epochFree(&gEpoch);
+    timeSetVirtualClock(NULL);
+
+    return TEST_DONE("test_epochsync");
+}
+
+/* ****************************************************************************************************************** */
+// eof
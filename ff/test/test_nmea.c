@@ -0,0 +1,252 @@
+// clang-format off
+// flipflip's library tests: NMEA decoding
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_nmea.h"
+#include "ff_parser.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// The field parsers are static, so they are tested through nmeaDecode(). The numbers are compared to what strtod()
+// makes of the same string, which is what the decoder used before (by way of sscanf()).
+
+static NMEA_MSG_t gNmea;
+
+// Make a message from the payload and decode it
+static bool _decode(const char *formatter, const char *payload)
+{
+    char msg[NMEA_FRAME_SIZE + 200];
+    const int size = nmeaMakeMessage("GN", formatter, payload, msg);
+    return nmeaDecode(&gNmea, (const uint8_t *)msg, size);
+}
+
+// Decode GGA with the given altitude field (a field without range checks)
+static bool _decodeAlt(const char *alt)
+{
+    char payload[200];
+    snprintf(payload, sizeof(payload), "123456.00,4723.12345,N,00832.12345,E,1,12,0.9,%s,M,47.0,M,,", alt);
+    return _decode("GGA", payload);
+}
+
+// Check that the altitude field decodes to exactly the same value as strtod() gives
+static bool _altIsStrtod(const char *alt)
+{
+    return _decodeAlt(alt) && (gNmea.gga.height == strtod(alt, NULL));
+}
+
+// Run a sentence through the parser, returns true if it was detected as a NMEA message
+static bool _parserNmea(const char *sentence)
+{
+    PARSER_t parser;
+    parserInit(&parser);
+    parserAdd(&parser, (const uint8_t *)sentence, strlen(sentence));
+    PARSER_MSG_t msg;
+    return parserProcess(&parser, &msg, true) && (msg.type == PARSER_MSGTYPE_NMEA) && (msg.size == (int)strlen(sentence));
+}
+
+static bool _near(const double a, const double b)
+{
+    return fabs(a - b) < 1e-12;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 1 ? DEBUG_LEVEL_TRACE : DEBUG_LEVEL_WARNING;
+    debugSetup(&debugCfg);
+
+    // Numbers, compared to strtod()
+    {
+        TEST("integer", _altIsStrtod("123"));
+        TEST("decimal", _altIsStrtod("123.45"));
+        TEST("trailing dot", _altIsStrtod("123."));
+        TEST("leading dot", _altIsStrtod(".45"));
+        TEST("zero", _altIsStrtod("0"));
+        TEST("zero decimals", _altIsStrtod("0.000"));
+        TEST("leading zeros", _altIsStrtod("000123.4500"));
+        TEST("negative", _altIsStrtod("-123.45"));
+        TEST("negative zero", _altIsStrtod("-0.0") && signbit(gNmea.gga.height));
+        TEST("positive", _altIsStrtod("+123.45"));
+        TEST("many decimals", _altIsStrtod("0.123456789012345"));
+        TEST("large", _altIsStrtod("9007199254740992"));
+        TEST("large with decimals", _altIsStrtod("90071992547.40992"));
+        TEST("not exact in binary", _altIsStrtod("0.1") && _altIsStrtod("0.3") && _altIsStrtod("1234.567"));
+
+        // Exhaustive-ish: all numbers with up to 4 integer and 3 fractional digits in some steps
+        int nFail = 0;
+        int nTest = 0;
+        for (int intPart = 0; intPart < 10000; intPart += 7)
+        {
+            for (int nFrac = 0; nFrac <= 3; nFrac++)
+            {
+                for (int frac = 0; frac < 1000; frac += 13)
+                {
+                    char str[50];
+                    switch (nFrac)
+                    {
+                        case 0: snprintf(str, sizeof(str), "%d", intPart); break;
+                        case 1: snprintf(str, sizeof(str), "%d.%01d", intPart, frac % 10); break;
+                        case 2: snprintf(str, sizeof(str), "%d.%02d", intPart, frac % 100); break;
+                        case 3: snprintf(str, sizeof(str), "-%d.%03d", intPart, frac); break;
+                    }
+                    nTest++;
+                    if (!_altIsStrtod(str))
+                    {
+                        nFail++;
+                        if (gVerbosity > 0)
+                        {
+                            printf("mismatch: %s -> %.17g != %.17g\n", str, gNmea.gga.height, strtod(str, NULL));
+                        }
+                    }
+                }
+            }
+        }
+        TEST("many numbers", (nTest > 10000) && (nFail == 0));
+    }
+
+    // Numbers that are rejected
+    {
+        TEST("empty field is not a number", _decodeAlt("") && (gNmea.gga.height == 0.0));
+        TEST("reject sign only", !_decodeAlt("-") && !_decodeAlt("+"));
+        TEST("reject dot only", !_decodeAlt(".") && !_decodeAlt("-."));
+        TEST("reject two dots", !_decodeAlt("1.2.3"));
+        TEST("reject two signs", !_decodeAlt("--1") && !_decodeAlt("+-1"));
+        TEST("reject sign inside", !_decodeAlt("1-2"));
+        TEST("reject exponent", !_decodeAlt("1e3") && !_decodeAlt("1.5E-2"));
+        TEST("reject inf/nan", !_decodeAlt("inf") && !_decodeAlt("nan"));
+        TEST("reject hex", !_decodeAlt("0x10"));
+        TEST("reject spaces", !_decodeAlt(" 1") && !_decodeAlt("1 "));
+        TEST("reject letters", !_decodeAlt("12a"));
+        TEST("reject too many digits", !_decodeAlt("9007199254740993") && !_decodeAlt("123456789012345678901234567890"));
+        TEST("reject too many decimals", !_decodeAlt("0.00000000000000000000001"));
+    }
+
+    // Integers
+    {
+        TEST("int numSv", _decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,07,0.9,500.0,M,47.0,M,,") && (gNmea.gga.numSv == 7));
+        TEST("int empty", _decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,,0.9,500.0,M,47.0,M,,") && (gNmea.gga.numSv == 0));
+        TEST("int negative out of range", !_decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,-1,0.9,500.0,M,47.0,M,,"));
+        TEST("int decimal", !_decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,7.0,0.9,500.0,M,47.0,M,,"));
+        TEST("int overflow", !_decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,12345678901,0.9,500.0,M,47.0,M,,"));
+        TEST("int signed", _decode("ZDA", "123456.00,02,01,2024,-02,30") && (gNmea.zda.ltzh == -2) && (gNmea.zda.ltzn == 30));
+        TEST("int plus", _decode("ZDA", "123456.00,02,01,2024,+02,00") && (gNmea.zda.ltzh == 2));
+        TEST("int range", !_decode("ZDA", "123456.00,02,01,2024,14,00") && !_decode("ZDA", "123456.00,02,01,2024,00,60"));
+    }
+
+    // Latitude and longitude
+    {
+        TEST("GGA latlon", _decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,,") &&
+            _near(gNmea.gga.lat, 47.0 + (strtod("23.12345", NULL) / 60.0)) &&
+            _near(gNmea.gga.lon,  8.0 + (strtod("32.12345", NULL) / 60.0)) && (gNmea.gga.fix == NMEA_FIX_S3D));
+        TEST("GGA south west", _decode("GGA", "123456.00,4723.12345,S,00832.12345,W,1,12,0.9,500.0,M,47.0,M,,") &&
+            (gNmea.gga.lat < -47.0) && (gNmea.gga.lon < -8.0));
+        TEST("GGA latlon no decimals", _decode("GGA", "123456.00,4723,N,00832,E,1,12,0.9,500.0,M,47.0,M,,") &&
+            _near(gNmea.gga.lat, 47.0 + (23.0 / 60.0)) && _near(gNmea.gga.lon, 8.0 + (32.0 / 60.0)));
+        TEST("GGA latlon empty", _decode("GGA", "123456.00,,,,,0,00,99.99,,,,,,") && (gNmea.gga.fix == NMEA_FIX_NOFIX));
+        TEST("GGA lat degrees only", !_decode("GGA", "123456.00,47,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,,"));
+        TEST("GGA lat signed minutes", !_decode("GGA", "123456.00,47-3.12345,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,,"));
+        TEST("GGA lat one digit minutes", !_decode("GGA", "123456.00,473.12345,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,,"));
+        TEST("GGA lat signed degrees", !_decode("GGA", "123456.00,-4723.12345,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,,"));
+        TEST("GGA height MSL", _decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,12,0.9,500.25,M,-47.5,M,,") &&
+            (gNmea.gga.height == 500.25) && (gNmea.gga.heightMsl == (500.25 + 47.5)));
+        TEST("GGA no diff", (gNmea.gga.diffAge < 0.0) && (gNmea.gga.diffStation < 0));
+        TEST("GGA diff", _decode("GGA", "123456.00,4723.12345,N,00832.12345,E,4,12,0.9,500.25,M,47.5,M,1.5,0123") &&
+            (gNmea.gga.diffAge == 1.5) && (gNmea.gga.diffStation == 123) && (gNmea.gga.fix == NMEA_FIX_RTK_FIXED));
+        TEST("GGA wrong number of fields", !_decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,") &&
+            !_decode("GGA", "123456.00,4723.12345,N,00832.12345,E,1,12,0.9,500.0,M,47.0,M,,,"));
+    }
+
+    // Time and date
+    {
+        TEST("time", _decode("GGA", "235959.99,,,,,0,00,99.99,,,,,,") && gNmea.gga.time.valid &&
+            (gNmea.gga.time.hour == 23) && (gNmea.gga.time.minute == 59) && (gNmea.gga.time.second == strtod("59.99", NULL)));
+        TEST("time no decimals", _decode("GGA", "010203,,,,,0,00,99.99,,,,,,") && gNmea.gga.time.valid &&
+            (gNmea.gga.time.hour == 1) && (gNmea.gga.time.minute == 2) && (gNmea.gga.time.second == 3.0));
+        TEST("time many decimals", _decode("GGA", "010203.123,,,,,0,00,99.99,,,,,,") &&
+            (gNmea.gga.time.second == strtod("03.123", NULL)));
+        TEST("time empty", _decode("GGA", ",,,,,0,00,99.99,,,,,,") && !gNmea.gga.time.valid);
+        TEST("time too short", !_decode("GGA", "0102,,,,,0,00,99.99,,,,,,") && !gNmea.gga.time.valid);
+        TEST("time extra digit", !_decode("GGA", "0102030.39,,,,,0,00,99.99,,,,,,") && !gNmea.gga.time.valid);
+        TEST("time signed", !_decode("GGA", "-10203.00,,,,,0,00,99.99,,,,,,") && !_decode("GGA", "01-203.00,,,,,0,00,99.99,,,,,,") &&
+            !_decode("GGA", "0102-3.00,,,,,0,00,99.99,,,,,,"));
+        TEST("RMC date", _decode("RMC", "123456.00,A,4723.12345,N,00832.12345,E,0.5,45.5,020124,,,A,V") &&
+            gNmea.rmc.date.valid && (gNmea.rmc.date.day == 2) && (gNmea.rmc.date.month == 1) && (gNmea.rmc.date.year == 2024) &&
+            gNmea.rmc.valid && (gNmea.rmc.spd == 0.5) && (gNmea.rmc.cog == 45.5));
+        TEST("RMC date empty", _decode("RMC", "123456.00,V,,,,,,,,,,N,V") && !gNmea.rmc.date.valid && gNmea.rmc.time.valid);
+        TEST("RMC date invalid", !_decode("RMC", "123456.00,V,,,,,,,0201240,,,N,V") && !_decode("RMC", "123456.00,V,,,,,,,02a124,,,N,V"));
+        TEST("RMC cog range", !_decode("RMC", "123456.00,A,4723.12345,N,00832.12345,E,0.5,360.5,020124,,,A,V"));
+        TEST("ZDA", _decode("ZDA", "123456.50,02,01,2024,00,00") && gNmea.zda.time.valid && gNmea.zda.date.valid &&
+            (gNmea.zda.date.year == 2024) && (gNmea.zda.time.second == 56.5));
+        TEST("ZDA empty date", _decode("ZDA", "123456.50,,,,,") && gNmea.zda.time.valid && !gNmea.zda.date.valid);
+        TEST("ZDA empty", _decode("ZDA", ",,,,,") && !gNmea.zda.time.valid && !gNmea.zda.date.valid);
+        TEST("ZDA partial date", !_decode("ZDA", "123456.50,02,,2024,,") && !gNmea.zda.date.valid);
+        TEST("ZDA short year", !_decode("ZDA", "123456.50,02,01,24,,") && !gNmea.zda.date.valid);
+    }
+
+    // Other messages
+    {
+        TEST("GLL", _decode("GLL", "4723.12345,N,00832.12345,W,123456.00,A,D") && gNmea.gll.valid &&
+            _near(gNmea.gll.lon, -(8.0 + (strtod("32.12345", NULL) / 60.0))) && (gNmea.gll.fix == NMEA_FIX_S3D));
+        TEST("GST", _decode("GST", "123456.00,1.5,2.5,1.25,45.0,0.5,0.75,1.0") && gNmea.gst.valid &&
+            (gNmea.gst.rangeRms == 1.5) && (gNmea.gst.stdLat == 0.5) && (gNmea.gst.stdLon == 0.75) && (gNmea.gst.stdAlt == 1.0));
+        TEST("GST empty", _decode("GST", "123456.00,,,,,,,") && !gNmea.gst.valid && (gNmea.gst.rangeRms < 0.0) &&
+            gNmea.gst.time.valid);
+        TEST("GST negative std", !_decode("GST", "123456.00,1.5,2.5,1.25,45.0,-0.5,0.75,1.0") && !gNmea.gst.valid);
+        TEST("VTG", _decode("VTG", "45.5,T,,M,1.25,N,2.315,K,A") && gNmea.vtg.valid && (gNmea.vtg.cogt == 45.5) &&
+            (gNmea.vtg.sogn == 1.25) && (gNmea.vtg.sogk == strtod("2.315", NULL)));
+    }
+
+    // Checksum and framing (done by the parser, nmeaDecode() expects a complete and valid sentence)
+    {
+        char msg[200];
+        nmeaMakeMessage("GN", "ZDA", "123456.50,02,01,2024,00,00", msg);
+        TEST("checksum ok", _parserNmea(msg));
+        const int len = strlen(msg);
+        const char ck1 = msg[len - 4];
+        const char ck2 = msg[len - 3];
+        msg[len - 3] = (ck2 == '0' ? '1' : '0');
+        TEST("checksum wrong", !_parserNmea(msg));
+        msg[len - 3] = ck2;
+        msg[len - 4] = (ck1 == '0' ? '1' : '0');
+        TEST("checksum wrong first digit", !_parserNmea(msg));
+        msg[len - 4] = ck1;
+        TEST("checksum ok again", _parserNmea(msg));
+
+        TEST("checksum upper case", _parserNmea("$GNTXT,01,01,02,x*2B\r\n"));
+        TEST("checksum lower case rejected", !_parserNmea("$GNTXT,01,01,02,x*2b\r\n"));
+        TEST("checksum missing", !_parserNmea("$GNTXT,01,01,02,x\r\n"));
+        TEST("checksum truncated", !_parserNmea("$GNTXT,01,01,02,x*2\r\n"));
+        TEST("checksum no star", !_parserNmea("$GNTXT,01,01,02,x2B\r\n"));
+        TEST("checksum no cr", !_parserNmea("$GNTXT,01,01,02,x*2B\n"));
+        TEST("invalid character", !_parserNmea("$GNTXT,01,01,02,\x01*2B\r\n"));
+        TEST("decode too short", !nmeaDecode(&gNmea, (const uint8_t *)"$GNZDA*4A\r\n", 5));
+    }
+
+    return TEST_DONE("test_nmea");
+}
+
+/* ****************************************************************************************************************** */
+// eof
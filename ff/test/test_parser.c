@@ -0,0 +1,271 @@
+// clang-format off
+// flipflip's library tests: message parser
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_ubx.h"
+#include "ff_nmea.h"
+#include "ff_parser.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// Test data: a stream of UBX and NMEA messages with some garbage in between, and the list of (non-garbage) messages
+
+#define MAX_MSGS 2000
+
+typedef struct STREAM_s
+{
+    uint8_t         *data;
+    int              size;
+    int              nMsgs;
+    PARSER_MSGTYPE_t types[MAX_MSGS];
+    int              sizes[MAX_MSGS];
+} STREAM_t;
+
+static uint32_t gRand = 42;
+
+static uint32_t _rand(void)
+{
+    gRand = (gRand * 1103515245) + 12345;
+    return (gRand >> 8) & 0xffffff;
+}
+
+static void _streamMake(STREAM_t *stream, const int nMsgs)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->data = malloc(nMsgs * (UBX_FRAME_SIZE + 2000 + 100));
+    for (int ix = 0; ix < nMsgs; ix++)
+    {
+        uint8_t *msg = &stream->data[stream->size];
+        const uint32_t what = _rand() % 10;
+        // Some garbage (no byte that could start a message)
+        if (what == 0)
+        {
+            const int size = 1 + (_rand() % 100);
+            for (int gIx = 0; gIx < size; gIx++)
+            {
+                msg[gIx] = "garbage"[gIx % 7];
+            }
+            stream->size += size;
+            continue;
+        }
+        // NMEA
+        else if (what < 4)
+        {
+            char payload[100];
+            snprintf(payload, sizeof(payload), "%06u.00,,,,,0,00,99.99,,,,,,", (unsigned int)(_rand() % 235959));
+            stream->sizes[stream->nMsgs] = nmeaMakeMessage("GN", "GGA", payload, (char *)msg);
+            stream->types[stream->nMsgs] = PARSER_MSGTYPE_NMEA;
+        }
+        // UBX, up to 2000 bytes payload
+        else
+        {
+            uint8_t payload[2000];
+            const int size = (what == 9 ? 2000 : (_rand() % 200));
+            for (int pIx = 0; pIx < size; pIx++)
+            {
+                payload[pIx] = _rand() & 0xff;
+            }
+            stream->sizes[stream->nMsgs] = ubxMakeMessage(UBX_NAV_CLSID, _rand() & 0xff, payload, size, msg);
+            stream->types[stream->nMsgs] = PARSER_MSGTYPE_UBX;
+        }
+        stream->size += stream->sizes[stream->nMsgs];
+        stream->nMsgs++;
+    }
+}
+
+// Parse the stream in blocks of the given size, returns true if all messages were found and all data was returned
+static bool _parseStream(const STREAM_t *stream, const int blockSize)
+{
+    PARSER_t *parser = malloc(sizeof(PARSER_t));
+    parserInit(parser);
+    parserSetNames(parser, false);
+    uint8_t *out = malloc(stream->size);
+    int outSize = 0;
+    int nMsgs = 0;
+    bool ok = true;
+    int inOffs = 0;
+    PARSER_MSG_t msg;
+    while (ok && (inOffs < stream->size))
+    {
+        const int size = MIN(blockSize, stream->size - inOffs);
+        if (!parserAdd(parser, &stream->data[inOffs], size))
+        {
+            ok = false;
+            break;
+        }
+        inOffs += size;
+        while (ok && parserProcess(parser, &msg, false))
+        {
+            memcpy(&out[outSize], msg.data, msg.size);
+            outSize += msg.size;
+            if (msg.type != PARSER_MSGTYPE_GARBAGE)
+            {
+                ok = (nMsgs < stream->nMsgs) && (msg.type == stream->types[nMsgs]) && (msg.size == stream->sizes[nMsgs]);
+                nMsgs++;
+            }
+        }
+    }
+    while (ok && parserFlush(parser, &msg))
+    {
+        memcpy(&out[outSize], msg.data, msg.size);
+        outSize += msg.size;
+    }
+    ok = ok && (nMsgs == stream->nMsgs) && (outSize == stream->size) && (memcmp(out, stream->data, outSize) == 0);
+    if (!ok && (gVerbosity > 0))
+    {
+        printf("blockSize=%d: nMsgs=%d/%d outSize=%d/%d\n", blockSize, nMsgs, stream->nMsgs, outSize, stream->size);
+    }
+    free(out);
+    free(parser);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 1 ? DEBUG_LEVEL_TRACE : DEBUG_LEVEL_WARNING;
+    debugSetup(&debugCfg);
+
+    // Streams much larger than the parser buffer, in various block sizes
+    {
+        STREAM_t *stream = malloc(sizeof(STREAM_t));
+        _streamMake(stream, MAX_MSGS);
+        TEST("stream larger than buffer", stream->size > (4 * PARSER_BUF_SIZE));
+        TEST("block size 1", _parseStream(stream, 1));
+        TEST("block size 7", _parseStream(stream, 7));
+        TEST("block size 100", _parseStream(stream, 100));
+        TEST("block size 1000", _parseStream(stream, 1000));
+        TEST("block size 4096", _parseStream(stream, 4096));
+        TEST("block size 10000", _parseStream(stream, 10000));
+        TEST("block size PARSER_BUF_SIZE - PARSER_MAX_ANY_SIZE", _parseStream(stream, PARSER_BUF_SIZE - PARSER_MAX_ANY_SIZE));
+        free(stream->data);
+        free(stream);
+    }
+
+    // Overflow
+    {
+        PARSER_t *parser = malloc(sizeof(PARSER_t));
+        parserInit(parser);
+        uint8_t *data = calloc(PARSER_BUF_SIZE + 1, 1);
+        TEST("add too much", !parserAdd(parser, data, PARSER_BUF_SIZE + 1));
+        TEST("add all", parserAdd(parser, data, PARSER_BUF_SIZE));
+        TEST("add more", !parserAdd(parser, data, 1));
+        PARSER_MSG_t msg;
+        TEST("garbage bin size", parserProcess(parser, &msg, false) && (msg.type == PARSER_MSGTYPE_GARBAGE) &&
+            (msg.size == PARSER_MAX_GARB_SIZE));
+        // Adding data does not make space, the message data must stay where it is
+        TEST("add after process", (parserSpace(parser) == 0) && !parserAdd(parser, data, 1));
+        // Processing makes space once enough data is consumed
+        for (int ix = 0; ix < 3; ix++)
+        {
+            parserProcess(parser, &msg, false);
+        }
+        TEST("no space yet", parserSpace(parser) == 0);
+        TEST("space after process", parserProcess(parser, &msg, false) && (msg.size == PARSER_MAX_GARB_SIZE) &&
+            (parserSpace(parser) == (4 * PARSER_MAX_GARB_SIZE)) && parserAdd(parser, data, 4 * PARSER_MAX_GARB_SIZE) &&
+            !parserAdd(parser, data, 1));
+        free(data);
+        free(parser);
+    }
+
+    // Message data stays valid while adding more data
+    {
+        PARSER_t *parser = malloc(sizeof(PARSER_t));
+        parserInit(parser);
+        char nmea[100];
+        const int nmeaSize = nmeaMakeMessage("GN", "TXT", "01,01,02,test", nmea);
+        uint8_t *data = malloc(PARSER_BUF_SIZE);
+        memset(data, 0x55, PARSER_BUF_SIZE);
+        PARSER_MSG_t msg;
+        TEST("valid: first", parserAdd(parser, (const uint8_t *)nmea, nmeaSize) &&
+            parserAdd(parser, (const uint8_t *)nmea, nmeaSize) && parserProcess(parser, &msg, false) &&
+            (msg.type == PARSER_MSGTYPE_NMEA) && (msg.size == nmeaSize));
+        const uint8_t *msgData = msg.data;
+        TEST("valid: add", parserAdd(parser, data, parserSpace(parser)) && (parserSpace(parser) == 0));
+        TEST("valid: data", (msg.data == msgData) && (memcmp(msg.data, nmea, nmeaSize) == 0));
+        TEST("valid: second", parserProcess(parser, &msg, false) && (msg.type == PARSER_MSGTYPE_NMEA) &&
+            (msg.size == nmeaSize) && (memcmp(msg.data, nmea, nmeaSize) == 0));
+        free(data);
+        free(parser);
+    }
+
+    // Flush more than PARSER_MAX_ANY_SIZE
+    {
+        PARSER_t *parser = malloc(sizeof(PARSER_t));
+        parserInit(parser);
+        uint8_t *data = malloc(PARSER_BUF_SIZE);
+        for (int ix = 0; ix < PARSER_BUF_SIZE; ix++)
+        {
+            data[ix] = ix & 0x7f;
+        }
+        PARSER_MSG_t msg;
+        TEST("flush empty", !parserFlush(parser, &msg));
+        TEST("flush all", parserAdd(parser, data, PARSER_BUF_SIZE) && parserFlush(parser, &msg) &&
+            (msg.type == PARSER_MSGTYPE_GARBAGE) && (msg.size == PARSER_BUF_SIZE) && (memcmp(msg.data, data, msg.size) == 0));
+        TEST("flush again", !parserFlush(parser, &msg) && !parserProcess(parser, &msg, false));
+        TEST("add after flush", parserAdd(parser, data, PARSER_BUF_SIZE));
+        free(data);
+        free(parser);
+    }
+
+    // Incomplete message, then flush
+    {
+        PARSER_t parser;
+        parserInit(&parser);
+        uint8_t msg1[UBX_FRAME_SIZE + 10] = { 0 };
+        const int size1 = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_PVT_MSGID, NULL, 10, msg1);
+        char msg2[100];
+        const int size2 = nmeaMakeMessage("GN", "TXT", "01,01,02,test", msg2);
+        PARSER_MSG_t msg;
+        TEST("incomplete: add", parserAdd(&parser, msg1, size1) && parserAdd(&parser, (const uint8_t *)msg2, size2 - 3));
+        TEST("incomplete: first", parserProcess(&parser, &msg, false) && (msg.type == PARSER_MSGTYPE_UBX) && (msg.size == size1));
+        TEST("incomplete: wait", !parserProcess(&parser, &msg, false));
+        TEST("incomplete: flush", parserFlush(&parser, &msg) && (msg.type == PARSER_MSGTYPE_GARBAGE) &&
+            (msg.size == (size2 - 3)) && (memcmp(msg.data, msg2, msg.size) == 0));
+        TEST("incomplete: done", !parserFlush(&parser, &msg));
+        TEST("incomplete: stats", (parser.nUbx == 1) && (parser.nNmea == 0) && (parser.nGarbage == 1) && (parser.nMsgs == 2));
+    }
+
+    // Chunk timestamps: the message gets the timestamp of the chunk that completed it
+    {
+        PARSER_t parser;
+        parserInit(&parser);
+        parserSetTs(&parser, PARSER_TS_CHUNK, NULL, NULL);
+        uint8_t msg1[UBX_FRAME_SIZE + 10] = { 0 };
+        const int size1 = ubxMakeMessage(UBX_NAV_CLSID, UBX_NAV_PVT_MSGID, NULL, 10, msg1);
+        PARSER_MSG_t msg;
+        TEST("ts: first part", parserAddTs(&parser, msg1, 5, 100) && !parserProcess(&parser, &msg, false));
+        TEST("ts: second part", parserAddTs(&parser, &msg1[5], size1 - 5, 200) && parserAddTs(&parser, msg1, size1, 300));
+        TEST("ts: first message", parserProcess(&parser, &msg, false) && (msg.size == size1) && (msg.ts == 200));
+        TEST("ts: second message", parserProcess(&parser, &msg, false) && (msg.size == size1) && (msg.ts == 300));
+        TEST("ts: done", !parserProcess(&parser, &msg, false));
+        TEST("ts: seq", msg.seq == 2);
+    }
+
+    return TEST_DONE("test_parser");
+}
+
+/* ****************************************************************************************************************** */
+// eof
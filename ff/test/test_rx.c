@@ -0,0 +1,311 @@
+// clang-format off
+// flipflip's library tests: receiver polling with a virtual clock
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_ubx.h"
+#include "ff_parser.h"
+#include "ff_rx.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+// The simulated receiver (the "peer") is the other end of a TCP connection on localhost. It runs in the virtual
+// clock's advance() callback, that is, whenever the rx code sleeps (e.g. while waiting for a poll response). As
+// everything happens in the same thread, and TCP on localhost delivers the data immediately, the tests are
+// deterministic. And they run instantly, regardless of the timeouts.
+
+typedef enum PEER_MODE_e
+{
+    PEER_SILENT,       // Never respond
+    PEER_RESPOND,      // Respond to polls
+    PEER_NAK,          // Respond with UBX-ACK-NAK
+} PEER_MODE_t;
+
+typedef struct PEER_s
+{
+    int         listenFd;
+    int         fd;
+    PARSER_t    parser;
+    PEER_MODE_t mode;
+    int         ignore;      // Number of polls to ignore before responding
+    uint32_t    delay;       // Response delay [ms]
+    int         nPolls;      // Number of polls received
+    uint64_t    tPoll;       // Time of the last poll
+    bool        pending;     // Response pending
+    uint8_t     pendingClsId;
+    uint8_t     pendingMsgId;
+} PEER_t;
+
+static void _peerSend(PEER_t *peer, const uint8_t clsId, const uint8_t msgId, const uint8_t *payload, const int size)
+{
+    uint8_t msg[UBX_FRAME_SIZE + 100];
+    const int msgSize = ubxMakeMessage(clsId, msgId, payload, size, msg);
+    if (send(peer->fd, msg, msgSize, 0) != msgSize)
+    {
+        WARNING("peer: send fail: %s", strerror(errno));
+    }
+}
+
+static void _peerRespond(PEER_t *peer)
+{
+    if (peer->mode == PEER_NAK)
+    {
+        const uint8_t nak[2] = { peer->pendingClsId, peer->pendingMsgId };
+        _peerSend(peer, UBX_ACK_CLSID, UBX_ACK_NAK_MSGID, nak, sizeof(nak));
+    }
+    else
+    {
+        // Some unrelated message first, which the poll must skip
+        const uint8_t other[4] = { 0 };
+        _peerSend(peer, UBX_MON_CLSID, UBX_MON_HW3_MSGID, other, sizeof(other));
+        uint8_t resp[40];
+        memset(resp, 0, sizeof(resp));
+        snprintf((char *)resp, sizeof(resp), "TEST 1.00");
+        _peerSend(peer, peer->pendingClsId, peer->pendingMsgId, resp, sizeof(resp));
+    }
+}
+
+static void _peerAdvance(void *arg, const uint64_t from, const uint64_t to)
+{
+    PEER_t *peer = (PEER_t *)arg;
+    UNUSED(from);
+    if (peer->fd < 0)
+    {
+        peer->fd = accept(peer->listenFd, NULL, NULL);
+        if (peer->fd < 0)
+        {
+            return;
+        }
+        fcntl(peer->fd, F_SETFL, fcntl(peer->fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    // Receive polls
+    uint8_t buf[1000];
+    const ssize_t num = recv(peer->fd, buf, sizeof(buf), 0);
+    if (num > 0)
+    {
+        parserAdd(&peer->parser, buf, num);
+        PARSER_MSG_t msg;
+        while (parserProcess(&peer->parser, &msg, false))
+        {
+            if ( (msg.type != PARSER_MSGTYPE_UBX) || (msg.size != UBX_FRAME_SIZE) )
+            {
+                continue;
+            }
+            peer->nPolls++;
+            peer->tPoll = to / 1000000;
+            if ( (peer->mode != PEER_SILENT) && (peer->nPolls > peer->ignore) )
+            {
+                peer->pending = true;
+                peer->pendingClsId = UBX_CLSID(msg.data);
+                peer->pendingMsgId = UBX_MSGID(msg.data);
+            }
+        }
+    }
+
+    // Respond, possibly with a delay
+    if (peer->pending && ((to / 1000000) >= (peer->tPoll + peer->delay)))
+    {
+        _peerRespond(peer);
+        peer->pending = false;
+    }
+}
+
+static bool _peerInit(PEER_t *peer, char *spec, const int size)
+{
+    memset(peer, 0, sizeof(*peer));
+    peer->fd = -1;
+    parserInit(&peer->parser);
+    peer->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addrLen = sizeof(addr);
+    if ( (peer->listenFd < 0) || (bind(peer->listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+         (listen(peer->listenFd, 1) != 0) || (getsockname(peer->listenFd, (struct sockaddr *)&addr, &addrLen) != 0) )
+    {
+        WARNING("peer: listen fail: %s", strerror(errno));
+        return false;
+    }
+    fcntl(peer->listenFd, F_SETFL, fcntl(peer->listenFd, F_GETFL, 0) | O_NONBLOCK);
+    snprintf(spec, size, "tcp://127.0.0.1:%d", (int)ntohs(addr.sin_port));
+    return true;
+}
+
+static void _peerClose(PEER_t *peer)
+{
+    if (peer->fd >= 0)
+    {
+        close(peer->fd);
+    }
+    if (peer->listenFd >= 0)
+    {
+        close(peer->listenFd);
+    }
+}
+
+/* ****************************************************************************************************************** */
+
+typedef struct RESULT_s
+{
+    bool     ok;       // Got response
+    bool     nak;      // Got NAK
+    int      nPolls;   // Number of polls the peer received
+    uint64_t dt;       // Duration of rxPollUbx() [ms] (virtual time)
+} RESULT_t;
+
+static RESULT_t _poll(const PEER_MODE_t mode, const int ignore, const uint32_t delay,
+    const uint8_t clsId, const uint8_t msgId, const uint32_t timeout, const int retries)
+{
+    RESULT_t result = { .ok = false };
+    PEER_t peer;
+    char spec[100];
+    if (!_peerInit(&peer, spec, sizeof(spec)))
+    {
+        return result;
+    }
+    peer.mode   = mode;
+    peer.ignore = ignore;
+    peer.delay  = delay;
+
+    TIME_VCLOCK_t vclock = { .now = 0, .advance = _peerAdvance, .arg = &peer };
+    timeSetVirtualClock(&vclock);
+
+    RX_OPTS_t opts = RX_OPTS_DEFAULT();
+    opts.detect   = RX_DET_NONE;
+    opts.autobaud = false;
+    opts.verbose  = false;
+    RX_t *rx = rxInit(spec, &opts);
+    if ( (rx != NULL) && rxOpen(rx) )
+    {
+        const RX_POLL_UBX_t param = { .clsId = clsId, .msgId = msgId, .timeout = timeout, .retries = retries };
+        const uint64_t t0 = TIME();
+        const PARSER_MSG_t *msg = rxPollUbx(rx, &param, &result.nak);
+        result.dt = TIME() - t0;
+        result.ok = (msg != NULL) && (UBX_CLSID(msg->data) == clsId) && (UBX_MSGID(msg->data) == msgId);
+        result.nPolls = peer.nPolls;
+        rxClose(rx);
+    }
+    free(rx);
+
+    timeSetVirtualClock(NULL);
+    _peerClose(&peer);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 0 ? DEBUG_LEVEL_DEBUG : DEBUG_LEVEL_WARNING;
+    debugSetup(&debugCfg);
+
+    const uint64_t t0 = timeRealNs();
+
+    // Virtual clock basics
+    {
+        TIME_VCLOCK_t vclock = { .now = 0 };
+        timeSetVirtualClock(&vclock);
+        const uint64_t ta = TIME();
+        SLEEP(1234);
+        const uint64_t tb = TIME();
+        TEST("vclock starts at 0", ta == 0);
+        TEST("vclock advances by sleep", tb == 1234);
+        TEST("vclock counts sleeps", (vclock.nSleeps == 1) && (vclock.slept == (1234 * 1000000)));
+        TEST("vclock sleepUntilMonoNs() in the past", sleepUntilMonoNs(0) && (timeMonoNs() == (1234 * 1000000)));
+        timeSetVirtualClock(NULL);
+    }
+
+    // Immediate response
+    {
+        const RESULT_t res = _poll(PEER_RESPOND, 0, 0, UBX_MON_CLSID, UBX_MON_VER_MSGID, 1500, 2);
+        TEST("poll response", res.ok && !res.nak);
+        TEST("poll response: one poll", res.nPolls == 1);
+        TEST("poll response: no timeout", res.dt < 100);
+    }
+
+    // Delayed response, within the timeout
+    {
+        const RESULT_t res = _poll(PEER_RESPOND, 0, 800, UBX_MON_CLSID, UBX_MON_VER_MSGID, 1000, 3);
+        TEST("delayed response", res.ok);
+        TEST("delayed response: one poll", res.nPolls == 1);
+        TEST("delayed response: delay", (res.dt >= 800) && (res.dt < 1000));
+    }
+
+    // Delayed response, after the timeout, retry
+    {
+        const RESULT_t res = _poll(PEER_RESPOND, 1, 1200, UBX_MON_CLSID, UBX_MON_VER_MSGID, 1000, 3);
+        TEST("late response", !res.ok);
+        TEST("late response: all polls", res.nPolls == 3);
+    }
+
+    // Response to second poll only
+    {
+        const RESULT_t res = _poll(PEER_RESPOND, 1, 0, UBX_MON_CLSID, UBX_MON_VER_MSGID, 1500, 2);
+        TEST("retry", res.ok);
+        TEST("retry: two polls", res.nPolls == 2);
+        TEST("retry: one timeout", (res.dt >= 1500) && (res.dt < 1600));
+    }
+
+    // No response, all retries time out
+    {
+        const RESULT_t res = _poll(PEER_SILENT, 0, 0, UBX_MON_CLSID, UBX_MON_VER_MSGID, 1500, 4);
+        TEST("timeout", !res.ok && !res.nak);
+        TEST("timeout: all polls", res.nPolls == 4);
+        TEST("timeout: all timeouts", (res.dt >= (4 * 1500)) && (res.dt < ((4 * 1500) + 100)));
+    }
+
+    // Default parameters
+    {
+        const RESULT_t res = _poll(PEER_SILENT, 0, 0, UBX_MON_CLSID, UBX_MON_VER_MSGID, 0, 0);
+        TEST("defaults", !res.ok);
+        TEST("defaults: 2 polls", res.nPolls == 2);
+        TEST("defaults: 1.5s timeout", (res.dt >= (2 * 1500)) && (res.dt < ((2 * 1500) + 100)));
+    }
+
+    // UBX-CFG polls can be NAKed, no retries
+    {
+        const RESULT_t res = _poll(PEER_NAK, 0, 0, UBX_CFG_CLSID, UBX_CFG_VALGET_MSGID, 1500, 3);
+        TEST("nak", !res.ok && res.nak);
+        TEST("nak: no retries", res.nPolls == 1);
+        TEST("nak: no timeout", res.dt < 100);
+    }
+
+    // All of the above must not take real time
+    const uint64_t dt = (timeRealNs() - t0) / 1000000;
+    TEST("tests run instantly", dt < 1000);
+
+    return TEST_DONE("test_rx");
+}
+
+/* ****************************************************************************************************************** */
+// eof
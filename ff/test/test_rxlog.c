@@ -0,0 +1,264 @@
+// clang-format off
+// flipflip's library tests: timestamped receiver log
+//
+// Copyright (c) Philippe Kehl (flipflip at oinkzwurgl dot org) and contributors
+// https://oinkzwurgl.org/projaeggd/ubloxcfg/
+//
+// This program is free software: you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation, either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+// even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "ff_stuff.h"
+#include "ff_debug.h"
+#include "ff_parser.h"
+#include "ff_rxlog.h"
+
+#include "test.h"
+
+/* ****************************************************************************************************************** */
+
+#define NUM_RECS 2000
+#define TS0      UINT64_C(1000000000000)
+#define DTS      UINT64_C(1000000)
+
+static char gPath[100];
+static uint32_t gRand = 42;
+
+static uint32_t _rand(void)
+{
+    gRand = (gRand * 1103515245) + 12345;
+    return (gRand >> 8) & 0xffffff;
+}
+
+// The data of record ix (deterministic, so that it can be compared when reading)
+static int _recData(const int ix, uint8_t *data)
+{
+    gRand = ix;
+    const int size = (ix % 100) == 0 ? 0 : (_rand() % 500);
+    for (int dIx = 0; dIx < size; dIx++)
+    {
+        data[dIx] = _rand() & 0xff;
+    }
+    return size;
+}
+
+static bool _write(const bool append, const uint32_t checkInterval, const int ix0, const int num, const uint64_t ts0)
+{
+    RXLOG_t *log = rxlogCreate(gPath, append, checkInterval);
+    bool ok = (log != NULL);
+    for (int ix = ix0; ok && (ix < (ix0 + num)); ix++)
+    {
+        uint8_t data[1000];
+        const int size = _recData(ix, data);
+        ok = rxlogWrite(log, ts0 + ((ix - ix0) * DTS), PARSER_MSGSRC_FROM_RX, (PARSER_MSGTYPE_t)(ix % 3), data, size);
+    }
+    return rxlogClose(log) && ok;
+}
+
+// Read all records, check that records ix0..(ix0+num-1) are there (with the given records missing, if any)
+static bool _read(const int ix0, const int num, const int missing, RXLOG_INFO_t *info)
+{
+    RXLOG_t *log = rxlogOpen(gPath);
+    bool ok = (log != NULL);
+    int ix = ix0;
+    RXLOG_REC_t rec;
+    while (ok && rxlogRead(log, &rec))
+    {
+        if (ix == missing)
+        {
+            ix++;
+        }
+        uint8_t data[1000];
+        const int size = _recData(ix, data);
+        ok = (rec.size == size) && (memcmp(rec.data, data, size) == 0) && (rec.type == (PARSER_MSGTYPE_t)(ix % 3)) &&
+            (rec.src == PARSER_MSGSRC_FROM_RX);
+        if (!ok && (gVerbosity > 0))
+        {
+            printf("record %d: size %d/%d\n", ix, rec.size, size);
+        }
+        ix++;
+    }
+    ok = ok && (ix == (ix0 + num));
+    rxlogGetInfo(log, info);
+    rxlogClose(log);
+    return ok;
+}
+
+// Find the offset of a record
+static uint64_t _recOffs(const int n)
+{
+    RXLOG_t *log = rxlogOpen(gPath);
+    RXLOG_REC_t rec = { .offs = 0 };
+    for (int ix = 0; (ix <= n) && rxlogRead(log, &rec); ix++) { }
+    rxlogClose(log);
+    return rec.offs;
+}
+
+static void _corrupt(const uint64_t offs)
+{
+    FILE *file = fopen(gPath, "r+b");
+    fseeko(file, offs, SEEK_SET);
+    const int c = fgetc(file);
+    fseeko(file, offs, SEEK_SET);
+    fputc(c ^ 0x55, file);
+    fclose(file);
+}
+
+static uint64_t _fileSize(void)
+{
+    FILE *file = fopen(gPath, "rb");
+    fseeko(file, 0, SEEK_END);
+    const uint64_t size = ftello(file);
+    fclose(file);
+    return size;
+}
+
+static bool _seekTs(const uint64_t ts, const uint64_t expTs)
+{
+    RXLOG_t *log = rxlogOpen(gPath);
+    RXLOG_REC_t rec;
+    const bool ok = rxlogSeekTs(log, ts) && rxlogRead(log, &rec) && (rec.ts == expTs);
+    rxlogClose(log);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    TEST_INIT(argc, argv);
+    DEBUG_CFG_t debugCfg;
+    debugGetCfg(&debugCfg);
+    debugCfg.level = gVerbosity > 0 ? DEBUG_LEVEL_DEBUG : DEBUG_LEVEL_ERROR;
+    debugSetup(&debugCfg);
+
+    snprintf(gPath, sizeof(gPath), "/tmp/ff-test-rxlog-%d.log", (int)getpid());
+    RXLOG_INFO_t info;
+
+    // Round trip without checks
+    {
+        TEST("write", _write(false, 0, 0, NUM_RECS, TS0));
+        TEST("read", _read(0, NUM_RECS, -1, &info));
+        TEST("read: info", (info.numRecs == NUM_RECS) && (info.numChecks == 0) && (info.numErrors == 0) &&
+            (info.checkInterval == 0) && (info.flags == 0) && (info.size == _fileSize()));
+    }
+
+    // Round trip with checks
+    {
+        TEST("write checks", _write(false, 10000, 0, NUM_RECS, TS0));
+        TEST("read checks", _read(0, NUM_RECS, -1, &info));
+        TEST("read checks: info", (info.numRecs == NUM_RECS) && (info.numChecks >= (_fileSize() / 10000)) &&
+            (info.numErrors == 0) && (info.checkInterval == 10000));
+    }
+
+    // Seek by timestamp
+    {
+        TEST("seek first", _seekTs(0, TS0));
+        TEST("seek exact", _seekTs(TS0 + (1234 * DTS), TS0 + (1234 * DTS)));
+        TEST("seek between", _seekTs(TS0 + (1234 * DTS) + 1, TS0 + (1235 * DTS)));
+        TEST("seek last", _seekTs(TS0 + ((NUM_RECS - 1) * DTS), TS0 + ((NUM_RECS - 1) * DTS)));
+        RXLOG_t *log = rxlogOpen(gPath);
+        TEST("seek beyond", !rxlogSeekTs(log, TS0 + (NUM_RECS * DTS)));
+        rxlogClose(log);
+    }
+
+    // Bad payload, the check must fail, but the record is still returned
+    {
+        _corrupt(_recOffs(1001) + RXLOG_REC_HEAD_SIZE + 1);
+        RXLOG_t *log = rxlogOpen(gPath);
+        RXLOG_REC_t rec;
+        while (rxlogRead(log, &rec)) { }
+        rxlogGetInfo(log, &info);
+        rxlogClose(log);
+        TEST("bad payload: all records", info.numRecs == NUM_RECS);
+        TEST("bad payload: check fail", info.numErrors == 1);
+    }
+
+    // Bad record header, the record is skipped
+    {
+        TEST("write", _write(false, 10000, 0, NUM_RECS, TS0));
+        _corrupt(_recOffs(1000) + 4);
+        TEST("bad header: record skipped", _read(0, NUM_RECS, 1000, &info) && (info.numRecs == (NUM_RECS - 1)));
+        TEST("bad header: resync", info.numErrors == 1);
+    }
+
+    // Garbage in front of a record, resync
+    {
+        TEST("write", _write(false, 0, 0, NUM_RECS, TS0));
+        _corrupt(_recOffs(500));
+        TEST("bad sync: record skipped", _read(0, NUM_RECS, 500, &info) && (info.numErrors == 1));
+    }
+
+    // Truncated log, append removes the truncated record
+    {
+        TEST("write", _write(false, 10000, 0, NUM_RECS, TS0));
+        const uint64_t offs = _recOffs(NUM_RECS - 1);
+        uint8_t data[1000];
+        const int size = _recData(NUM_RECS - 1, data);
+        TEST("truncate payload", (size > 1) && (truncate(gPath, offs + RXLOG_REC_HEAD_SIZE + (size / 2)) == 0));
+        TEST("truncated payload: read", _read(0, NUM_RECS - 1, -1, &info) && (info.numErrors == 1));
+        TEST("truncate header", truncate(gPath, offs + RXLOG_REC_HEAD_SIZE - 3) == 0);
+        TEST("truncated header: read", _read(0, NUM_RECS - 1, -1, &info) && (info.numErrors == 0));
+        TEST("append", _write(true, 0, NUM_RECS - 1, 1000, TS0 + ((NUM_RECS - 1) * DTS)));
+        TEST("append: read", _read(0, NUM_RECS - 1 + 1000, -1, &info) && (info.numErrors == 0) &&
+            (info.checkInterval == 10000));
+        TEST("append: monotonic", info.flags == 0);
+        TEST("append: seek", _seekTs(TS0 + ((NUM_RECS + 500) * DTS), TS0 + ((NUM_RECS + 500) * DTS)));
+    }
+
+    // Append with timestamps going backwards (e.g. after a reboot)
+    {
+        TEST("write", _write(false, 0, 0, NUM_RECS, TS0));
+        TEST("append after reboot", _write(true, 0, NUM_RECS, NUM_RECS, 1000));
+        TEST("not monotonic: read", _read(0, 2 * NUM_RECS, -1, &info) && (info.flags == RXLOG_FLAG_NONMONO));
+        // First session: TS0, TS0 + DTS, ..., second session: 1000, 1000 + DTS, ... (all before the first session).
+        // The first record in file order is found.
+        TEST("not monotonic: seek first session", _seekTs(TS0 + (1000 * DTS), TS0 + (1000 * DTS)));
+        TEST("not monotonic: seek second session", _seekTs(1000 + (1500 * DTS), TS0));
+        TEST("not monotonic: seek second session start", _seekTs(0, TS0));
+        RXLOG_t *log = rxlogOpen(gPath);
+        TEST("not monotonic: seek beyond", !rxlogSeekTs(log, TS0 + (NUM_RECS * DTS)));
+        rxlogClose(log);
+    }
+
+    // Parser
+    {
+        TEST("write", _write(false, 0, 0, NUM_RECS, TS0));
+        RXLOG_t *log = rxlogOpen(gPath);
+        PARSER_t parser;
+        parserInit(&parser);
+        parserSetTs(&parser, PARSER_TS_CHUNK, NULL, NULL);
+        RXLOG_REC_t rec;
+        PARSER_MSG_t msg;
+        TEST("parser: add", rxlogRead(log, &rec) && rxlogRead(log, &rec) && (rec.size > 0) && rxlogToParser(&parser, &rec));
+        TEST("parser: ts", parserFlush(&parser, &msg) && (msg.ts == (TS0 + DTS)) && (msg.size == rec.size));
+        rxlogClose(log);
+    }
+
+    // Not a log
+    {
+        const uint8_t data[RXLOG_HEAD_SIZE] = { 0 };
+        TEST("not a log", !rxlogIsLog(data, sizeof(data)));
+        FILE *file = fopen(gPath, "wb");
+        fwrite(data, sizeof(data), 1, file);
+        fclose(file);
+        TEST("not a log: open", rxlogOpen(gPath) == NULL);
+        TEST("not a log: append", rxlogCreate(gPath, true, 0) == NULL);
+    }
+
+    unlink(gPath);
+
+    return TEST_DONE("test_rxlog");
+}
+
+/* ****************************************************************************************************************** */
+// eof